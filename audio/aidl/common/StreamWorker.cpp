@@ -17,14 +17,164 @@
 #include <pthread.h>
 #include <sched.h>
 #include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
 
 #include "include/StreamWorker.h"
 
-namespace android::hardware::audio::common::internal {
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+namespace android::hardware::audio::common {
+
+namespace {
+
+// Same layout as 'struct sched_attr' of the kernel, which libc does not provide.
+struct SchedAttr {
+    uint32_t size;
+    uint32_t schedPolicy;
+    uint64_t schedFlags;
+    int32_t schedNice;
+    uint32_t schedPriority;
+    uint64_t schedRuntime;
+    uint64_t schedDeadline;
+    uint64_t schedPeriod;
+};
+
+std::string applyScheduling(const WorkerScheduling& scheduling) {
+    std::string error;
+    switch (scheduling.policy) {
+        case WorkerScheduling::Policy::NORMAL:
+            if (scheduling.priority != ANDROID_PRIORITY_DEFAULT &&
+                setpriority(PRIO_PROCESS, 0, scheduling.priority) != 0) {
+                int errCode = errno;
+                error.append("Failed to set thread priority: ").append(strerror(errCode));
+            }
+            break;
+        case WorkerScheduling::Policy::FIFO: {
+            sched_param param{};
+            param.sched_priority = scheduling.priority;
+            if (int errCode = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+                errCode != 0) {
+                error.append("Failed to set SCHED_FIFO priority ")
+                        .append(std::to_string(scheduling.priority))
+                        .append(": ")
+                        .append(strerror(errCode));
+            }
+            break;
+        }
+        case WorkerScheduling::Policy::DEADLINE: {
+            if (scheduling.budget.count() <= 0 || scheduling.budget > scheduling.period) {
+                error.append("Invalid SCHED_DEADLINE budget ")
+                        .append(std::to_string(scheduling.budget.count()))
+                        .append(" ns for the period ")
+                        .append(std::to_string(scheduling.period.count()))
+                        .append(" ns");
+                break;
+            }
+#if defined(__NR_sched_setattr)
+            SchedAttr attr{};
+            attr.size = sizeof(attr);
+            attr.schedPolicy = SCHED_DEADLINE;
+            attr.schedRuntime = scheduling.budget.count();
+            attr.schedDeadline = scheduling.period.count();
+            attr.schedPeriod = scheduling.period.count();
+            if (syscall(__NR_sched_setattr, 0, &attr, 0) != 0) {
+                int errCode = errno;
+                error.append("Failed to set SCHED_DEADLINE: ").append(strerror(errCode));
+            }
+#else
+            error.append("SCHED_DEADLINE is not supported");
+#endif
+            break;
+        }
+    }
+    return error;
+}
+
+// The CPU time used by the calling thread so far.
+std::chrono::nanoseconds getThreadCpuTime() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+// There is only one writer, so updates do not need atomic read-modify-write operations.
+void increment(std::atomic<uint64_t>* counter) {
+    counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+void CycleHistogram::record(std::chrono::nanoseconds duration) {
+    const uint64_t us = std::max<int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0);
+    const size_t bucket =
+            us == 0 ? 0 : std::min<size_t>(64 - __builtin_clzll(us), kBucketCount - 1);
+    add(&mBuckets[bucket], 1);
+    add(&mTotalUs, us);
+    if (us > mMaxUs.load(std::memory_order_relaxed)) {
+        mMaxUs.store(us, std::memory_order_relaxed);
+    }
+    // The count is updated last, so that readers rarely see a count which is ahead of
+    // the buckets.
+    mCount.store(mCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+std::array<uint64_t, CycleHistogram::kBucketCount> CycleHistogram::getBuckets() const {
+    std::array<uint64_t, kBucketCount> buckets;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+    }
+    return buckets;
+}
+
+std::string CycleHistogram::toString() const {
+    const uint64_t count = mCount.load(std::memory_order_acquire);
+    std::ostringstream s;
+    s << "count: " << count;
+    if (count == 0) return s.str();
+    s << ", mean: " << mTotalUs.load(std::memory_order_relaxed) / count
+      << " us, max: " << getMax().count() << " us, buckets:";
+    const auto buckets = getBuckets();
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        if (buckets[i] == 0) continue;
+        if (i == kBucketCount - 1) {
+            s << " >=" << (1ull << (i - 1));
+        } else {
+            s << " <" << (1ull << i);
+        }
+        s << " us: " << buckets[i] << ";";
+    }
+    return s.str();
+}
+
+std::string WorkerStats::toString() const {
+    std::ostringstream s;
+    s << "wakeup latency: " << wakeupLatency.toString() << "\n"
+      << "cycle duration: " << cycleDuration.toString() << "\n"
+      << "budget overruns: " << budgetOverruns.load(std::memory_order_relaxed) << "\n"
+      << "missed deadlines: " << missedDeadlines.load(std::memory_order_relaxed) << "\n";
+    return s.str();
+}
+
+namespace internal {
 
 bool ThreadController::start(const std::string& name, int priority) {
+    WorkerScheduling scheduling;
+    scheduling.priority = priority;
+    return start(name, scheduling);
+}
+
+bool ThreadController::start(const std::string& name, const WorkerScheduling& scheduling) {
     mThreadName = name;
-    mThreadPriority = priority;
+    mScheduling = scheduling;
     if (kTestSingleThread != name) {
         mWorker = std::thread(&ThreadController::workerThread, this);
     } else {
@@ -93,11 +243,8 @@ void ThreadController::workerThread() {
             error.append("Failed to set thread name: ").append(strerror(errCode));
         }
     }
-    if (error.empty() && mThreadPriority != ANDROID_PRIORITY_DEFAULT) {
-        if (int result = setpriority(PRIO_PROCESS, 0, mThreadPriority); result != 0) {
-            int errCode = errno;
-            error.append("Failed to set thread priority: ").append(strerror(errCode));
-        }
+    if (error.empty()) {
+        error.append(applyScheduling(mScheduling));
     }
     if (error.empty()) {
         error.append(mLogic->init());
@@ -110,11 +257,21 @@ void ThreadController::workerThread() {
     mWorkerCv.notify_one();
     if (!error.empty()) return;
 
+    std::chrono::steady_clock::time_point lastWakeup;
     for (WorkerState state = WorkerState::RUNNING; state != WorkerState::STOPPED;) {
         bool needToNotify = false;
-        if (Status status = state != WorkerState::PAUSED ? mLogic->cycle()
-                                                         : (sched_yield(), Status::CONTINUE);
-            status == Status::CONTINUE) {
+        Status status = Status::CONTINUE;
+        if (state != WorkerState::PAUSED) {
+            const auto cycleStart = std::chrono::steady_clock::now();
+            const auto cycleStartCpuTime = getThreadCpuTime();
+            status = mLogic->cycle();
+            recordCycle(cycleStart, cycleStartCpuTime, &lastWakeup);
+        } else {
+            sched_yield();
+            // Do not count the pause as a late wakeup.
+            lastWakeup = {};
+        }
+        if (status == Status::CONTINUE) {
             {
                 // See https://developer.android.com/training/articles/smp#nonracing
                 android::base::ScopedLockAssertion lock_assertion(mWorkerLock);
@@ -169,4 +326,32 @@ void ThreadController::workerThread() {
     }
 }
 
-}  // namespace android::hardware::audio::common::internal
+void ThreadController::recordCycle(std::chrono::steady_clock::time_point cycleStart,
+                                   std::chrono::nanoseconds cycleStartCpuTime,
+                                   std::chrono::steady_clock::time_point* lastWakeup) {
+    const auto cycleEnd = std::chrono::steady_clock::now();
+    // A thread does not use CPU time while it is blocked, so the time the logic spends
+    // waiting for work does not count against the budget.
+    const auto cpuTime = getThreadCpuTime() - cycleStartCpuTime;
+    const auto wakeup = mLogic->mCycleWakeupTime != std::chrono::steady_clock::time_point{}
+                                ? mLogic->mCycleWakeupTime
+                                : cycleStart;
+    mLogic->mCycleWakeupTime = {};
+    if (mScheduling.period.count() > 0 && *lastWakeup != std::chrono::steady_clock::time_point{}) {
+        mStats.wakeupLatency.record(std::max<std::chrono::nanoseconds>(
+                wakeup - (*lastWakeup + mScheduling.period), std::chrono::nanoseconds::zero()));
+    }
+    *lastWakeup = wakeup;
+    const auto duration = cycleEnd - wakeup;
+    mStats.cycleDuration.record(duration);
+    if (mScheduling.budget.count() > 0 && cpuTime > mScheduling.budget) {
+        increment(&mStats.budgetOverruns);
+    }
+    if (mScheduling.period.count() > 0 && duration > mScheduling.period) {
+        increment(&mStats.missedDeadlines);
+    }
+}
+
+}  // namespace internal
+
+}  // namespace android::hardware::audio::common
@@ -16,8 +16,11 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -29,6 +32,84 @@ namespace android::hardware::audio::common {
 
 class StreamLogic;
 
+// Scheduling of the worker thread.
+struct WorkerScheduling {
+    enum class Policy { NORMAL, FIFO, DEADLINE };
+
+    // The worker is expected to complete one cycle per buffer duration, and to only
+    // spend a fraction of it doing work, the rest is left for the client and the driver.
+    static constexpr int kBudgetFractionOfPeriod = 4;
+    static WorkerScheduling forBufferDuration(Policy policy, int priority,
+                                              std::chrono::nanoseconds bufferDuration) {
+        WorkerScheduling scheduling;
+        scheduling.policy = policy;
+        scheduling.priority = priority;
+        scheduling.period = bufferDuration;
+        scheduling.budget = bufferDuration / kBudgetFractionOfPeriod;
+        return scheduling;
+    }
+
+    Policy policy = Policy::NORMAL;
+    // The nice number for NORMAL, the real-time priority for FIFO, not used for DEADLINE.
+    int priority = ANDROID_PRIORITY_DEFAULT;
+    // The expected interval between cycles, zero if the worker is not periodic.
+    // Used as the period and the deadline for DEADLINE.
+    std::chrono::nanoseconds period{0};
+    // The expected maximum CPU time of a cycle, zero if unknown.
+    // Used as the runtime for DEADLINE.
+    std::chrono::nanoseconds budget{0};
+};
+
+// Counts durations in power-of-two buckets. Only one thread may record values,
+// however any thread may read the histogram at any time without locking. A reader
+// may observe a value counted in some of the fields, but not yet in the others.
+class CycleHistogram {
+  public:
+    // Bucket 0 counts durations below 1 us, bucket N counts durations in [2^(N-1), 2^N) us.
+    // The last bucket also counts all longer durations.
+    static constexpr size_t kBucketCount = 22;
+
+    void record(std::chrono::nanoseconds duration);
+
+    uint64_t getCount() const { return mCount.load(std::memory_order_relaxed); }
+    std::chrono::microseconds getMax() const {
+        return std::chrono::microseconds(mMaxUs.load(std::memory_order_relaxed));
+    }
+    std::array<uint64_t, kBucketCount> getBuckets() const;
+    std::string toString() const;
+
+  private:
+    // There is only one writer, so updates do not need atomic read-modify-write operations.
+    static void add(std::atomic<uint64_t>* counter, uint64_t value) {
+        counter->store(counter->load(std::memory_order_relaxed) + value,
+                       std::memory_order_relaxed);
+    }
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    std::array<std::atomic<uint64_t>, kBucketCount> mBuckets{};
+    std::atomic<uint64_t> mCount = 0;
+    std::atomic<uint64_t> mTotalUs = 0;
+    std::atomic<uint64_t> mMaxUs = 0;
+};
+
+// Timing of the worker cycles, updated by the worker thread after each cycle.
+//   - wakeup latency: how much later than one period after the previous cycle
+//     the cycle has started, only measured for periodic workers;
+//   - cycle duration: the time from the start of the cycle, or from the moment
+//     the logic has marked as its wakeup, until the end of the cycle;
+//   - budget overruns: the number of cycles which have used more CPU time than
+//     the budget, as measured by the CPU clock of the worker thread;
+//   - missed deadlines: the number of cycles for which the cycle duration was
+//     longer than the period.
+struct WorkerStats {
+    CycleHistogram wakeupLatency;
+    CycleHistogram cycleDuration;
+    std::atomic<uint64_t> budgetOverruns = 0;
+    std::atomic<uint64_t> missedDeadlines = 0;
+
+    std::string toString() const;
+};
+
 namespace internal {
 
 class ThreadController {
@@ -39,6 +120,7 @@ class ThreadController {
     ~ThreadController() { stop(); }
 
     bool start(const std::string& name, int priority);
+    bool start(const std::string& name, const WorkerScheduling& scheduling);
     // Note: 'pause' and 'resume' methods should only be used on the "driving" side.
     // In the case of audio HAL I/O, the driving side is the client, because the HAL
     // implementation always blocks on getting a command.
@@ -58,6 +140,7 @@ class ThreadController {
     // only happen in tests.
     void join();
     bool waitForAtLeastOneCycle();
+    const WorkerStats& getStats() const { return mStats; }
 
     // Only used by unit tests.
     void lockUnlockMutex(bool lock) NO_THREAD_SAFETY_ANALYSIS {
@@ -69,10 +152,15 @@ class ThreadController {
     void switchWorkerStateSync(WorkerState oldState, WorkerState newState,
                                WorkerState* finalState = nullptr);
     void workerThread();
+    void recordCycle(std::chrono::steady_clock::time_point cycleStart,
+                     std::chrono::nanoseconds cycleStartCpuTime,
+                     std::chrono::steady_clock::time_point* lastWakeup);
 
     StreamLogic* const mLogic;
     std::string mThreadName;
-    int mThreadPriority = ANDROID_PRIORITY_DEFAULT;
+    WorkerScheduling mScheduling;
+    // Updated by the worker thread only, and can be read at any time.
+    WorkerStats mStats;
     std::thread mWorker;
     std::mutex mWorkerLock;
     std::condition_variable mWorkerCv;
@@ -120,6 +208,15 @@ class StreamLogic {
      * of stopping the worker by its own initiative.
      */
     virtual Status cycle() = 0;
+
+    /* May be called from 'cycle' by logic which blocks at the beginning of the cycle
+     * waiting for work, once the work has arrived. The time spent waiting is then
+     * not counted in the cycle duration in WorkerStats.
+     */
+    void markCycleWakeup() { mCycleWakeupTime = std::chrono::steady_clock::now(); }
+
+  private:
+    std::chrono::steady_clock::time_point mCycleWakeupTime;
 };
 
 template <class LogicImpl>
@@ -139,6 +236,11 @@ class StreamWorker : public LogicImpl {
     bool start(const std::string& name = "", int priority = ANDROID_PRIORITY_DEFAULT) {
         return mThread.start(name, priority);
     }
+    // Use this variant for running the worker with a real-time scheduler. The process
+    // must be allowed to use the requested policy and priority, otherwise starting fails.
+    bool start(const std::string& name, const WorkerScheduling& scheduling) {
+        return mThread.start(name, scheduling);
+    }
     void pause() { mThread.pause(); }
     void resume() { mThread.resume(); }
     bool hasError() { return mThread.hasError(); }
@@ -146,6 +248,7 @@ class StreamWorker : public LogicImpl {
     void stop() { mThread.stop(); }
     void join() { mThread.join(); }
     bool waitForAtLeastOneCycle() { return mThread.waitForAtLeastOneCycle(); }
+    const WorkerStats& getStats() const { return mThread.getStats(); }
 
     // Only used by unit tests.
     void testLockUnlockMutex(bool lock) { mThread.lockUnlockMutex(lock); }
@@ -19,7 +19,10 @@
 #include <sys/resource.h>
 #include <unistd.h>
 
+#include <time.h>
+
 #include <atomic>
+#include <chrono>
 
 #include <StreamWorker.h>
 
@@ -27,8 +30,10 @@
 #define LOG_TAG "StreamWorker_Test"
 #include <log/log.h>
 
+using android::hardware::audio::common::CycleHistogram;
 using android::hardware::audio::common::StreamLogic;
 using android::hardware::audio::common::StreamWorker;
+using android::hardware::audio::common::WorkerScheduling;
 
 class TestWorkerLogic : public StreamLogic {
   public:
@@ -283,6 +288,31 @@ TEST_P(StreamWorkerTest, ThreadPriority) {
     EXPECT_EQ(priority, worker.getPriority());
 }
 
+TEST_P(StreamWorkerTest, CycleStats) {
+    const auto scheduling = WorkerScheduling::forBufferDuration(
+            WorkerScheduling::Policy::NORMAL, ANDROID_PRIORITY_DEFAULT, std::chrono::seconds(1));
+    ASSERT_TRUE(worker.start("", scheduling)) << worker.getError();
+    EXPECT_TRUE(worker.waitForAtLeastOneCycle());
+    EXPECT_TRUE(worker.waitForAtLeastOneCycle());
+    worker.stop();
+    const auto& stats = worker.getStats();
+    EXPECT_EQ(worker.getWorkerCycles(), stats.cycleDuration.getCount());
+    // Cycles of the test logic are back to back, thus never late, and always within the budget.
+    EXPECT_GT(stats.wakeupLatency.getCount(), 0u);
+    EXPECT_EQ(stats.wakeupLatency.getCount(), stats.wakeupLatency.getBuckets()[0]);
+    EXPECT_EQ(0u, stats.budgetOverruns);
+    EXPECT_EQ(0u, stats.missedDeadlines);
+    EXPECT_NE(std::string::npos, stats.toString().find("cycle duration: count: "));
+}
+
+TEST_P(StreamWorkerTest, InvalidDeadlineScheduling) {
+    WorkerScheduling scheduling;
+    scheduling.policy = WorkerScheduling::Policy::DEADLINE;
+    EXPECT_FALSE(worker.start("", scheduling));
+    EXPECT_TRUE(worker.hasError());
+    EXPECT_FALSE(worker.hasWorkerCycleCalled());
+}
+
 TEST_P(StreamWorkerTest, DeferredStartCheckNoError) {
     stream.setStopStatus();
     EXPECT_TRUE(worker.start(android::hardware::audio::common::internal::kTestSingleThread));
@@ -296,3 +326,89 @@ TEST_P(StreamWorkerTest, DeferredStartCheckWithError) {
 }
 
 INSTANTIATE_TEST_SUITE_P(StreamWorker, StreamWorkerTest, testing::Bool());
+
+// Runs a fixed number of cycles, each of them blocking for 'sleepTime', and then
+// using 'cpuTime' of CPU time.
+class TimedWorkerLogic : public StreamLogic {
+  public:
+    static constexpr size_t kCycles = 3;
+
+    TimedWorkerLogic(std::chrono::microseconds sleepTime, std::chrono::nanoseconds cpuTime)
+        : mSleepTime(sleepTime), mCpuTime(cpuTime) {}
+
+  protected:
+    std::string init() override { return ""; }
+    Status cycle() override {
+        usleep(mSleepTime.count());
+        const auto start = getThreadCpuTime();
+        while (getThreadCpuTime() - start < mCpuTime) {
+        }
+        return ++mCycles < kCycles ? Status::CONTINUE : Status::EXIT;
+    }
+
+  private:
+    static std::chrono::nanoseconds getThreadCpuTime() {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+    }
+
+    const std::chrono::microseconds mSleepTime;
+    const std::chrono::nanoseconds mCpuTime;
+    size_t mCycles = 0;
+};
+using TimedWorker = StreamWorker<TimedWorkerLogic>;
+
+TEST(StreamWorkerStatsTest, BlockingCycleIsWithinBudget) {
+    // The cycles are longer than the period, but they spend that time blocked.
+    TimedWorker worker(std::chrono::milliseconds(20), std::chrono::nanoseconds(0));
+    const auto scheduling = WorkerScheduling::forBufferDuration(
+            WorkerScheduling::Policy::NORMAL, ANDROID_PRIORITY_DEFAULT,
+            std::chrono::milliseconds(10));
+    ASSERT_TRUE(worker.start("", scheduling)) << worker.getError();
+    worker.join();
+    const auto& stats = worker.getStats();
+    EXPECT_EQ(TimedWorkerLogic::kCycles, stats.cycleDuration.getCount());
+    EXPECT_EQ(0u, stats.budgetOverruns);
+    EXPECT_EQ(TimedWorkerLogic::kCycles, stats.missedDeadlines);
+}
+
+TEST(StreamWorkerStatsTest, BusyCycleOverrunsBudget) {
+    TimedWorker worker(std::chrono::microseconds(0), std::chrono::milliseconds(5));
+    WorkerScheduling scheduling;
+    scheduling.period = std::chrono::seconds(1);
+    scheduling.budget = std::chrono::milliseconds(1);
+    ASSERT_TRUE(worker.start("", scheduling)) << worker.getError();
+    worker.join();
+    const auto& stats = worker.getStats();
+    EXPECT_EQ(TimedWorkerLogic::kCycles, stats.budgetOverruns);
+    EXPECT_EQ(0u, stats.missedDeadlines);
+}
+
+TEST(WorkerSchedulingTest, ForBufferDuration) {
+    const auto scheduling = WorkerScheduling::forBufferDuration(WorkerScheduling::Policy::FIFO, 3,
+                                                                std::chrono::milliseconds(20));
+    EXPECT_EQ(WorkerScheduling::Policy::FIFO, scheduling.policy);
+    EXPECT_EQ(3, scheduling.priority);
+    EXPECT_EQ(std::chrono::milliseconds(20), scheduling.period);
+    EXPECT_EQ(std::chrono::milliseconds(5), scheduling.budget);
+}
+
+TEST(CycleHistogramTest, Buckets) {
+    CycleHistogram histogram;
+    EXPECT_EQ("count: 0", histogram.toString());
+    histogram.record(std::chrono::nanoseconds(999));
+    histogram.record(std::chrono::microseconds(1));
+    histogram.record(std::chrono::microseconds(3));
+    histogram.record(std::chrono::microseconds(4));
+    histogram.record(std::chrono::hours(1));
+    histogram.record(std::chrono::microseconds(-1));
+    const auto buckets = histogram.getBuckets();
+    EXPECT_EQ(2u, buckets[0]);
+    EXPECT_EQ(1u, buckets[1]);
+    EXPECT_EQ(1u, buckets[2]);
+    EXPECT_EQ(1u, buckets[3]);
+    EXPECT_EQ(1u, buckets[CycleHistogram::kBucketCount - 1]);
+    EXPECT_EQ(6u, histogram.getCount());
+    EXPECT_EQ(std::chrono::hours(1), histogram.getMax());
+}
@@ -17,10 +17,13 @@
 #define LOG_TAG "AHAL_Config"
 #include <android-base/logging.h>
 
+#include <chrono>
+
 #include <system/audio_config.h>
 
 #include "core-impl/AudioPolicyConfigXmlConverter.h"
 #include "core-impl/Config.h"
+#include "core-impl/ConfigSnapshot.h"
 #include "core-impl/EngineConfigXmlConverter.h"
 
 using aidl::android::media::audio::common::AudioHalEngineConfig;
@@ -36,21 +39,46 @@ ndk::ScopedAStatus Config::getSurroundSoundConfig(SurroundSoundConfig* _aidl_ret
 
 ndk::ScopedAStatus Config::getEngineConfig(AudioHalEngineConfig* _aidl_return) {
     static const AudioHalEngineConfig returnEngCfg = [this]() {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t sourceHash = internal::ConfigSnapshot::hashSources(
+                {mEngineConfigFilePath, mAudioPolicyConfigFilePath});
         AudioHalEngineConfig engConfig;
-        if (mEngConfigConverter.getStatus() == ::android::OK) {
-            engConfig = mEngConfigConverter.getAidlEngineConfig();
+        const char* source = "snapshot";
+        if (auto snapshot = internal::ConfigSnapshot::load(
+                    internal::ConfigSnapshot::kDefaultSnapshotPath, sourceHash);
+            snapshot.has_value()) {
+            engConfig = std::move(snapshot.value());
+        } else if (auto xmlConfig = convertEngineConfigFromXml(); xmlConfig.has_value()) {
+            engConfig = std::move(xmlConfig.value());
+            source = "XML";
+            internal::ConfigSnapshot::store(internal::ConfigSnapshot::kDefaultSnapshotPath,
+                                            engConfig, sourceHash);
         } else {
-            LOG(INFO) << __func__ << mEngConfigConverter.getError();
-            if (mAudioPolicyConverter.getStatus() == ::android::OK) {
-                engConfig = mAudioPolicyConverter.getAidlEngineConfig();
-            } else {
-                LOG(WARNING) << __func__ << mAudioPolicyConverter.getError();
-            }
+            source = "defaults";
         }
+        LOG(INFO) << __func__ << ": loaded the engine config from " << source << " in "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count()
+                  << " us";
         return engConfig;
     }();
     *_aidl_return = returnEngCfg;
     LOG(DEBUG) << __func__ << ": returning " << _aidl_return->toString();
     return ndk::ScopedAStatus::ok();
 }
+
+std::optional<AudioHalEngineConfig> Config::convertEngineConfigFromXml() const {
+    internal::EngineConfigXmlConverter engConfigConverter{mEngineConfigFilePath};
+    if (engConfigConverter.getStatus() == ::android::OK) {
+        return engConfigConverter.getAidlEngineConfig();
+    }
+    LOG(INFO) << __func__ << engConfigConverter.getError();
+    internal::AudioPolicyConfigXmlConverter audioPolicyConverter{mAudioPolicyConfigFilePath};
+    if (audioPolicyConverter.getStatus() == ::android::OK) {
+        return audioPolicyConverter.getAidlEngineConfig();
+    }
+    LOG(WARNING) << __func__ << audioPolicyConverter.getError();
+    return std::nullopt;
+}
 }  // namespace aidl::android::hardware::audio::core
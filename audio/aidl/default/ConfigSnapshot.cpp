@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "AHAL_ConfigSnapshot"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include <aidl/android/hardware/audio/core/IConfig.h>
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/properties.h>
+#include <android-base/unique_fd.h>
+#include <android/binder_auto_utils.h>
+#include <android/binder_parcel.h>
+
+#include "core-impl/ConfigSnapshot.h"
+
+using aidl::android::hardware::audio::core::IConfig;
+using aidl::android::media::audio::common::AudioHalEngineConfig;
+using android::base::unique_fd;
+
+namespace aidl::android::hardware::audio::core::internal {
+
+namespace {
+
+constexpr uint32_t kSnapshotMagic = 0x53434841;  // "AHCS"
+// Must be incremented whenever the header layout changes. The payload is a marshalled parcel,
+// whose format is only guaranteed within a build, so it is covered by the source hash instead,
+// see ConfigSnapshot::hashSources.
+constexpr uint32_t kSnapshotVersion = 2;
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325;
+constexpr uint64_t kFnvPrime = 0x100000001b3;
+// Guards against include cycles.
+constexpr int kMaxIncludeDepth = 8;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t payloadHash;
+    uint64_t payloadSize;
+};
+
+uint64_t fnv1a(std::string_view data, uint64_t hash = kFnvOffsetBasis) {
+    for (char c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+uint64_t hashFile(const std::string& path, int depth, std::set<std::string>* visited,
+                  uint64_t hash) {
+    hash = fnv1a(path, hash);
+    std::string content;
+    if (depth > kMaxIncludeDepth || !visited->insert(path).second ||
+        !::android::base::ReadFileToString(path, &content)) {
+        return hash;
+    }
+    hash = fnv1a(content, hash);
+    // Included files are looked up relative to the including file, see
+    // https://www.w3.org/TR/xinclude/#include_element
+    const std::string dir = path.substr(0, path.find_last_of('/') + 1);
+    static constexpr std::string_view kIncludeTag = "<xi:include";
+    static constexpr std::string_view kHrefAttr = "href=\"";
+    for (size_t pos = content.find(kIncludeTag); pos != std::string::npos;
+         pos = content.find(kIncludeTag, pos + 1)) {
+        const size_t tagEnd = content.find('>', pos);
+        const size_t href = content.find(kHrefAttr, pos);
+        if (href == std::string::npos || href > tagEnd) continue;
+        const size_t begin = href + kHrefAttr.size();
+        const size_t end = content.find('"', begin);
+        if (end == std::string::npos) break;
+        std::string includePath = content.substr(begin, end - begin);
+        if (includePath.empty()) continue;
+        if (includePath[0] != '/') includePath = dir + includePath;
+        hash = hashFile(includePath, depth + 1, visited, hash);
+    }
+    return hash;
+}
+
+}  // namespace
+
+// static
+uint64_t ConfigSnapshot::hashSources(const std::vector<std::string>& configFilePaths) {
+    // The parcel format depends on libbinder_ndk from the system partition, and the
+    // conversion from XML on the vendor partition, either may be updated on its own.
+    uint64_t hash = fnv1a(::android::base::GetProperty("ro.build.fingerprint", ""));
+    hash = fnv1a(::android::base::GetProperty("ro.vendor.build.fingerprint", ""), hash);
+    hash = fnv1a(std::to_string(IConfig::version), hash);
+    hash = fnv1a(IConfig::hash, hash);
+    std::set<std::string> visited;
+    for (const auto& path : configFilePaths) {
+        hash = hashFile(path, 0, &visited, hash);
+    }
+    return hash;
+}
+
+// static
+std::optional<AudioHalEngineConfig> ConfigSnapshot::load(const std::string& snapshotPath,
+                                                         uint64_t sourceHash) {
+    unique_fd fd(TEMP_FAILURE_RETRY(open(snapshotPath.c_str(), O_RDONLY | O_CLOEXEC)));
+    if (fd == -1) {
+        LOG(DEBUG) << __func__ << ": no snapshot at " << snapshotPath;
+        return std::nullopt;
+    }
+    struct stat st;
+    if (fstat(fd.get(), &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        LOG(WARNING) << __func__ << ": " << snapshotPath << " is truncated";
+        return std::nullopt;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (data == MAP_FAILED) {
+        PLOG(WARNING) << __func__ << ": failed to map " << snapshotPath;
+        return std::nullopt;
+    }
+    std::optional<AudioHalEngineConfig> result;
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    std::string_view payload(static_cast<const char*>(data) + sizeof(header),
+                             size - sizeof(header));
+    if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion) {
+        LOG(WARNING) << __func__ << ": " << snapshotPath << " has an unsupported format";
+    } else if (header.sourceHash != sourceHash) {
+        LOG(INFO) << __func__ << ": " << snapshotPath << " is out of date";
+    } else if (header.payloadSize != payload.size() || header.payloadHash != fnv1a(payload)) {
+        LOG(WARNING) << __func__ << ": " << snapshotPath << " is corrupted";
+    } else {
+        ndk::ScopedAParcel parcel(AParcel_create());
+        AudioHalEngineConfig config;
+        if (AParcel_unmarshal(parcel.get(), reinterpret_cast<const uint8_t*>(payload.data()),
+                              payload.size()) == STATUS_OK &&
+            AParcel_setDataPosition(parcel.get(), 0) == STATUS_OK &&
+            config.readFromParcel(parcel.get()) == STATUS_OK) {
+            result = std::move(config);
+        } else {
+            LOG(WARNING) << __func__ << ": failed to read the config from " << snapshotPath;
+        }
+    }
+    munmap(data, size);
+    return result;
+}
+
+// static
+bool ConfigSnapshot::store(const std::string& snapshotPath, const AudioHalEngineConfig& config,
+                           uint64_t sourceHash) {
+    ndk::ScopedAParcel parcel(AParcel_create());
+    if (config.writeToParcel(parcel.get()) != STATUS_OK) {
+        LOG(ERROR) << __func__ << ": failed to write the config to a parcel";
+        return false;
+    }
+    const size_t payloadSize = AParcel_getDataSize(parcel.get());
+    std::string data(sizeof(SnapshotHeader) + payloadSize, '\0');
+    uint8_t* payload = reinterpret_cast<uint8_t*>(data.data() + sizeof(SnapshotHeader));
+    if (AParcel_marshal(parcel.get(), payload, 0, payloadSize) != STATUS_OK) {
+        LOG(ERROR) << __func__ << ": failed to marshal the config";
+        return false;
+    }
+    const SnapshotHeader header = {
+            .magic = kSnapshotMagic,
+            .version = kSnapshotVersion,
+            .sourceHash = sourceHash,
+            .payloadHash = fnv1a(std::string_view(data).substr(sizeof(SnapshotHeader))),
+            .payloadSize = payloadSize,
+    };
+    memcpy(data.data(), &header, sizeof(header));
+
+    // Write to a temporary file first so that a reader never sees a partial snapshot.
+    const std::string tmpPath = snapshotPath + ".tmp";
+    if (!::android::base::WriteStringToFile(data, tmpPath)) {
+        PLOG(WARNING) << __func__ << ": failed to write " << tmpPath;
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    if (rename(tmpPath.c_str(), snapshotPath.c_str()) != 0) {
+        PLOG(WARNING) << __func__ << ": failed to rename " << tmpPath << " to " << snapshotPath;
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace aidl::android::hardware::audio::core::internal
@@ -15,7 +15,9 @@
  */
 
 #define LOG_TAG "AHAL_Stream"
+#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/properties.h>
 #include <android/binder_ibinder_platform.h>
 #include <utils/SystemClock.h>
 
@@ -36,6 +38,7 @@ using aidl::android::media::audio::common::AudioOffloadInfo;
 using aidl::android::media::audio::common::AudioPlaybackRate;
 using aidl::android::media::audio::common::MicrophoneDynamicInfo;
 using aidl::android::media::audio::common::MicrophoneInfo;
+using android::hardware::audio::common::WorkerScheduling;
 
 namespace aidl::android::hardware::audio::core {
 
@@ -84,6 +87,32 @@ void StreamContext::reset() {
     mDataMQ.reset();
 }
 
+WorkerScheduling getStreamWorkerScheduling(const StreamContext& context) {
+    // Same as the real-time priority of the fast mixer in the audio server.
+    static constexpr int kRealTimePriority = 3;
+    std::chrono::nanoseconds bufferDuration{0};
+    if (auto dataMQ = context.getDataMQ();
+        dataMQ != nullptr && context.getFrameSize() != 0 && context.getSampleRate() > 0) {
+        const int64_t bufferSizeFrames =
+                dataMQ->getQuantumCount() * dataMQ->getQuantumSize() / context.getFrameSize();
+        bufferDuration = std::chrono::nanoseconds(std::chrono::seconds(bufferSizeFrames)) /
+                         context.getSampleRate();
+    }
+    if (bufferDuration.count() > 0) {
+        const std::string policy =
+                ::android::base::GetProperty(kStreamWorkerSchedulingProperty, "");
+        if (policy == "fifo") {
+            return WorkerScheduling::forBufferDuration(WorkerScheduling::Policy::FIFO,
+                                                       kRealTimePriority, bufferDuration);
+        } else if (policy == "deadline") {
+            return WorkerScheduling::forBufferDuration(WorkerScheduling::Policy::DEADLINE, 0,
+                                                       bufferDuration);
+        }
+    }
+    return WorkerScheduling::forBufferDuration(WorkerScheduling::Policy::NORMAL,
+                                               ANDROID_PRIORITY_AUDIO, bufferDuration);
+}
+
 std::string StreamWorkerCommonLogic::init() {
     if (mCommandMQ == nullptr) return "Command MQ is null";
     if (mReplyMQ == nullptr) return "Reply MQ is null";
@@ -138,6 +167,7 @@ StreamInWorkerLogic::Status StreamInWorkerLogic::cycle() {
         mState = StreamDescriptor::State::ERROR;
         return Status::ABORT;
     }
+    markCycleWakeup();
     using Tag = StreamDescriptor::Command::Tag;
     using LogSeverity = ::android::base::LogSeverity;
     const LogSeverity severity =
@@ -349,6 +379,7 @@ StreamOutWorkerLogic::Status StreamOutWorkerLogic::cycle() {
         mState = StreamDescriptor::State::ERROR;
         return Status::ABORT;
     }
+    markCycleWakeup();
     using Tag = StreamDescriptor::Command::Tag;
     using LogSeverity = ::android::base::LogSeverity;
     const LogSeverity severity =
@@ -598,6 +629,16 @@ ndk::ScopedAStatus StreamCommonImpl<Metadata>::getStreamCommon(
     return ndk::ScopedAStatus::ok();
 }
 
+template <class Metadata>
+binder_status_t StreamCommonImpl<Metadata>::dump(int fd, const char** /*args*/,
+                                                 uint32_t /*numArgs*/) {
+    const std::string dump = "Worker cycles:\n" + mWorker->dumpStats();
+    if (!::android::base::WriteStringToFd(dump, fd)) {
+        return STATUS_UNKNOWN_ERROR;
+    }
+    return STATUS_OK;
+}
+
 template <class Metadata>
 ndk::ScopedAStatus StreamCommonImpl<Metadata>::updateHwAvSyncId(int32_t in_hwAvSyncId) {
     LOG(DEBUG) << __func__ << ": id " << in_hwAvSyncId;
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+
 #include <aidl/android/hardware/audio/core/BnConfig.h>
 #include <system/audio_config.h>
 
@@ -29,9 +32,12 @@ class Config : public BnConfig {
     ndk::ScopedAStatus getSurroundSoundConfig(SurroundSoundConfig* _aidl_return) override;
     ndk::ScopedAStatus getEngineConfig(
             aidl::android::media::audio::common::AudioHalEngineConfig* _aidl_return) override;
-    internal::AudioPolicyConfigXmlConverter mAudioPolicyConverter{
-            ::android::audio_get_audio_policy_config_file()};
-    internal::EngineConfigXmlConverter mEngConfigConverter{
+    // Parses the XML files, returns std::nullopt if neither of them is valid.
+    std::optional<aidl::android::media::audio::common::AudioHalEngineConfig>
+    convertEngineConfigFromXml() const;
+
+    const std::string mAudioPolicyConfigFilePath{::android::audio_get_audio_policy_config_file()};
+    const std::string mEngineConfigFilePath{
             ::android::audio_find_readable_configuration_file(kEngineConfigFileName.c_str())};
 };
 
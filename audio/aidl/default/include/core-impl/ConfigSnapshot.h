@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <aidl/android/media/audio/common/AudioHalEngineConfig.h>
+
+namespace aidl::android::hardware::audio::core::internal {
+
+/**
+ * Keeps the engine config converted from the audio policy XML files on disk,
+ * so that the service does not have to parse the XML files again on every start.
+ *
+ * A snapshot is keyed by a hash of the XML files it was converted from,
+ * including the files they XInclude, and of the build it was written by. It is
+ * ignored if the files have changed since, or if it was written by another
+ * build, since the config is stored as a marshalled parcel, whose format is
+ * not stable across builds.
+ */
+class ConfigSnapshot {
+  public:
+    static constexpr char kDefaultSnapshotPath[] = "/data/vendor/audiohal/engine_config.bin";
+
+    // Hashes the contents of the given files and of the files they XInclude,
+    // together with the build fingerprints and the IConfig interface version.
+    // Files which can not be read only contribute their path.
+    static uint64_t hashSources(const std::vector<std::string>& configFilePaths);
+
+    // Maps the snapshot file, returns std::nullopt if it is missing or stale.
+    static std::optional<::aidl::android::media::audio::common::AudioHalEngineConfig> load(
+            const std::string& snapshotPath, uint64_t sourceHash);
+
+    // Writes the snapshot file, replacing any existing one atomically.
+    static bool store(const std::string& snapshotPath,
+                      const ::aidl::android::media::audio::common::AudioHalEngineConfig& config,
+                      uint64_t sourceHash);
+};
+
+}  // namespace aidl::android::hardware::audio::core::internal
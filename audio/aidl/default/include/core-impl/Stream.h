@@ -236,8 +236,17 @@ struct StreamWorkerInterface {
     virtual void setClosed() = 0;
     virtual bool start() = 0;
     virtual void stop() = 0;
+    virtual std::string dumpStats() const = 0;
 };
 
+// Returns the scheduling for the worker of a stream, with the period and the budget derived
+// from the duration of its data buffer. The policy is taken from the value of the
+// kStreamWorkerSchedulingProperty: "fifo", "deadline", or otherwise the default scheduler
+// with the audio priority.
+static constexpr char kStreamWorkerSchedulingProperty[] = "vendor.audio.hal.worker_scheduling";
+::android::hardware::audio::common::WorkerScheduling getStreamWorkerScheduling(
+        const StreamContext& context);
+
 template <class WorkerLogic>
 class StreamWorkerImpl : public StreamWorkerInterface,
                          public ::android::hardware::audio::common::StreamWorker<WorkerLogic> {
@@ -245,14 +254,16 @@ class StreamWorkerImpl : public StreamWorkerInterface,
 
   public:
     StreamWorkerImpl(const StreamContext& context, DriverInterface* driver)
-        : WorkerImpl(context, driver) {}
+        : WorkerImpl(context, driver), mScheduling(getStreamWorkerScheduling(context)) {}
     bool isClosed() const override { return WorkerImpl::isClosed(); }
     void setIsConnected(bool isConnected) override { WorkerImpl::setIsConnected(isConnected); }
     void setClosed() override { WorkerImpl::setClosed(); }
-    bool start() override {
-        return WorkerImpl::start(WorkerImpl::kThreadName, ANDROID_PRIORITY_AUDIO);
-    }
+    bool start() override { return WorkerImpl::start(WorkerImpl::kThreadName, mScheduling); }
     void stop() override { return WorkerImpl::stop(); }
+    std::string dumpStats() const override { return WorkerImpl::getStats().toString(); }
+
+  private:
+    const ::android::hardware::audio::common::WorkerScheduling mScheduling;
 };
 
 class StreamInWorkerLogic : public StreamWorkerCommonLogic {
@@ -379,6 +390,7 @@ class StreamCommonImpl : public StreamCommonInterface {
             override;
 
     ndk::ScopedAStatus getStreamCommon(std::shared_ptr<IStreamCommon>* _aidl_return);
+    binder_status_t dump(int fd, const char** args, uint32_t numArgs);
     ndk::ScopedAStatus init() {
         return mWorker->start() ? ndk::ScopedAStatus::ok()
                                 : ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_STATE);
@@ -419,6 +431,10 @@ class StreamIn : public StreamCommonImpl<::aidl::android::hardware::audio::commo
         return StreamCommonImpl<::aidl::android::hardware::audio::common::SinkMetadata>::
                 getStreamCommon(_aidl_return);
     }
+    binder_status_t dump(int fd, const char** args, uint32_t numArgs) override {
+        return StreamCommonImpl<::aidl::android::hardware::audio::common::SinkMetadata>::dump(
+                fd, args, numArgs);
+    }
     ndk::ScopedAStatus getActiveMicrophones(
             std::vector<::aidl::android::media::audio::common::MicrophoneDynamicInfo>* _aidl_return)
             override;
@@ -464,6 +480,10 @@ class StreamOut : public StreamCommonImpl<::aidl::android::hardware::audio::comm
         return StreamCommonImpl<::aidl::android::hardware::audio::common::SourceMetadata>::
                 getStreamCommon(_aidl_return);
     }
+    binder_status_t dump(int fd, const char** args, uint32_t numArgs) override {
+        return StreamCommonImpl<::aidl::android::hardware::audio::common::SourceMetadata>::dump(
+                fd, args, numArgs);
+    }
     ndk::ScopedAStatus updateMetadata(
             const ::aidl::android::hardware::audio::common::SourceMetadata& in_sourceMetadata)
             override {
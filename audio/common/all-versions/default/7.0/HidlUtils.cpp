@@ -17,6 +17,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #define LOG_TAG "HidlUtils"
 #include <log/log.h>
@@ -24,6 +30,7 @@
 #include PATH(APM_XSD_ENUMS_H_FILENAME)
 #include <common/all-versions/HidlSupport.h>
 #include <common/all-versions/VersionUtils.h>
+#include <xsdc/XsdcSupport.h>
 
 #include "HidlUtils.h"
 
@@ -43,10 +50,151 @@ using namespace ::android::audio::policy::configuration::CPP_VERSION;
         result = status;                                \
     }
 
+namespace {
+
+// A read-only hash table with open addressing, which is built once and then looked up without
+// allocating or comparing against every entry.
+template <typename Key, typename Value, typename Hash>
+class FlatLookupTable {
+  public:
+    explicit FlatLookupTable(const std::vector<std::pair<Key, Value>>& entries) {
+        size_t capacity = 8;
+        // Keep the table at most half full, so that lookups rarely probe more than one slot.
+        while (capacity < entries.size() * 2) capacity *= 2;
+        mMask = capacity - 1;
+        mSlots.resize(capacity);
+        for (const auto& [key, value] : entries) {
+            size_t i = Hash{}(key) & mMask;
+            while (mSlots[i].has_value() && mSlots[i]->first != key) i = (i + 1) & mMask;
+            if (!mSlots[i].has_value()) mSlots[i].emplace(key, value);
+        }
+    }
+
+    const Value* find(const Key& key) const {
+        for (size_t i = Hash{}(key) & mMask; mSlots[i].has_value(); i = (i + 1) & mMask) {
+            if (mSlots[i]->first == key) return &mSlots[i]->second;
+        }
+        return nullptr;
+    }
+
+  private:
+    std::vector<std::optional<std::pair<Key, Value>>> mSlots;
+    size_t mMask;
+};
+
+struct LegacyValueHash {
+    // Fibonacci hashing, so that flag values, which only differ in their high bits, still
+    // spread over the table.
+    size_t operator()(uint32_t value) const {
+        return static_cast<size_t>((value * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+};
+
+// Maps the strings of an XSD enum to their legacy values. Strings which are in the XSD, but
+// have no legacy value map to std::nullopt.
+template <typename T>
+using StringToLegacyTable =
+        FlatLookupTable<std::string_view, std::optional<T>, std::hash<std::string_view>>;
+// Maps legacy values to the XSD strings they are converted to.
+using LegacyToStringTable = FlatLookupTable<uint32_t, const std::string*, LegacyValueHash>;
+
+// Conversions between the XSD enum strings and the legacy values of channel masks, formats,
+// devices and gain modes. They are the same as looking up the legacy 'to_string' and
+// 'from_string' functions and then checking that the string is in the XSD, but do not repeat
+// the string comparisons these do on every call.
+class ConversionTables {
+  public:
+    static const ConversionTables& getInstance() {
+        static const ConversionTables* instance = new ConversionTables();
+        return *instance;
+    }
+
+    StringToLegacyTable<audio_channel_mask_t> channelMasks{{}};
+    LegacyToStringTable inputChannelMaskStrings{{}};
+    LegacyToStringTable outputChannelMaskStrings{{}};
+    LegacyToStringTable indexChannelMaskStrings{{}};
+    StringToLegacyTable<audio_format_t> formats{{}};
+    LegacyToStringTable formatStrings{{}};
+    StringToLegacyTable<audio_devices_t> devices{{}};
+    LegacyToStringTable deviceStrings{{}};
+    StringToLegacyTable<audio_gain_mode_t> gainModes{{}};
+    LegacyToStringTable gainModeStrings{{}};
+
+  private:
+    ConversionTables() {
+        std::vector<std::pair<std::string_view, std::optional<audio_channel_mask_t>>>
+                channelMaskEntries;
+        std::vector<std::pair<uint32_t, const std::string*>> inputEntries, outputEntries,
+                indexEntries;
+        for (const auto enumVal : xsdc_enum_range<xsd::AudioChannelMask>{}) {
+            const std::string& str = intern(toString(enumVal));
+            audio_channel_mask_t value;
+            if (!audio_channel_mask_from_string(str.c_str(), &value)) {
+                channelMaskEntries.emplace_back(str, std::nullopt);
+                continue;
+            }
+            channelMaskEntries.emplace_back(str, value);
+            if (str == audio_channel_in_mask_to_string(value)) {
+                inputEntries.emplace_back(value, &str);
+            }
+            if (str == audio_channel_out_mask_to_string(value)) {
+                outputEntries.emplace_back(value, &str);
+            }
+            if (str == audio_channel_index_mask_to_string(value)) {
+                indexEntries.emplace_back(value, &str);
+            }
+        }
+        channelMasks = StringToLegacyTable<audio_channel_mask_t>(channelMaskEntries);
+        inputChannelMaskStrings = LegacyToStringTable(inputEntries);
+        outputChannelMaskStrings = LegacyToStringTable(outputEntries);
+        indexChannelMaskStrings = LegacyToStringTable(indexEntries);
+
+        build<xsd::AudioFormat>(audio_format_from_string, audio_format_to_string, &formats,
+                                &formatStrings);
+        build<xsd::AudioDevice>(audio_device_from_string, audio_device_to_string, &devices,
+                                &deviceStrings);
+        build<xsd::AudioGainMode>(audio_gain_mode_from_string, audio_gain_mode_to_string,
+                                  &gainModes, &gainModeStrings);
+    }
+
+    template <typename XsdEnum, typename T>
+    void build(bool (*fromString)(const char*, T*), const char* (*toString)(T),
+               StringToLegacyTable<T>* table, LegacyToStringTable* stringTable) {
+        std::vector<std::pair<std::string_view, std::optional<T>>> entries;
+        std::vector<std::pair<uint32_t, const std::string*>> stringEntries;
+        for (const auto enumVal : xsdc_enum_range<XsdEnum>{}) {
+            const std::string& str = intern(xsd::toString(enumVal));
+            T value;
+            if (!fromString(str.c_str(), &value)) {
+                entries.emplace_back(str, std::nullopt);
+                continue;
+            }
+            entries.emplace_back(str, value);
+            if (str == toString(value)) {
+                stringEntries.emplace_back(value, &str);
+            }
+        }
+        *table = StringToLegacyTable<T>(entries);
+        *stringTable = LegacyToStringTable(stringEntries);
+    }
+
+    // Elements of a deque are never moved, so views and pointers to them stay valid.
+    const std::string& intern(std::string str) { return mStrings.emplace_back(std::move(str)); }
+
+    std::deque<std::string> mStrings;
+};
+
+std::string_view toStringView(const hidl_string& str) {
+    return std::string_view(str.c_str(), str.size());
+}
+
+}  // namespace
+
 status_t HidlUtils::audioIndexChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                                                  AudioChannelMask* channelMask) {
-    *channelMask = audio_channel_index_mask_to_string(halChannelMask);
-    if (!channelMask->empty() && !xsd::isUnknownAudioChannelMask(*channelMask)) {
+    if (const std::string* const* str =
+                ConversionTables::getInstance().indexChannelMaskStrings.find(halChannelMask)) {
+        *channelMask = **str;
         return NO_ERROR;
     }
     ALOGE("Unknown index channel mask value 0x%X", halChannelMask);
@@ -56,8 +204,9 @@ status_t HidlUtils::audioIndexChannelMaskFromHal(audio_channel_mask_t halChannel
 
 status_t HidlUtils::audioInputChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                                                  AudioChannelMask* channelMask) {
-    *channelMask = audio_channel_in_mask_to_string(halChannelMask);
-    if (!channelMask->empty() && !xsd::isUnknownAudioChannelMask(*channelMask)) {
+    if (const std::string* const* str =
+                ConversionTables::getInstance().inputChannelMaskStrings.find(halChannelMask)) {
+        *channelMask = **str;
         return NO_ERROR;
     }
     ALOGE("Unknown input channel mask value 0x%X", halChannelMask);
@@ -67,8 +216,9 @@ status_t HidlUtils::audioInputChannelMaskFromHal(audio_channel_mask_t halChannel
 
 status_t HidlUtils::audioOutputChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                                                   AudioChannelMask* channelMask) {
-    *channelMask = audio_channel_out_mask_to_string(halChannelMask);
-    if (!channelMask->empty() && !xsd::isUnknownAudioChannelMask(*channelMask)) {
+    if (const std::string* const* str =
+                ConversionTables::getInstance().outputChannelMaskStrings.find(halChannelMask)) {
+        *channelMask = **str;
         return NO_ERROR;
     }
     ALOGE("Unknown output channel mask value 0x%X", halChannelMask);
@@ -103,7 +253,7 @@ status_t HidlUtils::audioChannelMasksFromHal(const std::vector<std::string>& hal
     tempChannelMasks.resize(halChannelMasks.size());
     size_t tempPos = 0;
     for (const auto& halChannelMask : halChannelMasks) {
-        if (!halChannelMask.empty() && !xsd::isUnknownAudioChannelMask(halChannelMask)) {
+        if (ConversionTables::getInstance().channelMasks.find(halChannelMask) != nullptr) {
             tempChannelMasks[tempPos++] = halChannelMask;
         }
     }
@@ -118,8 +268,10 @@ status_t HidlUtils::audioChannelMasksFromHal(const std::vector<std::string>& hal
 
 status_t HidlUtils::audioChannelMaskToHal(const AudioChannelMask& channelMask,
                                           audio_channel_mask_t* halChannelMask) {
-    if (!xsd::isUnknownAudioChannelMask(channelMask) &&
-        audio_channel_mask_from_string(channelMask.c_str(), halChannelMask)) {
+    if (const auto* value =
+                ConversionTables::getInstance().channelMasks.find(toStringView(channelMask));
+        value != nullptr && value->has_value()) {
+        *halChannelMask = **value;
         return NO_ERROR;
     }
     ALOGE("Unknown channel mask \"%s\"", channelMask.c_str());
@@ -224,8 +376,9 @@ status_t HidlUtils::audioContentTypeToHal(const AudioContentType& contentType,
 }
 
 status_t HidlUtils::audioDeviceTypeFromHal(audio_devices_t halDevice, AudioDevice* device) {
-    *device = audio_device_to_string(halDevice);
-    if (!device->empty() && !xsd::isUnknownAudioDevice(*device)) {
+    if (const std::string* const* str =
+                ConversionTables::getInstance().deviceStrings.find(halDevice)) {
+        *device = **str;
         return NO_ERROR;
     }
     ALOGE("Unknown audio device value 0x%X", halDevice);
@@ -234,7 +387,9 @@ status_t HidlUtils::audioDeviceTypeFromHal(audio_devices_t halDevice, AudioDevic
 }
 
 status_t HidlUtils::audioDeviceTypeToHal(const AudioDevice& device, audio_devices_t* halDevice) {
-    if (!xsd::isUnknownAudioDevice(device) && audio_device_from_string(device.c_str(), halDevice)) {
+    if (const auto* value = ConversionTables::getInstance().devices.find(toStringView(device));
+        value != nullptr && value->has_value()) {
+        *halDevice = **value;
         return NO_ERROR;
     }
     ALOGE("Unknown audio device \"%s\"", device.c_str());
@@ -243,10 +398,12 @@ status_t HidlUtils::audioDeviceTypeToHal(const AudioDevice& device, audio_device
 }
 
 status_t HidlUtils::audioFormatFromHal(audio_format_t halFormat, AudioFormat* format) {
-    *format = audio_format_to_string(halFormat);
-    if (!format->empty() && !xsd::isUnknownAudioFormat(*format)) {
+    if (const std::string* const* str =
+                ConversionTables::getInstance().formatStrings.find(halFormat)) {
+        *format = **str;
         return NO_ERROR;
     }
+    *format = audio_format_to_string(halFormat);
     ALOGE("Unknown audio format value 0x%X", halFormat);
     return BAD_VALUE;
 }
@@ -257,7 +414,7 @@ status_t HidlUtils::audioFormatsFromHal(const std::vector<std::string>& halForma
     tempFormats.resize(halFormats.size());
     size_t tempPos = 0;
     for (const auto& halFormat : halFormats) {
-        if (!halFormat.empty() && !xsd::isUnknownAudioFormat(halFormat)) {
+        if (ConversionTables::getInstance().formats.find(halFormat) != nullptr) {
             tempFormats[tempPos++] = halFormat;
         }
     }
@@ -270,7 +427,9 @@ status_t HidlUtils::audioFormatsFromHal(const std::vector<std::string>& halForma
 }
 
 status_t HidlUtils::audioFormatToHal(const AudioFormat& format, audio_format_t* halFormat) {
-    if (!xsd::isUnknownAudioFormat(format) && audio_format_from_string(format.c_str(), halFormat)) {
+    if (const auto* value = ConversionTables::getInstance().formats.find(toStringView(format));
+        value != nullptr && value->has_value()) {
+        *halFormat = **value;
         return NO_ERROR;
     }
     ALOGE("Unknown audio format \"%s\"", format.c_str());
@@ -285,9 +444,9 @@ status_t HidlUtils::audioGainModeMaskFromHal(audio_gain_mode_t halGainModeMask,
     for (uint32_t bit = 0; halGainModeMask != 0 && bit < sizeof(audio_gain_mode_t) * 8; ++bit) {
         audio_gain_mode_t flag = static_cast<audio_gain_mode_t>(1u << bit);
         if ((flag & halGainModeMask) == flag) {
-            AudioGainMode flagStr = audio_gain_mode_to_string(flag);
-            if (!flagStr.empty() && !xsd::isUnknownAudioGainMode(flagStr)) {
-                result.push_back(flagStr);
+            if (const std::string* const* str =
+                        ConversionTables::getInstance().gainModeStrings.find(flag)) {
+                result.push_back(**str);
             } else {
                 ALOGE("Unknown audio gain mode value 0x%X", flag);
                 status = BAD_VALUE;
@@ -304,10 +463,10 @@ status_t HidlUtils::audioGainModeMaskToHal(const hidl_vec<AudioGainMode>& gainMo
     status_t status = NO_ERROR;
     *halGainModeMask = {};
     for (const auto& gainMode : gainModeMask) {
-        audio_gain_mode_t halGainMode;
-        if (!xsd::isUnknownAudioGainMode(gainMode) &&
-            audio_gain_mode_from_string(gainMode.c_str(), &halGainMode)) {
-            *halGainModeMask = static_cast<audio_gain_mode_t>(*halGainModeMask | halGainMode);
+        if (const auto* value =
+                    ConversionTables::getInstance().gainModes.find(toStringView(gainMode));
+            value != nullptr && value->has_value()) {
+            *halGainModeMask = static_cast<audio_gain_mode_t>(*halGainModeMask | **value);
         } else {
             ALOGE("Unknown audio gain mode \"%s\"", gainMode.c_str());
             status = BAD_VALUE;
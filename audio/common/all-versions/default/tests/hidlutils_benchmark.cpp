@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iterator>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#define LOG_TAG "HidlUtils_Benchmark"
+#include <log/log.h>
+
+#include <HidlUtils.h>
+#include PATH(APM_XSD_ENUMS_H_FILENAME)
+#include <system/audio.h>
+#include <xsdc/XsdcSupport.h>
+
+using namespace android;
+using ::android::hardware::hidl_vec;
+using namespace ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION;
+using ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION::implementation::HidlUtils;
+namespace xsd {
+using namespace ::android::audio::policy::configuration::CPP_VERSION;
+}
+
+namespace {
+
+AudioProfile makeProfile(xsd::AudioFormat format, bool isInput) {
+    AudioProfile profile;
+    profile.format = toString(format);
+    profile.sampleRates = {8000, 16000, 44100, 48000, 96000};
+    if (isInput) {
+        profile.channelMasks = {toString(xsd::AudioChannelMask::AUDIO_CHANNEL_IN_MONO),
+                                toString(xsd::AudioChannelMask::AUDIO_CHANNEL_IN_STEREO),
+                                toString(xsd::AudioChannelMask::AUDIO_CHANNEL_INDEX_MASK_4)};
+    } else {
+        profile.channelMasks = {toString(xsd::AudioChannelMask::AUDIO_CHANNEL_OUT_MONO),
+                                toString(xsd::AudioChannelMask::AUDIO_CHANNEL_OUT_STEREO),
+                                toString(xsd::AudioChannelMask::AUDIO_CHANNEL_OUT_5POINT1),
+                                toString(xsd::AudioChannelMask::AUDIO_CHANNEL_OUT_7POINT1)};
+    }
+    return profile;
+}
+
+AudioGain makeGain(bool isInput) {
+    AudioGain gain = {};
+    gain.mode = {toString(xsd::AudioGainMode::AUDIO_GAIN_MODE_JOINT),
+                 toString(xsd::AudioGainMode::AUDIO_GAIN_MODE_CHANNELS)};
+    gain.channelMask = toString(isInput ? xsd::AudioChannelMask::AUDIO_CHANNEL_IN_STEREO
+                                        : xsd::AudioChannelMask::AUDIO_CHANNEL_OUT_STEREO);
+    gain.minValue = -8400;
+    gain.maxValue = 4000;
+    gain.stepValue = 100;
+    return gain;
+}
+
+AudioPort makeMixPort(int32_t id, bool isInput) {
+    AudioPort port = {};
+    port.id = id;
+    port.name = isInput ? "primary input" : "primary output";
+    const xsd::AudioFormat formats[] = {xsd::AudioFormat::AUDIO_FORMAT_PCM_16_BIT,
+                                        xsd::AudioFormat::AUDIO_FORMAT_PCM_24_BIT_PACKED,
+                                        xsd::AudioFormat::AUDIO_FORMAT_PCM_32_BIT,
+                                        xsd::AudioFormat::AUDIO_FORMAT_PCM_FLOAT};
+    port.transports.resize(std::size(formats));
+    for (size_t i = 0; i < std::size(formats); ++i) {
+        port.transports[i].audioCapability.profile(makeProfile(formats[i], isInput));
+        port.transports[i].encapsulationType =
+                toString(xsd::AudioEncapsulationType::AUDIO_ENCAPSULATION_TYPE_NONE);
+    }
+    port.gains = {makeGain(isInput)};
+    port.ext.mix({});
+    port.ext.mix().ioHandle = id;
+    if (isInput) {
+        port.ext.mix().useCase.source(toString(xsd::AudioSource::AUDIO_SOURCE_MIC));
+    } else {
+        port.ext.mix().useCase.stream(toString(xsd::AudioStreamType::AUDIO_STREAM_MUSIC));
+    }
+    return port;
+}
+
+AudioPort makeDevicePort(int32_t id, xsd::AudioDevice device) {
+    const bool isInput = !xsd::isOutputDevice(device);
+    AudioPort port = {};
+    port.id = id;
+    port.name = toString(device);
+    port.transports.resize(1);
+    port.transports[0].audioCapability.profile(
+            makeProfile(xsd::AudioFormat::AUDIO_FORMAT_PCM_16_BIT, isInput));
+    port.transports[0].encapsulationType =
+            toString(xsd::AudioEncapsulationType::AUDIO_ENCAPSULATION_TYPE_NONE);
+    port.gains = {makeGain(isInput)};
+    port.ext.device({});
+    port.ext.device().deviceType = toString(device);
+    return port;
+}
+
+// A port list like the one of a device which supports every device type of the audio policy
+// configuration schema, with a few mix ports for the streams.
+std::vector<AudioPort> makePortList() {
+    std::vector<AudioPort> ports;
+    int32_t id = 1;
+    for (int i = 0; i < 4; ++i) {
+        ports.push_back(makeMixPort(id++, false /*isInput*/));
+        ports.push_back(makeMixPort(id++, true /*isInput*/));
+    }
+    for (const auto device : xsdc_enum_range<xsd::AudioDevice>{}) {
+        if (device == xsd::AudioDevice::AUDIO_DEVICE_NONE) continue;
+        AudioPort port = makeDevicePort(id, device);
+        // Skip the device types which need an address or have no legacy value.
+        struct audio_port_v7 halPort;
+        if (HidlUtils::audioPortToHal(port, &halPort) == NO_ERROR) {
+            ports.push_back(std::move(port));
+            ++id;
+        }
+    }
+    return ports;
+}
+
+std::vector<struct audio_port_v7> portListToHal(const std::vector<AudioPort>& ports) {
+    std::vector<struct audio_port_v7> halPorts(ports.size());
+    for (size_t i = 0; i < ports.size(); ++i) {
+        LOG_ALWAYS_FATAL_IF(HidlUtils::audioPortToHal(ports[i], &halPorts[i]) != NO_ERROR);
+    }
+    return halPorts;
+}
+
+}  // namespace
+
+static void BM_AudioPortToHal(benchmark::State& state) {
+    const std::vector<AudioPort> ports = makePortList();
+    std::vector<struct audio_port_v7> halPorts(ports.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < ports.size(); ++i) {
+            benchmark::DoNotOptimize(HidlUtils::audioPortToHal(ports[i], &halPorts[i]));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * ports.size());
+}
+BENCHMARK(BM_AudioPortToHal);
+
+static void BM_AudioPortFromHal(benchmark::State& state) {
+    const std::vector<struct audio_port_v7> halPorts = portListToHal(makePortList());
+    std::vector<AudioPort> ports(halPorts.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < halPorts.size(); ++i) {
+            benchmark::DoNotOptimize(HidlUtils::audioPortFromHal(halPorts[i], &ports[i]));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * halPorts.size());
+}
+BENCHMARK(BM_AudioPortFromHal);
+
+BENCHMARK_MAIN();
@@ -30,6 +30,15 @@ namespace android::hardware::automotive::can::V1_0::implementation {
 /** Whether to log sent/received packets. */
 static constexpr bool kSuperVerbose = false;
 
+/** Bits of a SocketCAN ID that listener filters can match against. */
+static constexpr canid_t kListenerIdMask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_EFF_MASK;
+
+/**
+ * Upper bound on the number of distinct message IDs in the per-ID listener index. The index is
+ * dropped once it's reached, so that a bus with a lot of extended IDs can't grow it indefinitely.
+ */
+static constexpr size_t kMaxIndexedIds = 4096;
+
 Return<Result> CanBus::send(const CanMessage& message) {
     std::lock_guard<std::mutex> lck(mIsUpGuard);
     if (!mIsUp) return Result::INTERFACE_DOWN;
@@ -69,7 +78,9 @@ Return<void> CanBus::listen(const hidl_vec<CanMessageFilter>& filter,
 
     sp<CloseHandle> closeHandle = new CloseHandle([this, listenerCb]() {
         std::lock_guard<std::mutex> lck(mMsgListenersGuard);
-        std::erase_if(mMsgListeners, [&](const auto& e) { return e.callback == listenerCb; });
+        const auto erased = std::erase_if(mMsgListeners,
+                                          [&](const auto& e) { return e.callback == listenerCb; });
+        if (erased > 0) onMsgListenersChanged();
     });
     mMsgListeners.emplace_back(CanMessageListener{listenerCb, filter, closeHandle});
     auto& listener = mMsgListeners.back();
@@ -77,6 +88,7 @@ Return<void> CanBus::listen(const hidl_vec<CanMessageFilter>& filter,
     // fix message IDs to have all zeros on bits not covered by mask
     std::for_each(listener.filter.begin(), listener.filter.end(),
                   [](auto& rule) { rule.id &= rule.mask; });
+    onMsgListenersChanged();
 
     _hidl_cb(Result::OK, closeHandle);
     return {};
@@ -142,6 +154,12 @@ ICanController::Result CanBus::up() {
         return ICanController::Result::UNKNOWN_ERROR;
     }
 
+    {
+        // There are no listeners yet, so this blocks all data frames until the first one appears.
+        std::lock_guard<std::mutex> lckListeners(mMsgListenersGuard);
+        onMsgListenersChanged();
+    }
+
     mIsUp = true;
     return ICanController::Result::OK;
 }
@@ -264,6 +282,79 @@ static bool match(const hidl_vec<CanMessageFilter>& filter, CanMessageId id, boo
     return !anyNonExcludeRulePresent || anyNonExcludeRuleSatisfied;
 }
 
+/**
+ * Add SocketCAN filter rules matching a superset of the messages the given filter accepts.
+ *
+ * Exclude rules can't be expressed as a part of a union of filters, so they are skipped; exact
+ * matching is still done in user space by match().
+ *
+ * \param filter Listener filter to translate
+ * \param kernelFilters List to append SocketCAN filter rules to
+ * \return false if the filter can't be narrowed down (i.e. it accepts every message not explicitly
+ *         excluded), true otherwise
+ */
+static bool appendKernelFilters(const hidl_vec<CanMessageFilter>& filter,
+                                std::vector<struct can_filter>& kernelFilters) {
+    const auto addFlag = [](FilterFlag filterFlag, canid_t flag, struct can_filter& rule) {
+        if (filterFlag == FilterFlag::DONT_CARE) return;
+        rule.can_mask |= flag;
+        if (filterFlag == FilterFlag::SET) rule.can_id |= flag;
+    };
+
+    bool anyNonExcludeRulePresent = false;
+    for (auto& rule : filter) {
+        if (rule.exclude) continue;
+        anyNonExcludeRulePresent = true;
+
+        struct can_filter kernelRule = {.can_id = rule.id & CAN_EFF_MASK,
+                                        .can_mask = rule.mask & CAN_EFF_MASK};
+        addFlag(rule.rtr, CAN_RTR_FLAG, kernelRule);
+        addFlag(rule.extendedFormat, CAN_EFF_FLAG, kernelRule);
+        kernelFilters.push_back(kernelRule);
+    }
+    return anyNonExcludeRulePresent;
+}
+
+void CanBus::onMsgListenersChanged() {
+    mMsgListenersById.clear();
+    if (mSocket == nullptr) return;
+
+    std::vector<struct can_filter> kernelFilters;
+    bool acceptAll = false;
+    for (auto& listener : mMsgListeners) {
+        if (!appendKernelFilters(listener.filter, kernelFilters)) {
+            acceptAll = true;
+            break;
+        }
+    }
+    if (kernelFilters.size() > CAN_RAW_FILTER_MAX) acceptAll = true;
+
+    if (!acceptAll && mSocket->setFilters(kernelFilters)) return;
+
+    // Either the filter union is too wide, or installing it failed. Fall back to receiving all
+    // frames, since an outdated filter could drop messages some listener is waiting for.
+    if (!mSocket->clearFilters()) {
+        LOG(ERROR) << "Can't reset CAN filters on " << mIfname;
+    }
+}
+
+const std::vector<size_t>& CanBus::getListenersFor(canid_t id) {
+    const auto it = mMsgListenersById.find(id);
+    if (it != mMsgListenersById.end()) return it->second;
+
+    if (mMsgListenersById.size() >= kMaxIndexedIds) mMsgListenersById.clear();
+
+    const CanMessageId messageId = id & CAN_EFF_MASK;
+    const bool isRtr = (id & CAN_RTR_FLAG) != 0;
+    const bool isExtendedId = (id & CAN_EFF_FLAG) != 0;
+
+    std::vector<size_t> listeners;
+    for (size_t i = 0; i < mMsgListeners.size(); i++) {
+        if (match(mMsgListeners[i].filter, messageId, isRtr, isExtendedId)) listeners.push_back(i);
+    }
+    return mMsgListenersById.emplace(id, std::move(listeners)).first->second;
+}
+
 void CanBus::notifyErrorListeners(ErrorEvent err, bool isFatal) {
     std::lock_guard<std::mutex> lck(mErrListenersGuard);
     for (auto& listener : mErrListeners) {
@@ -317,10 +408,8 @@ void CanBus::onRead(const struct canfd_frame& frame, std::chrono::nanoseconds ti
     }
 
     std::lock_guard<std::mutex> lck(mMsgListenersGuard);
-    for (auto& listener : mMsgListeners) {
-        if (!match(listener.filter, message.id, message.remoteTransmissionRequest,
-                   message.isExtendedId))
-            continue;
+    for (auto index : getListenersFor(frame.can_id & kListenerIdMask)) {
+        auto& listener = mMsgListeners[index];
         if (!listener.callback->onReceive(message).isOk() && !listener.failedOnce) {
             listener.failedOnce = true;
             LOG(WARNING) << "Failed to notify listener about message";
@@ -25,6 +25,8 @@
 
 #include <atomic>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace android::hardware::automotive::can::V1_0::implementation {
 
@@ -89,9 +91,23 @@ struct CanBus : public ICanBus {
     void onRead(const struct canfd_frame& frame, std::chrono::nanoseconds timestamp);
     void onError(int errnoVal);
 
+    /**
+     * Must be called whenever mMsgListeners changes: installs the union of all listener filters in
+     * the kernel and drops the per-ID listener index.
+     */
+    void onMsgListenersChanged() REQUIRES(mMsgListenersGuard);
+    const std::vector<size_t>& getListenersFor(canid_t id) REQUIRES(mMsgListenersGuard);
+
     std::mutex mMsgListenersGuard;
     std::vector<CanMessageListener> mMsgListeners GUARDED_BY(mMsgListenersGuard);
 
+    /**
+     * Indices into mMsgListeners of the listeners whose filter matches a given message ID (with
+     * EFF/RTR flags). Populated lazily on the first message with a given ID.
+     */
+    std::unordered_map<canid_t, std::vector<size_t>> mMsgListenersById
+            GUARDED_BY(mMsgListenersGuard);
+
     std::mutex mErrListenersGuard;
     std::vector<sp<ICanErrorListener>> mErrListeners GUARDED_BY(mErrListenersGuard);
 
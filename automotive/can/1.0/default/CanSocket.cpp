@@ -20,9 +20,13 @@
 #include <libnetdevice/can.h>
 #include <libnetdevice/libnetdevice.h>
 #include <linux/can.h>
+#include <linux/can/raw.h>
+#include <sys/socket.h>
 #include <utils/SystemClock.h>
 
+#include <array>
 #include <chrono>
+#include <optional>
 
 namespace android::hardware::automotive::can::V1_0::implementation {
 
@@ -34,6 +38,9 @@ using namespace std::chrono_literals;
  *       down the interface. */
 static constexpr auto kReadPooling = 100ms;
 
+/* Maximum number of frames received with a single system call. */
+static constexpr size_t kReadBatchSize = 32;
+
 std::unique_ptr<CanSocket> CanSocket::open(const std::string& ifname, ReadCallback rdcb,
                                            ErrorCallback errcb) {
     auto sock = netdevice::can::socket(ifname);
@@ -42,6 +49,11 @@ std::unique_ptr<CanSocket> CanSocket::open(const std::string& ifname, ReadCallba
         return nullptr;
     }
 
+    const int enable = 1;
+    if (setsockopt(sock.get(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0) {
+        PLOG(WARNING) << "Can't enable kernel timestamps on " << ifname;
+    }
+
     // Can't use std::make_unique due to private CanSocket constructor.
     return std::unique_ptr<CanSocket>(new CanSocket(std::move(sock), rdcb, errcb));
 }
@@ -77,6 +89,21 @@ bool CanSocket::send(const struct canfd_frame& frame) {
     return true;
 }
 
+bool CanSocket::setFilters(const std::vector<struct can_filter>& filters) {
+    const auto res = setsockopt(mSocket.get(), SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+                                filters.size() * sizeof(struct can_filter));
+    if (res < 0) {
+        PLOG(ERROR) << "Can't set CAN filters";
+        return false;
+    }
+    return true;
+}
+
+bool CanSocket::clearFilters() {
+    // A single rule with an empty mask matches every frame, which is also the kernel default.
+    return setFilters({{.can_id = 0, .can_mask = 0}});
+}
+
 static struct timeval toTimeval(std::chrono::microseconds t) {
     struct timeval tv;
     tv.tv_sec = t / 1s;
@@ -92,10 +119,44 @@ static int selectRead(const base::unique_fd& fd, std::chrono::microseconds timeo
     return select(fd.get() + 1, &readfds, nullptr, nullptr, &timeouttv);
 }
 
+static std::chrono::nanoseconds toNanoseconds(const struct timespec& ts) {
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+/* Kernel timestamps are taken from CLOCK_REALTIME, but what we really need is a time since boot.
+ * There is no direct way to convert between these clocks, so we sample the difference between them
+ * once per received batch. The wall clock is adjusted rarely enough that the offset is stable over
+ * a single batch, and sampling it per batch (rather than once) picks up any adjustment quickly. */
+static std::chrono::nanoseconds getRealtimeToBoottimeOffset() {
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    return std::chrono::nanoseconds(elapsedRealtimeNano()) - toNanoseconds(realtime);
+}
+
+/* Find the kernel timestamp (SCM_TIMESTAMPNS) attached to a received message. */
+static std::optional<std::chrono::nanoseconds> getKernelTimestamp(const struct msghdr& msg) {
+    for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&msg), cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS) continue;
+        struct timespec ts;
+        memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+        return toNanoseconds(ts);
+    }
+    return std::nullopt;
+}
+
 void CanSocket::readerThread() {
     LOG(VERBOSE) << "Reader thread started";
     int errnoCopy = 0;
 
+    std::array<struct canfd_frame, kReadBatchSize> frames;
+    std::array<struct iovec, kReadBatchSize> iovecs;
+    std::array<std::array<uint8_t, CMSG_SPACE(sizeof(struct timespec))>, kReadBatchSize> controls;
+    std::array<struct mmsghdr, kReadBatchSize> msgs;
+    for (size_t i = 0; i < kReadBatchSize; i++) {
+        iovecs[i] = {.iov_base = &frames[i], .iov_len = sizeof(frames[i])};
+    }
+
     while (!mStopReaderThread) {
         /* The ideal would be to have a blocking read(3) call and interrupt it with shutdown(3).
          * This is unfortunately not supported for SocketCAN, so we need to rely on select(3). */
@@ -106,35 +167,39 @@ void CanSocket::readerThread() {
             break;
         }
 
-        struct canfd_frame frame;
-        const auto nbytes = read(mSocket.get(), &frame, CAN_MTU);
-
-        /* We could use SIOCGSTAMP to get a precise UNIX timestamp for a given packet, but what
-         * we really need is a time since boot. There is no direct way to convert between these
-         * clocks. We could implement a class to calculate the difference between the clocks
-         * (querying both several times and picking the smallest difference); apply the difference
-         * to a SIOCGSTAMP returned value; re-synchronize if the elapsed time is too much in the
-         * past (indicating the UNIX timestamp might have been adjusted).
-         *
-         * Apart from the added complexity, it's possible the added calculations and system calls
-         * would add so much time to the processing pipeline so the precision of the reported time
-         * was buried under the subsystem latency. Let's just use a local time since boot here and
-         * leave precise hardware timestamps for custom proprietary implementations (if needed). */
-        const std::chrono::nanoseconds ts(elapsedRealtimeNano());
-
-        if (nbytes != CAN_MTU) {
-            if (nbytes >= 0) {
-                LOG(ERROR) << "Failed to read CAN packet, got " << nbytes << " bytes";
-                break;
-            }
+        /* Drain up to kReadBatchSize frames with a single system call. recvmmsg(2) updates the
+         * message headers, so they have to be reset before each call. */
+        for (size_t i = 0; i < kReadBatchSize; i++) {
+            msgs[i] = {};
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = controls[i].data();
+            msgs[i].msg_hdr.msg_controllen = controls[i].size();
+        }
+        const auto count = recvmmsg(mSocket.get(), msgs.data(), msgs.size(), MSG_DONTWAIT, nullptr);
+        if (count < 0) {
             if (errno == EAGAIN) continue;
 
             errnoCopy = errno;
-            PLOG(ERROR) << "Failed to read CAN packet";
+            PLOG(ERROR) << "Failed to read CAN packets";
             break;
         }
 
-        mReadCallback(frame, ts);
+        const auto clockOffset = getRealtimeToBoottimeOffset();
+        bool malformed = false;
+        for (int i = 0; i < count; i++) {
+            if (msgs[i].msg_len != CAN_MTU) {
+                LOG(ERROR) << "Failed to read CAN packet, got " << msgs[i].msg_len << " bytes";
+                malformed = true;
+                break;
+            }
+
+            const auto kernelTs = getKernelTimestamp(msgs[i].msg_hdr);
+            const auto ts = kernelTs.has_value() ? *kernelTs + clockOffset
+                                                 : std::chrono::nanoseconds(elapsedRealtimeNano());
+            mReadCallback(frames[i], ts);
+        }
+        if (malformed) break;
     }
 
     bool failed = !mStopReaderThread;
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 namespace android::hardware::automotive::can::V1_0::implementation {
 
@@ -51,6 +52,24 @@ struct CanSocket {
      */
     bool send(const struct canfd_frame& frame);
 
+    /**
+     * Install kernel-side receive filters.
+     *
+     * Frames not matching any of the filters are dropped by the kernel and never wake up the reader
+     * thread. Error frames are not affected.
+     *
+     * \param filters Filters to install, an empty list blocks all data frames
+     * \return true in case of success, false otherwise
+     */
+    bool setFilters(const std::vector<struct can_filter>& filters);
+
+    /**
+     * Remove kernel-side receive filters, so that all frames are received.
+     *
+     * \return true in case of success, false otherwise
+     */
+    bool clearFilters();
+
   private:
     CanSocket(base::unique_fd socket, ReadCallback rdcb, ErrorCallback errcb);
     void readerThread();
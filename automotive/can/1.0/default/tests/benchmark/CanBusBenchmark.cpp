@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <CanBusVirtual.h>
+#include <android-base/logging.h>
+#include <benchmark/benchmark.h>
+#include <libnetdevice/can.h>
+#include <linux/can.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace android::hardware::automotive::can::V1_0::implementation {
+
+using namespace std::chrono_literals;
+
+static constexpr auto kIfname = "vcanbench0";
+
+/** Offered load: 8k frames per second, typical for a busy powertrain bus. */
+static constexpr size_t kFramesPerSecond = 8000;
+static constexpr auto kFrameInterval = std::chrono::nanoseconds(1s) / kFramesPerSecond;
+
+/** One in kMatchingFrameRatio frames carries the ID the listener is interested in. */
+static constexpr size_t kMatchingFrameRatio = 16;
+static constexpr CanMessageId kListenedId = 0x100;
+
+struct CountingListener : public ICanMessageListener {
+    Return<void> onReceive(const CanMessage& /* message */) override {
+        received++;
+        return {};
+    }
+
+    std::atomic<uint64_t> received = 0;
+};
+
+static std::chrono::microseconds getCpuTime(int who) {
+    struct rusage usage = {};
+    getrusage(who, &usage);
+    const auto toDuration = [](const struct timeval& tv) {
+        return std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec);
+    };
+    return toDuration(usage.ru_utime) + toDuration(usage.ru_stime);
+}
+
+/**
+ * Sends one second worth of frames to a vcan interface and reports how many reach the listener,
+ * along with the CPU time spent on the receiving side.
+ *
+ * With a narrow filter (argument 1), the filter is installed in the kernel and the non-matching
+ * frames never wake up the reader thread. With an empty filter (argument 0), all frames are
+ * received and dispatched, which is the cost every listener used to pay regardless of its filter.
+ *
+ * Requires root (to create the vcan interface).
+ */
+static void BM_VirtualBusReceive(benchmark::State& state) {
+    const bool narrowFilter = state.range(0) != 0;
+
+    sp<CanBusVirtual> bus = new CanBusVirtual(kIfname);
+    if (bus->up() != ICanController::Result::OK) {
+        state.SkipWithError("Can't bring up vcan interface (are you root?)");
+        return;
+    }
+
+    sp<CountingListener> listener = new CountingListener();
+    hidl_vec<CanMessageFilter> filter;
+    if (narrowFilter) {
+        filter = {{.id = kListenedId,
+                   .mask = CAN_SFF_MASK,
+                   .rtr = FilterFlag::DONT_CARE,
+                   .extendedFormat = FilterFlag::NOT_SET,
+                   .exclude = false}};
+    }
+    sp<ICloseHandle> closeHandle;
+    bus->listen(filter, listener, [&closeHandle](Result result, const sp<ICloseHandle>& handle) {
+        CHECK(result == Result::OK);
+        closeHandle = handle;
+    });
+
+    auto sender = netdevice::can::socket(kIfname);
+    CHECK(sender.ok());
+
+    uint64_t framesSent = 0;
+    std::chrono::microseconds receiverCpuTime{0};
+    for (auto _ : state) {
+        const auto selfCpuStart = getCpuTime(RUSAGE_SELF);
+        const auto senderCpuStart = getCpuTime(RUSAGE_THREAD);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kFramesPerSecond; i++) {
+            struct can_frame frame = {};
+            frame.can_id = (i % kMatchingFrameRatio == 0) ? kListenedId : 0x200 + i % 0x100;
+            frame.can_dlc = 8;
+            std::this_thread::sleep_until(start + kFrameInterval * i);
+            if (write(sender.get(), &frame, CAN_MTU) == CAN_MTU) framesSent++;
+        }
+        // Give the reader thread a chance to drain the socket.
+        std::this_thread::sleep_for(10ms);
+
+        receiverCpuTime += (getCpuTime(RUSAGE_SELF) - selfCpuStart) -
+                           (getCpuTime(RUSAGE_THREAD) - senderCpuStart);
+    }
+
+    state.counters["frames_sent"] = benchmark::Counter(framesSent, benchmark::Counter::kIsRate);
+    state.counters["frames_delivered"] =
+            benchmark::Counter(listener->received, benchmark::Counter::kIsRate);
+    state.counters["receiver_cpu_us"] =
+            benchmark::Counter(receiverCpuTime.count(), benchmark::Counter::kAvgIterations);
+
+    closeHandle->close();
+    bus->down();
+}
+BENCHMARK(BM_VirtualBusReceive)
+        ->Arg(0)
+        ->Arg(1)
+        ->Iterations(5)
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+}  // namespace android::hardware::automotive::can::V1_0::implementation
+
+BENCHMARK_MAIN();
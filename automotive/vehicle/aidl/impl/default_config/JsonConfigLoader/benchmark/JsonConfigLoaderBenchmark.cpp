@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ConfigDeclarationCache.h>
+#include <JsonConfigLoader.h>
+
+#include <android-base/file.h>
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+namespace {
+
+std::string readDefaultProperties() {
+    std::string content;
+    android::base::ReadFileToString(
+            android::base::GetExecutableDirectory() + "/DefaultProperties.json", &content);
+    return content;
+}
+
+// Parses DefaultProperties.json, as VHAL does on every start without a cache.
+void BM_LoadJson(benchmark::State& state) {
+    const std::string content = readDefaultProperties();
+    for (auto _ : state) {
+        JsonConfigLoader loader;
+        std::istringstream is(content);
+        auto result = loader.loadPropConfig(is);
+        if (!result.ok()) {
+            state.SkipWithError(result.error().message().c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_LoadJson);
+
+// Loads the same configs from a cache file.
+void BM_LoadCache(benchmark::State& state) {
+    const std::string content = readDefaultProperties();
+    std::istringstream is(content);
+    auto configs = JsonConfigLoader().loadPropConfig(is);
+    if (!configs.ok()) {
+        state.SkipWithError(configs.error().message().c_str());
+        return;
+    }
+    const uint64_t sourceHash = ConfigDeclarationCache::hashSource(content);
+    TemporaryDir tempDir;
+    const std::string cachePath = std::string(tempDir.path) + "/config_cache.bin";
+    if (!ConfigDeclarationCache::store(cachePath, configs.value(), sourceHash).ok()) {
+        state.SkipWithError("failed to write the cache");
+        return;
+    }
+
+    for (auto _ : state) {
+        // The source hash has to be computed on every start to validate the cache.
+        auto result = ConfigDeclarationCache::load(cachePath,
+                                                   ConfigDeclarationCache::hashSource(content));
+        if (!result.ok()) {
+            state.SkipWithError(result.error().message().c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_LoadCache);
+
+}  // namespace
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef android_hardware_automotive_vehicle_aidl_impl_default_config_JsonConfigLoader_include_ConfigDeclarationCache_H_
+#define android_hardware_automotive_vehicle_aidl_impl_default_config_JsonConfigLoader_include_ConfigDeclarationCache_H_
+
+#include <ConfigDeclaration.h>
+
+#include <android-base/result.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+// A flat binary form of parsed config declarations, so that they can be loaded again without
+// parsing the JSON config files they come from.
+//
+// A cache carries a hash of the content it was built from and is rejected if the given hash does
+// not match, so it must be rebuilt whenever the config files change. Caches written by another
+// version of the format are rejected as well.
+class ConfigDeclarationCache final {
+  public:
+    static constexpr uint64_t kInitialSourceHash = 0xcbf29ce484222325;
+
+    // Adds the content of a config source to a source hash.
+    static uint64_t hashSource(std::string_view content, uint64_t hash = kInitialSourceHash);
+
+    // Adds the identity of the running build to a source hash: the vendor build fingerprint and
+    // the build ID of the executable. The parsed configs also depend on the loader and the
+    // generated property tables linked into the executable, not just on the config files.
+    static uint64_t hashBuildIdentity(uint64_t hash = kInitialSourceHash);
+
+    static std::string serialize(const std::unordered_map<int32_t, ConfigDeclaration>& configs,
+                                 uint64_t sourceHash);
+
+    static android::base::Result<std::unordered_map<int32_t, ConfigDeclaration>> deserialize(
+            std::string_view data, uint64_t sourceHash);
+
+    // Maps the cache file and deserializes it.
+    static android::base::Result<std::unordered_map<int32_t, ConfigDeclaration>> load(
+            const std::string& cachePath, uint64_t sourceHash);
+
+    // Writes the cache file, replacing any existing one atomically.
+    static android::base::Result<void> store(
+            const std::string& cachePath,
+            const std::unordered_map<int32_t, ConfigDeclaration>& configs, uint64_t sourceHash);
+};
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
+
+#endif  // android_hardware_automotive_vehicle_aidl_impl_default_config_JsonConfigLoader_include_ConfigDeclarationCache_H_
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ConfigDeclarationCache.h>
+
+#include <android-base/file.h>
+#include <android-base/properties.h>
+#include <android-base/unique_fd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+namespace {
+
+using ::aidl::android::hardware::automotive::vehicle::RawPropValues;
+using ::aidl::android::hardware::automotive::vehicle::VehicleAreaConfig;
+using ::aidl::android::hardware::automotive::vehicle::VehiclePropConfig;
+using ::aidl::android::hardware::automotive::vehicle::VehiclePropertyAccess;
+using ::aidl::android::hardware::automotive::vehicle::VehiclePropertyChangeMode;
+
+using ::android::base::Error;
+using ::android::base::ErrnoError;
+using ::android::base::Result;
+using ::android::base::unique_fd;
+
+constexpr uint32_t kCacheMagic = 0x43434856;  // "VHCC"
+// Must be incremented whenever the layout below or the serialized types change.
+constexpr uint32_t kCacheVersion = 1;
+constexpr uint64_t kFnvPrime = 0x100000001b3;
+
+// The cache is only read on the device which wrote it, so values are stored in its byte order.
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t payloadHash;
+    uint64_t payloadSize;
+    uint32_t configCount;
+    uint32_t reserved;
+};
+
+class CacheWriter final {
+  public:
+    template <class T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        mData.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void putArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        put<uint32_t>(values.size());
+        mData.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void putString(const std::string& value) {
+        put<uint32_t>(value.size());
+        mData.append(value);
+    }
+
+    void putRawPropValues(const RawPropValues& values) {
+        putArray(values.int32Values);
+        putArray(values.floatValues);
+        putArray(values.int64Values);
+        putArray(values.byteValues);
+        putString(values.stringValue);
+    }
+
+    void putAreaConfig(const VehicleAreaConfig& areaConfig) {
+        put(areaConfig.areaId);
+        put(areaConfig.minInt32Value);
+        put(areaConfig.maxInt32Value);
+        put(areaConfig.minInt64Value);
+        put(areaConfig.maxInt64Value);
+        put(areaConfig.minFloatValue);
+        put(areaConfig.maxFloatValue);
+        put<uint8_t>(areaConfig.supportedEnumValues.has_value());
+        if (areaConfig.supportedEnumValues.has_value()) {
+            putArray(*areaConfig.supportedEnumValues);
+        }
+    }
+
+    void putConfigDeclaration(const ConfigDeclaration& configDecl) {
+        const VehiclePropConfig& config = configDecl.config;
+        put(config.prop);
+        put(config.access);
+        put(config.changeMode);
+        put<uint32_t>(config.areaConfigs.size());
+        for (const auto& areaConfig : config.areaConfigs) {
+            putAreaConfig(areaConfig);
+        }
+        putArray(config.configArray);
+        putString(config.configString);
+        put(config.minSampleRate);
+        put(config.maxSampleRate);
+
+        putRawPropValues(configDecl.initialValue);
+        std::vector<int32_t> areaIds;
+        areaIds.reserve(configDecl.initialAreaValues.size());
+        for (const auto& [areaId, _] : configDecl.initialAreaValues) {
+            areaIds.push_back(areaId);
+        }
+        std::sort(areaIds.begin(), areaIds.end());
+        put<uint32_t>(areaIds.size());
+        for (int32_t areaId : areaIds) {
+            put(areaId);
+            putRawPropValues(configDecl.initialAreaValues.at(areaId));
+        }
+    }
+
+    std::string& data() { return mData; }
+
+  private:
+    std::string mData;
+};
+
+class CacheReader final {
+  public:
+    explicit CacheReader(std::string_view data) : mData(data) {}
+
+    template <class T>
+    bool get(T* out) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (mData.size() < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(out, mData.data(), sizeof(T));
+        mData.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    template <class T>
+    bool getArray(std::vector<T>* out) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint32_t size;
+        if (!get(&size) || size > mData.size() / sizeof(T)) {
+            return false;
+        }
+        out->resize(size);
+        std::memcpy(out->data(), mData.data(), size * sizeof(T));
+        mData.remove_prefix(size * sizeof(T));
+        return true;
+    }
+
+    bool getString(std::string* out) {
+        uint32_t size;
+        if (!get(&size) || size > mData.size()) {
+            return false;
+        }
+        out->assign(mData.data(), size);
+        mData.remove_prefix(size);
+        return true;
+    }
+
+    bool getRawPropValues(RawPropValues* out) {
+        return getArray(&out->int32Values) && getArray(&out->floatValues) &&
+               getArray(&out->int64Values) && getArray(&out->byteValues) &&
+               getString(&out->stringValue);
+    }
+
+    bool getAreaConfig(VehicleAreaConfig* out) {
+        uint8_t hasSupportedEnumValues;
+        if (!get(&out->areaId) || !get(&out->minInt32Value) || !get(&out->maxInt32Value) ||
+            !get(&out->minInt64Value) || !get(&out->maxInt64Value) ||
+            !get(&out->minFloatValue) || !get(&out->maxFloatValue) ||
+            !get(&hasSupportedEnumValues)) {
+            return false;
+        }
+        if (hasSupportedEnumValues) {
+            return getArray(&out->supportedEnumValues.emplace());
+        }
+        return true;
+    }
+
+    bool getConfigDeclaration(ConfigDeclaration* out) {
+        VehiclePropConfig& config = out->config;
+        uint32_t areaConfigCount;
+        if (!get(&config.prop) || !get(&config.access) || !get(&config.changeMode) ||
+            !get(&areaConfigCount)) {
+            return false;
+        }
+        config.areaConfigs.resize(std::min<size_t>(areaConfigCount, mData.size()));
+        for (auto& areaConfig : config.areaConfigs) {
+            if (!getAreaConfig(&areaConfig)) {
+                return false;
+            }
+        }
+        if (config.areaConfigs.size() != areaConfigCount || !getArray(&config.configArray) ||
+            !getString(&config.configString) || !get(&config.minSampleRate) ||
+            !get(&config.maxSampleRate)) {
+            return false;
+        }
+
+        uint32_t areaValueCount;
+        if (!getRawPropValues(&out->initialValue) || !get(&areaValueCount)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < areaValueCount; i++) {
+            int32_t areaId;
+            if (!get(&areaId) || !getRawPropValues(&out->initialAreaValues[areaId])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool empty() const { return mData.empty(); }
+
+  private:
+    std::string_view mData;
+};
+
+static_assert(std::is_same_v<std::underlying_type_t<VehiclePropertyAccess>, int32_t>);
+static_assert(std::is_same_v<std::underlying_type_t<VehiclePropertyChangeMode>, int32_t>);
+
+constexpr char kBuildFingerprintProperty[] = "ro.vendor.build.fingerprint";
+
+size_t alignNote(size_t size) {
+    return (size + 3) & ~size_t{3};
+}
+
+// Returns the GNU build ID of the executable, or an empty string if it has none.
+std::string getExecutableBuildId() {
+    std::string buildId;
+    dl_iterate_phdr(
+            [](struct dl_phdr_info* info, size_t, void* data) {
+                auto* buildId = static_cast<std::string*>(data);
+                for (ElfW(Half) i = 0; i < info->dlpi_phnum; i++) {
+                    const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+                    if (phdr.p_type != PT_NOTE) {
+                        continue;
+                    }
+                    const char* note = reinterpret_cast<const char*>(info->dlpi_addr + phdr.p_vaddr);
+                    const char* end = note + phdr.p_memsz;
+                    while (note + sizeof(ElfW(Nhdr)) <= end) {
+                        ElfW(Nhdr) header;
+                        std::memcpy(&header, note, sizeof(header));
+                        const char* name = note + sizeof(header);
+                        const char* desc = name + alignNote(header.n_namesz);
+                        if (desc + header.n_descsz > end) {
+                            break;
+                        }
+                        if (header.n_type == NT_GNU_BUILD_ID && header.n_namesz == 4 &&
+                            std::memcmp(name, "GNU", 4) == 0) {
+                            buildId->assign(desc, header.n_descsz);
+                            return 1;
+                        }
+                        note = desc + alignNote(header.n_descsz);
+                    }
+                }
+                // The executable is always reported first, the libraries do not matter.
+                return 1;
+            },
+            &buildId);
+    return buildId;
+}
+
+}  // namespace
+
+uint64_t ConfigDeclarationCache::hashSource(std::string_view content, uint64_t hash) {
+    // FNV-1a, which is good enough to tell whether the config files changed.
+    for (char c : content) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+uint64_t ConfigDeclarationCache::hashBuildIdentity(uint64_t hash) {
+    hash = hashSource(android::base::GetProperty(kBuildFingerprintProperty, ""), hash);
+    std::string buildId = getExecutableBuildId();
+    if (buildId.empty()) {
+        // Without a build ID, fall back to the size and modification time of the executable.
+        struct stat st;
+        if (stat("/proc/self/exe", &st) == 0) {
+            buildId = std::to_string(st.st_size) + ":" + std::to_string(st.st_mtime);
+        }
+    }
+    return hashSource(buildId, hash);
+}
+
+std::string ConfigDeclarationCache::serialize(
+        const std::unordered_map<int32_t, ConfigDeclaration>& configs, uint64_t sourceHash) {
+    std::vector<int32_t> propIds;
+    propIds.reserve(configs.size());
+    for (const auto& [propId, _] : configs) {
+        propIds.push_back(propId);
+    }
+    std::sort(propIds.begin(), propIds.end());
+
+    CacheWriter writer;
+    writer.put(CacheHeader{});
+    for (int32_t propId : propIds) {
+        writer.putConfigDeclaration(configs.at(propId));
+    }
+
+    std::string& data = writer.data();
+    std::string_view payload = std::string_view(data).substr(sizeof(CacheHeader));
+    CacheHeader header = {
+            .magic = kCacheMagic,
+            .version = kCacheVersion,
+            .sourceHash = sourceHash,
+            .payloadHash = hashSource(payload),
+            .payloadSize = payload.size(),
+            .configCount = static_cast<uint32_t>(propIds.size()),
+            .reserved = 0,
+    };
+    std::memcpy(data.data(), &header, sizeof(header));
+    return std::move(data);
+}
+
+Result<std::unordered_map<int32_t, ConfigDeclaration>> ConfigDeclarationCache::deserialize(
+        std::string_view data, uint64_t sourceHash) {
+    CacheReader reader(data);
+    CacheHeader header;
+    if (!reader.get(&header) || header.magic != kCacheMagic) {
+        return Error() << "not a config declaration cache";
+    }
+    if (header.version != kCacheVersion) {
+        return Error() << "cache version " << header.version << " is not supported, expected "
+                       << kCacheVersion;
+    }
+    if (header.sourceHash != sourceHash) {
+        return Error() << "cache is out of date";
+    }
+    std::string_view payload = data.substr(sizeof(CacheHeader));
+    if (header.payloadSize != payload.size() || header.payloadHash != hashSource(payload)) {
+        return Error() << "cache is corrupted";
+    }
+
+    std::unordered_map<int32_t, ConfigDeclaration> configsByPropId;
+    configsByPropId.reserve(header.configCount);
+    for (uint32_t i = 0; i < header.configCount; i++) {
+        ConfigDeclaration configDecl;
+        if (!reader.getConfigDeclaration(&configDecl)) {
+            return Error() << "cache is truncated at config " << i;
+        }
+        configsByPropId[configDecl.config.prop] = std::move(configDecl);
+    }
+    if (!reader.empty()) {
+        return Error() << "cache has trailing data";
+    }
+    return configsByPropId;
+}
+
+Result<std::unordered_map<int32_t, ConfigDeclaration>> ConfigDeclarationCache::load(
+        const std::string& cachePath, uint64_t sourceHash) {
+    unique_fd fd(TEMP_FAILURE_RETRY(open(cachePath.c_str(), O_RDONLY | O_CLOEXEC)));
+    if (fd == -1) {
+        return ErrnoError() << "couldn't open " << cachePath;
+    }
+    struct stat st;
+    if (fstat(fd.get(), &st) == -1) {
+        return ErrnoError() << "couldn't stat " << cachePath;
+    }
+    if (st.st_size == 0) {
+        return Error() << cachePath << " is empty";
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+    if (data == MAP_FAILED) {
+        return ErrnoError() << "couldn't map " << cachePath;
+    }
+    auto result = deserialize(std::string_view(static_cast<const char*>(data), size), sourceHash);
+    munmap(data, size);
+    return result;
+}
+
+Result<void> ConfigDeclarationCache::store(
+        const std::string& cachePath,
+        const std::unordered_map<int32_t, ConfigDeclaration>& configs, uint64_t sourceHash) {
+    const std::string tmpPath = cachePath + ".tmp";
+    if (!android::base::WriteStringToFile(serialize(configs, sourceHash), tmpPath)) {
+        return ErrnoError() << "couldn't write " << tmpPath;
+    }
+    if (rename(tmpPath.c_str(), cachePath.c_str()) == -1) {
+        auto error = ErrnoError() << "couldn't rename " << tmpPath << " to " << cachePath;
+        unlink(tmpPath.c_str());
+        return error;
+    }
+    return {};
+}
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
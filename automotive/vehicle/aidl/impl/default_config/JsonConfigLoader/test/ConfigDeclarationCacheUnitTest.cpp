@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ConfigDeclarationCache.h>
+#include <JsonConfigLoader.h>
+
+#include <android-base/file.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+using ::aidl::android::hardware::automotive::vehicle::VehiclePropertyAccess;
+using ::aidl::android::hardware::automotive::vehicle::VehiclePropertyChangeMode;
+
+constexpr char kConfigJson[] = R"(
+{
+    "properties": [
+        {
+            "property": "VehicleProperty::PERF_VEHICLE_SPEED",
+            "configArray": [1, 2, 3],
+            "configString": "config string",
+            "defaultValue": {
+                "floatValues": [1.5]
+            },
+            "minSampleRate": 1.0,
+            "maxSampleRate": 10.0
+        },
+        {
+            "property": "VehicleProperty::INFO_FUEL_CAPACITY",
+            "defaultValue": {
+                "int32Values": [1],
+                "stringValue": "string value"
+            },
+            "areas": [
+                {
+                    "areaId": "Constants::HVAC_LEFT",
+                    "minInt32Value": 0,
+                    "maxInt32Value": 10,
+                    "defaultValue": {
+                        "int32Values": [2]
+                    }
+                },
+                {
+                    "areaId": "Constants::HVAC_RIGHT",
+                    "supportedEnumValues": [1, 3]
+                }
+            ]
+        }
+    ]
+}
+)";
+
+class ConfigDeclarationCacheUnitTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        std::istringstream iss(kConfigJson);
+        auto result = JsonConfigLoader().loadPropConfig(iss);
+        ASSERT_TRUE(result.ok()) << result.error().message();
+        mConfigs = std::move(result.value());
+        ASSERT_EQ(mConfigs.size(), 2u);
+        mSourceHash = ConfigDeclarationCache::hashSource(kConfigJson);
+    }
+
+    std::unordered_map<int32_t, ConfigDeclaration> mConfigs;
+    uint64_t mSourceHash;
+};
+
+TEST_F(ConfigDeclarationCacheUnitTest, testRoundTrip) {
+    std::string data = ConfigDeclarationCache::serialize(mConfigs, mSourceHash);
+
+    auto result = ConfigDeclarationCache::deserialize(data, mSourceHash);
+
+    ASSERT_TRUE(result.ok()) << result.error().message();
+    ASSERT_EQ(result.value(), mConfigs);
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testRoundTripEmpty) {
+    std::string data = ConfigDeclarationCache::serialize({}, mSourceHash);
+
+    auto result = ConfigDeclarationCache::deserialize(data, mSourceHash);
+
+    ASSERT_TRUE(result.ok()) << result.error().message();
+    ASSERT_TRUE(result.value().empty());
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testRoundTripAllFields) {
+    ConfigDeclaration configDecl;
+    configDecl.config.prop = 1;
+    configDecl.config.access = VehiclePropertyAccess::READ_WRITE;
+    configDecl.config.changeMode = VehiclePropertyChangeMode::CONTINUOUS;
+    configDecl.config.areaConfigs.push_back({
+            .areaId = 4,
+            .minInt32Value = -1,
+            .maxInt32Value = 1,
+            .minInt64Value = -2,
+            .maxInt64Value = 2,
+            .minFloatValue = -3.5,
+            .maxFloatValue = 3.5,
+            .supportedEnumValues = std::vector<int64_t>({5, 6}),
+    });
+    configDecl.initialValue = {
+            .int32Values = {1},
+            .floatValues = {2.5},
+            .int64Values = {3},
+            .byteValues = {4, 5},
+            .stringValue = "value",
+    };
+    configDecl.initialAreaValues[4] = {.byteValues = {6}};
+    configDecl.initialAreaValues[8] = {.stringValue = "area value"};
+    std::unordered_map<int32_t, ConfigDeclaration> configs = {{1, configDecl}};
+
+    auto result = ConfigDeclarationCache::deserialize(
+            ConfigDeclarationCache::serialize(configs, mSourceHash), mSourceHash);
+
+    ASSERT_TRUE(result.ok()) << result.error().message();
+    ASSERT_EQ(result.value(), configs);
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testSerializeIsDeterministic) {
+    std::unordered_map<int32_t, ConfigDeclaration> reordered;
+    reordered.reserve(100);
+    for (auto& [propId, configDecl] : mConfigs) {
+        reordered[propId] = configDecl;
+    }
+
+    ASSERT_EQ(ConfigDeclarationCache::serialize(mConfigs, mSourceHash),
+              ConfigDeclarationCache::serialize(reordered, mSourceHash));
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testSourceHashMismatch) {
+    std::string data = ConfigDeclarationCache::serialize(mConfigs, mSourceHash);
+    uint64_t otherSourceHash = ConfigDeclarationCache::hashSource(" ", mSourceHash);
+
+    ASSERT_FALSE(ConfigDeclarationCache::deserialize(data, otherSourceHash).ok());
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testBuildIdentityChangesSourceHash) {
+    uint64_t buildHash = ConfigDeclarationCache::hashBuildIdentity(mSourceHash);
+
+    ASSERT_NE(buildHash, mSourceHash);
+    ASSERT_EQ(buildHash, ConfigDeclarationCache::hashBuildIdentity(mSourceHash));
+    std::string data = ConfigDeclarationCache::serialize(mConfigs, buildHash);
+    ASSERT_FALSE(ConfigDeclarationCache::deserialize(data, mSourceHash).ok());
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testCorrupted) {
+    std::string data = ConfigDeclarationCache::serialize(mConfigs, mSourceHash);
+    data[data.size() / 2] ^= 0x1;
+
+    ASSERT_FALSE(ConfigDeclarationCache::deserialize(data, mSourceHash).ok());
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testTruncated) {
+    std::string data = ConfigDeclarationCache::serialize(mConfigs, mSourceHash);
+
+    for (size_t size = 0; size < data.size(); size++) {
+        ASSERT_FALSE(ConfigDeclarationCache::deserialize(data.substr(0, size), mSourceHash).ok())
+                << "cache truncated to " << size << " bytes must be rejected";
+    }
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testVersionMismatch) {
+    std::string data = ConfigDeclarationCache::serialize(mConfigs, mSourceHash);
+    // The version follows the 4 byte magic.
+    data[4]++;
+
+    auto result = ConfigDeclarationCache::deserialize(data, mSourceHash);
+
+    ASSERT_FALSE(result.ok());
+    ASSERT_NE(result.error().message().find("version"), std::string::npos);
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testStoreAndLoad) {
+    TemporaryDir tempDir;
+    std::string cachePath = std::string(tempDir.path) + "/config_cache.bin";
+
+    auto storeResult = ConfigDeclarationCache::store(cachePath, mConfigs, mSourceHash);
+    ASSERT_TRUE(storeResult.ok()) << storeResult.error().message();
+    auto loadResult = ConfigDeclarationCache::load(cachePath, mSourceHash);
+
+    ASSERT_TRUE(loadResult.ok()) << loadResult.error().message();
+    ASSERT_EQ(loadResult.value(), mConfigs);
+}
+
+TEST_F(ConfigDeclarationCacheUnitTest, testLoadMissingFile) {
+    TemporaryDir tempDir;
+
+    ASSERT_FALSE(ConfigDeclarationCache::load(std::string(tempDir.path) + "/missing.bin",
+                                              mSourceHash)
+                         .ok());
+}
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
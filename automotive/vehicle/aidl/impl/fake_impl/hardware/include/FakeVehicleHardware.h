@@ -17,7 +17,6 @@
 #ifndef android_hardware_automotive_vehicle_aidl_impl_fake_impl_hardware_include_FakeVehicleHardware_H_
 #define android_hardware_automotive_vehicle_aidl_impl_fake_impl_hardware_include_FakeVehicleHardware_H_
 
-#include <ConcurrentQueue.h>
 #include <ConfigDeclaration.h>
 #include <FakeObd2Frame.h>
 #include <FakeUserHal.h>
@@ -25,6 +24,7 @@
 #include <IVehicleHardware.h>
 #include <JsonConfigLoader.h>
 #include <RecurrentTimer.h>
+#include <ShardedRequestHandler.h>
 #include <VehicleHalTypes.h>
 #include <VehiclePropertyStore.h>
 #include <aidl/android/hardware/automotive/vehicle/VehicleHwKeyInputAction.h>
@@ -53,6 +53,11 @@ class FakeVehicleHardware : public IVehicleHardware {
     FakeVehicleHardware(std::string defaultConfigDir, std::string overrideConfigDir,
                         bool forceOverride);
 
+    // If configCachePath is not empty, the parsed config files are cached there and the cache is
+    // used instead of parsing them again as long as the config files do not change.
+    FakeVehicleHardware(std::string defaultConfigDir, std::string overrideConfigDir,
+                        bool forceOverride, std::string configCachePath);
+
     ~FakeVehicleHardware();
 
     // Get all the property configs.
@@ -109,29 +114,6 @@ class FakeVehicleHardware : public IVehicleHardware {
     // Expose private methods to unit test.
     friend class FakeVehicleHardwareTestHelper;
 
-    template <class CallbackType, class RequestType>
-    struct RequestWithCallback {
-        RequestType request;
-        std::shared_ptr<const CallbackType> callback;
-    };
-
-    template <class CallbackType, class RequestType>
-    class PendingRequestHandler {
-      public:
-        PendingRequestHandler(FakeVehicleHardware* hardware);
-
-        void addRequest(RequestType request, std::shared_ptr<const CallbackType> callback);
-
-        void stop();
-
-      private:
-        FakeVehicleHardware* mHardware;
-        std::thread mThread;
-        ConcurrentQueue<RequestWithCallback<CallbackType, RequestType>> mRequests;
-
-        void handleRequestsOnce();
-    };
-
     const std::unique_ptr<obd2frame::FakeObd2Frame> mFakeObd2Frame;
     const std::unique_ptr<FakeUserHal> mFakeUserHal;
     // RecurrentTimer is thread-safe.
@@ -148,17 +130,19 @@ class FakeVehicleHardware : public IVehicleHardware {
             mRecurrentActions GUARDED_BY(mLock);
     std::unordered_map<PropIdAreaId, VehiclePropValuePool::RecyclableType, PropIdAreaIdHash>
             mSavedProps GUARDED_BY(mLock);
-    // PendingRequestHandler is thread-safe.
-    mutable PendingRequestHandler<GetValuesCallback,
-                                  aidl::android::hardware::automotive::vehicle::GetValueRequest>
+    // ShardedRequestHandler is thread-safe. Requests are sharded by property ID, except that
+    // properties whose availability depends on another property are sharded with that property.
+    mutable ShardedRequestHandler<aidl::android::hardware::automotive::vehicle::GetValueRequest,
+                                  aidl::android::hardware::automotive::vehicle::GetValueResult>
             mPendingGetValueRequests;
-    mutable PendingRequestHandler<SetValuesCallback,
-                                  aidl::android::hardware::automotive::vehicle::SetValueRequest>
+    mutable ShardedRequestHandler<aidl::android::hardware::automotive::vehicle::SetValueRequest,
+                                  aidl::android::hardware::automotive::vehicle::SetValueResult>
             mPendingSetValueRequests;
 
     const std::string mDefaultConfigDir;
     const std::string mOverrideConfigDir;
     const bool mForceOverride;
+    const std::string mConfigCachePath;
     bool mAddExtraTestVendorConfigs;
 
     // Only used during initialization.
@@ -170,10 +154,13 @@ class FakeVehicleHardware : public IVehicleHardware {
     // The callback that would be called when a vehicle property value change happens.
     void onValueChangeCallback(
             const aidl::android::hardware::automotive::vehicle::VehiclePropValue& value);
-    // Load the config files in format '*.json' from the directory and parse the config files
-    // into a map from property ID to ConfigDeclarations.
-    void loadPropConfigsFromDir(const std::string& dirPath,
-                                std::unordered_map<int32_t, ConfigDeclaration>* configs);
+    // Lists the config files in format '*.json' from the directory, sorted by name.
+    std::vector<std::string> listPropConfigFiles(const std::string& dirPath);
+    // Parse the config files into a map from property ID to ConfigDeclarations. Configs from later
+    // files overwrite the ones from earlier files.
+    void loadPropConfigFiles(const std::vector<std::string>& filePaths,
+                             const std::vector<std::string>& fileContents,
+                             std::unordered_map<int32_t, ConfigDeclaration>* configs);
     // Function to be called when a value change event comes from vehicle bus. In our fake
     // implementation, this function is only called during "--inject-event" dump command.
     void eventFromVehicleBus(
@@ -19,6 +19,7 @@
 #define FAKE_VEHICLEHARDWARE_DEBUG false  // STOPSHIP if true.
 
 #include "FakeVehicleHardware.h"
+#include <ConfigDeclarationCache.h>
 
 #include <FakeObd2Frame.h>
 #include <JsonFakeValueGenerator.h>
@@ -37,10 +38,13 @@
 #include <utils/Trace.h>
 
 #include <dirent.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <fstream>
 #include <regex>
+#include <sstream>
 #include <unordered_set>
 #include <vector>
 
@@ -102,6 +106,18 @@ constexpr char OVERRIDE_CONFIG_DIR[] = "/vendor/etc/automotive/vhaloverride/";
 // If OVERRIDE_PROPERTY is set, we will use the configuration files from OVERRIDE_CONFIG_DIR to
 // overwrite the default configs.
 constexpr char OVERRIDE_PROPERTY[] = "persist.vendor.vhal_init_value_override";
+// The file the parsed configuration files are cached in, so that they do not need to be parsed
+// again on every start. The cache is rebuilt whenever the configuration files or the build change.
+// The cache is optional. The service starts with the early_hal class, before /data is mounted, so
+// after a cold boot the configuration files are parsed, and the cache is used when the service
+// restarts. Devices with a partition mounted before early_hal starts, e.g. a persist partition,
+// can move the cache there with CONFIG_CACHE_PATH_PROPERTY.
+constexpr char CONFIG_CACHE_PATH[] = "/data/vendor/vhal/config_cache.bin";
+constexpr char CONFIG_CACHE_PATH_PROPERTY[] = "ro.vendor.vhal.config_cache_path";
+// The number of threads handling get value requests, and the number handling set value requests.
+// Requests for the same property, or for properties depending on each other, are always handled in
+// order on the same thread, see getRequestShardKey.
+constexpr size_t PENDING_REQUEST_WORKER_COUNT = 4;
 constexpr char POWER_STATE_REQ_CONFIG_PROPERTY[] = "ro.vendor.fake_vhal.ap_power_state_req.config";
 // The value to be returned if VENDOR_PROPERTY_ID is set as the property
 constexpr int VENDOR_ERROR_CODE = 0x00ab0005;
@@ -190,6 +206,41 @@ const std::unordered_map<int32_t, std::vector<int32_t>> mAdasEnabledPropToAdasPr
                 },
         },
 };
+
+std::unordered_map<int32_t, int32_t> makeRequestShardKeys() {
+    std::unordered_map<int32_t, int32_t> shardKeys;
+    for (int32_t propId : HVAC_POWER_PROPERTIES) {
+        shardKeys[propId] = toInt(VehicleProperty::HVAC_POWER_ON);
+    }
+    for (const auto& [enabledPropId, statePropIds] : mAdasEnabledPropToAdasPropWithErrorState) {
+        for (int32_t propId : statePropIds) {
+            shardKeys[propId] = enabledPropId;
+        }
+    }
+    // The ADAS properties which are only available in certain ADAS states.
+    shardKeys[toInt(VehicleProperty::LANE_CENTERING_ASSIST_COMMAND)] =
+            toInt(VehicleProperty::LANE_CENTERING_ASSIST_ENABLED);
+    for (auto property : {
+                 VehicleProperty::CRUISE_CONTROL_COMMAND,
+                 VehicleProperty::CRUISE_CONTROL_TARGET_SPEED,
+                 VehicleProperty::ADAPTIVE_CRUISE_CONTROL_TARGET_TIME_GAP,
+                 VehicleProperty::ADAPTIVE_CRUISE_CONTROL_LEAD_VEHICLE_MEASURED_DISTANCE,
+         }) {
+        shardKeys[toInt(property)] = toInt(VehicleProperty::CRUISE_CONTROL_ENABLED);
+    }
+    return shardKeys;
+}
+
+// Returns the key to shard the requests for the property by. The availability of some properties
+// depends on the value of another property, e.g. HVAC_FAN_SPEED is not available while
+// HVAC_POWER_ON is off. Such properties share the shard key of the property they depend on, so that
+// the requests for both within one batch are handled in order.
+int32_t getRequestShardKey(int32_t propId) {
+    static const std::unordered_map<int32_t, int32_t> kShardKeys = makeRequestShardKeys();
+    auto it = kShardKeys.find(propId);
+    return it == kShardKeys.end() ? propId : it->second;
+}
+
 }  // namespace
 
 void FakeVehicleHardware::storePropInitialValue(const ConfigDeclaration& config) {
@@ -234,10 +285,18 @@ void FakeVehicleHardware::storePropInitialValue(const ConfigDeclaration& config)
 }
 
 FakeVehicleHardware::FakeVehicleHardware()
-    : FakeVehicleHardware(DEFAULT_CONFIG_DIR, OVERRIDE_CONFIG_DIR, false) {}
+    : FakeVehicleHardware(DEFAULT_CONFIG_DIR, OVERRIDE_CONFIG_DIR, false,
+                          android::base::GetProperty(CONFIG_CACHE_PATH_PROPERTY,
+                                                     CONFIG_CACHE_PATH)) {}
 
 FakeVehicleHardware::FakeVehicleHardware(std::string defaultConfigDir,
                                          std::string overrideConfigDir, bool forceOverride)
+    : FakeVehicleHardware(std::move(defaultConfigDir), std::move(overrideConfigDir),
+                          forceOverride, /*configCachePath=*/"") {}
+
+FakeVehicleHardware::FakeVehicleHardware(std::string defaultConfigDir,
+                                         std::string overrideConfigDir, bool forceOverride,
+                                         std::string configCachePath)
     : mValuePool(std::make_unique<VehiclePropValuePool>()),
       mServerSidePropStore(new VehiclePropertyStore(mValuePool)),
       mFakeObd2Frame(new obd2frame::FakeObd2Frame(mServerSidePropStore)),
@@ -245,11 +304,32 @@ FakeVehicleHardware::FakeVehicleHardware(std::string defaultConfigDir,
       mRecurrentTimer(new RecurrentTimer()),
       mGeneratorHub(new GeneratorHub(
               [this](const VehiclePropValue& value) { eventFromVehicleBus(value); })),
-      mPendingGetValueRequests(this),
-      mPendingSetValueRequests(this),
+      mPendingGetValueRequests(
+              PENDING_REQUEST_WORKER_COUNT,
+              [this](const GetValueRequest& request) {
+                  ATRACE_BEGIN("FakeVehicleHardware:handleGetValueRequest");
+                  auto result = handleGetValueRequest(request);
+                  ATRACE_END();
+                  return result;
+              },
+              [](const GetValueRequest& request) {
+                  return getRequestShardKey(request.prop.prop);
+              }),
+      mPendingSetValueRequests(
+              PENDING_REQUEST_WORKER_COUNT,
+              [this](const SetValueRequest& request) {
+                  ATRACE_BEGIN("FakeVehicleHardware:handleSetValueRequest");
+                  auto result = handleSetValueRequest(request);
+                  ATRACE_END();
+                  return result;
+              },
+              [](const SetValueRequest& request) {
+                  return getRequestShardKey(request.value.prop);
+              }),
       mDefaultConfigDir(defaultConfigDir),
       mOverrideConfigDir(overrideConfigDir),
-      mForceOverride(forceOverride) {
+      mForceOverride(forceOverride),
+      mConfigCachePath(configCachePath) {
     init();
 }
 
@@ -260,11 +340,56 @@ FakeVehicleHardware::~FakeVehicleHardware() {
 }
 
 std::unordered_map<int32_t, ConfigDeclaration> FakeVehicleHardware::loadConfigDeclarations() {
-    std::unordered_map<int32_t, ConfigDeclaration> configsByPropId;
-    loadPropConfigsFromDir(mDefaultConfigDir, &configsByPropId);
+    std::vector<std::string> filePaths = listPropConfigFiles(mDefaultConfigDir);
     if (mForceOverride ||
         android::base::GetBoolProperty(OVERRIDE_PROPERTY, /*default_value=*/false)) {
-        loadPropConfigsFromDir(mOverrideConfigDir, &configsByPropId);
+        std::vector<std::string> overrideFilePaths = listPropConfigFiles(mOverrideConfigDir);
+        filePaths.insert(filePaths.end(), overrideFilePaths.begin(), overrideFilePaths.end());
+    }
+
+    // The source hash covers the file names as well, since they decide the override order, and
+    // the build, since the parsing code and the generated property tables may change too.
+    std::vector<std::string> readFilePaths;
+    std::vector<std::string> fileContents;
+    uint64_t sourceHash = ConfigDeclarationCache::hashBuildIdentity();
+    for (auto& filePath : filePaths) {
+        std::string content;
+        if (!android::base::ReadFileToString(filePath, &content)) {
+            ALOGE("failed to read config file: %s", filePath.c_str());
+            continue;
+        }
+        sourceHash = ConfigDeclarationCache::hashSource(filePath, sourceHash);
+        sourceHash = ConfigDeclarationCache::hashSource(std::to_string(content.size()), sourceHash);
+        sourceHash = ConfigDeclarationCache::hashSource(content, sourceHash);
+        readFilePaths.push_back(std::move(filePath));
+        fileContents.push_back(std::move(content));
+    }
+
+    if (!mConfigCachePath.empty()) {
+        auto result = ConfigDeclarationCache::load(mConfigCachePath, sourceHash);
+        if (result.ok()) {
+            ALOGI("loaded %zu property configs from cache %s", result.value().size(),
+                  mConfigCachePath.c_str());
+            return std::move(result.value());
+        }
+        ALOGI("not using config cache: %s", result.error().message().c_str());
+    }
+
+    std::unordered_map<int32_t, ConfigDeclaration> configsByPropId;
+    loadPropConfigFiles(readFilePaths, fileContents, &configsByPropId);
+
+    if (!mConfigCachePath.empty()) {
+        if (auto result = ConfigDeclarationCache::store(mConfigCachePath, configsByPropId,
+                                                        sourceHash);
+            !result.ok()) {
+            if (result.error().code() == ENOENT) {
+                // e.g. /data is not mounted yet
+                ALOGI("config cache directory is not available: %s",
+                      result.error().message().c_str());
+            } else {
+                ALOGW("failed to write config cache: %s", result.error().message().c_str());
+            }
+        }
     }
     return configsByPropId;
 }
@@ -962,7 +1087,7 @@ DumpResult FakeVehicleHardware::dump(const std::vector<std::string>& options) {
     if (options.size() == 0) {
         // We only want caller to dump default state when there is no options.
         result.callerShouldDumpState = true;
-        result.buffer = dumpAllProperties();
+        result.buffer = dumpAllProperties() + mValuePool->dump();
         return result;
     }
     std::string option = options[0];
@@ -1864,30 +1989,40 @@ void FakeVehicleHardware::onValueChangeCallback(const VehiclePropValue& value) {
     (*mOnPropertyChangeCallback)(std::move(updatedValues));
 }
 
-void FakeVehicleHardware::loadPropConfigsFromDir(
-        const std::string& dirPath,
-        std::unordered_map<int32_t, ConfigDeclaration>* configsByPropId) {
+std::vector<std::string> FakeVehicleHardware::listPropConfigFiles(const std::string& dirPath) {
     ALOGI("loading properties from %s", dirPath.c_str());
+    std::vector<std::string> filePaths;
     if (auto dir = opendir(dirPath.c_str()); dir != NULL) {
         std::regex regJson(".*[.]json", std::regex::icase);
         while (auto f = readdir(dir)) {
             if (!std::regex_match(f->d_name, regJson)) {
                 continue;
             }
-            std::string filePath = dirPath + "/" + std::string(f->d_name);
-            ALOGI("loading properties from %s", filePath.c_str());
-            auto result = mLoader.loadPropConfig(filePath);
-            if (!result.ok()) {
-                ALOGE("failed to load config file: %s, error: %s", filePath.c_str(),
-                      result.error().message().c_str());
-                continue;
-            }
-            for (auto& [propId, configDeclaration] : result.value()) {
-                (*configsByPropId)[propId] = std::move(configDeclaration);
-            }
+            filePaths.push_back(dirPath + "/" + std::string(f->d_name));
         }
         closedir(dir);
     }
+    std::sort(filePaths.begin(), filePaths.end());
+    return filePaths;
+}
+
+void FakeVehicleHardware::loadPropConfigFiles(
+        const std::vector<std::string>& filePaths, const std::vector<std::string>& fileContents,
+        std::unordered_map<int32_t, ConfigDeclaration>* configsByPropId) {
+    for (size_t i = 0; i < filePaths.size(); i++) {
+        const std::string& filePath = filePaths[i];
+        ALOGI("loading properties from %s", filePath.c_str());
+        std::istringstream is(fileContents[i]);
+        auto result = mLoader.loadPropConfig(is);
+        if (!result.ok()) {
+            ALOGE("failed to load config file: %s, error: %s", filePath.c_str(),
+                  result.error().message().c_str());
+            continue;
+        }
+        for (auto& [propId, configDeclaration] : result.value()) {
+            (*configsByPropId)[propId] = std::move(configDeclaration);
+        }
+    }
 }
 
 Result<float> FakeVehicleHardware::safelyParseFloat(int index, const std::string& s) {
@@ -1933,72 +2068,6 @@ Result<std::vector<uint8_t>> FakeVehicleHardware::parseHexString(const std::stri
     return bytes;
 }
 
-template <class CallbackType, class RequestType>
-FakeVehicleHardware::PendingRequestHandler<CallbackType, RequestType>::PendingRequestHandler(
-        FakeVehicleHardware* hardware)
-    : mHardware(hardware) {
-    // Don't initialize mThread in initialization list because mThread depends on mRequests and we
-    // want mRequests to be initialized first.
-    mThread = std::thread([this] {
-        while (mRequests.waitForItems()) {
-            handleRequestsOnce();
-        }
-    });
-}
-
-template <class CallbackType, class RequestType>
-void FakeVehicleHardware::PendingRequestHandler<CallbackType, RequestType>::addRequest(
-        RequestType request, std::shared_ptr<const CallbackType> callback) {
-    mRequests.push({
-            request,
-            callback,
-    });
-}
-
-template <class CallbackType, class RequestType>
-void FakeVehicleHardware::PendingRequestHandler<CallbackType, RequestType>::stop() {
-    mRequests.deactivate();
-    if (mThread.joinable()) {
-        mThread.join();
-    }
-}
-
-template <>
-void FakeVehicleHardware::PendingRequestHandler<FakeVehicleHardware::GetValuesCallback,
-                                                GetValueRequest>::handleRequestsOnce() {
-    std::unordered_map<std::shared_ptr<const GetValuesCallback>, std::vector<GetValueResult>>
-            callbackToResults;
-    for (const auto& rwc : mRequests.flush()) {
-        ATRACE_BEGIN("FakeVehicleHardware:handleGetValueRequest");
-        auto result = mHardware->handleGetValueRequest(rwc.request);
-        ATRACE_END();
-        callbackToResults[rwc.callback].push_back(std::move(result));
-    }
-    for (const auto& [callback, results] : callbackToResults) {
-        ATRACE_BEGIN("FakeVehicleHardware:call get value result callback");
-        (*callback)(std::move(results));
-        ATRACE_END();
-    }
-}
-
-template <>
-void FakeVehicleHardware::PendingRequestHandler<FakeVehicleHardware::SetValuesCallback,
-                                                SetValueRequest>::handleRequestsOnce() {
-    std::unordered_map<std::shared_ptr<const SetValuesCallback>, std::vector<SetValueResult>>
-            callbackToResults;
-    for (const auto& rwc : mRequests.flush()) {
-        ATRACE_BEGIN("FakeVehicleHardware:handleSetValueRequest");
-        auto result = mHardware->handleSetValueRequest(rwc.request);
-        ATRACE_END();
-        callbackToResults[rwc.callback].push_back(std::move(result));
-    }
-    for (const auto& [callback, results] : callbackToResults) {
-        ATRACE_BEGIN("FakeVehicleHardware:call set value result callback");
-        (*callback)(std::move(results));
-        ATRACE_END();
-    }
-}
-
 }  // namespace fake
 }  // namespace vehicle
 }  // namespace automotive
@@ -86,6 +86,7 @@ using ::testing::ContainsRegex;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::IsSubsetOf;
+using ::testing::UnorderedElementsAreArray;
 using ::testing::WhenSortedBy;
 
 using std::chrono::milliseconds;
@@ -482,7 +483,9 @@ TEST_F(FakeVehicleHardwareTest, testGetDefaultValues) {
         resultCopy.prop->timestamp = 0;
         getValueResultsWithNoTimestamp.push_back(std::move(resultCopy));
     }
-    ASSERT_THAT(getValueResultsWithNoTimestamp, ContainerEq(expectedGetValueResults));
+    // Results for different properties might come in any order.
+    ASSERT_THAT(getValueResultsWithNoTimestamp,
+                UnorderedElementsAreArray(expectedGetValueResults));
 }
 
 TEST_F(FakeVehicleHardwareTest, testSetValues) {
@@ -499,8 +502,9 @@ TEST_F(FakeVehicleHardwareTest, testSetValues) {
     ASSERT_EQ(status, StatusCode::OK);
 
     // Although callback might be called asynchronously, in our implementation, the callback would
-    // be called before setValues returns.
-    ASSERT_THAT(getSetValueResults(), ContainerEq(expectedResults));
+    // be called before setValues returns. Results for different properties might come in any
+    // order.
+    ASSERT_THAT(getSetValueResults(), UnorderedElementsAreArray(expectedResults));
 }
 
 TEST_F(FakeVehicleHardwareTest, testSetValuesError) {
@@ -524,8 +528,73 @@ TEST_F(FakeVehicleHardwareTest, testSetValuesError) {
     ASSERT_EQ(status, StatusCode::OK);
 
     // Although callback might be called asynchronously, in our implementation, the callback would
-    // be called before setValues returns.
+    // be called before setValues returns. Results for different properties might come in any
+    // order.
+    ASSERT_THAT(getSetValueResults(), UnorderedElementsAreArray(expectedResults));
+}
+
+TEST_F(FakeVehicleHardwareTest, testSetValuesSamePropertyInOrder) {
+    std::vector<SetValueRequest> requests;
+    std::vector<SetValueResult> expectedResults;
+
+    int64_t requestId = 1;
+    for (float capacity = 1.0; capacity <= 100.0; capacity++) {
+        addSetValueRequest(requests, expectedResults, requestId++,
+                           VehiclePropValue{
+                                   .prop = toInt(VehicleProperty::INFO_FUEL_CAPACITY),
+                                   .value = {.floatValues = {capacity}},
+                           },
+                           StatusCode::OK);
+    }
+
+    StatusCode status = setValues(requests);
+
+    ASSERT_EQ(status, StatusCode::OK);
+    // Requests for the same property are handled in order.
     ASSERT_THAT(getSetValueResults(), ContainerEq(expectedResults));
+    auto result = getValue(VehiclePropValue{
+            .prop = toInt(VehicleProperty::INFO_FUEL_CAPACITY),
+    });
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(result.value().value.floatValues, std::vector<float>({100.0}));
+}
+
+TEST_F(FakeVehicleHardwareTest, testSetValuesHvacPowerDependentPropertiesInOrder) {
+    std::vector<SetValueRequest> requests;
+    std::vector<SetValueResult> expectedResults;
+
+    int64_t requestId = 1;
+    for (int32_t fanSpeed = 1; fanSpeed <= 7; fanSpeed++) {
+        for (int32_t hvacPowerOn : {0, 1}) {
+            addSetValueRequest(requests, expectedResults, requestId++,
+                               VehiclePropValue{
+                                       .prop = toInt(VehicleProperty::HVAC_POWER_ON),
+                                       .areaId = SEAT_1_LEFT,
+                                       .value.int32Values = {hvacPowerOn},
+                               },
+                               StatusCode::OK);
+            // HVAC_FAN_SPEED is only available if the HVAC_POWER_ON request before it in the
+            // batch turned the power on.
+            addSetValueRequest(requests, expectedResults, requestId++,
+                               VehiclePropValue{
+                                       .prop = toInt(VehicleProperty::HVAC_FAN_SPEED),
+                                       .areaId = SEAT_1_LEFT,
+                                       .value.int32Values = {fanSpeed},
+                               },
+                               hvacPowerOn ? StatusCode::OK : StatusCode::NOT_AVAILABLE_DISABLED);
+        }
+    }
+
+    StatusCode status = setValues(requests);
+
+    ASSERT_EQ(status, StatusCode::OK);
+    ASSERT_THAT(getSetValueResults(), ContainerEq(expectedResults));
+    auto result = getValue(VehiclePropValue{
+            .prop = toInt(VehicleProperty::HVAC_FAN_SPEED),
+            .areaId = SEAT_1_LEFT,
+    });
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(result.value().value.int32Values, std::vector<int32_t>({7}));
 }
 
 TEST_F(FakeVehicleHardwareTest, testRegisterOnPropertyChangeEvent) {
@@ -594,7 +663,9 @@ TEST_F(FakeVehicleHardwareTest, testReadValues) {
         resultCopy.prop->timestamp = 0;
         getValueResultsWithNoTimestamp.push_back(std::move(resultCopy));
     }
-    ASSERT_THAT(getValueResultsWithNoTimestamp, ContainerEq(expectedGetValueResults));
+    // Results for different properties might come in any order.
+    ASSERT_THAT(getValueResultsWithNoTimestamp,
+                UnorderedElementsAreArray(expectedGetValueResults));
 }
 
 TEST_F(FakeVehicleHardwareTest, testReadValuesErrorInvalidProp) {
@@ -2133,6 +2204,7 @@ TEST_F(FakeVehicleHardwareTest, testDumpAllProperties) {
     ASSERT_TRUE(result.callerShouldDumpState);
     ASSERT_NE(result.buffer, "");
     ASSERT_THAT(result.buffer, ContainsRegex("dumping .+ properties"));
+    ASSERT_THAT(result.buffer, ContainsRegex("VehiclePropValuePool: .+ hit rate"));
 }
 
 TEST_F(FakeVehicleHardwareTest, testDumpHelp) {
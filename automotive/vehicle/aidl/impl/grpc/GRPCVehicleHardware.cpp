@@ -21,8 +21,10 @@
 #include <android-base/logging.h>
 #include <grpc++/grpc++.h>
 
+#include <cstdint>
 #include <cstdlib>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <utility>
 
@@ -33,11 +35,61 @@ static std::shared_ptr<::grpc::ChannelCredentials> getChannelCredentials() {
     return ::grpc::InsecureChannelCredentials();
 }
 
+// How long to wait before reconnecting a value request stream which failed to start.
+static constexpr auto kValueStreamRetryDelay = std::chrono::milliseconds(100);
+
+// The operations of the value request stream, used as completion queue tags.
+enum class ValueStreamOp : intptr_t {
+    START = 1,
+    READ,
+    WRITE,
+    FINISH,
+};
+
+static std::vector<aidlvhal::GetValueResult> toAidlResults(proto::GetValueResults* protoResults) {
+    std::vector<aidlvhal::GetValueResult> aidlResults;
+    aidlResults.reserve(protoResults->results_size());
+    for (const auto& protoResult : protoResults->results()) {
+        auto& result = aidlResults.emplace_back();
+        result.requestId = protoResult.request_id();
+        result.status = static_cast<aidlvhal::StatusCode>(protoResult.status());
+        if (protoResult.has_value()) {
+            proto_msg_converter::protoToAidl(protoResult.value(), &result.prop.emplace());
+        }
+    }
+    return aidlResults;
+}
+
+static std::vector<aidlvhal::SetValueResult> toAidlResults(
+        const proto::SetValueResults& protoResults) {
+    std::vector<aidlvhal::SetValueResult> aidlResults;
+    aidlResults.reserve(protoResults.results_size());
+    for (const auto& protoResult : protoResults.results()) {
+        auto& result = aidlResults.emplace_back();
+        result.requestId = protoResult.request_id();
+        result.status = static_cast<aidlvhal::StatusCode>(protoResult.status());
+        // TODO(chenhaosjtuacm): call on-set-error callback.
+    }
+    return aidlResults;
+}
+
+static void* toTag(ValueStreamOp op) {
+    return reinterpret_cast<void*>(static_cast<intptr_t>(op));
+}
+
+static ValueStreamOp fromTag(void* tag) {
+    return static_cast<ValueStreamOp>(reinterpret_cast<intptr_t>(tag));
+}
+
 GRPCVehicleHardware::GRPCVehicleHardware(std::string service_addr)
     : mServiceAddr(std::move(service_addr)),
       mGrpcChannel(::grpc::CreateChannel(mServiceAddr, getChannelCredentials())),
       mGrpcStub(proto::VehicleServer::NewStub(mGrpcChannel)),
-      mValuePollingThread([this] { ValuePollingLoop(); }) {}
+      mValuePollingThread([this] { ValuePollingLoop(); }) {
+    // Started here instead of in the initializer list, so that all the members it uses are
+    // initialized.
+    mValueStreamThread = std::thread([this] { ValueStreamLoop(); });
+}
 
 GRPCVehicleHardware::~GRPCVehicleHardware() {
     {
@@ -45,7 +97,14 @@ GRPCVehicleHardware::~GRPCVehicleHardware() {
         mShuttingDownFlag.store(true);
     }
     mShutdownCV.notify_all();
+    {
+        std::lock_guard lck(mValueStreamMutex);
+        if (mValueStream) {
+            mValueStream->context.TryCancel();
+        }
+    }
     mValuePollingThread.join();
+    mValueStreamThread.join();
 }
 
 std::vector<aidlvhal::VehiclePropConfig> GRPCVehicleHardware::getAllPropertyConfigs() const {
@@ -69,66 +128,82 @@ std::vector<aidlvhal::VehiclePropConfig> GRPCVehicleHardware::getAllPropertyConf
 aidlvhal::StatusCode GRPCVehicleHardware::setValues(
         std::shared_ptr<const SetValuesCallback> callback,
         const std::vector<aidlvhal::SetValueRequest>& requests) {
-    ::grpc::ClientContext context;
-    proto::VehiclePropValueRequests protoRequests;
-    proto::SetValueResults protoResults;
+    proto::VehiclePropValueRequestBatch batch;
+    PendingBatch pending{.setCallback = std::move(callback)};
+    auto& protoRequests = *batch.mutable_set_requests();
+    protoRequests.mutable_requests()->Reserve(requests.size());
+    pending.requestIds.reserve(requests.size());
     for (const auto& request : requests) {
         auto& protoRequest = *protoRequests.add_requests();
         protoRequest.set_request_id(request.requestId);
         proto_msg_converter::aidlToProto(request.value, protoRequest.mutable_value());
+        pending.requestIds.push_back(request.requestId);
     }
-    // TODO(chenhaosjtuacm): Make it Async.
-    auto grpc_status = mGrpcStub->SetValues(&context, protoRequests, &protoResults);
-    if (!grpc_status.ok()) {
-        LOG(ERROR) << __func__ << ": GRPC SetValues Failed: " << grpc_status.error_message();
-        {
-            std::shared_lock lck(mCallbackMutex);
-            // TODO(chenhaosjtuacm): call on-set-error callback.
-        }
-        return aidlvhal::StatusCode::INTERNAL_ERROR;
-    }
-    std::vector<aidlvhal::SetValueResult> results;
-    for (const auto& protoResult : protoResults.results()) {
-        auto& result = results.emplace_back();
-        result.requestId = protoResult.request_id();
-        result.status = static_cast<aidlvhal::StatusCode>(protoResult.status());
-        // TODO(chenhaosjtuacm): call on-set-error callback.
+    if (mUseUnaryValueRpcs.load()) {
+        return SetValuesUnary(*pending.setCallback, protoRequests);
     }
-    (*callback)(std::move(results));
-
-    return aidlvhal::StatusCode::OK;
+    // TODO(chenhaosjtuacm): call on-set-error callback.
+    return SendBatch(std::move(batch), std::move(pending));
 }
 
 aidlvhal::StatusCode GRPCVehicleHardware::getValues(
         std::shared_ptr<const GetValuesCallback> callback,
         const std::vector<aidlvhal::GetValueRequest>& requests) const {
-    ::grpc::ClientContext context;
-    proto::VehiclePropValueRequests protoRequests;
-    proto::GetValueResults protoResults;
+    proto::VehiclePropValueRequestBatch batch;
+    PendingBatch pending{.getCallback = std::move(callback)};
+    auto& protoRequests = *batch.mutable_get_requests();
+    protoRequests.mutable_requests()->Reserve(requests.size());
+    pending.requestIds.reserve(requests.size());
     for (const auto& request : requests) {
         auto& protoRequest = *protoRequests.add_requests();
         protoRequest.set_request_id(request.requestId);
         proto_msg_converter::aidlToProto(request.prop, protoRequest.mutable_value());
+        pending.requestIds.push_back(request.requestId);
     }
-    // TODO(chenhaosjtuacm): Make it Async.
-    auto grpc_status = mGrpcStub->GetValues(&context, protoRequests, &protoResults);
+    if (mUseUnaryValueRpcs.load()) {
+        return GetValuesUnary(*pending.getCallback, protoRequests);
+    }
+    return SendBatch(std::move(batch), std::move(pending));
+}
+
+aidlvhal::StatusCode GRPCVehicleHardware::SendBatch(proto::VehiclePropValueRequestBatch batch,
+                                                    PendingBatch pending) const {
+    std::lock_guard lck(mValueStreamMutex);
+    if (!mValueStream || mValueStream->finishing) {
+        LOG(WARNING) << __func__ << ": Value request stream is reconnecting";
+        return aidlvhal::StatusCode::TRY_AGAIN;
+    }
+    const int64_t batchId = mNextBatchId++;
+    batch.set_batch_id(batchId);
+    mPendingBatches.emplace(batchId, std::move(pending));
+    mBatchesToWrite.push_back(std::move(batch));
+    WriteNextBatchLocked();
+    return aidlvhal::StatusCode::OK;
+}
+
+aidlvhal::StatusCode GRPCVehicleHardware::GetValuesUnary(
+        const GetValuesCallback& callback, const proto::VehiclePropValueRequests& requests) const {
+    ::grpc::ClientContext context;
+    proto::GetValueResults protoResults;
+    auto grpc_status = mGrpcStub->GetValues(&context, requests, &protoResults);
     if (!grpc_status.ok()) {
         LOG(ERROR) << __func__ << ": GRPC GetValues Failed: " << grpc_status.error_message();
         return aidlvhal::StatusCode::INTERNAL_ERROR;
     }
-    std::vector<aidlvhal::GetValueResult> results;
-    for (const auto& protoResult : protoResults.results()) {
-        auto& result = results.emplace_back();
-        result.requestId = protoResult.request_id();
-        result.status = static_cast<aidlvhal::StatusCode>(protoResult.status());
-        if (protoResult.has_value()) {
-            aidlvhal::VehiclePropValue value;
-            proto_msg_converter::protoToAidl(protoResult.value(), &value);
-            result.prop = std::move(value);
-        }
-    }
-    (*callback)(std::move(results));
+    callback(toAidlResults(&protoResults));
+    return aidlvhal::StatusCode::OK;
+}
 
+aidlvhal::StatusCode GRPCVehicleHardware::SetValuesUnary(
+        const SetValuesCallback& callback, const proto::VehiclePropValueRequests& requests) {
+    ::grpc::ClientContext context;
+    proto::SetValueResults protoResults;
+    auto grpc_status = mGrpcStub->SetValues(&context, requests, &protoResults);
+    if (!grpc_status.ok()) {
+        LOG(ERROR) << __func__ << ": GRPC SetValues Failed: " << grpc_status.error_message();
+        return aidlvhal::StatusCode::INTERNAL_ERROR;
+    }
+    callback(toAidlResults(protoResults));
     return aidlvhal::StatusCode::OK;
 }
 
@@ -221,13 +296,13 @@ void GRPCVehicleHardware::ValuePollingLoop() {
         proto::VehiclePropValues protoValues;
         while (!mShuttingDownFlag.load() && value_stream->Read(&protoValues)) {
             std::vector<aidlvhal::VehiclePropValue> values;
-            for (const auto protoValue : protoValues.values()) {
-                values.push_back(aidlvhal::VehiclePropValue());
-                proto_msg_converter::protoToAidl(protoValue, &values.back());
+            values.reserve(protoValues.values_size());
+            for (const auto& protoValue : protoValues.values()) {
+                proto_msg_converter::protoToAidl(protoValue, &values.emplace_back());
             }
             std::shared_lock lck(mCallbackMutex);
             if (mOnPropChange) {
-                (*mOnPropChange)(values);
+                (*mOnPropChange)(std::move(values));
             }
         }
 
@@ -246,4 +321,168 @@ void GRPCVehicleHardware::ValuePollingLoop() {
     }
 }
 
+void GRPCVehicleHardware::ValueStreamLoop() {
+    while (!mShuttingDownFlag.load() && !mUseUnaryValueRpcs.load()) {
+        RunValueStream();
+
+        std::unique_lock<std::mutex> lck(mShutdownMutex);
+        mShutdownCV.wait_for(lck, kValueStreamRetryDelay,
+                             [this] { return mShuttingDownFlag.load(); });
+    }
+    mValueCq.Shutdown();
+    void* tag;
+    bool ok;
+    while (mValueCq.Next(&tag, &ok)) {
+    }
+}
+
+void GRPCVehicleHardware::RunValueStream() {
+    {
+        std::lock_guard lck(mValueStreamMutex);
+        if (mShuttingDownFlag.load()) {
+            return;
+        }
+        mValueStream = std::make_unique<ValueStream>();
+        // Wait for the server instead of failing right away, so that requests are queued
+        // meanwhile.
+        mValueStream->context.set_wait_for_ready(true);
+        mValueStream->rw =
+                mGrpcStub->PrepareAsyncStreamValueRequests(&mValueStream->context, &mValueCq);
+        mValueStream->opsInFlight++;
+        mValueStream->rw->StartCall(toTag(ValueStreamOp::START));
+    }
+
+    void* tag;
+    bool ok;
+    while (mValueCq.Next(&tag, &ok)) {
+        std::optional<proto::VehiclePropValueResultBatch> results;
+        {
+            std::lock_guard lck(mValueStreamMutex);
+            auto& stream = *mValueStream;
+            stream.opsInFlight--;
+            switch (fromTag(tag)) {
+                case ValueStreamOp::START:
+                    if (!ok) {
+                        FinishValueStreamLocked();
+                        break;
+                    }
+                    LOG(INFO) << __func__ << ": GRPC Value Request Stream Started";
+                    stream.started = true;
+                    ReadNextResultsLocked();
+                    WriteNextBatchLocked();
+                    break;
+                case ValueStreamOp::READ:
+                    if (!ok) {
+                        FinishValueStreamLocked();
+                        break;
+                    }
+                    results = std::move(stream.readResults);
+                    ReadNextResultsLocked();
+                    break;
+                case ValueStreamOp::WRITE:
+                    stream.writing = false;
+                    // If the write failed, so does the pending read, which finishes the stream.
+                    if (ok) {
+                        mBatchesToWrite.pop_front();
+                        WriteNextBatchLocked();
+                    }
+                    break;
+                case ValueStreamOp::FINISH:
+                    if (stream.status.error_code() == ::grpc::StatusCode::UNIMPLEMENTED) {
+                        LOG(WARNING) << __func__
+                                     << ": Server does not support value request streams, "
+                                     << "falling back to unary GetValues and SetValues";
+                        mUseUnaryValueRpcs.store(true);
+                        break;
+                    }
+                    LOG(ERROR) << __func__ << ": GRPC Value Request Stream Failed: "
+                               << stream.status.error_message();
+                    break;
+            }
+            if (stream.finishing && stream.opsInFlight == 0) {
+                break;
+            }
+        }
+        if (results) {
+            OnResults(std::move(*results));
+        }
+    }
+
+    std::unordered_map<int64_t, PendingBatch> failedBatches;
+    {
+        std::lock_guard lck(mValueStreamMutex);
+        mValueStream.reset();
+        mBatchesToWrite.clear();
+        failedBatches = std::move(mPendingBatches);
+        mPendingBatches.clear();
+    }
+    for (const auto& [batchId, pending] : failedBatches) {
+        FailBatch(pending, aidlvhal::StatusCode::TRY_AGAIN);
+    }
+}
+
+void GRPCVehicleHardware::ReadNextResultsLocked() const {
+    mValueStream->opsInFlight++;
+    mValueStream->rw->Read(&mValueStream->readResults, toTag(ValueStreamOp::READ));
+}
+
+void GRPCVehicleHardware::WriteNextBatchLocked() const {
+    auto& stream = *mValueStream;
+    if (!stream.started || stream.writing || stream.finishing || mBatchesToWrite.empty()) {
+        return;
+    }
+    stream.writing = true;
+    stream.opsInFlight++;
+    stream.rw->Write(mBatchesToWrite.front(), toTag(ValueStreamOp::WRITE));
+}
+
+void GRPCVehicleHardware::FinishValueStreamLocked() const {
+    auto& stream = *mValueStream;
+    if (stream.finishing) {
+        return;
+    }
+    stream.finishing = true;
+    stream.opsInFlight++;
+    stream.rw->Finish(&stream.status, toTag(ValueStreamOp::FINISH));
+}
+
+void GRPCVehicleHardware::OnResults(proto::VehiclePropValueResultBatch results) const {
+    PendingBatch pending;
+    {
+        std::lock_guard lck(mValueStreamMutex);
+        auto it = mPendingBatches.find(results.batch_id());
+        if (it == mPendingBatches.end()) {
+            LOG(ERROR) << __func__ << ": Unexpected results for batch " << results.batch_id();
+            return;
+        }
+        pending = std::move(it->second);
+        mPendingBatches.erase(it);
+    }
+
+    if (pending.getCallback && results.has_get_results()) {
+        (*pending.getCallback)(toAidlResults(results.mutable_get_results()));
+    } else if (pending.setCallback && results.has_set_results()) {
+        (*pending.setCallback)(toAidlResults(results.set_results()));
+    } else {
+        LOG(ERROR) << __func__ << ": Mismatched results for batch " << results.batch_id();
+        FailBatch(pending, aidlvhal::StatusCode::INTERNAL_ERROR);
+    }
+}
+
+void GRPCVehicleHardware::FailBatch(const PendingBatch& pending, aidlvhal::StatusCode status) {
+    if (pending.getCallback) {
+        std::vector<aidlvhal::GetValueResult> results;
+        for (int64_t requestId : pending.requestIds) {
+            results.push_back({.requestId = requestId, .status = status});
+        }
+        (*pending.getCallback)(std::move(results));
+    } else if (pending.setCallback) {
+        std::vector<aidlvhal::SetValueResult> results;
+        for (int64_t requestId : pending.requestIds) {
+            results.push_back({.requestId = requestId, .status = status});
+        }
+        (*pending.setCallback)(std::move(results));
+    }
+}
+
 }  // namespace android::hardware::automotive::vehicle::virtualization
@@ -27,10 +27,13 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace android::hardware::automotive::vehicle::virtualization {
@@ -81,13 +84,63 @@ class GRPCVehicleHardware : public IVehicleHardware {
     bool waitForConnected(std::chrono::milliseconds waitTime);
 
   private:
+    // A getValues or setValues call waiting for the results of its batch.
+    struct PendingBatch {
+        std::shared_ptr<const GetValuesCallback> getCallback;
+        std::shared_ptr<const SetValuesCallback> setCallback;
+        std::vector<int64_t> requestIds;
+    };
+
+    // A StreamValueRequests call. Its operations complete on mValueCq.
+    struct ValueStream {
+        ::grpc::ClientContext context;
+        std::unique_ptr<::grpc::ClientAsyncReaderWriter<proto::VehiclePropValueRequestBatch,
+                                                        proto::VehiclePropValueResultBatch>>
+                rw;
+        proto::VehiclePropValueResultBatch readResults;
+        ::grpc::Status status;
+        size_t opsInFlight{0};
+        bool started{false};
+        bool writing{false};
+        bool finishing{false};
+    };
+
     void ValuePollingLoop();
 
+    void ValueStreamLoop();
+    void RunValueStream();
+    aidlvhal::StatusCode SendBatch(proto::VehiclePropValueRequestBatch batch,
+                                   PendingBatch pending) const;
+    // Used instead of the value request stream with servers which do not support it.
+    aidlvhal::StatusCode GetValuesUnary(const GetValuesCallback& callback,
+                                        const proto::VehiclePropValueRequests& requests) const;
+    aidlvhal::StatusCode SetValuesUnary(const SetValuesCallback& callback,
+                                        const proto::VehiclePropValueRequests& requests);
+    void ReadNextResultsLocked() const;
+    void WriteNextBatchLocked() const;
+    void FinishValueStreamLocked() const;
+    void OnResults(proto::VehiclePropValueResultBatch results) const;
+    static void FailBatch(const PendingBatch& pending, aidlvhal::StatusCode status);
+
     std::string mServiceAddr;
     std::shared_ptr<::grpc::Channel> mGrpcChannel;
     std::unique_ptr<proto::VehicleServer::Stub> mGrpcStub;
     std::thread mValuePollingThread;
 
+    // Get and set value requests are sent over a single stream, without waiting for the results
+    // of the previous ones.
+    mutable ::grpc::CompletionQueue mValueCq;
+    mutable std::mutex mValueStreamMutex;
+    // Null while reconnecting.
+    mutable std::unique_ptr<ValueStream> mValueStream;
+    // The front batch is being written.
+    mutable std::deque<proto::VehiclePropValueRequestBatch> mBatchesToWrite;
+    mutable std::unordered_map<int64_t, PendingBatch> mPendingBatches;
+    mutable int64_t mNextBatchId{0};
+    std::thread mValueStreamThread;
+    // Set once the server turned out not to implement StreamValueRequests, e.g. an older proxy.
+    std::atomic<bool> mUseUnaryValueRpcs{false};
+
     std::shared_mutex mCallbackMutex;
     std::unique_ptr<const PropertyChangeCallback> mOnPropChange;
     std::unique_ptr<const PropertySetErrorCallback> mOnSetErr;
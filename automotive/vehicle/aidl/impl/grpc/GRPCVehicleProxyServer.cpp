@@ -38,6 +38,21 @@ static std::shared_ptr<::grpc::ServerCredentials> getServerCredentials() {
     return ::grpc::InsecureServerCredentials();
 }
 
+static void toProtoResult(const aidlvhal::SetValueResult& aidlResult,
+                          proto::SetValueResult* protoResult) {
+    protoResult->set_request_id(aidlResult.requestId);
+    protoResult->set_status(static_cast<proto::StatusCode>(aidlResult.status));
+}
+
+static void toProtoResult(const aidlvhal::GetValueResult& aidlResult,
+                          proto::GetValueResult* protoResult) {
+    protoResult->set_request_id(aidlResult.requestId);
+    protoResult->set_status(static_cast<proto::StatusCode>(aidlResult.status));
+    if (aidlResult.prop) {
+        proto_msg_converter::aidlToProto(*aidlResult.prop, protoResult->mutable_value());
+    }
+}
+
 GrpcVehicleProxyServer::GrpcVehicleProxyServer(std::string serverAddr,
                                                std::unique_ptr<IVehicleHardware>&& hardware)
     : mServiceAddr(std::move(serverAddr)), mHardware(std::move(hardware)) {
@@ -79,10 +94,7 @@ GrpcVehicleProxyServer::GrpcVehicleProxyServer(std::string serverAddr,
                     [waitMtx, waitCV, complete,
                      tmpResults](std::vector<aidlvhal::SetValueResult> setValueResults) {
                         for (const auto& aidlResult : setValueResults) {
-                            auto& protoResult = *tmpResults->add_results();
-                            protoResult.set_request_id(aidlResult.requestId);
-                            protoResult.set_status(
-                                    static_cast<proto::StatusCode>(aidlResult.status));
+                            toProtoResult(aidlResult, tmpResults->add_results());
                         }
                         {
                             std::lock_guard lck(*waitMtx);
@@ -124,14 +136,7 @@ GrpcVehicleProxyServer::GrpcVehicleProxyServer(std::string serverAddr,
                     [waitMtx, waitCV, complete,
                      tmpResults](std::vector<aidlvhal::GetValueResult> getValueResults) {
                         for (const auto& aidlResult : getValueResults) {
-                            auto& protoResult = *tmpResults->add_results();
-                            protoResult.set_request_id(aidlResult.requestId);
-                            protoResult.set_status(
-                                    static_cast<proto::StatusCode>(aidlResult.status));
-                            if (aidlResult.prop) {
-                                auto* valuePtr = protoResult.mutable_value();
-                                proto_msg_converter::aidlToProto(*aidlResult.prop, valuePtr);
-                            }
+                            toProtoResult(aidlResult, tmpResults->add_results());
                         }
                         {
                             std::lock_guard lck(*waitMtx);
@@ -195,6 +200,112 @@ GrpcVehicleProxyServer::GrpcVehicleProxyServer(std::string serverAddr,
     return ::grpc::Status(::grpc::StatusCode::ABORTED, "Connection lost.");
 }
 
+::grpc::Status GrpcVehicleProxyServer::StreamValueRequests(
+        ::grpc::ServerContext* context,
+        ::grpc::ServerReaderWriter<proto::VehiclePropValueResultBatch,
+                                   proto::VehiclePropValueRequestBatch>* stream) {
+    {
+        std::lock_guard lck(mValueRequestStreamMutex);
+        if (mShuttingDown) {
+            return ::grpc::Status(::grpc::StatusCode::UNAVAILABLE, "Server is shutting down.");
+        }
+        mValueRequestStreamContexts.insert(context);
+    }
+    auto writer = std::make_shared<ResultBatchWriter>(stream);
+    proto::VehiclePropValueRequestBatch batch;
+    while (stream->Read(&batch)) {
+        switch (batch.requests_case()) {
+            case proto::VehiclePropValueRequestBatch::kGetRequests:
+                StreamGetValues(batch.batch_id(), batch.get_requests(), writer);
+                break;
+            case proto::VehiclePropValueRequestBatch::kSetRequests:
+                StreamSetValues(batch.batch_id(), batch.set_requests(), writer);
+                break;
+            default:
+                LOG(WARNING) << __func__ << ": Ignoring empty batch " << batch.batch_id();
+                break;
+        }
+    }
+    writer->Close(kHardwareOpTimeout);
+    {
+        std::lock_guard lck(mValueRequestStreamMutex);
+        mValueRequestStreamContexts.erase(context);
+    }
+    return ::grpc::Status::OK;
+}
+
+void GrpcVehicleProxyServer::StreamGetValues(int64_t batchId,
+                                             const proto::VehiclePropValueRequests& requests,
+                                             std::shared_ptr<ResultBatchWriter> writer) {
+    std::vector<aidlvhal::GetValueRequest> aidlRequests;
+    aidlRequests.reserve(requests.requests_size());
+    for (const auto& protoRequest : requests.requests()) {
+        auto& aidlRequest = aidlRequests.emplace_back();
+        aidlRequest.requestId = protoRequest.request_id();
+        proto_msg_converter::protoToAidl(protoRequest.value(), &aidlRequest.prop);
+    }
+    writer->BeginBatch();
+    auto aidlStatus = mHardware->getValues(
+            std::make_shared<const IVehicleHardware::GetValuesCallback>(
+                    [batchId, writer](std::vector<aidlvhal::GetValueResult> getValueResults) {
+                        proto::VehiclePropValueResultBatch protoBatch;
+                        protoBatch.set_batch_id(batchId);
+                        auto* protoResults = protoBatch.mutable_get_results();
+                        for (const auto& aidlResult : getValueResults) {
+                            toProtoResult(aidlResult, protoResults->add_results());
+                        }
+                        writer->WriteResults(protoBatch);
+                    }),
+            aidlRequests);
+    if (aidlStatus != aidlvhal::StatusCode::OK) {
+        proto::VehiclePropValueResultBatch protoBatch;
+        protoBatch.set_batch_id(batchId);
+        auto* protoResults = protoBatch.mutable_get_results();
+        for (const auto& aidlRequest : aidlRequests) {
+            toProtoResult(aidlvhal::GetValueResult{.requestId = aidlRequest.requestId,
+                                                   .status = aidlStatus},
+                          protoResults->add_results());
+        }
+        writer->WriteResults(protoBatch);
+    }
+}
+
+void GrpcVehicleProxyServer::StreamSetValues(int64_t batchId,
+                                             const proto::VehiclePropValueRequests& requests,
+                                             std::shared_ptr<ResultBatchWriter> writer) {
+    std::vector<aidlvhal::SetValueRequest> aidlRequests;
+    aidlRequests.reserve(requests.requests_size());
+    for (const auto& protoRequest : requests.requests()) {
+        auto& aidlRequest = aidlRequests.emplace_back();
+        aidlRequest.requestId = protoRequest.request_id();
+        proto_msg_converter::protoToAidl(protoRequest.value(), &aidlRequest.value);
+    }
+    writer->BeginBatch();
+    auto aidlStatus = mHardware->setValues(
+            std::make_shared<const IVehicleHardware::SetValuesCallback>(
+                    [batchId, writer](std::vector<aidlvhal::SetValueResult> setValueResults) {
+                        proto::VehiclePropValueResultBatch protoBatch;
+                        protoBatch.set_batch_id(batchId);
+                        auto* protoResults = protoBatch.mutable_set_results();
+                        for (const auto& aidlResult : setValueResults) {
+                            toProtoResult(aidlResult, protoResults->add_results());
+                        }
+                        writer->WriteResults(protoBatch);
+                    }),
+            aidlRequests);
+    if (aidlStatus != aidlvhal::StatusCode::OK) {
+        proto::VehiclePropValueResultBatch protoBatch;
+        protoBatch.set_batch_id(batchId);
+        auto* protoResults = protoBatch.mutable_set_results();
+        for (const auto& aidlRequest : aidlRequests) {
+            toProtoResult(aidlvhal::SetValueResult{.requestId = aidlRequest.requestId,
+                                                   .status = aidlStatus},
+                          protoResults->add_results());
+        }
+        writer->WriteResults(protoBatch);
+    }
+}
+
 void GrpcVehicleProxyServer::OnVehiclePropChange(
         const std::vector<aidlvhal::VehiclePropValue>& values) {
     std::unordered_set<uint64_t> brokenConn;
@@ -245,6 +356,13 @@ GrpcVehicleProxyServer& GrpcVehicleProxyServer::Shutdown() {
     for (auto& conn : mValueStreamingConnections) {
         conn->Shutdown();
     }
+    {
+        std::lock_guard lck(mValueRequestStreamMutex);
+        mShuttingDown = true;
+        for (auto* context : mValueRequestStreamContexts) {
+            context->TryCancel();
+        }
+    }
     if (mServer) {
         mServer->Shutdown();
     }
@@ -258,6 +376,35 @@ void GrpcVehicleProxyServer::Wait() {
     mServer.reset();
 }
 
+void GrpcVehicleProxyServer::ResultBatchWriter::BeginBatch() {
+    std::lock_guard lck(mMtx);
+    ++mBatchesInFlight;
+}
+
+void GrpcVehicleProxyServer::ResultBatchWriter::WriteResults(
+        const proto::VehiclePropValueResultBatch& results) {
+    {
+        std::lock_guard lck(mMtx);
+        --mBatchesInFlight;
+        if (!mStream) {
+            LOG(WARNING) << __func__ << ": Stream lost, dropping results of batch "
+                         << results.batch_id();
+        } else if (!mStream->Write(results)) {
+            LOG(ERROR) << __func__ << ": Server Write failed, batch " << results.batch_id();
+        }
+    }
+    mCV.notify_all();
+}
+
+void GrpcVehicleProxyServer::ResultBatchWriter::Close(std::chrono::nanoseconds timeout) {
+    std::unique_lock lck(mMtx);
+    if (!mCV.wait_for(lck, timeout, [this] { return mBatchesInFlight == 0; })) {
+        LOG(ERROR) << __func__ << ": " << mBatchesInFlight
+                   << " batches not completed by the underlying hardware in time";
+    }
+    mStream = nullptr;
+}
+
 GrpcVehicleProxyServer::ConnectionDescriptor::~ConnectionDescriptor() {
     Shutdown();
 }
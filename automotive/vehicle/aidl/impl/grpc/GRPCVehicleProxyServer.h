@@ -25,11 +25,14 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <unordered_set>
 #include <utility>
 
 namespace android::hardware::automotive::vehicle::virtualization {
@@ -67,6 +70,11 @@ class GrpcVehicleProxyServer : public proto::VehicleServer::Service {
             ::grpc::ServerContext* context, const ::google::protobuf::Empty* request,
             ::grpc::ServerWriter<proto::VehiclePropValues>* stream) override;
 
+    ::grpc::Status StreamValueRequests(
+            ::grpc::ServerContext* context,
+            ::grpc::ServerReaderWriter<proto::VehiclePropValueResultBatch,
+                                       proto::VehiclePropValueRequestBatch>* stream) override;
+
     GrpcVehicleProxyServer& Start();
 
     GrpcVehicleProxyServer& Shutdown();
@@ -109,6 +117,36 @@ class GrpcVehicleProxyServer : public proto::VehicleServer::Service {
         static std::atomic<uint64_t> connection_id_counter_;
     };
 
+    // Writes the results of the batches of a value request stream. The hardware may complete a
+    // batch after the stream is gone, in which case its results are dropped.
+    class ResultBatchWriter {
+      public:
+        using Stream = ::grpc::ServerReaderWriter<proto::VehiclePropValueResultBatch,
+                                                  proto::VehiclePropValueRequestBatch>;
+
+        explicit ResultBatchWriter(Stream* stream) : mStream(stream) {}
+
+        // Must be called before the batch is passed to the hardware.
+        void BeginBatch();
+
+        void WriteResults(const proto::VehiclePropValueResultBatch& results);
+
+        // Waits for the batches in flight to complete, up to the timeout, then drops the stream.
+        void Close(std::chrono::nanoseconds timeout);
+
+      private:
+        std::mutex mMtx;
+        std::condition_variable mCV;
+        Stream* mStream;
+        size_t mBatchesInFlight{0};
+    };
+
+    void StreamGetValues(int64_t batchId, const proto::VehiclePropValueRequests& requests,
+                         std::shared_ptr<ResultBatchWriter> writer);
+
+    void StreamSetValues(int64_t batchId, const proto::VehiclePropValueRequests& requests,
+                         std::shared_ptr<ResultBatchWriter> writer);
+
     std::string mServiceAddr;
     std::unique_ptr<::grpc::Server> mServer{nullptr};
     std::unique_ptr<IVehicleHardware> mHardware;
@@ -116,6 +154,12 @@ class GrpcVehicleProxyServer : public proto::VehicleServer::Service {
     std::shared_mutex mConnectionMutex;
     std::vector<std::shared_ptr<ConnectionDescriptor>> mValueStreamingConnections;
 
+    // The value request streams only end when the client disconnects, so they are cancelled on
+    // shutdown, otherwise the server would wait for them forever.
+    std::mutex mValueRequestStreamMutex;
+    std::unordered_set<::grpc::ServerContext*> mValueRequestStreamContexts;
+    bool mShuttingDown{false};
+
     static constexpr auto kHardwareOpTimeout = std::chrono::seconds(1);
 };
 
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GRPCVehicleHardware.h"
+#include "GRPCVehicleProxyServer.h"
+#include "IVehicleHardware.h"
+#include "VehicleServer.grpc.pb.h"
+#include "VehicleServer.pb.h"
+
+#include <benchmark/benchmark.h>
+#include <grpc++/grpc++.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace android::hardware::automotive::vehicle::virtualization {
+namespace {
+
+const std::string kLoopbackServerAddr = "127.0.0.1:54322";
+constexpr auto kWaitForConnectionMaxTime = std::chrono::seconds(5);
+constexpr int32_t kPropId = 0x11600207;  // PERF_VEHICLE_SPEED
+
+// Answers every request right away, with the value it was given.
+class EchoVehicleHardware : public IVehicleHardware {
+  public:
+    aidlvhal::StatusCode getValues(
+            std::shared_ptr<const GetValuesCallback> callback,
+            const std::vector<aidlvhal::GetValueRequest>& requests) const override {
+        std::vector<aidlvhal::GetValueResult> results;
+        for (const auto& request : requests) {
+            results.push_back({.requestId = request.requestId,
+                               .status = aidlvhal::StatusCode::OK,
+                               .prop = request.prop});
+        }
+        (*callback)(std::move(results));
+        return aidlvhal::StatusCode::OK;
+    }
+
+    aidlvhal::StatusCode setValues(std::shared_ptr<const SetValuesCallback> callback,
+                                   const std::vector<aidlvhal::SetValueRequest>& requests) override {
+        std::vector<aidlvhal::SetValueResult> results;
+        for (const auto& request : requests) {
+            results.push_back({.requestId = request.requestId, .status = aidlvhal::StatusCode::OK});
+        }
+        (*callback)(std::move(results));
+        return aidlvhal::StatusCode::OK;
+    }
+
+    // Functions that we do not care.
+    std::vector<aidlvhal::VehiclePropConfig> getAllPropertyConfigs() const override { return {}; }
+
+    DumpResult dump(const std::vector<std::string>& options) override { return {}; }
+
+    aidlvhal::StatusCode checkHealth() override { return aidlvhal::StatusCode::OK; }
+
+    void registerOnPropertyChangeEvent(
+            std::unique_ptr<const PropertyChangeCallback> callback) override {}
+
+    void registerOnPropertySetErrorEvent(
+            std::unique_ptr<const PropertySetErrorCallback> callback) override {}
+};
+
+GrpcVehicleProxyServer& startLoopbackServer() {
+    static auto* server = [] {
+        auto* server = new GrpcVehicleProxyServer(kLoopbackServerAddr,
+                                                  std::make_unique<EchoVehicleHardware>());
+        server->Start();
+        return server;
+    }();
+    return *server;
+}
+
+aidlvhal::GetValueRequest makeGetValueRequest(int64_t requestId) {
+    aidlvhal::GetValueRequest request;
+    request.requestId = requestId;
+    request.prop.prop = kPropId;
+    return request;
+}
+
+// Limits the number of requests in flight.
+class InFlightLimiter {
+  public:
+    explicit InFlightLimiter(size_t limit) : mLimit(limit) {}
+
+    void acquire() {
+        std::unique_lock lck(mMtx);
+        mCV.wait(lck, [this] { return mInFlight < mLimit; });
+        mInFlight++;
+    }
+
+    void release() {
+        {
+            std::lock_guard lck(mMtx);
+            mInFlight--;
+        }
+        mCV.notify_all();
+    }
+
+    void drain() {
+        std::unique_lock lck(mMtx);
+        mCV.wait(lck, [this] { return mInFlight == 0; });
+    }
+
+  private:
+    std::mutex mMtx;
+    std::condition_variable mCV;
+    const size_t mLimit;
+    size_t mInFlight = 0;
+};
+
+// One request per call, with up to range(0) of them in flight.
+void BM_GetValues(benchmark::State& state) {
+    startLoopbackServer();
+    GRPCVehicleHardware hardware(kLoopbackServerAddr);
+    if (!hardware.waitForConnected(kWaitForConnectionMaxTime)) {
+        state.SkipWithError("Failed to connect to the loopback server");
+        return;
+    }
+
+    auto limiter = std::make_shared<InFlightLimiter>(state.range(0));
+    auto callback = std::make_shared<const IVehicleHardware::GetValuesCallback>(
+            [limiter](std::vector<aidlvhal::GetValueResult>) { limiter->release(); });
+    int64_t requestId = 0;
+    int64_t sent = 0;
+    for (auto _ : state) {
+        limiter->acquire();
+        if (hardware.getValues(callback, {makeGetValueRequest(requestId++)}) ==
+            aidlvhal::StatusCode::OK) {
+            sent++;
+        } else {
+            // The stream is reconnecting.
+            limiter->release();
+        }
+    }
+    limiter->drain();
+    state.SetItemsProcessed(sent);
+}
+BENCHMARK(BM_GetValues)->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
+
+// A blocking unary GetValues RPC per call, as the vehicle hardware used to do.
+void BM_UnaryGetValues(benchmark::State& state) {
+    startLoopbackServer();
+    auto channel = ::grpc::CreateChannel(kLoopbackServerAddr, ::grpc::InsecureChannelCredentials());
+    auto stub = proto::VehicleServer::NewStub(channel);
+
+    int64_t requestId = 0;
+    for (auto _ : state) {
+        ::grpc::ClientContext context;
+        proto::VehiclePropValueRequests protoRequests;
+        proto::GetValueResults protoResults;
+        auto& protoRequest = *protoRequests.add_requests();
+        protoRequest.set_request_id(requestId++);
+        protoRequest.mutable_value()->set_prop(kPropId);
+        if (!stub->GetValues(&context, protoRequests, &protoResults).ok()) {
+            state.SkipWithError("GetValues RPC failed");
+            return;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UnaryGetValues)->UseRealTime();
+
+}  // namespace
+}  // namespace android::hardware::automotive::vehicle::virtualization
+
+BENCHMARK_MAIN();
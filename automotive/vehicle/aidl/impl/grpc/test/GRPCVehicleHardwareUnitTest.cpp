@@ -21,13 +21,19 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace android::hardware::automotive::vehicle::virtualization {
 
 const std::string kFakeServerAddr = "0.0.0.0:54321";
 
+constexpr auto kMaxWaitTime = std::chrono::seconds(5);
+
 class FakeVehicleServer : public proto::VehicleServer::Service {
   public:
     ::grpc::Status StartPropertyValuesStream(
@@ -58,6 +64,208 @@ class FakeVehicleServer : public proto::VehicleServer::Service {
     }
 };
 
+// Answers every request with its own value, either over the unary calls or, if streaming is
+// enabled, over the value request stream.
+class EchoVehicleServer : public FakeVehicleServer {
+  public:
+    explicit EchoVehicleServer(bool streaming) : mStreaming(streaming) {}
+
+    ::grpc::Status SetValues(::grpc::ServerContext* context,
+                             const proto::VehiclePropValueRequests* requests,
+                             proto::SetValueResults* results) override {
+        mUnaryRequests.fetch_add(1);
+        EchoSetValues(*requests, results);
+        return ::grpc::Status::OK;
+    }
+
+    ::grpc::Status GetValues(::grpc::ServerContext* context,
+                             const proto::VehiclePropValueRequests* requests,
+                             proto::GetValueResults* results) override {
+        mUnaryRequests.fetch_add(1);
+        EchoGetValues(*requests, results);
+        return ::grpc::Status::OK;
+    }
+
+    ::grpc::Status StreamValueRequests(
+            ::grpc::ServerContext* context,
+            ::grpc::ServerReaderWriter<proto::VehiclePropValueResultBatch,
+                                       proto::VehiclePropValueRequestBatch>* stream) override {
+        if (!mStreaming) {
+            return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "Not implemented.");
+        }
+        proto::VehiclePropValueRequestBatch batch;
+        while (stream->Read(&batch)) {
+            mStreamBatches.fetch_add(1);
+            proto::VehiclePropValueResultBatch results;
+            results.set_batch_id(batch.batch_id());
+            if (batch.has_get_requests()) {
+                EchoGetValues(batch.get_requests(), results.mutable_get_results());
+            } else {
+                EchoSetValues(batch.set_requests(), results.mutable_set_results());
+            }
+            stream->Write(results);
+        }
+        return ::grpc::Status::OK;
+    }
+
+    int unaryRequests() const { return mUnaryRequests.load(); }
+
+    int streamBatches() const { return mStreamBatches.load(); }
+
+  private:
+    static void EchoGetValues(const proto::VehiclePropValueRequests& requests,
+                              proto::GetValueResults* results) {
+        for (const auto& request : requests.requests()) {
+            auto& result = *results->add_results();
+            result.set_request_id(request.request_id());
+            result.set_status(proto::StatusCode::OK);
+            *result.mutable_value() = request.value();
+        }
+    }
+
+    static void EchoSetValues(const proto::VehiclePropValueRequests& requests,
+                              proto::SetValueResults* results) {
+        for (const auto& request : requests.requests()) {
+            auto& result = *results->add_results();
+            result.set_request_id(request.request_id());
+            result.set_status(proto::StatusCode::OK);
+        }
+    }
+
+    const bool mStreaming;
+    std::atomic<int> mUnaryRequests{0};
+    std::atomic<int> mStreamBatches{0};
+};
+
+std::unique_ptr<::grpc::Server> startServer(::grpc::Service* service) {
+    ::grpc::ServerBuilder builder;
+    builder.RegisterService(service);
+    builder.AddListeningPort(kFakeServerAddr, ::grpc::InsecureServerCredentials());
+    return builder.BuildAndStart();
+}
+
+// Gets the value of the property, retrying while the hardware is still connecting.
+std::optional<aidlvhal::GetValueResult> getValue(GRPCVehicleHardware* hardware, int32_t prop) {
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < kMaxWaitTime) {
+        auto promise = std::make_shared<std::promise<std::vector<aidlvhal::GetValueResult>>>();
+        auto future = promise->get_future();
+        auto status = hardware->getValues(
+                std::make_shared<const IVehicleHardware::GetValuesCallback>(
+                        [promise](std::vector<aidlvhal::GetValueResult> results) {
+                            promise->set_value(std::move(results));
+                        }),
+                {{.requestId = 1, .prop = {.prop = prop}}});
+        if (status == aidlvhal::StatusCode::TRY_AGAIN) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (status != aidlvhal::StatusCode::OK ||
+            future.wait_for(kMaxWaitTime) != std::future_status::ready) {
+            return std::nullopt;
+        }
+        auto results = future.get();
+        if (results.size() != 1) {
+            return std::nullopt;
+        }
+        return results[0];
+    }
+    return std::nullopt;
+}
+
+std::optional<aidlvhal::SetValueResult> setValue(GRPCVehicleHardware* hardware, int32_t prop) {
+    auto startTime = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - startTime < kMaxWaitTime) {
+        auto promise = std::make_shared<std::promise<std::vector<aidlvhal::SetValueResult>>>();
+        auto future = promise->get_future();
+        auto status = hardware->setValues(
+                std::make_shared<const IVehicleHardware::SetValuesCallback>(
+                        [promise](std::vector<aidlvhal::SetValueResult> results) {
+                            promise->set_value(std::move(results));
+                        }),
+                {{.requestId = 2, .value = {.prop = prop}}});
+        if (status == aidlvhal::StatusCode::TRY_AGAIN) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (status != aidlvhal::StatusCode::OK ||
+            future.wait_for(kMaxWaitTime) != std::future_status::ready) {
+            return std::nullopt;
+        }
+        auto results = future.get();
+        if (results.size() != 1) {
+            return std::nullopt;
+        }
+        return results[0];
+    }
+    return std::nullopt;
+}
+
+TEST(GRPCVehicleHardwareUnitTest, GetSetValuesOverStream) {
+    EchoVehicleServer fakeServer(/* streaming= */ true);
+    auto grpcServer = startServer(&fakeServer);
+    GRPCVehicleHardware vehicleHardware(kFakeServerAddr);
+
+    auto getResult = getValue(&vehicleHardware, /* prop= */ 123);
+    ASSERT_TRUE(getResult.has_value());
+    EXPECT_EQ(getResult->requestId, 1);
+    EXPECT_EQ(getResult->status, aidlvhal::StatusCode::OK);
+    ASSERT_TRUE(getResult->prop.has_value());
+    EXPECT_EQ(getResult->prop->prop, 123);
+
+    auto setResult = setValue(&vehicleHardware, /* prop= */ 123);
+    ASSERT_TRUE(setResult.has_value());
+    EXPECT_EQ(setResult->requestId, 2);
+    EXPECT_EQ(setResult->status, aidlvhal::StatusCode::OK);
+
+    EXPECT_EQ(fakeServer.streamBatches(), 2);
+    EXPECT_EQ(fakeServer.unaryRequests(), 0);
+
+    grpcServer->Shutdown();
+    grpcServer->Wait();
+}
+
+TEST(GRPCVehicleHardwareUnitTest, FallBackToUnaryCallsIfStreamUnimplemented) {
+    EchoVehicleServer fakeServer(/* streaming= */ false);
+    auto grpcServer = startServer(&fakeServer);
+    GRPCVehicleHardware vehicleHardware(kFakeServerAddr);
+
+    auto getResult = getValue(&vehicleHardware, /* prop= */ 123);
+    ASSERT_TRUE(getResult.has_value());
+    EXPECT_EQ(getResult->requestId, 1);
+    ASSERT_TRUE(getResult->prop.has_value());
+    EXPECT_EQ(getResult->prop->prop, 123);
+
+    auto setResult = setValue(&vehicleHardware, /* prop= */ 123);
+    ASSERT_TRUE(setResult.has_value());
+    EXPECT_EQ(setResult->requestId, 2);
+    EXPECT_EQ(setResult->status, aidlvhal::StatusCode::OK);
+
+    EXPECT_EQ(fakeServer.streamBatches(), 0);
+    EXPECT_EQ(fakeServer.unaryRequests(), 2);
+
+    grpcServer->Shutdown();
+    grpcServer->Wait();
+}
+
+TEST(GRPCVehicleHardwareUnitTest, StreamReconnectsAfterServerRestart) {
+    GRPCVehicleHardware vehicleHardware(kFakeServerAddr);
+    constexpr size_t kServerRestartTimes = 3;
+    for (size_t serverStart = 0; serverStart < kServerRestartTimes; ++serverStart) {
+        EchoVehicleServer fakeServer(/* streaming= */ true);
+        auto grpcServer = startServer(&fakeServer);
+
+        auto getResult = getValue(&vehicleHardware, /* prop= */ 123);
+        ASSERT_TRUE(getResult.has_value());
+        EXPECT_EQ(getResult->status, aidlvhal::StatusCode::OK);
+        EXPECT_EQ(fakeServer.streamBatches(), 1);
+
+        // Cancels the open stream, the hardware must reconnect to the next server.
+        grpcServer->Shutdown(std::chrono::system_clock::now());
+        grpcServer->Wait();
+    }
+}
+
 TEST(GRPCVehicleHardwareUnitTest, Reconnect) {
     auto receivedUpdate = std::make_shared<std::atomic<int>>(0);
     auto vehicleHardware = std::make_unique<GRPCVehicleHardware>(kFakeServerAddr);
@@ -76,7 +284,6 @@ TEST(GRPCVehicleHardwareUnitTest, Reconnect) {
 
         // Wait until the vehicle hardware received the second update (after one fake
         // disconnection).
-        constexpr auto kMaxWaitTime = std::chrono::seconds(5);
         auto startTime = std::chrono::steady_clock::now();
         while (receivedUpdate->load() <= 1 &&
                std::chrono::steady_clock::now() - startTime < kMaxWaitTime)
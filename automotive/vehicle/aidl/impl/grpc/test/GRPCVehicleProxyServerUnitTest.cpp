@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <thread>
@@ -46,16 +47,18 @@ class VehicleHardwareForTest : public IVehicleHardware {
         }
     }
 
-    // Functions that we do not care.
-    std::vector<aidl::android::hardware::automotive::vehicle::VehiclePropConfig>
-    getAllPropertyConfigs() const override {
-        return {};
-    }
-
+    // Answers every request with its own value.
     aidl::android::hardware::automotive::vehicle::StatusCode setValues(
             std::shared_ptr<const SetValuesCallback> callback,
             const std::vector<aidl::android::hardware::automotive::vehicle::SetValueRequest>&
                     requests) override {
+        std::vector<aidl::android::hardware::automotive::vehicle::SetValueResult> results;
+        for (const auto& request : requests) {
+            results.push_back({.requestId = request.requestId,
+                               .status = aidl::android::hardware::automotive::vehicle::
+                                       StatusCode::OK});
+        }
+        (*callback)(std::move(results));
         return aidl::android::hardware::automotive::vehicle::StatusCode::OK;
     }
 
@@ -63,9 +66,23 @@ class VehicleHardwareForTest : public IVehicleHardware {
             std::shared_ptr<const GetValuesCallback> callback,
             const std::vector<aidl::android::hardware::automotive::vehicle::GetValueRequest>&
                     requests) const override {
+        std::vector<aidl::android::hardware::automotive::vehicle::GetValueResult> results;
+        for (const auto& request : requests) {
+            results.push_back({.requestId = request.requestId,
+                               .status = aidl::android::hardware::automotive::vehicle::
+                                       StatusCode::OK,
+                               .prop = request.prop});
+        }
+        (*callback)(std::move(results));
         return aidl::android::hardware::automotive::vehicle::StatusCode::OK;
     }
 
+    // Functions that we do not care.
+    std::vector<aidl::android::hardware::automotive::vehicle::VehiclePropConfig>
+    getAllPropertyConfigs() const override {
+        return {};
+    }
+
     DumpResult dump(const std::vector<std::string>& options) override { return {}; }
 
     aidl::android::hardware::automotive::vehicle::StatusCode checkHealth() override {
@@ -144,4 +161,76 @@ TEST(GRPCVehicleProxyServerUnitTest, ClientConnectDisconnect) {
     vehicleServer->Shutdown().Wait();
 }
 
+TEST(GRPCVehicleProxyServerUnitTest, GetSetValuesOverStream) {
+    auto vehicleServer = std::make_unique<GrpcVehicleProxyServer>(
+            kFakeServerAddr, std::make_unique<VehicleHardwareForTest>());
+    vehicleServer->Start();
+
+    constexpr auto kWaitForConnectionMaxTime = std::chrono::seconds(5);
+    constexpr auto kWaitForResultsMaxTime = std::chrono::seconds(5);
+
+    auto vehicleHardware = std::make_unique<GRPCVehicleHardware>(kFakeServerAddr);
+    EXPECT_TRUE(vehicleHardware->waitForConnected(kWaitForConnectionMaxTime));
+
+    // The value request stream is opened in the background, retry until it is up.
+    std::promise<std::vector<aidl::android::hardware::automotive::vehicle::GetValueResult>>
+            getPromise;
+    auto getFuture = getPromise.get_future();
+    auto getCallback = std::make_shared<const IVehicleHardware::GetValuesCallback>(
+            [&getPromise](auto results) { getPromise.set_value(std::move(results)); });
+    aidl::android::hardware::automotive::vehicle::StatusCode status;
+    auto startTime = std::chrono::steady_clock::now();
+    do {
+        status = vehicleHardware->getValues(getCallback, {{.requestId = 1, .prop = {.prop = 1}}});
+    } while (status == aidl::android::hardware::automotive::vehicle::StatusCode::TRY_AGAIN &&
+             std::chrono::steady_clock::now() - startTime < kWaitForConnectionMaxTime);
+    ASSERT_EQ(status, aidl::android::hardware::automotive::vehicle::StatusCode::OK);
+    ASSERT_EQ(getFuture.wait_for(kWaitForResultsMaxTime), std::future_status::ready);
+    auto getResults = getFuture.get();
+    ASSERT_EQ(getResults.size(), 1u);
+    EXPECT_EQ(getResults[0].requestId, 1);
+    ASSERT_TRUE(getResults[0].prop.has_value());
+    EXPECT_EQ(getResults[0].prop->prop, 1);
+
+    std::promise<std::vector<aidl::android::hardware::automotive::vehicle::SetValueResult>>
+            setPromise;
+    auto setFuture = setPromise.get_future();
+    ASSERT_EQ(vehicleHardware->setValues(
+                      std::make_shared<const IVehicleHardware::SetValuesCallback>(
+                              [&setPromise](auto results) {
+                                  setPromise.set_value(std::move(results));
+                              }),
+                      {{.requestId = 2, .value = {.prop = 1}}}),
+              aidl::android::hardware::automotive::vehicle::StatusCode::OK);
+    ASSERT_EQ(setFuture.wait_for(kWaitForResultsMaxTime), std::future_status::ready);
+    auto setResults = setFuture.get();
+    ASSERT_EQ(setResults.size(), 1u);
+    EXPECT_EQ(setResults[0].requestId, 2);
+    EXPECT_EQ(setResults[0].status, aidl::android::hardware::automotive::vehicle::StatusCode::OK);
+
+    vehicleHardware.reset();
+    vehicleServer->Shutdown().Wait();
+}
+
+TEST(GRPCVehicleProxyServerUnitTest, ShutdownWithConnectedClient) {
+    auto vehicleServer = std::make_unique<GrpcVehicleProxyServer>(
+            kFakeServerAddr, std::make_unique<VehicleHardwareForTest>());
+    vehicleServer->Start();
+
+    constexpr auto kWaitForConnectionMaxTime = std::chrono::seconds(5);
+    constexpr auto kWaitForStreamStartTime = std::chrono::seconds(1);
+    constexpr auto kShutdownMaxTime = std::chrono::seconds(5);
+
+    // The client keeps its property value and value request streams open.
+    auto vehicleHardware = std::make_unique<GRPCVehicleHardware>(kFakeServerAddr);
+    EXPECT_TRUE(vehicleHardware->waitForConnected(kWaitForConnectionMaxTime));
+    std::this_thread::sleep_for(kWaitForStreamStartTime);
+
+    auto shutdown = std::async(std::launch::async,
+                               [&vehicleServer] { vehicleServer->Shutdown().Wait(); });
+    EXPECT_EQ(shutdown.wait_for(kShutdownMaxTime), std::future_status::ready);
+    // Only reset the client after the shutdown, so it does not end its streams by itself.
+    vehicleHardware.reset();
+}
+
 }  // namespace android::hardware::automotive::vehicle::virtualization
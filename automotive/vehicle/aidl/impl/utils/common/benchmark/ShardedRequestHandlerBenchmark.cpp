@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShardedRequestHandler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+namespace {
+
+// Stands for a property whose handler is slow, e.g. one served by a slow vehicle bus.
+constexpr int32_t kSlowPropId = 0;
+constexpr auto kSlowRequestTime = std::chrono::milliseconds(1);
+constexpr int32_t kFastPropCount = 8;
+
+struct Request {
+    int32_t propId;
+};
+
+using Handler = ShardedRequestHandler<Request, int32_t>;
+using Clock = std::chrono::steady_clock;
+
+class Waiter {
+  public:
+    void done(size_t count) {
+        {
+            std::scoped_lock<std::mutex> lockGuard(mLock);
+            mDone += count;
+        }
+        mCv.notify_all();
+    }
+
+    void waitFor(size_t count) {
+        std::unique_lock<std::mutex> lk(mLock);
+        mCv.wait(lk, [this, count] { return mDone >= count; });
+        mDone -= count;
+    }
+
+  private:
+    std::mutex mLock;
+    std::condition_variable mCv;
+    size_t mDone = 0;
+};
+
+// Sends a request to a slow property followed by requests to fast properties and measures how long
+// the fast requests take on average. With a single worker, as FakeVehicleHardware used to have,
+// all of them wait for the slow one; with more workers only the ones sharing its worker do.
+void BM_FastRequestLatencyWithSlowRequest(benchmark::State& state) {
+    std::mutex latencyLock;
+    Clock::time_point start;
+    Clock::duration totalFastLatency{};
+    Handler handler(
+            state.range(0),
+            [](const Request& request) {
+                if (request.propId == kSlowPropId) {
+                    std::this_thread::sleep_for(kSlowRequestTime);
+                }
+                return request.propId;
+            },
+            [](const Request& request) { return request.propId; });
+    Waiter waiter;
+    auto callback = std::make_shared<const Handler::Callback>([&](std::vector<int32_t> results) {
+        size_t fast = 0;
+        for (int32_t propId : results) {
+            if (propId != kSlowPropId) fast++;
+        }
+        {
+            std::scoped_lock<std::mutex> lockGuard(latencyLock);
+            totalFastLatency += (Clock::now() - start) * fast;
+        }
+        waiter.done(results.size());
+    });
+
+    for (auto _ : state) {
+        start = Clock::now();
+        handler.addRequest({.propId = kSlowPropId}, callback);
+        for (int32_t propId = 1; propId <= kFastPropCount; propId++) {
+            handler.addRequest({.propId = propId}, callback);
+        }
+        waiter.waitFor(kFastPropCount + 1);
+    }
+    state.counters["fast_request_latency_us"] =
+            std::chrono::duration<double, std::micro>(totalFastLatency).count() /
+            (state.iterations() * kFastPropCount);
+}
+BENCHMARK(BM_FastRequestLatencyWithSlowRequest)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// Measures the overhead of handling fast requests only.
+void BM_FastRequestThroughput(benchmark::State& state) {
+    Handler handler(
+            state.range(0), [](const Request& request) { return request.propId; },
+            [](const Request& request) { return request.propId; });
+    Waiter waiter;
+    auto callback = std::make_shared<const Handler::Callback>(
+            [&waiter](std::vector<int32_t> results) { waiter.done(results.size()); });
+
+    for (auto _ : state) {
+        for (int32_t propId = 1; propId <= kFastPropCount; propId++) {
+            handler.addRequest({.propId = propId}, callback);
+        }
+        waiter.waitFor(kFastPropCount);
+    }
+    state.SetItemsProcessed(state.iterations() * kFastPropCount);
+}
+BENCHMARK(BM_FastRequestThroughput)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+}  // namespace
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
+
+BENCHMARK_MAIN();
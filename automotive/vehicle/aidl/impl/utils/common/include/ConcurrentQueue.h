@@ -24,6 +24,7 @@
 #include <iostream>
 #include <queue>
 #include <thread>
+#include <vector>
 
 namespace android {
 namespace hardware {
@@ -58,6 +59,16 @@ class ConcurrentQueue {
         return items;
     }
 
+    // Same as flush(), but appends the items to the given vector so that the caller could reuse
+    // its storage.
+    void flush(std::vector<T>* items) {
+        std::scoped_lock<std::mutex> lockGuard(mLock);
+        while (!mQueue.empty()) {
+            items->push_back(std::move(mQueue.front()));
+            mQueue.pop();
+        }
+    }
+
     void push(T&& item) {
         {
             std::scoped_lock<std::mutex> lockGuard(mLock);
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef android_hardware_automotive_vehicle_aidl_impl_utils_common_include_ShardedRequestHandler_H_
+#define android_hardware_automotive_vehicle_aidl_impl_utils_common_include_ShardedRequestHandler_H_
+
+#include "ConcurrentQueue.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+// A thread-safe handler that handles requests asynchronously on a fixed number of worker threads.
+//
+// Each request is assigned to a worker by its shard key, e.g. its property ID. Requests with the
+// same shard key are handled by the same worker in the order they are added, requests with
+// different shard keys might be handled in parallel, so a slow request only delays the requests
+// that share its worker.
+//
+// A worker handles all the requests that are pending when it wakes up as one batch and delivers
+// the results of the batch with one call per callback.
+template <class RequestType, class ResultType>
+class ShardedRequestHandler final {
+  public:
+    using Callback = std::function<void(std::vector<ResultType>)>;
+    using HandleRequestFunc = std::function<ResultType(const RequestType&)>;
+    using ShardKeyFunc = std::function<int32_t(const RequestType&)>;
+
+    ShardedRequestHandler(size_t workerCount, HandleRequestFunc handleRequestFunc,
+                          ShardKeyFunc shardKeyFunc)
+        : mHandleRequestFunc(std::move(handleRequestFunc)),
+          mShardKeyFunc(std::move(shardKeyFunc)) {
+        workerCount = std::max<size_t>(workerCount, 1);
+        for (size_t i = 0; i < workerCount; i++) {
+            mWorkers.push_back(std::make_unique<Worker>());
+        }
+        // Start the threads after all the workers are created since mWorkers is not guarded.
+        for (auto& worker : mWorkers) {
+            worker->thread = std::thread([this, w = worker.get()] { handleRequests(w); });
+        }
+    }
+
+    ~ShardedRequestHandler() { stop(); }
+
+    ShardedRequestHandler(const ShardedRequestHandler&) = delete;
+    ShardedRequestHandler& operator=(const ShardedRequestHandler&) = delete;
+
+    void addRequest(RequestType request, std::shared_ptr<const Callback> callback) {
+        const uint32_t key = static_cast<uint32_t>(mShardKeyFunc(request));
+        mWorkers[key % mWorkers.size()]->requests.push({
+                std::move(request),
+                std::move(callback),
+        });
+    }
+
+    // Stops all the workers. Requests that are not handled yet are dropped.
+    void stop() {
+        for (auto& worker : mWorkers) {
+            worker->requests.deactivate();
+        }
+        for (auto& worker : mWorkers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    size_t getWorkerCount() const { return mWorkers.size(); }
+
+  private:
+    struct RequestWithCallback {
+        RequestType request;
+        std::shared_ptr<const Callback> callback;
+    };
+
+    struct Worker {
+        ConcurrentQueue<RequestWithCallback> requests;
+        std::thread thread;
+    };
+
+    const HandleRequestFunc mHandleRequestFunc;
+    const ShardKeyFunc mShardKeyFunc;
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    void handleRequests(Worker* worker) {
+        // Both are reused across batches. A batch usually comes from one or two callbacks, so a
+        // linear search is cheaper than a map.
+        std::vector<RequestWithCallback> batch;
+        std::vector<std::pair<std::shared_ptr<const Callback>, std::vector<ResultType>>>
+                resultsByCallback;
+        while (worker->requests.waitForItems()) {
+            worker->requests.flush(&batch);
+            for (const auto& [request, callback] : batch) {
+                auto it = std::find_if(resultsByCallback.begin(), resultsByCallback.end(),
+                                       [&callback](const auto& p) { return p.first == callback; });
+                if (it == resultsByCallback.end()) {
+                    it = resultsByCallback.emplace(resultsByCallback.end(), callback,
+                                                   std::vector<ResultType>());
+                    it->second.reserve(batch.size());
+                }
+                it->second.push_back(mHandleRequestFunc(request));
+            }
+            batch.clear();
+            for (auto& [callback, results] : resultsByCallback) {
+                (*callback)(std::move(results));
+            }
+            resultsByCallback.clear();
+        }
+    }
+};
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
+
+#endif  // android_hardware_automotive_vehicle_aidl_impl_utils_common_include_ShardedRequestHandler_H_
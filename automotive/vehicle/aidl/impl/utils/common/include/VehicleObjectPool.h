@@ -17,14 +17,16 @@
 #ifndef android_hardware_automotive_vehicle_utils_include_VehicleObjectPool_H_
 #define android_hardware_automotive_vehicle_utils_include_VehicleObjectPool_H_
 
-#include <deque>
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <memory>
-#include <mutex>
+#include <string>
 
 #include <VehicleHalTypes.h>
-
-#include <android-base/thread_annotations.h>
+#include <VehicleUtils.h>
 
 namespace android {
 namespace hardware {
@@ -68,31 +70,60 @@ using recyclable_ptr = typename std::unique_ptr<T, Deleter<T>>;
 
 // Generic abstract object pool class. Users of this class must implement {@Code createObject}.
 //
-// This class is thread-safe. Concurrent calls to {@Code obtain} from multiple threads is OK, also
-// client can obtain an object in one thread and then move ownership to another thread.
+// This class is thread-safe and lock-free. Concurrent calls to {@Code obtain} from multiple
+// threads is OK, also client can obtain an object in one thread and then move ownership to
+// another thread.
+//
+// Pooled objects are kept in a fixed array of nodes which are linked into two lock-free stacks: one
+// of the nodes holding an object and one of the free nodes. The pool holds objects of objectSize
+// bytes, as returned by {@Code getSizeFunc}, and has room for maxPoolObjectsSize / objectSize of
+// them. Objects of any other size are not recycled.
 template <typename T>
 class ObjectPool {
   public:
     using GetSizeFunc = std::function<size_t(const T&)>;
 
-    ObjectPool(size_t maxPoolObjectsSize, GetSizeFunc getSizeFunc)
-        : mMaxPoolObjectsSize(maxPoolObjectsSize), mGetSizeFunc(getSizeFunc){};
-    virtual ~ObjectPool() = default;
+    ObjectPool(size_t maxPoolObjectsSize, GetSizeFunc getSizeFunc, size_t objectSize = sizeof(T))
+        : mMaxPoolObjectsSize(maxPoolObjectsSize),
+          mGetSizeFunc(getSizeFunc),
+          mObjectSize(objectSize),
+          mCapacity(std::min<size_t>(maxPoolObjectsSize / std::max<size_t>(objectSize, 1),
+                                     kNoNode)),
+          mNodes(new Node[mCapacity]) {
+        for (size_t i = 0; i < mCapacity; i++) {
+            mNodes[i].next.store(i + 1 < mCapacity ? static_cast<uint32_t>(i + 1) : kNoNode,
+                                 std::memory_order_relaxed);
+        }
+        mFreeHead.store(mCapacity > 0 ? 0 : kNoNode, std::memory_order_relaxed);
+    }
+
+    virtual ~ObjectPool() {
+        uint32_t index;
+        while (popNode(&mObjectHead, &index)) {
+            delete mNodes[index].object;
+        }
+    }
 
     virtual recyclable_ptr<T> obtain() {
-        std::scoped_lock<std::mutex> lock(mLock);
         INC_METRIC_IF_DEBUG(Obtained)
-        if (mObjects.empty()) {
+        uint32_t index;
+        if (!popNode(&mObjectHead, &index)) {
             INC_METRIC_IF_DEBUG(Created)
+            mMissCount.fetch_add(1, std::memory_order_relaxed);
             return wrap(createObject());
         }
-
-        auto o = wrap(mObjects.front().release());
-        mObjects.pop_front();
-        mPoolObjectsSize -= mGetSizeFunc(*o);
-        return o;
+        T* o = mNodes[index].object;
+        pushNode(&mFreeHead, index);
+        mHitCount.fetch_add(1, std::memory_order_relaxed);
+        return wrap(o);
     }
 
+    // The number of obtained objects that were reused from the pool.
+    uint64_t getHitCount() const { return mHitCount.load(std::memory_order_relaxed); }
+
+    // The number of obtained objects that had to be created.
+    uint64_t getMissCount() const { return mMissCount.load(std::memory_order_relaxed); }
+
     ObjectPool& operator=(const ObjectPool&) = delete;
     ObjectPool(const ObjectPool&) = delete;
 
@@ -100,11 +131,8 @@ class ObjectPool {
     virtual T* createObject() = 0;
 
     virtual void recycle(T* o) {
-        std::scoped_lock<std::mutex> lock(mLock);
-        size_t objectSize = mGetSizeFunc(*o);
-
-        if (objectSize > mMaxPoolObjectsSize ||
-            mPoolObjectsSize > mMaxPoolObjectsSize - objectSize) {
+        uint32_t index;
+        if (mGetSizeFunc(*o) != mObjectSize || !popNode(&mFreeHead, &index)) {
             INC_METRIC_IF_DEBUG(Deleted)
 
             // We have no space left in the pool.
@@ -114,29 +142,64 @@ class ObjectPool {
 
         INC_METRIC_IF_DEBUG(Recycled)
 
-        mObjects.push_back(std::unique_ptr<T>{o});
-        mPoolObjectsSize += objectSize;
+        mNodes[index].object = o;
+        pushNode(&mObjectHead, index);
     }
 
     const size_t mMaxPoolObjectsSize;
 
   private:
-    const Deleter<T>& getDeleter() {
-        if (!mDeleter.get()) {
-            Deleter<T>* d =
-                    new Deleter<T>(std::bind(&ObjectPool::recycle, this, std::placeholders::_1));
-            mDeleter.reset(d);
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+
+    struct Node {
+        std::atomic<uint32_t> next;
+        T* object = nullptr;
+    };
+
+    // A stack head is the index of its top node in the low 32 bits and a counter in the high 32
+    // bits, which is bumped on every change so that a stale head never compares equal.
+    static uint64_t makeHead(uint64_t oldHead, uint32_t index) {
+        return (((oldHead >> 32) + 1) << 32) | index;
+    }
+
+    bool popNode(std::atomic<uint64_t>* head, uint32_t* index) {
+        uint64_t oldHead = head->load(std::memory_order_acquire);
+        while (true) {
+            uint32_t top = static_cast<uint32_t>(oldHead);
+            if (top == kNoNode) {
+                return false;
+            }
+            uint32_t next = mNodes[top].next.load(std::memory_order_relaxed);
+            if (head->compare_exchange_weak(oldHead, makeHead(oldHead, next),
+                                            std::memory_order_acquire)) {
+                *index = top;
+                return true;
+            }
         }
-        return *mDeleter.get();
     }
 
-    recyclable_ptr<T> wrap(T* raw) { return recyclable_ptr<T>{raw, getDeleter()}; }
+    void pushNode(std::atomic<uint64_t>* head, uint32_t index) {
+        uint64_t oldHead = head->load(std::memory_order_relaxed);
+        do {
+            mNodes[index].next.store(static_cast<uint32_t>(oldHead), std::memory_order_relaxed);
+        } while (!head->compare_exchange_weak(oldHead, makeHead(oldHead, index),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
 
-    mutable std::mutex mLock;
-    std::deque<std::unique_ptr<T>> mObjects GUARDED_BY(mLock);
-    std::unique_ptr<Deleter<T>> mDeleter;
-    size_t mPoolObjectsSize GUARDED_BY(mLock);
-    GetSizeFunc mGetSizeFunc;
+    recyclable_ptr<T> wrap(T* raw) { return recyclable_ptr<T>{raw, mDeleter}; }
+
+    const GetSizeFunc mGetSizeFunc;
+    const size_t mObjectSize;
+    const size_t mCapacity;
+    const std::unique_ptr<Node[]> mNodes;
+    const Deleter<T> mDeleter{[this](T* o) { recycle(o); }};
+    // Every obtain and recycle writes both heads, so they are kept off the cache line of the
+    // read-only members above.
+    alignas(64) std::atomic<uint64_t> mObjectHead{kNoNode};
+    alignas(64) std::atomic<uint64_t> mFreeHead{kNoNode};
+    std::atomic<uint64_t> mHitCount{0};
+    std::atomic<uint64_t> mMissCount{0};
 };
 
 #undef INC_METRIC_IF_DEBUG
@@ -180,9 +243,9 @@ class VehiclePropValuePool {
     // @param maxPoolObjectsSize - The approximate upper bound of memory each internal recycling
     // pool could take. We have 4 different type pools, each with 4 different vector size, so
     // approximately this pool would at-most take 4 * 4 * 10240 = 160k memory.
-    VehiclePropValuePool(size_t maxRecyclableVectorSize = 4, size_t maxPoolObjectsSize = 10240)
-        : mMaxRecyclableVectorSize(maxRecyclableVectorSize),
-          mMaxPoolObjectsSize(maxPoolObjectsSize){};
+    VehiclePropValuePool(size_t maxRecyclableVectorSize = 4, size_t maxPoolObjectsSize = 10240);
+
+    ~VehiclePropValuePool();
 
     // Obtain a recyclable VehiclePropertyValue object from the pool for the given type. If the
     // given type is not MIXED or STRING, the internal value vector size would be set to 1.
@@ -215,6 +278,10 @@ class VehiclePropValuePool {
     // Obtain a recyclable mixed object.
     RecyclableType obtainComplex();
 
+    // Returns the pool hit rate, overall and for each type and vector size, in a human readable
+    // format.
+    std::string dump() const;
+
     VehiclePropValuePool(VehiclePropValuePool&) = delete;
     VehiclePropValuePool& operator=(VehiclePropValuePool&) = delete;
 
@@ -233,9 +300,13 @@ class VehiclePropValuePool {
                type == aidl::android::hardware::automotive::vehicle::VehiclePropertyType::STRING;
     }
 
+    // Values of types without a pool, including values outside of VehiclePropertyType, are never
+    // recycled.
     bool isDisposable(aidl::android::hardware::automotive::vehicle::VehiclePropertyType type,
                       size_t vectorSize) const {
-        return vectorSize > mMaxRecyclableVectorSize || isComplexType(type);
+        return vectorSize > mMaxRecyclableVectorSize || isComplexType(type) ||
+               std::find(std::begin(kRecyclableTypes), std::end(kRecyclableTypes), type) ==
+                       std::end(kRecyclableTypes);
     }
 
     RecyclableType obtainDisposable(
@@ -245,13 +316,32 @@ class VehiclePropValuePool {
             aidl::android::hardware::automotive::vehicle::VehiclePropertyType type,
             size_t vectorSize);
 
+    // The types whose values could be recycled, i.e. the types with a fixed vector size.
+    static constexpr aidl::android::hardware::automotive::vehicle::VehiclePropertyType
+            kRecyclableTypes[] = {
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::BOOLEAN,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::INT32,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::INT32_VEC,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::INT64,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::INT64_VEC,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::FLOAT,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::FLOAT_VEC,
+                    aidl::android::hardware::automotive::vehicle::VehiclePropertyType::BYTES,
+            };
+    static constexpr size_t kRecyclableTypeCount = std::size(kRecyclableTypes);
+
+    // Returns the index of the pool for the type and vector size in mValueTypePools.
+    size_t getPoolIndex(aidl::android::hardware::automotive::vehicle::VehiclePropertyType type,
+                        size_t vectorSize) const;
+
     class InternalPool
         : public ObjectPool<aidl::android::hardware::automotive::vehicle::VehiclePropValue> {
       public:
         InternalPool(aidl::android::hardware::automotive::vehicle::VehiclePropertyType type,
                      size_t vectorSize, size_t maxPoolObjectsSize,
                      ObjectPool::GetSizeFunc getSizeFunc)
-            : ObjectPool(maxPoolObjectsSize, getSizeFunc),
+            : ObjectPool(maxPoolObjectsSize, getSizeFunc,
+                         getSizeFunc(*createVehiclePropValueVec(type, vectorSize))),
               mPropType(type),
               mVectorSize(vectorSize) {}
 
@@ -277,12 +367,14 @@ class VehiclePropValuePool {
                         delete v;
                     }};
 
-    mutable std::mutex mLock;
     const size_t mMaxRecyclableVectorSize;
     const size_t mMaxPoolObjectsSize;
-    // A map with 'property_type' | 'value_vector_size' as key and a recyclable object pool as
-    // value. We would create a recyclable pool for each property type and vector size combination.
-    std::map<int32_t, std::unique_ptr<InternalPool>> mValueTypePools GUARDED_BY(mLock);
+    // A recyclable object pool for each recyclable property type and vector size combination, in
+    // the order of kRecyclableTypes and then vector size. A pool is created on first use, so
+    // lookups do not need a lock.
+    const std::unique_ptr<std::atomic<InternalPool*>[]> mValueTypePools;
+    // The number of values obtained that could not be recycled.
+    mutable std::atomic<uint64_t> mDisposableCount{0};
 };
 
 }  // namespace vehicle
@@ -20,7 +20,9 @@
 
 #include <VehicleUtils.h>
 
+#include <android-base/stringprintf.h>
 #include <assert.h>
+#include <inttypes.h>
 #include <utils/Log.h>
 
 namespace android {
@@ -32,6 +34,33 @@ using ::aidl::android::hardware::automotive::vehicle::RawPropValues;
 using ::aidl::android::hardware::automotive::vehicle::VehicleProperty;
 using ::aidl::android::hardware::automotive::vehicle::VehiclePropertyType;
 using ::aidl::android::hardware::automotive::vehicle::VehiclePropValue;
+using ::android::base::StringAppendF;
+using ::android::base::StringPrintf;
+
+namespace {
+
+double getHitRatePercent(uint64_t hits, uint64_t misses) {
+    return hits + misses == 0 ? 0.0 : 100.0 * hits / (hits + misses);
+}
+
+}  // namespace
+
+VehiclePropValuePool::VehiclePropValuePool(size_t maxRecyclableVectorSize,
+                                           size_t maxPoolObjectsSize)
+    : mMaxRecyclableVectorSize(maxRecyclableVectorSize),
+      mMaxPoolObjectsSize(maxPoolObjectsSize),
+      mValueTypePools(new std::atomic<InternalPool*>[kRecyclableTypeCount *
+                                                     (maxRecyclableVectorSize + 1)]) {
+    for (size_t i = 0; i < kRecyclableTypeCount * (mMaxRecyclableVectorSize + 1); i++) {
+        mValueTypePools[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+VehiclePropValuePool::~VehiclePropValuePool() {
+    for (size_t i = 0; i < kRecyclableTypeCount * (mMaxRecyclableVectorSize + 1); i++) {
+        delete mValueTypePools[i].load(std::memory_order_acquire);
+    }
+}
 
 VehiclePropValuePool::RecyclableType VehiclePropValuePool::obtain(VehiclePropertyType type) {
     if (isComplexType(type)) {
@@ -101,21 +130,27 @@ VehiclePropValuePool::RecyclableType VehiclePropValuePool::obtainComplex() {
     return obtain(VehiclePropertyType::MIXED);
 }
 
+size_t VehiclePropValuePool::getPoolIndex(VehiclePropertyType type, size_t vectorSize) const {
+    size_t typeIndex = std::find(std::begin(kRecyclableTypes), std::end(kRecyclableTypes), type) -
+                       std::begin(kRecyclableTypes);
+    return typeIndex * (mMaxRecyclableVectorSize + 1) + vectorSize;
+}
+
 VehiclePropValuePool::RecyclableType VehiclePropValuePool::obtainRecyclable(
         VehiclePropertyType type, size_t vectorSize) {
-    std::scoped_lock<std::mutex> lock(mLock);
     assert(vectorSize > 0);
 
-    // VehiclePropertyType is not overlapping with vectorSize.
-    int32_t key = static_cast<int32_t>(type) | static_cast<int32_t>(vectorSize);
-    auto it = mValueTypePools.find(key);
-
-    if (it == mValueTypePools.end()) {
-        auto newPool(std::make_unique<InternalPool>(type, vectorSize, mMaxPoolObjectsSize,
-                                                    getVehiclePropValueSize));
-        it = mValueTypePools.emplace(key, std::move(newPool)).first;
+    std::atomic<InternalPool*>& slot = mValueTypePools[getPoolIndex(type, vectorSize)];
+    InternalPool* pool = slot.load(std::memory_order_acquire);
+    if (pool == nullptr) {
+        auto newPool = std::make_unique<InternalPool>(type, vectorSize, mMaxPoolObjectsSize,
+                                                      getVehiclePropValueSize);
+        // If another thread created the pool first, use that one instead.
+        if (slot.compare_exchange_strong(pool, newPool.get(), std::memory_order_acq_rel)) {
+            pool = newPool.release();
+        }
     }
-    return it->second->obtain();
+    return pool->obtain();
 }
 
 VehiclePropValuePool::RecyclableType VehiclePropValuePool::obtainBoolean(bool value) {
@@ -124,10 +159,39 @@ VehiclePropValuePool::RecyclableType VehiclePropValuePool::obtainBoolean(bool va
 
 VehiclePropValuePool::RecyclableType VehiclePropValuePool::obtainDisposable(
         VehiclePropertyType valueType, size_t vectorSize) const {
+    mDisposableCount.fetch_add(1, std::memory_order_relaxed);
     return RecyclableType{createVehiclePropValueVec(valueType, vectorSize).release(),
                           mDisposableDeleter};
 }
 
+std::string VehiclePropValuePool::dump() const {
+    uint64_t totalHits = 0;
+    uint64_t totalMisses = 0;
+    std::string perPool;
+    for (VehiclePropertyType type : kRecyclableTypes) {
+        for (size_t vectorSize = 1; vectorSize <= mMaxRecyclableVectorSize; vectorSize++) {
+            const InternalPool* pool =
+                    mValueTypePools[getPoolIndex(type, vectorSize)].load(std::memory_order_acquire);
+            if (pool == nullptr) {
+                continue;
+            }
+            uint64_t hits = pool->getHitCount();
+            uint64_t misses = pool->getMissCount();
+            totalHits += hits;
+            totalMisses += misses;
+            StringAppendF(&perPool, "  %s[%zu]: %" PRIu64 " obtained, %.1f%% hit rate\n",
+                          toString(type).c_str(), vectorSize, hits + misses,
+                          getHitRatePercent(hits, misses));
+        }
+    }
+    std::string msg = StringPrintf(
+            "VehiclePropValuePool: %" PRIu64 " recyclable values obtained, %.1f%% hit rate, "
+            "%" PRIu64 " non-recyclable values obtained\n",
+            totalHits + totalMisses, getHitRatePercent(totalHits, totalMisses),
+            mDisposableCount.load(std::memory_order_relaxed));
+    return msg + perPool;
+}
+
 void VehiclePropValuePool::InternalPool::recycle(VehiclePropValue* o) {
     if (o == nullptr) {
         ALOGE("Attempt to recycle nullptr");
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShardedRequestHandler.h"
+
+#include <android-base/thread_annotations.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace android {
+namespace hardware {
+namespace automotive {
+namespace vehicle {
+
+namespace {
+
+using ::android::base::ScopedLockAssertion;
+using std::chrono::milliseconds;
+
+struct TestRequest {
+    int32_t key;
+    int32_t value;
+};
+
+using TestHandler = ShardedRequestHandler<TestRequest, TestRequest>;
+
+}  // namespace
+
+class ShardedRequestHandlerTest : public testing::Test {
+  public:
+    std::shared_ptr<const TestHandler::Callback> getCallback() {
+        return std::make_shared<const TestHandler::Callback>(
+                [this](std::vector<TestRequest> results) {
+                    std::scoped_lock<std::mutex> lockGuard(mLock);
+                    mCallbackCount++;
+                    for (const auto& result : results) {
+                        mResults[result.key].push_back(result.value);
+                    }
+                    mCv.notify_all();
+                });
+    }
+
+    bool waitForResults(size_t count) {
+        std::unique_lock<std::mutex> lk(mLock);
+        return mCv.wait_for(lk, milliseconds(1000), [this, count] {
+            ScopedLockAssertion lockAssertion(mLock);
+            size_t total = 0;
+            for (const auto& [_, values] : mResults) {
+                total += values.size();
+            }
+            return total >= count;
+        });
+    }
+
+    std::map<int32_t, std::vector<int32_t>> getResults() {
+        std::scoped_lock<std::mutex> lockGuard(mLock);
+        return mResults;
+    }
+
+    size_t getCallbackCount() {
+        std::scoped_lock<std::mutex> lockGuard(mLock);
+        return mCallbackCount;
+    }
+
+  private:
+    std::mutex mLock;
+    std::condition_variable mCv;
+    std::map<int32_t, std::vector<int32_t>> mResults GUARDED_BY(mLock);
+    size_t mCallbackCount GUARDED_BY(mLock) = 0;
+};
+
+TEST_F(ShardedRequestHandlerTest, testRequestsWithSameKeyInOrder) {
+    TestHandler handler(
+            /*workerCount=*/4, [](const TestRequest& request) { return request; },
+            [](const TestRequest& request) { return request.key; });
+    auto callback = getCallback();
+
+    for (int32_t value = 0; value < 100; value++) {
+        for (int32_t key = 0; key < 8; key++) {
+            handler.addRequest({.key = key, .value = value}, callback);
+        }
+    }
+
+    ASSERT_TRUE(waitForResults(800));
+    auto results = getResults();
+    ASSERT_EQ(results.size(), 8u);
+    for (const auto& [key, values] : results) {
+        ASSERT_EQ(values.size(), 100u) << "key: " << key;
+        for (int32_t value = 0; value < 100; value++) {
+            ASSERT_EQ(values[value], value) << "key: " << key;
+        }
+    }
+}
+
+TEST_F(ShardedRequestHandlerTest, testSlowRequestDoesNotBlockOtherShards) {
+    std::mutex blockLock;
+    std::condition_variable blockCv;
+    bool unblocked = false;
+    TestHandler handler(
+            /*workerCount=*/2,
+            [&](const TestRequest& request) {
+                if (request.key == 0) {
+                    std::unique_lock<std::mutex> lk(blockLock);
+                    blockCv.wait(lk, [&] { return unblocked; });
+                }
+                return request;
+            },
+            [](const TestRequest& request) { return request.key; });
+    auto callback = getCallback();
+
+    handler.addRequest({.key = 0, .value = 0}, callback);
+    handler.addRequest({.key = 1, .value = 1}, callback);
+
+    // The request with key 1 is handled while the one with key 0 is still blocked.
+    bool gotResult = waitForResults(1);
+    auto results = getResults();
+    {
+        std::scoped_lock<std::mutex> lockGuard(blockLock);
+        unblocked = true;
+    }
+    blockCv.notify_all();
+
+    ASSERT_TRUE(gotResult);
+    ASSERT_EQ(results, (std::map<int32_t, std::vector<int32_t>>{{1, {1}}}));
+    ASSERT_TRUE(waitForResults(2));
+}
+
+TEST_F(ShardedRequestHandlerTest, testResultsBatchedPerCallback) {
+    std::mutex blockLock;
+    std::condition_variable blockCv;
+    bool unblocked = false;
+    TestHandler handler(
+            /*workerCount=*/1,
+            [&](const TestRequest& request) {
+                if (request.value == 0) {
+                    std::unique_lock<std::mutex> lk(blockLock);
+                    blockCv.wait(lk, [&] { return unblocked; });
+                }
+                return request;
+            },
+            [](const TestRequest& request) { return request.key; });
+    auto callback = getCallback();
+
+    // The worker is blocked on the first request while the rest are queued up.
+    handler.addRequest({.key = 0, .value = 0}, callback);
+    for (int32_t value = 1; value <= 10; value++) {
+        handler.addRequest({.key = 0, .value = value}, callback);
+    }
+    {
+        std::scoped_lock<std::mutex> lockGuard(blockLock);
+        unblocked = true;
+    }
+    blockCv.notify_all();
+
+    ASSERT_TRUE(waitForResults(11));
+    // Requests queued up while the worker is busy are delivered together.
+    ASSERT_LE(getCallbackCount(), 2u);
+}
+
+TEST_F(ShardedRequestHandlerTest, testStop) {
+    TestHandler handler(
+            /*workerCount=*/4, [](const TestRequest& request) { return request; },
+            [](const TestRequest& request) { return request.key; });
+    auto callback = getCallback();
+
+    handler.stop();
+    handler.addRequest({.key = 0, .value = 0}, callback);
+
+    ASSERT_FALSE(waitForResults(1));
+}
+
+TEST_F(ShardedRequestHandlerTest, testAtLeastOneWorker) {
+    TestHandler handler(
+            /*workerCount=*/0, [](const TestRequest& request) { return request; },
+            [](const TestRequest& request) { return request.key; });
+
+    ASSERT_EQ(handler.getWorkerCount(), 1u);
+}
+
+}  // namespace vehicle
+}  // namespace automotive
+}  // namespace hardware
+}  // namespace android
@@ -187,6 +187,15 @@ TEST_F(VehicleObjectPoolTest, testObtainNewObject) {
     ASSERT_EQ(mStats->Created, 2u);
 }
 
+TEST_F(VehicleObjectPoolTest, testObtainUnknownType) {
+    // Not a VehiclePropertyType, must not be looked up in the pools.
+    auto value = mValuePool->obtain(static_cast<VehiclePropertyType>(0x00f00000), 1);
+
+    ASSERT_EQ(value, nullptr);
+    ASSERT_EQ(mStats->Obtained, 0u);
+    ASSERT_EQ(mStats->Created, 0u);
+}
+
 TEST_F(VehicleObjectPoolTest, testObtainStrings) {
     mValuePool->obtain(VehiclePropertyType::STRING);
     auto stringProp = mValuePool->obtain(VehiclePropertyType::STRING);
@@ -375,6 +384,22 @@ TEST_F(VehicleObjectPoolTest, testMemoryLimitation) {
                                       "values are in the pool";
 }
 
+TEST_F(VehicleObjectPoolTest, testDumpHitRate) {
+    // The first value has to be created, the next three are recycled from the pool.
+    for (size_t i = 0; i < 4; i++) {
+        mValuePool->obtain(VehiclePropertyType::INT32);
+    }
+    mValuePool->obtain(VehiclePropertyType::STRING);
+
+    std::string dump = mValuePool->dump();
+
+    ASSERT_NE(dump.find("4 recyclable values obtained, 75.0% hit rate, "
+                        "1 non-recyclable values obtained"),
+              std::string::npos)
+            << dump;
+    ASSERT_NE(dump.find("INT32[1]: 4 obtained, 75.0% hit rate"), std::string::npos) << dump;
+}
+
 }  // namespace vehicle
 }  // namespace automotive
 }  // namespace hardware
@@ -45,6 +45,11 @@ inline constexpr std::chrono::milliseconds kSeekDelayTimeMs = 200ms;
 inline constexpr std::chrono::milliseconds kStepDelayTimeMs = 100ms;
 inline constexpr std::chrono::milliseconds kTuneDelayTimeMs = 150ms;
 inline constexpr std::chrono::seconds kListDelayTimeS = 1s;
+inline constexpr std::chrono::seconds kListRescanDelayTimeS = 10s;
+
+// Keeps each onProgramListUpdated transaction well below the binder buffer size, even for
+// programs carrying a lot of metadata.
+inline constexpr size_t kMaxProgramsPerChunk = 100;
 
 // clang-format off
 const AmFmRegionConfig kDefaultAmFmConfig = {
@@ -116,6 +121,7 @@ BroadcastRadio::BroadcastRadio(const VirtualRadio& virtualRadio)
 
 BroadcastRadio::~BroadcastRadio() {
     mThread.reset();
+    mProgramListThread.reset();
 }
 
 ScopedAStatus BroadcastRadio::getAmFmRegionConfig(bool full, AmFmRegionConfig* returnConfigs) {
@@ -382,42 +388,74 @@ ScopedAStatus BroadcastRadio::startProgramListUpdates(const ProgramFilter& filte
     LOG(DEBUG) << __func__ << ": requested program list updates, filter = " << filter.toString()
                << "...";
 
-    auto filterCb = [&filter](const VirtualProgram& program) {
-        return utils::satisfies(filter, program.selector);
-    };
-
     lock_guard<mutex> lk(mMutex);
+    stopProgramListUpdatesLocked();
 
-    const auto& list = mVirtualRadio.getProgramList();
-    vector<VirtualProgram> filteredList;
-    std::copy_if(list.begin(), list.end(), std::back_inserter(filteredList), filterCb);
+    // The client clears its list, so the whole list is sent again.
+    mProgramListFilter = filter;
+    mProgramListSent.reset();
+    const uint32_t session = mProgramListSession;
+    mProgramListThread->schedule([this, session]() { sendProgramListUpdates(session); },
+                                 kListDelayTimeS);
+
+    return ScopedAStatus::ok();
+}
+
+void BroadcastRadio::sendProgramListUpdates(uint32_t session) {
+    std::shared_ptr<ITunerCallback> callback;
+    vector<ProgramListChunk> chunks;
+    {
+        lock_guard<mutex> lk(mMutex);
+        if (session != mProgramListSession) {
+            return;
+        }
+        if (mCallback == nullptr) {
+            LOG(WARNING) << "Callback is null when updating program List";
+            return;
+        }
+        callback = mCallback;
+
+        utils::ProgramInfoSet current;
+        for (const auto& program : mVirtualRadio.getProgramList()) {
+            if (utils::satisfies(mProgramListFilter, program.selector)) {
+                current.insert(ProgramInfo(program));
+            }
+        }
+        const utils::ProgramInfoSet* previous = mProgramListSent ? &*mProgramListSent : nullptr;
+        chunks = utils::makeProgramListChunks(previous, current,
+                                              mProgramListFilter.excludeModifications,
+                                              kMaxProgramsPerChunk);
+        mProgramListSent = std::move(current);
+
+        // Like a background tuner, keep scanning and only send what changed since.
+        mProgramListThread->schedule([this, session]() { sendProgramListUpdates(session); },
+                                     kListRescanDelayTimeS);
+    }
 
-    auto task = [this, filteredList]() {
-        std::shared_ptr<ITunerCallback> callback;
+    for (const auto& chunk : chunks) {
         {
             lock_guard<mutex> lk(mMutex);
-            if (mCallback == nullptr) {
-                LOG(WARNING) << "Callback is null when updating program List";
+            if (session != mProgramListSession) {
+                LOG(DEBUG) << __func__ << ": program list updates stopped while sending";
                 return;
             }
-            callback = mCallback;
         }
-
-        ProgramListChunk chunk = {};
-        chunk.purge = true;
-        chunk.complete = true;
-        chunk.modified = vector<ProgramInfo>(filteredList.begin(), filteredList.end());
-
         callback->onProgramListUpdated(chunk);
-    };
-    mThread->schedule(task, kListDelayTimeS);
+    }
+}
 
-    return ScopedAStatus::ok();
+void BroadcastRadio::stopProgramListUpdatesLocked() {
+    mProgramListThread->cancelAll();
+    mProgramListSession++;
+    mProgramListSent.reset();
 }
 
 ScopedAStatus BroadcastRadio::stopProgramListUpdates() {
     LOG(DEBUG) << __func__ << ": requested program list updates to stop...";
-    // TODO(b/243681584) Implement stop program list updates method
+
+    lock_guard<mutex> lk(mMutex);
+    stopProgramListUpdatesLocked();
+
     return ScopedAStatus::ok();
 }
 
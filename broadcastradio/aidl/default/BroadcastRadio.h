@@ -27,6 +27,7 @@
 #include <aidl/android/hardware/broadcastradio/ICloseHandle.h>
 #include <aidl/android/hardware/broadcastradio/ITunerCallback.h>
 #include <aidl/android/hardware/broadcastradio/Properties.h>
+#include <broadcastradio-utils-aidl/Utils.h>
 #include <broadcastradio-utils/WorkerThread.h>
 
 #include <android-base/thread_annotations.h>
@@ -75,9 +76,21 @@ class BroadcastRadio final : public BnBroadcastRadio {
     ProgramSelector mCurrentProgram GUARDED_BY(mMutex) = {};
     std::shared_ptr<ITunerCallback> mCallback GUARDED_BY(mMutex);
 
+    // Program list updates run on their own thread, so that cancelling them doesn't cancel a
+    // pending tune and vice versa.
+    std::unique_ptr<::android::WorkerThread> mProgramListThread GUARDED_BY(mMutex) =
+            std::unique_ptr<::android::WorkerThread>(new ::android::WorkerThread());
+    // Incremented whenever program list updates are started or stopped, to abandon pending ones.
+    uint32_t mProgramListSession GUARDED_BY(mMutex) = 0;
+    ProgramFilter mProgramListFilter GUARDED_BY(mMutex) = {};
+    // Program list as last sent to the client, or nullopt if the client list has been cleared.
+    std::optional<utils::ProgramInfoSet> mProgramListSent GUARDED_BY(mMutex);
+
     std::optional<AmFmBandRange> getAmFmRangeLocked() const;
     void cancelLocked();
     ProgramInfo tuneInternalLocked(const ProgramSelector& sel);
+    void stopProgramListUpdatesLocked();
+    void sendProgramListUpdates(uint32_t session);
 
     binder_status_t cmdHelp(int fd) const;
     binder_status_t cmdTune(int fd, const char** args, uint32_t numArgs);
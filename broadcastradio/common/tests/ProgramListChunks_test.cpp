@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <broadcastradio-utils-aidl/Utils.h>
+#include <gtest/gtest.h>
+
+#include <android/binder_auto_utils.h>
+#include <android/binder_parcel.h>
+
+#include <iostream>
+#include <string>
+
+namespace {
+
+using ::aidl::android::hardware::broadcastradio::Metadata;
+using ::aidl::android::hardware::broadcastradio::ProgramInfo;
+using ::aidl::android::hardware::broadcastradio::ProgramListChunk;
+using ::aidl::android::hardware::broadcastradio::utils::makeProgramListChunks;
+using ::aidl::android::hardware::broadcastradio::utils::makeSelectorDab;
+using ::aidl::android::hardware::broadcastradio::utils::ProgramInfoSet;
+using ::aidl::android::hardware::broadcastradio::utils::updateProgramList;
+using ::std::string;
+using ::std::to_string;
+using ::std::vector;
+
+constexpr size_t kStationCount = 5000;
+constexpr size_t kMaxProgramsPerChunk = 100;
+
+ProgramInfo makeDabProgram(size_t index, const string& songTitle) {
+    ProgramInfo info = {};
+    info.selector = makeSelectorDab(/* sidExt= */ 0xE00000 + index,
+                                    /* ensemble= */ 0xC000 + index / 20,
+                                    /* freq= */ 174928 + 1712 * (index / 20 % 38));
+    info.logicallyTunedTo = info.selector.primaryId;
+    info.physicallyTunedTo = info.selector.secondaryIds[1];
+    info.infoFlags = ProgramInfo::FLAG_TUNABLE | ProgramInfo::FLAG_STEREO;
+    info.signalQuality = 100;
+    info.metadata = {
+            Metadata::make<Metadata::dabServiceName>("DAB Station " + to_string(index)),
+            Metadata::make<Metadata::dabServiceNameShort>("DAB" + to_string(index)),
+            Metadata::make<Metadata::songTitle>(songTitle),
+            Metadata::make<Metadata::songArtist>("Artist " + to_string(index)),
+    };
+    return info;
+}
+
+ProgramInfoSet makeDabList(size_t count) {
+    ProgramInfoSet list;
+    for (size_t i = 0; i < count; i++) {
+        list.insert(makeDabProgram(i, "Song"));
+    }
+    return list;
+}
+
+size_t getParcelSize(const ProgramListChunk& chunk) {
+    ::ndk::ScopedAParcel parcel(AParcel_create());
+    EXPECT_EQ(STATUS_OK, chunk.writeToParcel(parcel.get()));
+    return AParcel_getDataSize(parcel.get());
+}
+
+size_t getParcelSize(const vector<ProgramListChunk>& chunks) {
+    size_t size = 0;
+    for (const auto& chunk : chunks) {
+        size += getParcelSize(chunk);
+    }
+    return size;
+}
+
+void expectCompleteChunks(const vector<ProgramListChunk>& chunks) {
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const auto& chunk = chunks[i];
+        const size_t removed = chunk.removed.has_value() ? chunk.removed->size() : 0;
+        EXPECT_LE(chunk.modified.size() + removed, kMaxProgramsPerChunk);
+        EXPECT_EQ(i == chunks.size() - 1, chunk.complete);
+        if (i > 0) EXPECT_FALSE(chunk.purge);
+        if (chunk.purge) EXPECT_FALSE(chunk.removed.has_value());
+    }
+}
+
+void expectSameList(const ProgramInfoSet& expected, const ProgramInfoSet& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (const auto& info : expected) {
+        auto it = actual.find(info);
+        ASSERT_NE(actual.end(), it) << info.selector.toString();
+        EXPECT_EQ(info, *it);
+    }
+}
+
+ProgramInfoSet applyChunks(const vector<ProgramListChunk>& chunks, ProgramInfoSet list) {
+    for (const auto& chunk : chunks) {
+        updateProgramList(chunk, &list);
+    }
+    return list;
+}
+
+TEST(ProgramListChunksTest, InitialListIsPurgedAndSplit) {
+    const auto list = makeDabList(kStationCount);
+
+    const auto chunks = makeProgramListChunks(nullptr, list, /* excludeModifications= */ false,
+                                              kMaxProgramsPerChunk);
+
+    ASSERT_EQ(kStationCount / kMaxProgramsPerChunk, chunks.size());
+    EXPECT_TRUE(chunks.front().purge);
+    expectCompleteChunks(chunks);
+    ProgramInfoSet stale;
+    stale.insert(makeDabProgram(kStationCount, "Stale"));
+    expectSameList(list, applyChunks(chunks, stale));
+}
+
+TEST(ProgramListChunksTest, EmptyInitialListIsSentComplete) {
+    const auto chunks = makeProgramListChunks(nullptr, {}, /* excludeModifications= */ false,
+                                              kMaxProgramsPerChunk);
+
+    ASSERT_EQ(1u, chunks.size());
+    EXPECT_TRUE(chunks[0].purge);
+    EXPECT_TRUE(chunks[0].complete);
+    EXPECT_TRUE(chunks[0].modified.empty());
+}
+
+TEST(ProgramListChunksTest, UnchangedListSendsNothing) {
+    const auto list = makeDabList(kStationCount);
+
+    EXPECT_TRUE(makeProgramListChunks(&list, list, /* excludeModifications= */ false,
+                                      kMaxProgramsPerChunk)
+                        .empty());
+}
+
+TEST(ProgramListChunksTest, OnlyChangesAreSent) {
+    const auto previous = makeDabList(kStationCount);
+    auto current = previous;
+    // now playing changed on some stations, some went off air and some new ones came up
+    for (size_t i = 0; i < 50; i++) {
+        current.erase(makeDabProgram(i * 7, ""));
+        current.insert(makeDabProgram(i * 7, "Next song"));
+    }
+    for (size_t i = 0; i < 20; i++) {
+        current.erase(makeDabProgram(kStationCount - 1 - i, ""));
+    }
+    for (size_t i = 0; i < 10; i++) {
+        current.insert(makeDabProgram(kStationCount + i, "Song"));
+    }
+
+    const auto chunks = makeProgramListChunks(&previous, current,
+                                              /* excludeModifications= */ false,
+                                              kMaxProgramsPerChunk);
+
+    ASSERT_FALSE(chunks.empty());
+    EXPECT_FALSE(chunks.front().purge);
+    expectCompleteChunks(chunks);
+    size_t modified = 0;
+    size_t removed = 0;
+    for (const auto& chunk : chunks) {
+        modified += chunk.modified.size();
+        removed += chunk.removed.has_value() ? chunk.removed->size() : 0;
+    }
+    EXPECT_EQ(60u, modified);
+    EXPECT_EQ(20u, removed);
+    expectSameList(current, applyChunks(chunks, previous));
+
+    const size_t fullBytes = getParcelSize(makeProgramListChunks(
+            nullptr, current, /* excludeModifications= */ false, kMaxProgramsPerChunk));
+    const size_t diffBytes = getParcelSize(chunks);
+    std::cout << "Bytes per update of " << kStationCount << " DAB stations: " << fullBytes
+              << " for the whole list, " << diffBytes << " for the changes" << std::endl;
+    EXPECT_LT(diffBytes * 20, fullBytes);
+}
+
+TEST(ProgramListChunksTest, ExcludedModificationsAreNotSent) {
+    const auto previous = makeDabList(kStationCount);
+    auto current = previous;
+    for (size_t i = 0; i < 50; i++) {
+        current.erase(makeDabProgram(i * 7, ""));
+        current.insert(makeDabProgram(i * 7, "Next song"));
+    }
+    current.erase(makeDabProgram(kStationCount - 1, ""));
+    current.insert(makeDabProgram(kStationCount, "Song"));
+
+    const auto chunks = makeProgramListChunks(&previous, current,
+                                              /* excludeModifications= */ true,
+                                              kMaxProgramsPerChunk);
+
+    ASSERT_EQ(1u, chunks.size());
+    EXPECT_FALSE(chunks[0].purge);
+    EXPECT_TRUE(chunks[0].complete);
+    ASSERT_EQ(1u, chunks[0].modified.size());
+    EXPECT_EQ(makeDabProgram(kStationCount, "Song"), chunks[0].modified[0]);
+    ASSERT_TRUE(chunks[0].removed.has_value());
+    ASSERT_EQ(1u, chunks[0].removed->size());
+    EXPECT_EQ(makeDabProgram(kStationCount - 1, "").selector.primaryId,
+              chunks[0].removed->front());
+}
+
+TEST(ProgramListChunksTest, UpdateReplacesModifiedPrograms) {
+    ProgramInfoSet list;
+    list.insert(makeDabProgram(0, "Song"));
+    ProgramListChunk chunk = {};
+    chunk.modified.push_back(makeDabProgram(0, "Next song"));
+
+    updateProgramList(chunk, &list);
+
+    ASSERT_EQ(1u, list.size());
+    EXPECT_EQ(makeDabProgram(0, "Next song"), *list.begin());
+}
+
+}  // namespace
@@ -372,7 +372,11 @@ void updateProgramList(const ProgramListChunk& chunk, ProgramInfoSet* list) {
         list->clear();
     }
 
-    list->insert(chunk.modified.begin(), chunk.modified.end());
+    for (const auto& info : chunk.modified) {
+        // an entry with the same primaryId is replaced, not kept
+        list->erase(info);
+        list->insert(info);
+    }
 
     if (!chunk.removed.has_value()) {
         return;
@@ -387,6 +391,58 @@ void updateProgramList(const ProgramListChunk& chunk, ProgramInfoSet* list) {
     }
 }
 
+vector<ProgramListChunk> makeProgramListChunks(const ProgramInfoSet* previous,
+                                               const ProgramInfoSet& current,
+                                               bool excludeModifications,
+                                               size_t maxProgramsPerChunk) {
+    CHECK_GT(maxProgramsPerChunk, 0u);
+
+    vector<ProgramListChunk> chunks;
+    size_t chunkPrograms = 0;
+    auto nextChunk = [&]() -> ProgramListChunk& {
+        if (chunks.empty() || chunkPrograms == maxProgramsPerChunk) {
+            chunks.emplace_back();
+            chunkPrograms = 0;
+        }
+        chunkPrograms++;
+        return chunks.back();
+    };
+
+    if (previous != nullptr) {
+        for (const auto& info : *previous) {
+            if (current.find(info) != current.end()) {
+                continue;
+            }
+            auto& removed = nextChunk().removed;
+            if (!removed.has_value()) {
+                removed.emplace();
+            }
+            removed->push_back(info.selector.primaryId);
+        }
+    }
+
+    for (const auto& info : current) {
+        if (previous != nullptr) {
+            auto it = previous->find(info);
+            if (it != previous->end() && (excludeModifications || *it == info)) {
+                continue;
+            }
+        }
+        nextChunk().modified.push_back(info);
+    }
+
+    if (previous == nullptr) {
+        if (chunks.empty()) {
+            chunks.emplace_back();
+        }
+        chunks.front().purge = true;
+    }
+    if (!chunks.empty()) {
+        chunks.back().complete = true;
+    }
+    return chunks;
+}
+
 std::optional<std::string> getMetadataString(const ProgramInfo& info, const Metadata::Tag& tag) {
     auto isRdsPs = [tag](const Metadata& item) { return item.getTag() == tag; };
 
@@ -155,6 +155,27 @@ typedef std::unordered_set<ProgramInfo, ProgramInfoHasher, ProgramInfoKeyEqual>
 
 void updateProgramList(const ProgramListChunk& chunk, ProgramInfoSet* list);
 
+/**
+ * Makes the chunks bringing a program list from {@code previous} to {@code current}, when applied
+ * in order with {@link updateProgramList}.
+ *
+ * Programs which are new or differ from their previous version are sent as modified, and the ones
+ * which are gone as removed. Only the last chunk is marked as complete.
+ *
+ * @param previous Program list last sent to the client, or null if the client list is cleared.
+ *                 In the latter case the first chunk purges the list and there is at least one
+ *                 chunk even if the list is empty.
+ * @param current Current program list.
+ * @param excludeModifications Whether only new programs are sent as modified, not the ones whose
+ *                             info changed, see {@link ProgramFilter#excludeModifications}.
+ * @param maxProgramsPerChunk Maximum number of modified and removed entries in a single chunk.
+ * @return Chunks to send, none if nothing changed.
+ */
+std::vector<ProgramListChunk> makeProgramListChunks(const ProgramInfoSet* previous,
+                                                    const ProgramInfoSet& current,
+                                                    bool excludeModifications,
+                                                    size_t maxProgramsPerChunk);
+
 std::optional<std::string> getMetadataString(const ProgramInfo& info, const Metadata::Tag& tag);
 
 ProgramIdentifier makeHdRadioStationName(const std::string& name);
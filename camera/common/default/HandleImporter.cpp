@@ -31,7 +31,6 @@ using aidl::android::hardware::graphics::common::PlaneLayout;
 using aidl::android::hardware::graphics::common::PlaneLayoutComponent;
 using aidl::android::hardware::graphics::common::PlaneLayoutComponentType;
 using aidl::android::hardware::graphics::common::Smpte2086;
-using MetadataType = android::hardware::graphics::mapper::V4_0::IMapper::MetadataType;
 using MapperErrorV2 = android::hardware::graphics::mapper::V2_0::Error;
 using MapperErrorV3 = android::hardware::graphics::mapper::V3_0::Error;
 using MapperErrorV4 = android::hardware::graphics::mapper::V4_0::Error;
@@ -71,6 +70,7 @@ void HandleImporter::cleanup() {
     mMapperV4.clear();
     mMapperV3.clear();
     mMapperV2.clear();
+    mBufferMetadata.clear();
     mInitialized = false;
 }
 
@@ -125,7 +125,7 @@ YCbCrLayout HandleImporter::lockYCbCrInternal(const sp<M> mapper, buffer_handle_
 }
 
 bool isMetadataPesent(const sp<IMapperV4> mapper, const buffer_handle_t& buf,
-                      MetadataType metadataType) {
+                      const IMapperV4::MetadataType& metadataType) {
     auto buffer = const_cast<native_handle_t*>(buf);
     bool ret = false;
     hidl_vec<uint8_t> vec;
@@ -158,22 +158,103 @@ bool isMetadataPesent(const sp<IMapperV4> mapper, const buffer_handle_t& buf,
     return ret;
 }
 
-std::vector<PlaneLayout> getPlaneLayouts(const sp<IMapperV4> mapper, buffer_handle_t& buf) {
+bool getPlaneLayouts(const sp<IMapperV4> mapper, const buffer_handle_t& buf,
+                     std::vector<PlaneLayout>* outPlaneLayouts) {
     auto buffer = const_cast<native_handle_t*>(buf);
-    std::vector<PlaneLayout> planeLayouts;
+    bool fetched = false;
     hidl_vec<uint8_t> encodedPlaneLayouts;
-    mapper->get(buffer, gralloc4::MetadataType_PlaneLayouts,
-                [&](const auto& tmpError, const auto& tmpEncodedPlaneLayouts) {
-                    if (tmpError == MapperErrorV4::NONE) {
-                        encodedPlaneLayouts = tmpEncodedPlaneLayouts;
-                    } else {
-                        ALOGE("%s: failed to get plane layouts %d!", __FUNCTION__, tmpError);
-                    }
-                });
-
-    gralloc4::decodePlaneLayouts(encodedPlaneLayouts, &planeLayouts);
-
-    return planeLayouts;
+    auto ret = mapper->get(buffer, gralloc4::MetadataType_PlaneLayouts,
+                           [&](const auto& tmpError, const auto& tmpEncodedPlaneLayouts) {
+                               if (tmpError == MapperErrorV4::NONE) {
+                                   encodedPlaneLayouts = tmpEncodedPlaneLayouts;
+                                   fetched = true;
+                               } else {
+                                   ALOGE("%s: failed to get plane layouts %d!", __FUNCTION__,
+                                         tmpError);
+                               }
+                           });
+    if (!ret.isOk() || !fetched) {
+        return false;
+    }
+
+    return gralloc4::decodePlaneLayouts(encodedPlaneLayouts, outPlaneLayouts) == NO_ERROR;
+}
+
+HandleImporter::BufferMetadata* HandleImporter::getBufferMetadataLocked(
+        const buffer_handle_t& buf) {
+    auto it = mBufferMetadata.find(buf);
+    return it != mBufferMetadata.end() ? &it->second : nullptr;
+}
+
+bool HandleImporter::getPlaneInfoLocked(const buffer_handle_t& buf, PlaneInfo* outPlaneInfo) {
+    BufferMetadata* metadata = getBufferMetadataLocked(buf);
+    if (metadata != nullptr && metadata->planeInfo.has_value()) {
+        *outPlaneInfo = *metadata->planeInfo;
+        return true;
+    }
+
+    std::vector<PlaneLayout> planeLayouts;
+    if (!getPlaneLayouts(mMapperV4, buf, &planeLayouts)) {
+        return false;
+    }
+
+    PlaneInfo planeInfo;
+    planeInfo.planeCount = planeLayouts.size();
+    if (!planeLayouts.empty()) {
+        planeInfo.firstPlaneStrideBytes = planeLayouts[0].strideInBytes;
+    }
+    for (const auto& planeLayout : planeLayouts) {
+        for (const auto& planeLayoutComponent : planeLayout.components) {
+            const auto& type = planeLayoutComponent.type;
+
+            if (!gralloc4::isStandardPlaneLayoutComponentType(type)) {
+                continue;
+            }
+
+            const int64_t offset =
+                    planeLayout.offsetInBytes + planeLayoutComponent.offsetInBits / 8;
+
+            switch (static_cast<PlaneLayoutComponentType>(type.value)) {
+                case PlaneLayoutComponentType::Y:
+                    planeInfo.yOffset = offset;
+                    planeInfo.yStride = planeLayout.strideInBytes;
+                    break;
+                case PlaneLayoutComponentType::CB:
+                    planeInfo.cbOffset = offset;
+                    planeInfo.cStride = planeLayout.strideInBytes;
+                    planeInfo.chromaStep = planeLayout.sampleIncrementInBits / 8;
+                    break;
+                case PlaneLayoutComponentType::CR:
+                    planeInfo.crOffset = offset;
+                    planeInfo.cStride = planeLayout.strideInBytes;
+                    planeInfo.chromaStep = planeLayout.sampleIncrementInBits / 8;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    if (metadata != nullptr) {
+        metadata->planeInfo = planeInfo;
+    }
+    *outPlaneInfo = planeInfo;
+    return true;
+}
+
+bool HandleImporter::isMetadataPresentLocked(const buffer_handle_t& buf,
+                                             const MetadataType& metadataType,
+                                             std::optional<bool> BufferMetadata::*cachedPresent) {
+    BufferMetadata* metadata = getBufferMetadataLocked(buf);
+    if (metadata != nullptr && (metadata->*cachedPresent).has_value()) {
+        return *(metadata->*cachedPresent);
+    }
+
+    bool present = isMetadataPesent(mMapperV4, buf, metadataType);
+    if (metadata != nullptr) {
+        metadata->*cachedPresent = present;
+    }
+    return present;
 }
 
 template <>
@@ -200,38 +281,25 @@ YCbCrLayout HandleImporter::lockYCbCrInternal<IMapperV4, MapperErrorV4>(
         return layout;
     }
 
-    std::vector<PlaneLayout> planeLayouts = getPlaneLayouts(mapper, buf);
-    for (const auto& planeLayout : planeLayouts) {
-        for (const auto& planeLayoutComponent : planeLayout.components) {
-            const auto& type = planeLayoutComponent.type;
-
-            if (!gralloc4::isStandardPlaneLayoutComponentType(type)) {
-                continue;
-            }
-
-            uint8_t* data = reinterpret_cast<uint8_t*>(mapped);
-            data += planeLayout.offsetInBytes;
-            data += planeLayoutComponent.offsetInBits / 8;
+    PlaneInfo planeInfo;
+    if (!getPlaneInfoLocked(buf, &planeInfo)) {
+        return layout;
+    }
 
-            switch (static_cast<PlaneLayoutComponentType>(type.value)) {
-                case PlaneLayoutComponentType::Y:
-                    layout.y = data;
-                    layout.yStride = planeLayout.strideInBytes;
-                    break;
-                case PlaneLayoutComponentType::CB:
-                    layout.cb = data;
-                    layout.cStride = planeLayout.strideInBytes;
-                    layout.chromaStep = planeLayout.sampleIncrementInBits / 8;
-                    break;
-                case PlaneLayoutComponentType::CR:
-                    layout.cr = data;
-                    layout.cStride = planeLayout.strideInBytes;
-                    layout.chromaStep = planeLayout.sampleIncrementInBits / 8;
-                    break;
-                default:
-                    break;
-            }
-        }
+    uint8_t* data = reinterpret_cast<uint8_t*>(mapped);
+    if (planeInfo.yOffset >= 0) {
+        layout.y = data + planeInfo.yOffset;
+        layout.yStride = planeInfo.yStride;
+    }
+    if (planeInfo.cbOffset >= 0) {
+        layout.cb = data + planeInfo.cbOffset;
+    }
+    if (planeInfo.crOffset >= 0) {
+        layout.cr = data + planeInfo.crOffset;
+    }
+    if (planeInfo.cbOffset >= 0 || planeInfo.crOffset >= 0) {
+        layout.cStride = planeInfo.cStride;
+        layout.chromaStep = planeInfo.chromaStep;
     }
 
     return layout;
@@ -278,7 +346,11 @@ bool HandleImporter::importBuffer(buffer_handle_t& handle) {
     }
 
     if (mMapperV4 != nullptr) {
-        return importBufferInternal<IMapperV4, MapperErrorV4>(mMapperV4, handle);
+        if (!importBufferInternal<IMapperV4, MapperErrorV4>(mMapperV4, handle)) {
+            return false;
+        }
+        mBufferMetadata[handle] = BufferMetadata();
+        return true;
     }
 
     if (mMapperV3 != nullptr) {
@@ -303,6 +375,7 @@ void HandleImporter::freeBuffer(buffer_handle_t handle) {
         initializeLocked();
     }
 
+    mBufferMetadata.erase(handle);
     if (mMapperV4 != nullptr) {
         auto ret = mMapperV4->freeBuffer(const_cast<native_handle_t*>(handle));
         if (!ret.isOk()) {
@@ -445,13 +518,13 @@ status_t HandleImporter::getMonoPlanarStrideBytes(buffer_handle_t& buf, uint32_t
     }
 
     if (mMapperV4 != nullptr) {
-        std::vector<PlaneLayout> planeLayouts = getPlaneLayouts(mMapperV4, buf);
-        if (planeLayouts.size() != 1) {
-            ALOGE("%s: Unexpected number of planes %zu!", __FUNCTION__, planeLayouts.size());
+        PlaneInfo planeInfo;
+        if (!getPlaneInfoLocked(buf, &planeInfo) || planeInfo.planeCount != 1) {
+            ALOGE("%s: Unexpected number of planes %zu!", __FUNCTION__, planeInfo.planeCount);
             return BAD_VALUE;
         }
 
-        *stride = planeLayouts[0].strideInBytes;
+        *stride = planeInfo.firstPlaneStrideBytes;
     } else {
         ALOGE("%s: mMapperV4 is null! Query not supported!", __FUNCTION__);
         return NO_INIT;
@@ -483,7 +556,8 @@ bool HandleImporter::isSmpte2086Present(const buffer_handle_t& buf) {
     }
 
     if (mMapperV4 != nullptr) {
-        return isMetadataPesent(mMapperV4, buf, gralloc4::MetadataType_Smpte2086);
+        return isMetadataPresentLocked(buf, gralloc4::MetadataType_Smpte2086,
+                                       &BufferMetadata::smpte2086Present);
     } else {
         ALOGE("%s: mMapperV4 is null! Query not supported!", __FUNCTION__);
     }
@@ -499,7 +573,8 @@ bool HandleImporter::isSmpte2094_10Present(const buffer_handle_t& buf) {
     }
 
     if (mMapperV4 != nullptr) {
-        return isMetadataPesent(mMapperV4, buf, gralloc4::MetadataType_Smpte2094_10);
+        return isMetadataPresentLocked(buf, gralloc4::MetadataType_Smpte2094_10,
+                                       &BufferMetadata::smpte2094_10Present);
     } else {
         ALOGE("%s: mMapperV4 is null! Query not supported!", __FUNCTION__);
     }
@@ -515,7 +590,8 @@ bool HandleImporter::isSmpte2094_40Present(const buffer_handle_t& buf) {
     }
 
     if (mMapperV4 != nullptr) {
-        return isMetadataPesent(mMapperV4, buf, gralloc4::MetadataType_Smpte2094_40);
+        return isMetadataPresentLocked(buf, gralloc4::MetadataType_Smpte2094_40,
+                                       &BufferMetadata::smpte2094_40Present);
     } else {
         ALOGE("%s: mMapperV4 is null! Query not supported!", __FUNCTION__);
     }
@@ -23,6 +23,9 @@
 #include <cutils/native_handle.h>
 #include <utils/Mutex.h>
 
+#include <optional>
+#include <unordered_map>
+
 using android::hardware::graphics::mapper::V2_0::IMapper;
 using android::hardware::graphics::mapper::V2_0::YCbCrLayout;
 
@@ -60,15 +63,48 @@ class HandleImporter {
 
     int unlock(buffer_handle_t& buf);  // returns release fence
 
-    // Query Gralloc4 metadata
+    // Query Gralloc4 metadata. For buffers imported by this importer the
+    // result is cached until the buffer is freed, so metadata set by the
+    // producer after the first query is only seen after a new import.
     bool isSmpte2086Present(const buffer_handle_t& buf);
     bool isSmpte2094_10Present(const buffer_handle_t& buf);
     bool isSmpte2094_40Present(const buffer_handle_t& buf);
 
   private:
+    using MetadataType = graphics::mapper::V4_0::IMapper::MetadataType;
+
+    // Plane layouts decoded from Gralloc4 metadata, reduced to what the lock
+    // and stride queries need. Offsets are in bytes from the start of the
+    // mapping, or -1 if the buffer has no such component.
+    struct PlaneInfo {
+        size_t planeCount = 0;
+        int64_t firstPlaneStrideBytes = 0;
+        int64_t yOffset = -1;
+        int64_t cbOffset = -1;
+        int64_t crOffset = -1;
+        int64_t yStride = 0;
+        int64_t cStride = 0;
+        int64_t chromaStep = 0;
+    };
+
+    // Gralloc4 metadata of a buffer imported by this importer. Buffers come
+    // from a small set that is locked every frame, so the metadata is only
+    // fetched and decoded once per import.
+    struct BufferMetadata {
+        std::optional<PlaneInfo> planeInfo;
+        std::optional<bool> smpte2086Present;
+        std::optional<bool> smpte2094_10Present;
+        std::optional<bool> smpte2094_40Present;
+    };
+
     void initializeLocked();
     void cleanup();
 
+    BufferMetadata* getBufferMetadataLocked(const buffer_handle_t& buf);
+    bool getPlaneInfoLocked(const buffer_handle_t& buf, PlaneInfo* outPlaneInfo);
+    bool isMetadataPresentLocked(const buffer_handle_t& buf, const MetadataType& metadataType,
+                                 std::optional<bool> BufferMetadata::*cachedPresent);
+
     template <class M, class E>
     bool importBufferInternal(const sp<M> mapper, buffer_handle_t& handle);
     template <class M, class E>
@@ -82,6 +118,8 @@ class HandleImporter {
     sp<IMapper> mMapperV2;
     sp<graphics::mapper::V3_0::IMapper> mMapperV3;
     sp<graphics::mapper::V4_0::IMapper> mMapperV4;
+    // Keyed by the imported handle, which stays valid until freeBuffer.
+    std::unordered_map<buffer_handle_t, BufferMetadata> mBufferMetadata;
 };
 
 }  // namespace helper
@@ -19,6 +19,7 @@
 
 #include <set>
 #include <cutils/properties.h>
+#include <utils/Timers.h>
 #include <utils/Trace.h>
 #include <hardware/gralloc.h>
 #include <hardware/gralloc1.h>
@@ -615,35 +616,53 @@ void CameraDeviceSession::ResultBatcher::sendBatchMetadataLocked(
         return;
     }
 
+    ATRACE_BEGIN("sendBatchMetadata");
+    nsecs_t startTime = systemTime();
+    // All partial results of the batch are sent in one callback. Their metadata is not copied
+    // here: results point into the batch and are written to the FMQ from there.
     std::vector<CaptureResult> results;
-    std::vector<uint32_t> toBeRemovedIdxes;
-    for (auto& pair : batch->mResultMds) {
-        uint32_t partialIdx = pair.first;
-        if (partialIdx > lastPartialResultIdx) {
-            continue;
-        }
-        toBeRemovedIdxes.push_back(partialIdx);
-        InflightBatch::MetadataBatch& mb = pair.second;
+    size_t metadataSize = 0;
+    auto end = batch->mResultMds.upper_bound(lastPartialResultIdx);
+    for (auto it = batch->mResultMds.begin(); it != end; it++) {
+        uint32_t partialIdx = it->first;
+        InflightBatch::MetadataBatch& mb = it->second;
+        uint8_t* data = mb.mData.data();
         for (const auto& p : mb.mMds) {
             CaptureResult result;
             result.frameNumber = p.first;
-            result.result = std::move(p.second);
+            result.result.setToExternal(data, p.second);
             result.fmqResultSize = 0;
             result.inputBuffer.streamId = -1;
             result.inputBuffer.bufferId = 0;
             result.inputBuffer.buffer = nullptr;
             result.partialResult = partialIdx;
             results.push_back(std::move(result));
+            data += p.second;
         }
-        mb.mMds.clear();
+        metadataSize += mb.mData.size();
     }
     hidl_vec<CaptureResult> hResults;
     hResults.setToExternal(results.data(), results.size());
     invokeProcessCaptureResultCallback(hResults, /* tryWriteFmq */true);
     batch->mPartialResultProgress = lastPartialResultIdx;
-    for (uint32_t partialIdx : toBeRemovedIdxes) {
-        batch->mResultMds.erase(partialIdx);
-    }
+    batch->mResultMds.erase(batch->mResultMds.begin(), end);
+    ATRACE_END();
+    ALOGV("%s: sent %zu results (%zu bytes) of frames %u-%u in %" PRId64 "us", __FUNCTION__,
+            results.size(), metadataSize, batch->mFirstFrame, batch->mLastFrame,
+            ns2us(systemTime() - startTime));
+}
+
+void CameraDeviceSession::ResultBatcher::queueBatchMetadataLocked(
+        std::shared_ptr<InflightBatch> batch, uint32_t frameNumber, uint32_t partialResult,
+        const CameraMetadata& metadata) {
+    InflightBatch::MetadataBatch& mb = batch->mResultMds[partialResult];
+    if (mb.mMds.empty()) {
+        // Frames of a batch have similar metadata, so make room for all of them at once
+        mb.mData.reserve(metadata.size() * batch->mBatchSize);
+        mb.mMds.reserve(batch->mBatchSize);
+    }
+    mb.mData.insert(mb.mData.end(), metadata.data(), metadata.data() + metadata.size());
+    mb.mMds.push_back(std::make_pair(frameNumber, metadata.size()));
 }
 
 void CameraDeviceSession::ResultBatcher::notifySingleMsg(NotifyMsg& msg) {
@@ -727,20 +746,7 @@ void CameraDeviceSession::ResultBatcher::invokeProcessCaptureResultCallback(
         }
     }
     if (tryWriteFmq && mResultMetadataQueue->availableToWrite() > 0) {
-        for (CaptureResult &result : results) {
-            if (result.result.size() > 0) {
-                if (mResultMetadataQueue->write(result.result.data(), result.result.size())) {
-                    result.fmqResultSize = result.result.size();
-                    result.result.resize(0);
-                } else {
-                    ALOGW("%s: couldn't utilize fmq, fall back to hwbinder, result size: %zu,"
-                    "shared message queue available size: %zu",
-                        __FUNCTION__, result.result.size(),
-                        mResultMetadataQueue->availableToWrite());
-                    result.fmqResultSize = 0;
-                }
-            }
-        }
+        writeResultMetadataToFmqLocked(results);
     }
     auto ret = mCallback->processCaptureResult(results);
     if (!ret.isOk()) {
@@ -750,6 +756,55 @@ void CameraDeviceSession::ResultBatcher::invokeProcessCaptureResultCallback(
     mProcessCaptureResultLock.unlock();
 }
 
+void CameraDeviceSession::ResultBatcher::writeResultMetadataToFmqLocked(
+        hidl_vec<CaptureResult> &results) {
+    size_t totalSize = 0;
+    for (const CaptureResult &result : results) {
+        totalSize += result.result.size();
+    }
+    if (totalSize == 0) {
+        return;
+    }
+
+    // Copy all metadata straight into the queue and make it visible to the reader at once
+    ResultMetadataQueue::MemTransaction tx;
+    if (mResultMetadataQueue->beginWrite(totalSize, &tx)) {
+        size_t offset = 0;
+        bool copied = true;
+        for (const CaptureResult &result : results) {
+            size_t size = result.result.size();
+            if (size > 0 && !tx.copyTo(result.result.data(), offset, size)) {
+                copied = false;
+                break;
+            }
+            offset += size;
+        }
+        if (copied && mResultMetadataQueue->commitWrite(totalSize)) {
+            for (CaptureResult &result : results) {
+                result.fmqResultSize = result.result.size();
+                result.result.resize(0);
+            }
+            return;
+        }
+    }
+
+    // Not everything fits, so send as many results as possible through the queue
+    for (CaptureResult &result : results) {
+        if (result.result.size() > 0) {
+            if (mResultMetadataQueue->write(result.result.data(), result.result.size())) {
+                result.fmqResultSize = result.result.size();
+                result.result.resize(0);
+            } else {
+                ALOGW("%s: couldn't utilize fmq, fall back to hwbinder, result size: %zu,"
+                "shared message queue available size: %zu",
+                    __FUNCTION__, result.result.size(),
+                    mResultMetadataQueue->availableToWrite());
+                result.fmqResultSize = 0;
+            }
+        }
+    }
+}
+
 void CameraDeviceSession::ResultBatcher::processOneCaptureResult(CaptureResult& result) {
     hidl_vec<CaptureResult> results;
     results.resize(1);
@@ -778,9 +833,8 @@ void CameraDeviceSession::ResultBatcher::processCaptureResult(CaptureResult& res
 
         // queue metadata
         if (result.result.size() != 0) {
-            // Save a copy of metadata
-            batch->mResultMds[result.partialResult].mMds.push_back(
-                    std::make_pair(result.frameNumber, result.result));
+            queueBatchMetadataLocked(batch, result.frameNumber, result.partialResult,
+                    result.result);
         }
 
         // queue buffer
@@ -225,8 +225,11 @@ protected:
             std::unordered_map<int, BufferBatch> mBatchBufs;
 
             struct MetadataBatch {
-                //                   (frameNumber, metadata)
-                std::vector<std::pair<uint32_t, CameraMetadata>> mMds;
+                // Metadata of all frames back to back, so that it is copied once from the HAL
+                // result and then straight into the result FMQ when the batch is sent
+                std::vector<uint8_t> mData;
+                //                   (frameNumber, metadata size)
+                std::vector<std::pair<uint32_t, size_t>> mMds;
             };
             // Partial result IDs that has been delivered to framework
             uint32_t mNumPartialResults;
@@ -256,6 +259,11 @@ protected:
         void moveStreamBuffer(StreamBuffer&& src, StreamBuffer& dst);
         void pushStreamBuffer(StreamBuffer&& src, std::vector<StreamBuffer>& dst);
 
+        // Save a copy of the metadata of a frame until its batch is sent
+        // Caller must hold the InflightBatch::mLock
+        void queueBatchMetadataLocked(std::shared_ptr<InflightBatch> batch, uint32_t frameNumber,
+                uint32_t partialResult, const CameraMetadata& metadata);
+
         void sendBatchMetadataLocked(
                 std::shared_ptr<InflightBatch> batch, uint32_t lastPartialResultIdx);
 
@@ -278,6 +286,9 @@ protected:
         void notifySingleMsg(NotifyMsg& msg);
         void processOneCaptureResult(CaptureResult& result);
         void invokeProcessCaptureResultCallback(hidl_vec<CaptureResult> &results, bool tryWriteFmq);
+        // Move the metadata of results into mResultMetadataQueue, in a single FMQ write if all of
+        // it fits. Caller must hold mProcessCaptureResultLock
+        void writeResultMetadataToFmqLocked(hidl_vec<CaptureResult> &results);
 
         // Protect access to mInflightBatches, mNumPartialResults and mStreamsToBatch
         // processCaptureRequest, processCaptureResult, notify will compete for this lock
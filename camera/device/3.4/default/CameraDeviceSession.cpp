@@ -644,9 +644,8 @@ void CameraDeviceSession::ResultBatcher_3_4::processCaptureResult_3_4(CaptureRes
 
         // queue metadata
         if (result.v3_2.result.size() != 0) {
-            // Save a copy of metadata
-            batch->mResultMds[result.v3_2.partialResult].mMds.push_back(
-                    std::make_pair(result.v3_2.frameNumber, result.v3_2.result));
+            queueBatchMetadataLocked(batch, result.v3_2.frameNumber, result.v3_2.partialResult,
+                    result.v3_2.result);
         }
 
         // queue buffer
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExtCamCapCache"
+// #define LOG_NDEBUG 0
+#include <log/log.h>
+
+#include "ExternalCameraCapabilityCache.h"
+
+#include <cutils/properties.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+
+namespace android {
+namespace hardware {
+namespace camera {
+namespace device {
+namespace implementation {
+
+namespace {
+constexpr uint32_t kCacheMagic = 0x43434545;  // "EECC"
+// Must be incremented whenever the file layout or the way capabilities are probed changes.
+constexpr uint32_t kCacheVersion = 1;
+
+// Reads the first line of a sysfs attribute, or returns an empty string.
+std::string readSysfsAttribute(const std::string& path) {
+    std::ifstream file(path);
+    std::string value;
+    std::getline(file, value);
+    return value;
+}
+
+class CacheWriter {
+  public:
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        mData.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putBytes(const void* data, size_t size) {
+        put<uint32_t>(size);
+        mData.append(static_cast<const char*>(data), size);
+    }
+
+    const std::string& data() const { return mData; }
+
+  private:
+    std::string mData;
+};
+
+class CacheReader {
+  public:
+    explicit CacheReader(const std::string& data) : mData(data) {}
+
+    template <typename T>
+    bool get(T* out) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (mData.size() - mOffset < sizeof(T)) {
+            return false;
+        }
+        memcpy(out, mData.data() + mOffset, sizeof(T));
+        mOffset += sizeof(T);
+        return true;
+    }
+
+    // Points out at the bytes in the cache data, which must outlive it.
+    bool getBytes(const char** out, size_t* size) {
+        uint32_t length;
+        if (!get(&length) || mData.size() - mOffset < length) {
+            return false;
+        }
+        *out = mData.data() + mOffset;
+        *size = length;
+        mOffset += length;
+        return true;
+    }
+
+    bool done() const { return mOffset == mData.size(); }
+
+  private:
+    const std::string& mData;
+    size_t mOffset = 0;
+};
+}  // namespace
+
+const char* ExternalCameraCapabilityCache::kDefaultCacheDir = "/data/vendor/external_camera";
+
+ExternalCameraCapabilityCache::ExternalCameraCapabilityCache(const std::string& cacheDir)
+    : mCacheDir(cacheDir) {}
+
+std::string ExternalCameraCapabilityCache::getCacheKey(const std::string& devicePath, int fd,
+                                                       const ExternalCameraConfig& cfg) {
+    // /sys/class/video4linux/videoN/device is the USB interface of the camera, and its parent
+    // is the USB device.
+    std::string nodeName = devicePath.substr(devicePath.find_last_of('/') + 1);
+    std::string usbDevicePath = "/sys/class/video4linux/" + nodeName + "/device/../";
+    std::string vendorId = readSysfsAttribute(usbDevicePath + "idVendor");
+    std::string productId = readSysfsAttribute(usbDevicePath + "idProduct");
+    std::string deviceRelease = readSysfsAttribute(usbDevicePath + "bcdDevice");
+    if (vendorId.empty() || productId.empty()) {
+        ALOGV("%s: %s is not a USB device, not caching its capabilities", __FUNCTION__,
+              devicePath.c_str());
+        return "";
+    }
+
+    v4l2_capability capability{};
+    if (TEMP_FAILURE_RETRY(ioctl(fd, VIDIOC_QUERYCAP, &capability)) != 0) {
+        ALOGE("%s: VIDIOC_QUERYCAP on %s failed: %s", __FUNCTION__, devicePath.c_str(),
+              strerror(errno));
+        return "";
+    }
+
+    char fingerprint[PROPERTY_VALUE_MAX];
+    property_get("ro.vendor.build.fingerprint", fingerprint, "");
+
+    std::ostringstream key;
+    key << "usb:" << vendorId << ":" << productId << ":" << deviceRelease
+        << "/driver:" << reinterpret_cast<const char*>(capability.driver) << ":"
+        << capability.version << "/card:" << reinterpret_cast<const char*>(capability.card)
+        << "/build:" << fingerprint << "/config:" << cfg.depthEnabled << ","
+        << cfg.minStreamSize.width << "x" << cfg.minStreamSize.height << ","
+        << cfg.maxJpegBufSize << "," << cfg.orientation;
+    for (const auto* fpsLimits : {&cfg.fpsLimits, &cfg.depthFpsLimits}) {
+        key << "/fps";
+        for (const auto& limit : *fpsLimits) {
+            key << ":" << limit.size.width << "x" << limit.size.height << "@"
+                << limit.fpsUpperBound;
+        }
+    }
+    return key.str();
+}
+
+std::string ExternalCameraCapabilityCache::getCachePath(const std::string& key) const {
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%016zx.bin", std::hash<std::string>{}(key));
+    return mCacheDir + "/" + fileName;
+}
+
+bool ExternalCameraCapabilityCache::load(const std::string& key,
+                                         std::vector<SupportedV4L2Format>* supportedFormats,
+                                         CroppingType* croppingType,
+                                         CameraMetadata* cameraCharacteristics) const {
+    std::string cachePath = getCachePath(key);
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    CacheReader reader(data);
+    uint32_t magic;
+    uint32_t version;
+    const char* cachedKey;
+    size_t cachedKeySize;
+    if (!reader.get(&magic) || magic != kCacheMagic || !reader.get(&version) ||
+        version != kCacheVersion || !reader.getBytes(&cachedKey, &cachedKeySize) ||
+        key.compare(0, std::string::npos, cachedKey, cachedKeySize) != 0) {
+        ALOGW("%s: %s is stale, probing the camera again", __FUNCTION__, cachePath.c_str());
+        return false;
+    }
+
+    int32_t cachedCroppingType;
+    uint32_t formatCount;
+    if (!reader.get(&cachedCroppingType) || !reader.get(&formatCount)) {
+        ALOGE("%s: %s is truncated", __FUNCTION__, cachePath.c_str());
+        return false;
+    }
+    std::vector<SupportedV4L2Format> formats;
+    for (uint32_t i = 0; i < formatCount; i++) {
+        SupportedV4L2Format format;
+        uint32_t frameRateCount;
+        if (!reader.get(&format.width) || !reader.get(&format.height) ||
+            !reader.get(&format.fourcc) || !reader.get(&frameRateCount)) {
+            ALOGE("%s: %s is truncated", __FUNCTION__, cachePath.c_str());
+            return false;
+        }
+        for (uint32_t j = 0; j < frameRateCount; j++) {
+            SupportedV4L2Format::FrameRate frameRate;
+            if (!reader.get(&frameRate.durationNumerator) ||
+                !reader.get(&frameRate.durationDenominator)) {
+                ALOGE("%s: %s is truncated", __FUNCTION__, cachePath.c_str());
+                return false;
+            }
+            format.frameRates.push_back(frameRate);
+        }
+        formats.push_back(std::move(format));
+    }
+
+    const char* metadata;
+    size_t metadataSize;
+    if (!reader.getBytes(&metadata, &metadataSize) || !reader.done()) {
+        ALOGE("%s: %s is truncated", __FUNCTION__, cachePath.c_str());
+        return false;
+    }
+    if (formats.empty()) {
+        ALOGE("%s: %s has no supported formats", __FUNCTION__, cachePath.c_str());
+        return false;
+    }
+    // camera_metadata_t must be aligned, which the bytes in the file are not.
+    std::vector<uint64_t> alignedMetadata((metadataSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    memcpy(alignedMetadata.data(), metadata, metadataSize);
+    camera_metadata_t* chars = allocate_copy_camera_metadata_checked(
+            reinterpret_cast<const camera_metadata_t*>(alignedMetadata.data()), metadataSize);
+    if (chars == nullptr) {
+        ALOGE("%s: %s is corrupted", __FUNCTION__, cachePath.c_str());
+        return false;
+    }
+
+    *supportedFormats = std::move(formats);
+    *croppingType = static_cast<CroppingType>(cachedCroppingType);
+    cameraCharacteristics->acquire(chars);
+    return true;
+}
+
+bool ExternalCameraCapabilityCache::store(const std::string& key,
+                                          const std::vector<SupportedV4L2Format>& supportedFormats,
+                                          CroppingType croppingType,
+                                          const camera_metadata_t* cameraCharacteristics) const {
+    CacheWriter writer;
+    writer.put(kCacheMagic);
+    writer.put(kCacheVersion);
+    writer.putBytes(key.data(), key.size());
+    writer.put<int32_t>(croppingType);
+    writer.put<uint32_t>(supportedFormats.size());
+    for (const auto& format : supportedFormats) {
+        writer.put(format.width);
+        writer.put(format.height);
+        writer.put(format.fourcc);
+        writer.put<uint32_t>(format.frameRates.size());
+        for (const auto& frameRate : format.frameRates) {
+            writer.put(frameRate.durationNumerator);
+            writer.put(frameRate.durationDenominator);
+        }
+    }
+    writer.putBytes(cameraCharacteristics, get_camera_metadata_size(cameraCharacteristics));
+
+    // Write to a temporary file first so that a reader never sees a partial entry.
+    std::string cachePath = getCachePath(key);
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(writer.data().data(), writer.data().size());
+        if (!file) {
+            ALOGW("%s: cannot write %s", __FUNCTION__, tmpPath.c_str());
+            unlink(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        ALOGW("%s: cannot rename %s to %s: %s", __FUNCTION__, tmpPath.c_str(), cachePath.c_str(),
+              strerror(errno));
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace implementation
+}  // namespace device
+}  // namespace camera
+}  // namespace hardware
+}  // namespace android
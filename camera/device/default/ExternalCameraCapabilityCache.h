@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HARDWARE_INTERFACES_CAMERA_DEVICE_DEFAULT_EXTERNALCAMERACAPABILITYCACHE_H_
+#define HARDWARE_INTERFACES_CAMERA_DEVICE_DEFAULT_EXTERNALCAMERACAPABILITYCACHE_H_
+
+#include <ExternalCameraUtils.h>
+
+#include <string>
+#include <vector>
+
+namespace android {
+namespace hardware {
+namespace camera {
+namespace device {
+namespace implementation {
+
+using ::android::hardware::camera::external::common::ExternalCameraConfig;
+
+// Keeps the supported formats and camera characteristics of external cameras on disk, so that
+// they do not have to be probed again every time a camera is plugged in or the provider restarts.
+// Some UVC cameras take seconds to enumerate all their formats, sizes and frame intervals.
+//
+// Entries are keyed by the USB vendor/product ID and device release of the camera, its V4L2
+// driver and driver version, the vendor build and the parts of the HAL config that affect
+// the probed capabilities.
+class ExternalCameraCapabilityCache {
+  public:
+    static const char* kDefaultCacheDir;
+
+    explicit ExternalCameraCapabilityCache(const std::string& cacheDir = kDefaultCacheDir);
+
+    // Returns the key of the V4L2 device at devicePath, which the caller has open as fd, or an
+    // empty string if the device cannot be cached, e.g. because it is not a USB device.
+    static std::string getCacheKey(const std::string& devicePath, int fd,
+                                   const ExternalCameraConfig& cfg);
+
+    // Returns false if there is no valid entry for key.
+    bool load(const std::string& key, std::vector<SupportedV4L2Format>* supportedFormats,
+              CroppingType* croppingType, CameraMetadata* cameraCharacteristics) const;
+
+    bool store(const std::string& key, const std::vector<SupportedV4L2Format>& supportedFormats,
+               CroppingType croppingType, const camera_metadata_t* cameraCharacteristics) const;
+
+  private:
+    std::string getCachePath(const std::string& key) const;
+
+    const std::string mCacheDir;
+};
+
+}  // namespace implementation
+}  // namespace device
+}  // namespace camera
+}  // namespace hardware
+}  // namespace android
+
+#endif  // HARDWARE_INTERFACES_CAMERA_DEVICE_DEFAULT_EXTERNALCAMERACAPABILITYCACHE_H_
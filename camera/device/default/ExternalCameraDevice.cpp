@@ -19,6 +19,7 @@
 #include <log/log.h>
 
 #include "ExternalCameraDevice.h"
+#include "ExternalCameraCapabilityCache.h"
 
 #include <aidl/android/hardware/camera/common/Status.h>
 #include <convert.h>
@@ -276,6 +277,14 @@ status_t ExternalCameraDevice::initCameraCharacteristics() {
         return DEAD_OBJECT;
     }
 
+    ExternalCameraCapabilityCache cache;
+    std::string cacheKey = ExternalCameraCapabilityCache::getCacheKey(mDevicePath, fd.get(), mCfg);
+    if (!cacheKey.empty() &&
+        cache.load(cacheKey, &mSupportedFormats, &mCroppingType, &mCameraCharacteristics)) {
+        ALOGV("%s: loaded capabilities of %s from cache", __FUNCTION__, mDevicePath.c_str());
+        return OK;
+    }
+
     status_t ret;
     ret = initDefaultCharsKeys(&mCameraCharacteristics);
     if (ret != OK) {
@@ -305,6 +314,12 @@ status_t ExternalCameraDevice::initCameraCharacteristics() {
         return ret;
     }
 
+    if (!cacheKey.empty()) {
+        const camera_metadata_t* rawMetadata = mCameraCharacteristics.getAndLock();
+        cache.store(cacheKey, mSupportedFormats, mCroppingType, rawMetadata);
+        mCameraCharacteristics.unlock(rawMetadata);
+    }
+
     return OK;
 }
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ExternalCameraCapabilityCache.h"
+
+#include <android-base/file.h>
+#include <gtest/gtest.h>
+#include <linux/videodev2.h>
+#include <system/camera_metadata.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace android {
+namespace hardware {
+namespace camera {
+namespace device {
+namespace implementation {
+
+namespace {
+
+constexpr char kKey[] = "usb:046d:0825:0010/driver:uvcvideo:393728/card:Webcam";
+constexpr int32_t kSensorOrientation = 90;
+
+class ExternalCameraCapabilityCacheTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        mFormats = {
+                {.width = 640,
+                 .height = 480,
+                 .fourcc = V4L2_PIX_FMT_MJPEG,
+                 .frameRates = {{.durationNumerator = 1, .durationDenominator = 30},
+                                {.durationNumerator = 1, .durationDenominator = 15}}},
+                {.width = 1280,
+                 .height = 720,
+                 .fourcc = V4L2_PIX_FMT_YUYV,
+                 .frameRates = {{.durationNumerator = 1, .durationDenominator = 10}}},
+        };
+        mCharacteristics = allocate_camera_metadata(/* entry_capacity= */ 1,
+                                                    /* data_capacity= */ 16);
+        ASSERT_NE(mCharacteristics, nullptr);
+        ASSERT_EQ(add_camera_metadata_entry(mCharacteristics, ANDROID_SENSOR_ORIENTATION,
+                                            &kSensorOrientation, 1),
+                  0);
+    }
+
+    void TearDown() override { free_camera_metadata(mCharacteristics); }
+
+    // Returns the path of the only entry in the cache.
+    std::string getCacheFilePath() const {
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(mCacheDir.path)) {
+            paths.push_back(entry.path());
+        }
+        EXPECT_EQ(paths.size(), 1u);
+        return paths.empty() ? "" : paths[0];
+    }
+
+    bool load(const std::string& key) {
+        return mCache.load(key, &mLoadedFormats, &mLoadedCroppingType, &mLoadedCharacteristics);
+    }
+
+    TemporaryDir mCacheDir;
+    ExternalCameraCapabilityCache mCache{mCacheDir.path};
+    std::vector<SupportedV4L2Format> mFormats;
+    camera_metadata_t* mCharacteristics = nullptr;
+
+    std::vector<SupportedV4L2Format> mLoadedFormats;
+    CroppingType mLoadedCroppingType = HORIZONTAL;
+    CameraMetadata mLoadedCharacteristics;
+};
+
+TEST_F(ExternalCameraCapabilityCacheTest, RoundTrip) {
+    ASSERT_TRUE(mCache.store(kKey, mFormats, VERTICAL, mCharacteristics));
+
+    ASSERT_TRUE(load(kKey));
+
+    ASSERT_EQ(mLoadedFormats.size(), mFormats.size());
+    for (size_t i = 0; i < mFormats.size(); i++) {
+        EXPECT_EQ(mLoadedFormats[i].width, mFormats[i].width);
+        EXPECT_EQ(mLoadedFormats[i].height, mFormats[i].height);
+        EXPECT_EQ(mLoadedFormats[i].fourcc, mFormats[i].fourcc);
+        ASSERT_EQ(mLoadedFormats[i].frameRates.size(), mFormats[i].frameRates.size());
+        for (size_t j = 0; j < mFormats[i].frameRates.size(); j++) {
+            EXPECT_EQ(mLoadedFormats[i].frameRates[j].durationNumerator,
+                      mFormats[i].frameRates[j].durationNumerator);
+            EXPECT_EQ(mLoadedFormats[i].frameRates[j].durationDenominator,
+                      mFormats[i].frameRates[j].durationDenominator);
+        }
+    }
+    EXPECT_EQ(mLoadedCroppingType, VERTICAL);
+    camera_metadata_entry entry = mLoadedCharacteristics.find(ANDROID_SENSOR_ORIENTATION);
+    ASSERT_EQ(entry.count, 1u);
+    EXPECT_EQ(entry.data.i32[0], kSensorOrientation);
+}
+
+TEST_F(ExternalCameraCapabilityCacheTest, MissingEntry) {
+    EXPECT_FALSE(load(kKey));
+}
+
+TEST_F(ExternalCameraCapabilityCacheTest, OtherKey) {
+    ASSERT_TRUE(mCache.store(kKey, mFormats, HORIZONTAL, mCharacteristics));
+
+    EXPECT_FALSE(load(std::string(kKey) + "/other"));
+}
+
+TEST_F(ExternalCameraCapabilityCacheTest, Truncated) {
+    ASSERT_TRUE(mCache.store(kKey, mFormats, HORIZONTAL, mCharacteristics));
+    const std::string path = getCacheFilePath();
+    std::string data;
+    ASSERT_TRUE(base::ReadFileToString(path, &data));
+
+    // Cut off within the formats, and within the metadata.
+    for (size_t size : {data.size() / 4, data.size() - 1}) {
+        ASSERT_TRUE(base::WriteStringToFile(data.substr(0, size), path));
+        EXPECT_FALSE(load(kKey)) << "truncated to " << size << " bytes";
+    }
+}
+
+TEST_F(ExternalCameraCapabilityCacheTest, Corrupted) {
+    ASSERT_TRUE(mCache.store(kKey, mFormats, HORIZONTAL, mCharacteristics));
+    const std::string path = getCacheFilePath();
+    std::string data;
+    ASSERT_TRUE(base::ReadFileToString(path, &data));
+
+    // The metadata is at the end of the file and starts with its own size, which must not be
+    // trusted.
+    const size_t metadataOffset = data.size() - get_camera_metadata_size(mCharacteristics);
+    data.replace(metadataOffset, sizeof(uint32_t), sizeof(uint32_t), '\xff');
+    ASSERT_TRUE(base::WriteStringToFile(data, path));
+
+    EXPECT_FALSE(load(kKey));
+}
+
+TEST_F(ExternalCameraCapabilityCacheTest, NoFormats) {
+    ASSERT_TRUE(mCache.store(kKey, {}, HORIZONTAL, mCharacteristics));
+
+    EXPECT_FALSE(load(kKey));
+}
+
+}  // namespace
+
+}  // namespace implementation
+}  // namespace device
+}  // namespace camera
+}  // namespace hardware
+}  // namespace android
@@ -20,12 +20,20 @@
 
 #include <android/hardware/graphics/composer/2.1/IComposer.h>
 
+#include <android-base/properties.h>
 #include <binder/ProcessState.h>
 #include <composer-passthrough/2.1/HwcLoader.h>
+#include <composer-replay/2.1/CommandStream.h>
 #include <hidl/LegacySupport.h>
 
 using android::hardware::graphics::composer::V2_1::IComposer;
+using android::hardware::graphics::composer::V2_1::hal::Composer;
 using android::hardware::graphics::composer::V2_1::passthrough::HwcLoader;
+using android::hardware::graphics::composer::V2_1::replay::CommandStreamFileRecorder;
+
+// When set to a file path, the command batches of the clients are recorded to
+// the file, for replay with android.hardware.graphics.composer@2.1-replay.
+constexpr char kRecordCommandStreamProperty[] = "vendor.hwc.record_command_stream";
 
 int main() {
     // the conventional HAL might start binder services
@@ -43,10 +51,25 @@ int main() {
 
     android::hardware::configureRpcThreadpool(4, true /* will join */);
 
-    android::sp<IComposer> composer = HwcLoader::load();
-    if (composer == nullptr) {
+    const hw_module_t* module = HwcLoader::loadModule();
+    auto hal = module ? HwcLoader::createHalWithAdapter(module) : nullptr;
+    if (hal == nullptr) {
         return 1;
     }
+    auto composerImpl = Composer::create(std::move(hal));
+
+    CommandStreamFileRecorder recorder;
+    const std::string recordPath =
+            android::base::GetProperty(kRecordCommandStreamProperty, "");
+    if (!recordPath.empty() && recorder.open(recordPath)) {
+        ALOGI("recording the command stream to %s", recordPath.c_str());
+        composerImpl->setCommandBatchObserver(
+                [&recorder](const uint32_t* data, uint32_t length, size_t handleCount) {
+                    recorder.recordFrame(data, length, handleCount);
+                });
+    }
+
+    android::sp<IComposer> composer = composerImpl.release();
     if (composer->registerAsService() != android::NO_ERROR) {
         ALOGE("failed to register service");
         return 1;
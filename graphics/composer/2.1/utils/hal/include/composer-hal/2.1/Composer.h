@@ -23,6 +23,7 @@
 #include <array>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -51,6 +52,13 @@ class ComposerImpl : public Interface {
 
     ComposerImpl(std::unique_ptr<Hal> hal) : mHal(std::move(hal)) {}
 
+    // Observe the command batches of the clients created from now on, e.g.,
+    // to record the command stream of the service for offline replay.
+    void setCommandBatchObserver(ComposerCommandEngine::BatchObserver observer) {
+        std::lock_guard<std::mutex> lock(mClientMutex);
+        mCommandBatchObserver = std::move(observer);
+    }
+
     // IComposer 2.1 interface
 
     Return<void> getCapabilities(IComposer::getCapabilities_cb hidl_cb) override {
@@ -82,7 +90,7 @@ class ComposerImpl : public Interface {
     }
 
     Return<void> dumpDebugInfo(IComposer::dumpDebugInfo_cb hidl_cb) override {
-        hidl_cb(mHal->dumpDebugInfo());
+        hidl_cb(mHal->dumpDebugInfo() + dumpClientDebugInfo());
         return Void();
     }
 
@@ -126,9 +134,25 @@ class ComposerImpl : public Interface {
         return mClient == nullptr;
     }
 
+    std::string dumpClientDebugInfo() {
+        sp<IComposerClient> client;
+        std::function<std::string()> dumpClient;
+        {
+            std::lock_guard<std::mutex> lock(mClientMutex);
+            client = mClient.promote();
+            dumpClient = mDumpClientDebugInfo;
+        }
+
+        // The promoted reference keeps the client alive while it is dumped.
+        // It is released without holding mClientMutex, since destroying the
+        // client calls onClientDestroyed.
+        return (client != nullptr && dumpClient) ? dumpClient() : std::string();
+    }
+
     void onClientDestroyed() {
         std::lock_guard<std::mutex> lock(mClientMutex);
         mClient.clear();
+        mDumpClientDebugInfo = nullptr;
         mClientDestroyedCondition.notify_all();
     }
 
@@ -140,6 +164,10 @@ class ComposerImpl : public Interface {
 
         auto clientDestroyed = [this]() { onClientDestroyed(); };
         client->setOnClientDestroyed(clientDestroyed);
+        mDumpClientDebugInfo = [client = client.get()]() { return client->dumpDebugInfo(); };
+        if (mCommandBatchObserver) {
+            client->setCommandBatchObserver(mCommandBatchObserver);
+        }
 
         return client.release();
     }
@@ -148,6 +176,9 @@ class ComposerImpl : public Interface {
 
     std::mutex mClientMutex;
     wp<IComposerClient> mClient;
+    // dumps the client in mClient; only valid while mClient can be promoted
+    std::function<std::string()> mDumpClientDebugInfo;
+    ComposerCommandEngine::BatchObserver mCommandBatchObserver;
     std::condition_variable mClientDestroyedCondition;
 };
 
@@ -83,6 +83,15 @@ class ComposerClientImpl : public Interface {
         mOnClientDestroyed = onClientDestroyed;
     }
 
+    // dump the debug information of the client, appended to that of the HAL
+    std::string dumpDebugInfo() { return mResources->dumpDebugInfo(); }
+
+    // observe the command batches of the client, e.g., to record them
+    void setCommandBatchObserver(ComposerCommandEngine::BatchObserver observer) {
+        std::lock_guard<std::mutex> lock(mCommandEngineMutex);
+        mCommandEngine->setBatchObserver(std::move(observer));
+    }
+
     // IComposerClient 2.1 interface
 
     class HalEventCallback : public Hal::EventCallback {
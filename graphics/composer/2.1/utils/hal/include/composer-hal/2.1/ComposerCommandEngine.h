@@ -20,6 +20,7 @@
 #warning "ComposerCommandEngine.h included without LOG_TAG"
 #endif
 
+#include <functional>
 #include <vector>
 
 #include <composer-command-buffer/2.1/ComposerCommandBuffer.h>
@@ -50,11 +51,21 @@ class ComposerCommandEngine : protected CommandReaderBase {
         return setMQDescriptor(descriptor);
     }
 
+    // Observer of every command batch read from the input queue, before it is
+    // executed, e.g., to record the command stream for offline replay.  The
+    // data is only valid for the duration of the call.
+    using BatchObserver =
+            std::function<void(const uint32_t* data, uint32_t length, size_t handleCount)>;
+    void setBatchObserver(BatchObserver observer) { mBatchObserver = std::move(observer); }
+
     Error execute(uint32_t inLength, const hidl_vec<hidl_handle>& inHandles, bool* outQueueChanged,
                   uint32_t* outCommandLength, hidl_vec<hidl_handle>* outCommandHandles) {
         if (!readQueue(inLength, inHandles)) {
             return Error::BAD_PARAMETER;
         }
+        if (mBatchObserver) {
+            mBatchObserver(mData.get(), inLength, inHandles.size());
+        }
 
         IComposerClient::Command command;
         uint16_t length = 0;
@@ -153,9 +164,11 @@ class ComposerCommandEngine : protected CommandReaderBase {
         std::vector<Layer> requestedLayers;
         std::vector<uint32_t> requestMasks;
 
+        prepareValidateDisplay();
         auto err = mHal->validateDisplay(mCurrentDisplay, &changedLayers, &compositionTypes,
                                          &displayRequestMask, &requestedLayers, &requestMasks);
         mResources->setDisplayMustValidateState(mCurrentDisplay, false);
+        onDisplayValidated(err, changedLayers);
         if (err == Error::NONE) {
             mWriter->setChangedCompositionTypes(changedLayers, compositionTypes);
             mWriter->setDisplayRequests(displayRequestMask, requestedLayers, requestMasks);
@@ -292,6 +305,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
                            ? Error::NOT_VALIDATED
                            : mHal->presentDisplay(mCurrentDisplay, &presentFence, &layers, &fences);
             if (err == Error::NONE) {
+                mResources->clearDisplayLayerStateDirtyMask(mCurrentDisplay);
                 mWriter->setPresentOrValidateResult(1);
                 mWriter->setPresentFence(presentFence);
                 mWriter->setReleaseFences(layers, fences);
@@ -331,6 +345,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
         std::vector<int> fences;
         auto err = mHal->presentDisplay(mCurrentDisplay, &presentFence, &layers, &fences);
         if (err == Error::NONE) {
+            mResources->clearDisplayLayerStateDirtyMask(mCurrentDisplay);
             mWriter->setPresentFence(presentFence);
             mWriter->setReleaseFences(layers, fences);
         } else {
@@ -345,6 +360,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
+        mResources->markLayerStateDirty(mCurrentDisplay, LayerProperty::CURSOR_POSITION);
         auto err = mHal->setLayerCursorPosition(mCurrentDisplay, mCurrentLayer, readSigned(),
                                                 readSigned());
         if (err != Error::NONE) {
@@ -370,6 +386,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
         auto err = mResources->getLayerBuffer(mCurrentDisplay, mCurrentLayer, slot, useCache,
                                               rawHandle, &buffer, &replacedBuffer);
         if (err == Error::NONE) {
+            mResources->markLayerStateDirty(mCurrentDisplay, LayerProperty::BUFFER);
             err = mHal->setLayerBuffer(mCurrentDisplay, mCurrentLayer, buffer, fence);
             if (err == Error::NONE) {
                 closeFence = false;
@@ -392,6 +409,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
         }
 
         auto damage = readRegion(length / 4);
+        mResources->markLayerStateDirty(mCurrentDisplay, LayerProperty::SURFACE_DAMAGE);
         auto err = mHal->setLayerSurfaceDamage(mCurrentDisplay, mCurrentLayer, damage);
         if (err != Error::NONE) {
             mWriter->setError(getCommandLoc(), err);
@@ -405,10 +423,9 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerBlendMode(mCurrentDisplay, mCurrentLayer, readSigned());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::BLEND_MODE, readSigned(), [this](int32_t mode) {
+            return mHal->setLayerBlendMode(mCurrentDisplay, mCurrentLayer, mode);
+        });
 
         return true;
     }
@@ -418,10 +435,10 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerColor(mCurrentDisplay, mCurrentLayer, readColor());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::COLOR, readColor(),
+                            [this](IComposerClient::Color color) {
+                                return mHal->setLayerColor(mCurrentDisplay, mCurrentLayer, color);
+                            });
 
         return true;
     }
@@ -431,10 +448,9 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerCompositionType(mCurrentDisplay, mCurrentLayer, readSigned());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::COMPOSITION_TYPE, readSigned(), [this](int32_t type) {
+            return mHal->setLayerCompositionType(mCurrentDisplay, mCurrentLayer, type);
+        });
 
         return true;
     }
@@ -444,10 +460,9 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerDataspace(mCurrentDisplay, mCurrentLayer, readSigned());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::DATASPACE, readSigned(), [this](int32_t dataspace) {
+            return mHal->setLayerDataspace(mCurrentDisplay, mCurrentLayer, dataspace);
+        });
 
         return true;
     }
@@ -457,10 +472,11 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerDisplayFrame(mCurrentDisplay, mCurrentLayer, readRect());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::DISPLAY_FRAME, readRect(),
+                            [this](const hwc_rect_t& frame) {
+                                return mHal->setLayerDisplayFrame(mCurrentDisplay, mCurrentLayer,
+                                                                  frame);
+                            });
 
         return true;
     }
@@ -470,10 +486,9 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerPlaneAlpha(mCurrentDisplay, mCurrentLayer, readFloat());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::PLANE_ALPHA, readFloat(), [this](float alpha) {
+            return mHal->setLayerPlaneAlpha(mCurrentDisplay, mCurrentLayer, alpha);
+        });
 
         return true;
     }
@@ -490,6 +505,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
         auto err = mResources->getLayerSidebandStream(mCurrentDisplay, mCurrentLayer, rawHandle,
                                                       &stream, &replacedStream);
         if (err == Error::NONE) {
+            mResources->markLayerStateDirty(mCurrentDisplay, LayerProperty::SIDEBAND_STREAM);
             err = mHal->setLayerSidebandStream(mCurrentDisplay, mCurrentLayer, stream);
         }
         if (err != Error::NONE) {
@@ -504,10 +520,11 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerSourceCrop(mCurrentDisplay, mCurrentLayer, readFRect());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::SOURCE_CROP, readFRect(),
+                            [this](const hwc_frect_t& crop) {
+                                return mHal->setLayerSourceCrop(mCurrentDisplay, mCurrentLayer,
+                                                                crop);
+                            });
 
         return true;
     }
@@ -517,10 +534,9 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerTransform(mCurrentDisplay, mCurrentLayer, readSigned());
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::TRANSFORM, readSigned(), [this](int32_t transform) {
+            return mHal->setLayerTransform(mCurrentDisplay, mCurrentLayer, transform);
+        });
 
         return true;
     }
@@ -531,11 +547,11 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto region = readRegion(length / 4);
-        auto err = mHal->setLayerVisibleRegion(mCurrentDisplay, mCurrentLayer, region);
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
-        }
+        setCachedLayerState(LayerProperty::VISIBLE_REGION, readRegion(length / 4),
+                            [this](const std::vector<hwc_rect_t>& region) {
+                                return mHal->setLayerVisibleRegion(mCurrentDisplay, mCurrentLayer,
+                                                                   region);
+                            });
 
         return true;
     }
@@ -545,12 +561,46 @@ class ComposerCommandEngine : protected CommandReaderBase {
             return false;
         }
 
-        auto err = mHal->setLayerZOrder(mCurrentDisplay, mCurrentLayer, read());
+        setCachedLayerState(LayerProperty::Z_ORDER, read(), [this](uint32_t z) {
+            return mHal->setLayerZOrder(mCurrentDisplay, mCurrentLayer, z);
+        });
+
+        return true;
+    }
+
+    // Forward a cached layer property to the HAL, unless the value is the same
+    // as the one last set on the current layer.  The cached value is forgotten
+    // when the HAL rejects it.
+    template <typename T, typename SetLayerState>
+    void setCachedLayerState(LayerProperty property, const T& value,
+                             SetLayerState&& setLayerState) {
+        if (!mResources->updateLayerState(mCurrentDisplay, mCurrentLayer, property, value)) {
+            return;
+        }
+
+        auto err = setLayerState(value);
         if (err != Error::NONE) {
+            mResources->invalidateLayerState(mCurrentDisplay, mCurrentLayer, property);
             mWriter->setError(getCommandLoc(), err);
         }
+    }
 
-        return true;
+    // tell the HAL which layer properties changed since the last validation
+    void prepareValidateDisplay() {
+        mHal->setLayerStateDirtyMask(mCurrentDisplay,
+                                     mResources->getDisplayLayerStateDirtyMask(mCurrentDisplay));
+    }
+
+    // The HAL may have changed the composition type of the layers it reports,
+    // so the cached composition types of those layers are stale.
+    void onDisplayValidated(Error err, const std::vector<Layer>& changedLayers) {
+        for (auto layer : changedLayers) {
+            mResources->invalidateLayerState(mCurrentDisplay, layer,
+                                             LayerProperty::COMPOSITION_TYPE);
+        }
+        if (err == Error::NONE) {
+            mResources->clearDisplayLayerStateDirtyMask(mCurrentDisplay);
+        }
     }
 
     hwc_rect_t readRect() {
@@ -585,6 +635,8 @@ class ComposerCommandEngine : protected CommandReaderBase {
 
     Display mCurrentDisplay = 0;
     Layer mCurrentLayer = 0;
+
+    BatchObserver mBatchObserver;
 };
 
 }  // namespace hal
@@ -100,6 +100,11 @@ class ComposerHal {
                                   int32_t dataspace, const std::vector<hwc_rect_t>& damage) = 0;
     virtual Error setOutputBuffer(Display display, buffer_handle_t buffer,
                                   int32_t releaseFence) = 0;
+    // Called before validateDisplay with the layer properties (a bitmask of
+    // toLayerPropertyMask() from ComposerResources) set on any layer of the
+    // display since it was last validated or presented.  Commands setting a
+    // layer property to the value it already has never reach the HAL.
+    virtual void setLayerStateDirtyMask(Display /*display*/, uint32_t /*dirtyMask*/) {}
     virtual Error validateDisplay(Display display, std::vector<Layer>* outChangedLayers,
                                   std::vector<IComposerClient::Composition>* outCompositionTypes,
                                   uint32_t* outDisplayRequestMask,
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ComposerReplay"
+
+#include <composer-replay/2.1/CommandStream.h>
+
+#include <stdio.h>
+
+#include <iterator>
+#include <memory>
+
+#include <log/log.h>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x31534343;  // "CCS1"
+constexpr uint32_t kVersion = 1;
+
+// Guard against allocating absurd amounts of memory for a corrupted file.
+constexpr uint32_t kMaxFrameCount = 1024 * 1024;
+constexpr uint32_t kMaxFrameLength = 16 * 1024 * 1024;
+constexpr uint32_t kMaxHandleCount = 64 * 1024;
+
+using File = std::unique_ptr<FILE, decltype(&fclose)>;
+
+bool writeWords(FILE* file, const uint32_t* words, size_t count) {
+    return fwrite(words, sizeof(uint32_t), count, file) == count;
+}
+
+bool readWords(FILE* file, uint32_t* words, size_t count) {
+    return fread(words, sizeof(uint32_t), count, file) == count;
+}
+
+bool writeHeader(FILE* file, uint32_t frameCount) {
+    const uint32_t header[] = {kMagic, kVersion, frameCount};
+    return writeWords(file, header, std::size(header));
+}
+
+bool writeFrame(FILE* file, const uint32_t* data, uint32_t length, uint32_t handleCount) {
+    const uint32_t frameHeader[] = {handleCount, length};
+    return writeWords(file, frameHeader, std::size(frameHeader)) &&
+           writeWords(file, data, length);
+}
+
+}  // namespace
+
+void CommandStreamRecorder::recordFrame(const uint32_t* data, uint32_t length,
+                                        size_t handleCount) {
+    CommandFrame frame;
+    frame.commands.assign(data, data + length);
+    frame.handleCount = static_cast<uint32_t>(handleCount);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFrames.push_back(std::move(frame));
+}
+
+std::vector<CommandFrame> CommandStreamRecorder::getFrames() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFrames;
+}
+
+CommandStreamFileRecorder::~CommandStreamFileRecorder() {
+    if (mFile) {
+        fclose(mFile);
+    }
+}
+
+bool CommandStreamFileRecorder::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFile) {
+        fclose(mFile);
+    }
+    mFrameCount = 0;
+
+    mFile = fopen(path.c_str(), "wb");
+    if (!mFile) {
+        ALOGE("failed to open %s for writing", path.c_str());
+        return false;
+    }
+    if (!writeHeader(mFile, 0) || fflush(mFile) != 0) {
+        ALOGE("failed to write header to %s", path.c_str());
+        fclose(mFile);
+        mFile = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool CommandStreamFileRecorder::recordFrame(const uint32_t* data, uint32_t length,
+                                            size_t handleCount) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mFile || mFrameCount >= kMaxFrameCount) {
+        return false;
+    }
+
+    // Append the frame before counting it in the header, so that a reader
+    // never sees a frame that has not been completely written.
+    if (fseek(mFile, 0, SEEK_END) != 0 ||
+        !writeFrame(mFile, data, length, static_cast<uint32_t>(handleCount)) ||
+        fseek(mFile, 0, SEEK_SET) != 0 || !writeHeader(mFile, mFrameCount + 1) ||
+        fflush(mFile) != 0) {
+        ALOGE("failed to record frame %u", mFrameCount);
+        return false;
+    }
+    mFrameCount++;
+    return true;
+}
+
+bool writeCommandStream(const std::string& path, const std::vector<CommandFrame>& frames) {
+    File file(fopen(path.c_str(), "wb"), fclose);
+    if (!file) {
+        ALOGE("failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    if (!writeHeader(file.get(), static_cast<uint32_t>(frames.size()))) {
+        ALOGE("failed to write header to %s", path.c_str());
+        return false;
+    }
+
+    for (const auto& frame : frames) {
+        if (!writeFrame(file.get(), frame.commands.data(),
+                        static_cast<uint32_t>(frame.commands.size()), frame.handleCount)) {
+            ALOGE("failed to write frame to %s", path.c_str());
+            return false;
+        }
+    }
+
+    return fflush(file.get()) == 0;
+}
+
+bool readCommandStream(const std::string& path, std::vector<CommandFrame>* outFrames) {
+    File file(fopen(path.c_str(), "rb"), fclose);
+    if (!file) {
+        ALOGE("failed to open %s for reading", path.c_str());
+        return false;
+    }
+
+    uint32_t header[3];
+    if (!readWords(file.get(), header, std::size(header)) || header[0] != kMagic ||
+        header[1] != kVersion || header[2] > kMaxFrameCount) {
+        ALOGE("%s is not a version %u command stream", path.c_str(), kVersion);
+        return false;
+    }
+
+    std::vector<CommandFrame> frames(header[2]);
+    for (auto& frame : frames) {
+        uint32_t frameHeader[2];
+        if (!readWords(file.get(), frameHeader, std::size(frameHeader)) ||
+            frameHeader[0] > kMaxHandleCount || frameHeader[1] > kMaxFrameLength) {
+            ALOGE("invalid frame header in %s", path.c_str());
+            return false;
+        }
+
+        frame.handleCount = frameHeader[0];
+        frame.commands.resize(frameHeader[1]);
+        if (!readWords(file.get(), frame.commands.data(), frame.commands.size())) {
+            ALOGE("truncated frame in %s", path.c_str());
+            return false;
+        }
+    }
+
+    *outFrames = std::move(frames);
+    return true;
+}
+
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
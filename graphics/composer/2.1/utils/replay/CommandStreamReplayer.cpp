@@ -0,0 +1,213 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ComposerReplay"
+
+#include "CommandStreamReplayer.h"
+
+#include <algorithm>
+
+#include <log/log.h>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kOpcodeMask = static_cast<uint32_t>(IComposerClient::Command::OPCODE_MASK);
+constexpr uint32_t kLengthMask = static_cast<uint32_t>(IComposerClient::Command::LENGTH_MASK);
+
+uint64_t makeId(uint32_t lo, uint32_t hi) {
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+}  // namespace
+
+// ComposerCommandEngine that times every command it executes
+class CommandStreamReplayer::TimedCommandEngine : public hal::ComposerCommandEngine {
+  public:
+    TimedCommandEngine(ComposerHal* hal, hal::ComposerResources* resources)
+        : ComposerCommandEngine(hal, resources) {}
+
+    void setStats(std::map<IComposerClient::Command, CommandStats>* stats) { mStats = stats; }
+
+  protected:
+    bool executeCommand(IComposerClient::Command command, uint16_t length) override {
+        if (!mStats) {
+            return ComposerCommandEngine::executeCommand(command, length);
+        }
+
+        const auto start = Clock::now();
+        const bool parsed = ComposerCommandEngine::executeCommand(command, length);
+        const auto elapsed = Clock::now() - start;
+
+        auto& stats = (*mStats)[command];
+        stats.count++;
+        stats.total += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+        return parsed;
+    }
+
+  private:
+    std::map<IComposerClient::Command, CommandStats>* mStats = nullptr;
+};
+
+CommandStreamReplayer::CommandStreamReplayer()
+    : mResources(std::make_unique<hal::ComposerResources>()),
+      mEngine(std::make_unique<TimedCommandEngine>(&mHal, mResources.get())) {}
+
+CommandStreamReplayer::~CommandStreamReplayer() {
+    mEngine.reset();
+    mResources.reset();
+    for (auto handle : mStandInHandles) {
+        native_handle_delete(handle);
+    }
+}
+
+void CommandStreamReplayer::addDisplay(Display display) {
+    if (mResources->hasDisplay(display)) {
+        return;
+    }
+    mResources->addPhysicalDisplay(display);
+    mResources->setDisplayClientTargetCacheSize(display, kSlotCount);
+}
+
+void CommandStreamReplayer::addLayer(Display display, Layer layer) {
+    addDisplay(display);
+    // fails harmlessly when the layer is already registered
+    mResources->addLayer(display, layer, kSlotCount);
+}
+
+void CommandStreamReplayer::addDisplaysAndLayers(const std::vector<CommandFrame>& frames) {
+    for (const auto& frame : frames) {
+        const auto& words = frame.commands;
+        Display display = 0;
+        size_t pos = 0;
+        while (pos < words.size()) {
+            const auto command = static_cast<IComposerClient::Command>(words[pos] & kOpcodeMask);
+            const size_t length = words[pos] & kLengthMask;
+            if (pos + 1 + length > words.size()) {
+                break;
+            }
+
+            if (command == IComposerClient::Command::SELECT_DISPLAY &&
+                length == CommandWriterBase::kSelectDisplayLength) {
+                display = makeId(words[pos + 1], words[pos + 2]);
+                addDisplay(display);
+            } else if (command == IComposerClient::Command::SELECT_LAYER &&
+                       length == CommandWriterBase::kSelectLayerLength) {
+                addLayer(display, makeId(words[pos + 1], words[pos + 2]));
+            }
+            pos += 1 + length;
+        }
+    }
+}
+
+void CommandStreamReplayer::setBatchObserver(hal::ComposerCommandEngine::BatchObserver observer) {
+    mEngine->setBatchObserver(std::move(observer));
+}
+
+Error CommandStreamReplayer::execute(CommandWriterBase* writer) {
+    bool queueChanged = false;
+    uint32_t length = 0;
+    hidl_vec<hidl_handle> handles;
+    if (!writer->writeQueue(&queueChanged, &length, &handles)) {
+        return Error::NO_RESOURCES;
+    }
+    if (queueChanged || mWriterQueueDetached) {
+        const auto* descriptor = writer->getMQDescriptor();
+        if (!descriptor || !mEngine->setInputMQDescriptor(*descriptor)) {
+            return Error::NO_RESOURCES;
+        }
+        mWriterQueueDetached = false;
+    }
+
+    bool outQueueChanged = false;
+    uint32_t outLength = 0;
+    hidl_vec<hidl_handle> outHandles;
+    auto err = mEngine->execute(length, handles, &outQueueChanged, &outLength, &outHandles);
+    mEngine->reset();
+    writer->reset();
+    return err;
+}
+
+ReplayReport CommandStreamReplayer::replay(const std::vector<CommandFrame>& frames,
+                                           size_t iterations) {
+    ReplayReport report;
+
+    size_t maxLength = 1;
+    size_t maxHandleCount = 0;
+    for (const auto& frame : frames) {
+        maxLength = std::max(maxLength, frame.commands.size());
+        maxHandleCount = std::max(maxHandleCount, static_cast<size_t>(frame.handleCount));
+    }
+
+    // The engine reads from this queue instead of the one of the last writer
+    // passed to execute, as if the client had resized its queue.
+    CommandQueueType queue(maxLength);
+    mWriterQueueDetached = true;
+    if (!queue.isValid() || !mEngine->setInputMQDescriptor(*queue.getDesc())) {
+        ALOGE("failed to create a command queue of %zu words", maxLength);
+        return report;
+    }
+
+    while (mStandInHandles.size() < maxHandleCount) {
+        mStandInHandles.push_back(native_handle_create(0, 0));
+    }
+    std::vector<hidl_handle> standIns(mStandInHandles.begin(), mStandInHandles.end());
+
+    mEngine->setStats(&report.commands);
+    const auto start = Clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        for (const auto& frame : frames) {
+            report.frames++;
+            report.bytes += frame.commands.size() * sizeof(uint32_t);
+
+            if (!queue.write(frame.commands.data(), frame.commands.size())) {
+                report.failedFrames++;
+                continue;
+            }
+
+            hidl_vec<hidl_handle> handles;
+            handles.setToExternal(standIns.data(), frame.handleCount);
+            bool outQueueChanged = false;
+            uint32_t outLength = 0;
+            hidl_vec<hidl_handle> outHandles;
+            auto err = mEngine->execute(frame.commands.size(), handles, &outQueueChanged,
+                                        &outLength, &outHandles);
+            mEngine->reset();
+            if (err != Error::NONE) {
+                report.failedFrames++;
+            }
+        }
+    }
+    report.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    mEngine->setStats(nullptr);
+
+    return report;
+}
+
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifndef LOG_TAG
+#warning "CommandStreamReplayer.h included without LOG_TAG"
+#endif
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <composer-command-buffer/2.1/ComposerCommandBuffer.h>
+#include <composer-hal/2.1/ComposerCommandEngine.h>
+#include <composer-replay/2.1/CommandStream.h>
+#include <composer-resources/2.1/ComposerResources.h>
+
+#include "FakeComposerHal.h"
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+
+struct CommandStats {
+    uint64_t count = 0;
+    // time spent parsing the command and dispatching it to the HAL
+    std::chrono::nanoseconds total{0};
+};
+
+struct ReplayReport {
+    uint64_t frames = 0;
+    // frames rejected by the command engine as a whole
+    uint64_t failedFrames = 0;
+    uint64_t bytes = 0;
+    std::chrono::nanoseconds elapsed{0};
+    std::map<IComposerClient::Command, CommandStats> commands;
+};
+
+// Executes command streams with the real ComposerCommandEngine and
+// ComposerResources on top of FakeComposerHal.  No mapper is needed: the
+// resources are never initialized, and the stand-in handles used for replay
+// import as null buffers.
+class CommandStreamReplayer {
+  public:
+    CommandStreamReplayer();
+    ~CommandStreamReplayer();
+
+    CommandStreamReplayer(const CommandStreamReplayer&) = delete;
+    CommandStreamReplayer& operator=(const CommandStreamReplayer&) = delete;
+
+    // Register a display or a layer, as IComposerClient would when the client
+    // creates them.  Adding a layer adds its display if needed.
+    void addDisplay(Display display);
+    void addLayer(Display display, Layer layer);
+
+    // Register every display and layer selected by the frames.
+    void addDisplaysAndLayers(const std::vector<CommandFrame>& frames);
+
+    void setBatchObserver(hal::ComposerCommandEngine::BatchObserver observer);
+
+    // Execute the pending commands of a client side writer, as
+    // IComposerClient::executeCommands would.
+    Error execute(CommandWriterBase* writer);
+
+    // Execute every frame `iterations` times and report the cost.
+    ReplayReport replay(const std::vector<CommandFrame>& frames, size_t iterations);
+
+  private:
+    class TimedCommandEngine;
+
+    // buffer and client target slots of the registered layers and displays
+    static constexpr uint32_t kSlotCount = 64;
+
+    FakeComposerHal mHal;
+    std::unique_ptr<hal::ComposerResources> mResources;
+    std::unique_ptr<TimedCommandEngine> mEngine;
+    std::vector<native_handle_t*> mStandInHandles;
+    // whether the engine no longer reads from the queue of the writers passed
+    // to execute
+    bool mWriterQueueDetached = false;
+};
+
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
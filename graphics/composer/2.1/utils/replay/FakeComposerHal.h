@@ -0,0 +1,222 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifndef LOG_TAG
+#warning "FakeComposerHal.h included without LOG_TAG"
+#endif
+
+#include <unistd.h>
+
+#include <composer-hal/2.1/ComposerHal.h>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+
+using hal::ComposerHal;
+
+// ComposerHal that accepts every call and does no work, so that replaying a
+// command stream against it measures the cost of the command path alone.
+// Displays never request composition changes and fences are always -1.
+class FakeComposerHal : public ComposerHal {
+  public:
+    bool hasCapability(hwc2_capability_t capability) override {
+        return capability == HWC2_CAPABILITY_SKIP_VALIDATE;
+    }
+
+    std::string dumpDebugInfo() override { return std::string(); }
+
+    void registerEventCallback(EventCallback* /*callback*/) override {}
+    void unregisterEventCallback() override {}
+
+    uint32_t getMaxVirtualDisplayCount() override { return 0; }
+    Error createVirtualDisplay(uint32_t /*width*/, uint32_t /*height*/, PixelFormat* /*format*/,
+                               Display* /*outDisplay*/) override {
+        return Error::NO_RESOURCES;
+    }
+    Error destroyVirtualDisplay(Display /*display*/) override { return Error::BAD_DISPLAY; }
+    Error createLayer(Display /*display*/, Layer* outLayer) override {
+        *outLayer = mNextLayer++;
+        return Error::NONE;
+    }
+    Error destroyLayer(Display /*display*/, Layer /*layer*/) override { return Error::NONE; }
+
+    Error getActiveConfig(Display /*display*/, Config* outConfig) override {
+        *outConfig = 0;
+        return Error::NONE;
+    }
+    Error getClientTargetSupport(Display /*display*/, uint32_t /*width*/, uint32_t /*height*/,
+                                 PixelFormat /*format*/, Dataspace /*dataspace*/) override {
+        return Error::NONE;
+    }
+    Error getColorModes(Display /*display*/, hidl_vec<ColorMode>* outModes) override {
+        *outModes = hidl_vec<ColorMode>{ColorMode::NATIVE};
+        return Error::NONE;
+    }
+    Error getDisplayAttribute(Display /*display*/, Config /*config*/,
+                              IComposerClient::Attribute /*attribute*/,
+                              int32_t* outValue) override {
+        *outValue = 0;
+        return Error::NONE;
+    }
+    Error getDisplayConfigs(Display /*display*/, hidl_vec<Config>* outConfigs) override {
+        *outConfigs = hidl_vec<Config>{0};
+        return Error::NONE;
+    }
+    Error getDisplayName(Display /*display*/, hidl_string* outName) override {
+        *outName = "replay";
+        return Error::NONE;
+    }
+    Error getDisplayType(Display /*display*/, IComposerClient::DisplayType* outType) override {
+        *outType = IComposerClient::DisplayType::PHYSICAL;
+        return Error::NONE;
+    }
+    Error getDozeSupport(Display /*display*/, bool* outSupport) override {
+        *outSupport = false;
+        return Error::NONE;
+    }
+    Error getHdrCapabilities(Display /*display*/, hidl_vec<Hdr>* outTypes,
+                             float* outMaxLuminance, float* outMaxAverageLuminance,
+                             float* outMinLuminance) override {
+        outTypes->resize(0);
+        *outMaxLuminance = 0.0f;
+        *outMaxAverageLuminance = 0.0f;
+        *outMinLuminance = 0.0f;
+        return Error::NONE;
+    }
+
+    Error setActiveConfig(Display /*display*/, Config /*config*/) override { return Error::NONE; }
+    Error setColorMode(Display /*display*/, ColorMode /*mode*/) override { return Error::NONE; }
+    Error setPowerMode(Display /*display*/, IComposerClient::PowerMode /*mode*/) override {
+        return Error::NONE;
+    }
+    Error setVsyncEnabled(Display /*display*/, IComposerClient::Vsync /*enabled*/) override {
+        return Error::NONE;
+    }
+
+    Error setColorTransform(Display /*display*/, const float* /*matrix*/,
+                            int32_t /*hint*/) override {
+        return Error::NONE;
+    }
+    Error setClientTarget(Display /*display*/, buffer_handle_t /*target*/, int32_t acquireFence,
+                          int32_t /*dataspace*/,
+                          const std::vector<hwc_rect_t>& /*damage*/) override {
+        closeFence(acquireFence);
+        return Error::NONE;
+    }
+    Error setOutputBuffer(Display /*display*/, buffer_handle_t /*buffer*/,
+                          int32_t releaseFence) override {
+        closeFence(releaseFence);
+        return Error::NONE;
+    }
+    Error validateDisplay(Display /*display*/, std::vector<Layer>* outChangedLayers,
+                          std::vector<IComposerClient::Composition>* outCompositionTypes,
+                          uint32_t* outDisplayRequestMask, std::vector<Layer>* outRequestedLayers,
+                          std::vector<uint32_t>* outRequestMasks) override {
+        outChangedLayers->clear();
+        outCompositionTypes->clear();
+        *outDisplayRequestMask = 0;
+        outRequestedLayers->clear();
+        outRequestMasks->clear();
+        return Error::NONE;
+    }
+    Error acceptDisplayChanges(Display /*display*/) override { return Error::NONE; }
+    Error presentDisplay(Display /*display*/, int32_t* outPresentFence,
+                         std::vector<Layer>* outLayers,
+                         std::vector<int32_t>* outReleaseFences) override {
+        *outPresentFence = -1;
+        outLayers->clear();
+        outReleaseFences->clear();
+        return Error::NONE;
+    }
+
+    Error setLayerCursorPosition(Display /*display*/, Layer /*layer*/, int32_t /*x*/,
+                                 int32_t /*y*/) override {
+        return Error::NONE;
+    }
+    Error setLayerBuffer(Display /*display*/, Layer /*layer*/, buffer_handle_t /*buffer*/,
+                         int32_t acquireFence) override {
+        closeFence(acquireFence);
+        return Error::NONE;
+    }
+    Error setLayerSurfaceDamage(Display /*display*/, Layer /*layer*/,
+                                const std::vector<hwc_rect_t>& /*damage*/) override {
+        return Error::NONE;
+    }
+    Error setLayerBlendMode(Display /*display*/, Layer /*layer*/, int32_t /*mode*/) override {
+        return Error::NONE;
+    }
+    Error setLayerColor(Display /*display*/, Layer /*layer*/,
+                        IComposerClient::Color /*color*/) override {
+        return Error::NONE;
+    }
+    Error setLayerCompositionType(Display /*display*/, Layer /*layer*/,
+                                  int32_t /*type*/) override {
+        return Error::NONE;
+    }
+    Error setLayerDataspace(Display /*display*/, Layer /*layer*/,
+                            int32_t /*dataspace*/) override {
+        return Error::NONE;
+    }
+    Error setLayerDisplayFrame(Display /*display*/, Layer /*layer*/,
+                               const hwc_rect_t& /*frame*/) override {
+        return Error::NONE;
+    }
+    Error setLayerPlaneAlpha(Display /*display*/, Layer /*layer*/, float /*alpha*/) override {
+        return Error::NONE;
+    }
+    Error setLayerSidebandStream(Display /*display*/, Layer /*layer*/,
+                                 buffer_handle_t /*stream*/) override {
+        return Error::NONE;
+    }
+    Error setLayerSourceCrop(Display /*display*/, Layer /*layer*/,
+                             const hwc_frect_t& /*crop*/) override {
+        return Error::NONE;
+    }
+    Error setLayerTransform(Display /*display*/, Layer /*layer*/,
+                            int32_t /*transform*/) override {
+        return Error::NONE;
+    }
+    Error setLayerVisibleRegion(Display /*display*/, Layer /*layer*/,
+                                const std::vector<hwc_rect_t>& /*visible*/) override {
+        return Error::NONE;
+    }
+    Error setLayerZOrder(Display /*display*/, Layer /*layer*/, uint32_t /*z*/) override {
+        return Error::NONE;
+    }
+
+  private:
+    // the HAL owns the fences passed to it
+    static void closeFence(int32_t fence) {
+        if (fence >= 0) {
+            close(fence);
+        }
+    }
+
+    Layer mNextLayer = 1;
+};
+
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+
+// One batch of commands, as passed to IComposerClient::executeCommands.
+//
+// Handles cannot be recorded.  Only their number is kept, and the commands
+// still refer to them by index.  On replay every handle is replaced by an
+// empty stand-in, so buffers import as null buffers and fences read as -1.
+struct CommandFrame {
+    std::vector<uint32_t> commands;
+    uint32_t handleCount = 0;
+};
+
+// Collects command batches, e.g., from a ComposerCommandEngine batch
+// observer.  This class is thread-safe.
+class CommandStreamRecorder {
+  public:
+    void recordFrame(const uint32_t* data, uint32_t length, size_t handleCount);
+
+    std::vector<CommandFrame> getFrames() const;
+
+  private:
+    mutable std::mutex mMutex;
+    std::vector<CommandFrame> mFrames;
+};
+
+// Appends command batches to a command stream file as they are recorded, so
+// that a composer service can record its clients for as long as it runs.  The
+// file is readable at any time.  This class is thread-safe.
+class CommandStreamFileRecorder {
+  public:
+    CommandStreamFileRecorder() = default;
+    ~CommandStreamFileRecorder();
+
+    CommandStreamFileRecorder(const CommandStreamFileRecorder&) = delete;
+    CommandStreamFileRecorder& operator=(const CommandStreamFileRecorder&) = delete;
+
+    // Create the file, replacing any existing one.
+    bool open(const std::string& path);
+
+    bool recordFrame(const uint32_t* data, uint32_t length, size_t handleCount);
+
+  private:
+    std::mutex mMutex;
+    FILE* mFile = nullptr;
+    uint32_t mFrameCount = 0;
+};
+
+// Read or write a command stream file.  The file holds a small header
+// followed by the frames, in host byte order.
+bool writeCommandStream(const std::string& path, const std::vector<CommandFrame>& frames);
+bool readCommandStream(const std::string& path, std::vector<CommandFrame>* outFrames);
+
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
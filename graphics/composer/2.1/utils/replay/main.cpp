@@ -0,0 +1,189 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ComposerReplay"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "CommandStreamReplayer.h"
+
+using android::hardware::graphics::common::V1_0::Dataspace;
+using android::hardware::graphics::common::V1_0::Transform;
+using android::hardware::graphics::composer::V2_1::CommandWriterBase;
+using android::hardware::graphics::composer::V2_1::Display;
+using android::hardware::graphics::composer::V2_1::Error;
+using android::hardware::graphics::composer::V2_1::IComposerClient;
+using android::hardware::graphics::composer::V2_1::Layer;
+using android::hardware::graphics::composer::V2_1::toString;
+using android::hardware::graphics::composer::V2_1::replay::CommandFrame;
+using android::hardware::graphics::composer::V2_1::replay::CommandStreamRecorder;
+using android::hardware::graphics::composer::V2_1::replay::CommandStreamReplayer;
+using android::hardware::graphics::composer::V2_1::replay::readCommandStream;
+using android::hardware::graphics::composer::V2_1::replay::ReplayReport;
+using android::hardware::graphics::composer::V2_1::replay::writeCommandStream;
+
+namespace {
+
+constexpr Display kDisplay = 1;
+constexpr int32_t kDisplayWidth = 1080;
+constexpr int32_t kDisplayHeight = 2340;
+// frames in which every layer latches a new buffer before the buffer slots
+// are reused from the cache
+constexpr int kBufferFrames = 3;
+
+void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s record <file> [frames] [layers]\n"
+            "       %s replay <file> [iterations]\n",
+            program, program);
+}
+
+// Write a frame the way SurfaceFlinger does for a static scene of `layers`
+// full-width layers stacked on top of each other.
+void writeFrame(CommandWriterBase* writer, int frame, uint32_t layers,
+                const native_handle_t* buffer) {
+    const int32_t layerHeight = kDisplayHeight / static_cast<int32_t>(layers);
+
+    writer->selectDisplay(kDisplay);
+    for (uint32_t i = 0; i < layers; i++) {
+        const IComposerClient::Rect frameRect{0, layerHeight * static_cast<int32_t>(i),
+                                              kDisplayWidth,
+                                              layerHeight * static_cast<int32_t>(i + 1)};
+        const IComposerClient::FRect crop{0.0f, 0.0f, static_cast<float>(kDisplayWidth),
+                                          static_cast<float>(layerHeight)};
+
+        writer->selectLayer(i + 1);
+        // a null buffer reuses the one cached in the slot
+        writer->setLayerBuffer(frame % kBufferFrames,
+                               frame < kBufferFrames ? buffer : nullptr, -1);
+        writer->setLayerSurfaceDamage({frameRect});
+        writer->setLayerDisplayFrame(frameRect);
+        writer->setLayerSourceCrop(crop);
+        writer->setLayerPlaneAlpha(1.0f);
+        writer->setLayerBlendMode(IComposerClient::BlendMode::PREMULTIPLIED);
+        writer->setLayerCompositionType(IComposerClient::Composition::DEVICE);
+        writer->setLayerZOrder(i);
+        writer->setLayerDataspace(Dataspace::V0_SRGB);
+        writer->setLayerTransform(static_cast<Transform>(0));
+        writer->setLayerVisibleRegion({frameRect});
+    }
+    writer->validateDisplay();
+    writer->acceptDisplayChanges();
+    writer->presentDisplay();
+}
+
+int record(const std::string& path, int frames, uint32_t layers) {
+    CommandStreamReplayer replayer;
+    for (uint32_t i = 0; i < layers; i++) {
+        replayer.addLayer(kDisplay, i + 1);
+    }
+
+    CommandStreamRecorder recorder;
+    replayer.setBatchObserver([&recorder](const uint32_t* data, uint32_t length,
+                                          size_t handleCount) {
+        recorder.recordFrame(data, length, handleCount);
+    });
+
+    native_handle_t* buffer = native_handle_create(0, 0);
+    CommandWriterBase writer(64);
+    for (int frame = 0; frame < frames; frame++) {
+        writeFrame(&writer, frame, layers, buffer);
+        auto err = replayer.execute(&writer);
+        if (err != Error::NONE) {
+            fprintf(stderr, "frame %d failed: %s\n", frame, toString(err).c_str());
+            native_handle_delete(buffer);
+            return EXIT_FAILURE;
+        }
+    }
+    native_handle_delete(buffer);
+
+    const auto recorded = recorder.getFrames();
+    if (!writeCommandStream(path, recorded)) {
+        fprintf(stderr, "failed to write %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+    printf("recorded %zu frames of %u layers to %s\n", recorded.size(), layers, path.c_str());
+    return EXIT_SUCCESS;
+}
+
+void printReport(const ReplayReport& report) {
+    const double seconds = report.elapsed.count() / 1e9;
+    printf("frames:        %llu (%llu failed)\n", static_cast<unsigned long long>(report.frames),
+           static_cast<unsigned long long>(report.failedFrames));
+    printf("elapsed:       %.3f ms\n", seconds * 1e3);
+    if (report.frames == 0 || seconds <= 0.0) {
+        return;
+    }
+    printf("frames/s:      %.1f\n", report.frames / seconds);
+    printf("bytes/frame:   %.1f\n", static_cast<double>(report.bytes) / report.frames);
+
+    printf("\n%-32s %12s %12s\n", "command", "count", "avg ns");
+    for (const auto& [command, stats] : report.commands) {
+        printf("%-32s %12llu %12.1f\n", toString(command).c_str(),
+               static_cast<unsigned long long>(stats.count),
+               static_cast<double>(stats.total.count()) / stats.count);
+    }
+}
+
+int replay(const std::string& path, size_t iterations) {
+    std::vector<CommandFrame> frames;
+    if (!readCommandStream(path, &frames)) {
+        fprintf(stderr, "failed to read %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    CommandStreamReplayer replayer;
+    replayer.addDisplaysAndLayers(frames);
+    const auto report = replayer.replay(frames, iterations);
+    printReport(report);
+    return report.failedFrames == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[1], "record") == 0 && argc <= 5) {
+        const int frames = argc > 3 ? atoi(argv[3]) : 120;
+        const int layers = argc > 4 ? atoi(argv[4]) : 8;
+        if (frames <= 0 || layers <= 0) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        return record(argv[2], frames, static_cast<uint32_t>(layers));
+    }
+
+    if (strcmp(argv[1], "replay") == 0 && argc <= 4) {
+        const int iterations = argc > 3 ? atoi(argv[3]) : 100;
+        if (iterations <= 0) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        return replay(argv[2], static_cast<size_t>(iterations));
+    }
+
+    usage(argv[0]);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ComposerReplayTest"
+
+#include "CommandStreamReplayer.h"
+
+#include <memory>
+#include <vector>
+
+#include <composer-hal/2.1/ComposerClient.h>
+#include <gtest/gtest.h>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+namespace {
+
+constexpr Display kDisplay = 1;
+constexpr Layer kLayer = 1;
+constexpr int kFrames = 4;
+
+void writeFrame(CommandWriterBase* writer, float alpha) {
+    writer->selectDisplay(kDisplay);
+    writer->selectLayer(kLayer);
+    writer->setLayerPlaneAlpha(alpha);
+    writer->setLayerZOrder(0);
+    writer->validateDisplay();
+    writer->acceptDisplayChanges();
+    writer->presentDisplay();
+}
+
+// Records the batches executed by `replayer`.
+std::vector<CommandFrame> recordFrames(CommandStreamReplayer* replayer) {
+    CommandStreamRecorder recorder;
+    replayer->setBatchObserver(
+            [&recorder](const uint32_t* data, uint32_t length, size_t handleCount) {
+                recorder.recordFrame(data, length, handleCount);
+            });
+
+    CommandWriterBase writer(64);
+    for (int i = 0; i < kFrames; i++) {
+        writeFrame(&writer, i % 2 ? 0.5f : 1.0f);
+        EXPECT_EQ(replayer->execute(&writer), Error::NONE);
+    }
+    replayer->setBatchObserver(nullptr);
+    return recorder.getFrames();
+}
+
+TEST(CommandStreamReplayerTest, RecordAndReplay) {
+    CommandStreamReplayer recordingReplayer;
+    recordingReplayer.addLayer(kDisplay, kLayer);
+    const auto frames = recordFrames(&recordingReplayer);
+    ASSERT_EQ(frames.size(), static_cast<size_t>(kFrames));
+
+    // a fresh replayer learns the displays and layers from the stream
+    CommandStreamReplayer replayer;
+    replayer.addDisplaysAndLayers(frames);
+    constexpr size_t kIterations = 3;
+    const auto report = replayer.replay(frames, kIterations);
+
+    EXPECT_EQ(report.frames, kFrames * kIterations);
+    EXPECT_EQ(report.failedFrames, 0u);
+    EXPECT_GT(report.bytes, 0u);
+    for (auto command : {IComposerClient::Command::SELECT_DISPLAY,
+                         IComposerClient::Command::SELECT_LAYER,
+                         IComposerClient::Command::SET_LAYER_PLANE_ALPHA,
+                         IComposerClient::Command::SET_LAYER_Z_ORDER,
+                         IComposerClient::Command::VALIDATE_DISPLAY,
+                         IComposerClient::Command::PRESENT_DISPLAY}) {
+        auto it = report.commands.find(command);
+        ASSERT_NE(it, report.commands.end()) << toString(command);
+        EXPECT_EQ(it->second.count, kFrames * kIterations) << toString(command);
+    }
+}
+
+TEST(CommandStreamReplayerTest, ReplayEmptyStream) {
+    CommandStreamReplayer replayer;
+    const auto report = replayer.replay({}, 1);
+
+    EXPECT_EQ(report.frames, 0u);
+    EXPECT_EQ(report.failedFrames, 0u);
+    EXPECT_TRUE(report.commands.empty());
+}
+
+// ComposerClient that does not need a mapper, since no buffer is imported.
+// kDisplay is connected from the start.
+class TestComposerClient : public hal::ComposerClient {
+  public:
+    using hal::ComposerClient::ComposerClient;
+
+  protected:
+    std::unique_ptr<hal::ComposerResources> createResources() override {
+        auto resources = std::make_unique<hal::ComposerResources>();
+        resources->addPhysicalDisplay(kDisplay);
+        return resources;
+    }
+};
+
+// Execute the pending commands of `writer`, as the client side would.
+void executeCommands(TestComposerClient* client, CommandWriterBase* writer,
+                     uint32_t* outLength = nullptr, size_t* outHandleCount = nullptr) {
+    bool queueChanged = false;
+    uint32_t length = 0;
+    hidl_vec<hidl_handle> handles;
+    ASSERT_TRUE(writer->writeQueue(&queueChanged, &length, &handles));
+    if (queueChanged) {
+        ASSERT_EQ(client->setInputCommandQueue(*writer->getMQDescriptor()), Error::NONE);
+    }
+    client->executeCommands(length, handles,
+                            [](Error, bool, uint32_t, const hidl_vec<hidl_handle>&) {});
+    writer->reset();
+
+    if (outLength) {
+        *outLength = length;
+    }
+    if (outHandleCount) {
+        *outHandleCount = handles.size();
+    }
+}
+
+TEST(CommandStreamReplayerTest, ComposerClientObserver) {
+    FakeComposerHal hal;
+    TestComposerClient client(&hal);
+    ASSERT_TRUE(client.init());
+
+    CommandStreamRecorder recorder;
+    client.setCommandBatchObserver(
+            [&recorder](const uint32_t* data, uint32_t length, size_t handleCount) {
+                recorder.recordFrame(data, length, handleCount);
+            });
+
+    CommandWriterBase writer(64);
+    writeFrame(&writer, 1.0f);
+    uint32_t length = 0;
+    size_t handleCount = 0;
+    executeCommands(&client, &writer, &length, &handleCount);
+
+    const auto frames = recorder.getFrames();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].commands.size(), length);
+    EXPECT_EQ(frames[0].handleCount, handleCount);
+}
+
+// FakeComposerHal that keeps the layer state dirty masks it is given
+class DirtyMaskComposerHal : public FakeComposerHal {
+  public:
+    void setLayerStateDirtyMask(Display /*display*/, uint32_t dirtyMask) override {
+        dirtyMasks.push_back(dirtyMask);
+    }
+
+    std::vector<uint32_t> dirtyMasks;
+};
+
+TEST(CommandStreamReplayerTest, PresentDisplayClearsDirtyMask) {
+    DirtyMaskComposerHal hal;
+    TestComposerClient client(&hal);
+    ASSERT_TRUE(client.init());
+    Layer layer = 0;
+    client.createLayer(kDisplay, 1, [&layer](Error error, Layer outLayer) {
+        ASSERT_EQ(error, Error::NONE);
+        layer = outLayer;
+    });
+
+    CommandWriterBase writer(64);
+    writer.selectDisplay(kDisplay);
+    writer.selectLayer(layer);
+    writer.setLayerPlaneAlpha(1.0f);
+    writer.validateDisplay();
+    writer.presentDisplay();
+    executeCommands(&client, &writer);
+
+    // a frame presented without validation
+    writer.selectDisplay(kDisplay);
+    writer.selectLayer(layer);
+    writer.setLayerPlaneAlpha(0.5f);
+    writer.presentDisplay();
+    executeCommands(&client, &writer);
+
+    writer.selectDisplay(kDisplay);
+    writer.validateDisplay();
+    executeCommands(&client, &writer);
+
+    // everything is dirty after a layer is created
+    ASSERT_EQ(hal.dirtyMasks.size(), 2u);
+    EXPECT_EQ(hal.dirtyMasks[0], hal::kAllLayerPropertiesMask);
+    EXPECT_EQ(hal.dirtyMasks[1], 0u);
+}
+
+}  // namespace
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <composer-replay/2.1/CommandStream.h>
+
+#include <string>
+#include <vector>
+
+#include <android-base/file.h>
+#include <gtest/gtest.h>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+namespace {
+
+std::vector<CommandFrame> makeFrames() {
+    std::vector<CommandFrame> frames(3);
+    frames[0].commands = {0x01000002, 1, 0};
+    frames[0].handleCount = 2;
+    frames[1].commands = {0x02000002, 7, 0, 0x13000000};
+    frames[2].handleCount = 1;
+    return frames;
+}
+
+void expectFramesEq(const std::vector<CommandFrame>& actual,
+                    const std::vector<CommandFrame>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(actual[i].commands, expected[i].commands) << "frame " << i;
+        EXPECT_EQ(actual[i].handleCount, expected[i].handleCount) << "frame " << i;
+    }
+}
+
+TEST(CommandStreamTest, WriteAndRead) {
+    TemporaryFile file;
+    const auto frames = makeFrames();
+    ASSERT_TRUE(writeCommandStream(file.path, frames));
+
+    std::vector<CommandFrame> readFrames;
+    ASSERT_TRUE(readCommandStream(file.path, &readFrames));
+    expectFramesEq(readFrames, frames);
+}
+
+TEST(CommandStreamTest, ReadMissingFile) {
+    std::vector<CommandFrame> frames;
+    EXPECT_FALSE(readCommandStream("/nonexistent/command-stream", &frames));
+}
+
+TEST(CommandStreamTest, ReadTruncatedFile) {
+    TemporaryFile file;
+    ASSERT_TRUE(writeCommandStream(file.path, makeFrames()));
+    std::string data;
+    ASSERT_TRUE(base::ReadFileToString(file.path, &data));
+    ASSERT_TRUE(base::WriteStringToFile(data.substr(0, data.size() - sizeof(uint32_t)),
+                                        file.path));
+
+    std::vector<CommandFrame> frames;
+    EXPECT_FALSE(readCommandStream(file.path, &frames));
+    EXPECT_TRUE(frames.empty());
+}
+
+TEST(CommandStreamTest, ReadOtherFile) {
+    TemporaryFile file;
+    ASSERT_TRUE(base::WriteStringToFile("not a command stream", file.path));
+
+    std::vector<CommandFrame> frames;
+    EXPECT_FALSE(readCommandStream(file.path, &frames));
+}
+
+TEST(CommandStreamTest, Recorder) {
+    const auto frames = makeFrames();
+    CommandStreamRecorder recorder;
+    for (const auto& frame : frames) {
+        recorder.recordFrame(frame.commands.data(), frame.commands.size(), frame.handleCount);
+    }
+
+    expectFramesEq(recorder.getFrames(), frames);
+}
+
+TEST(CommandStreamTest, FileRecorder) {
+    TemporaryFile file;
+    const auto frames = makeFrames();
+    CommandStreamFileRecorder recorder;
+    ASSERT_TRUE(recorder.open(file.path));
+
+    // the file is complete after every frame
+    std::vector<CommandFrame> readFrames;
+    ASSERT_TRUE(readCommandStream(file.path, &readFrames));
+    EXPECT_TRUE(readFrames.empty());
+    for (size_t i = 0; i < frames.size(); i++) {
+        ASSERT_TRUE(recorder.recordFrame(frames[i].commands.data(), frames[i].commands.size(),
+                                         frames[i].handleCount));
+        ASSERT_TRUE(readCommandStream(file.path, &readFrames));
+        expectFramesEq(readFrames,
+                       std::vector<CommandFrame>(frames.begin(), frames.begin() + i + 1));
+    }
+}
+
+TEST(CommandStreamTest, FileRecorderNotOpened) {
+    CommandStreamFileRecorder recorder;
+    const uint32_t command = 0x13000000;
+    EXPECT_FALSE(recorder.recordFrame(&command, 1, 0));
+}
+
+}  // namespace
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
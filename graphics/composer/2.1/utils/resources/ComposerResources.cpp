@@ -18,6 +18,10 @@
 
 #include "composer-resources/2.1/ComposerResources.h"
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
 namespace android {
 namespace hardware {
 namespace graphics {
@@ -25,6 +29,40 @@ namespace composer {
 namespace V2_1 {
 namespace hal {
 
+const char* toString(LayerProperty property) {
+    switch (property) {
+        case LayerProperty::BLEND_MODE:
+            return "BLEND_MODE";
+        case LayerProperty::COLOR:
+            return "COLOR";
+        case LayerProperty::COMPOSITION_TYPE:
+            return "COMPOSITION_TYPE";
+        case LayerProperty::DATASPACE:
+            return "DATASPACE";
+        case LayerProperty::DISPLAY_FRAME:
+            return "DISPLAY_FRAME";
+        case LayerProperty::PLANE_ALPHA:
+            return "PLANE_ALPHA";
+        case LayerProperty::SOURCE_CROP:
+            return "SOURCE_CROP";
+        case LayerProperty::TRANSFORM:
+            return "TRANSFORM";
+        case LayerProperty::VISIBLE_REGION:
+            return "VISIBLE_REGION";
+        case LayerProperty::Z_ORDER:
+            return "Z_ORDER";
+        case LayerProperty::BUFFER:
+            return "BUFFER";
+        case LayerProperty::CURSOR_POSITION:
+            return "CURSOR_POSITION";
+        case LayerProperty::SIDEBAND_STREAM:
+            return "SIDEBAND_STREAM";
+        case LayerProperty::SURFACE_DAMAGE:
+            return "SURFACE_DAMAGE";
+    }
+    return "UNKNOWN";
+}
+
 bool ComposerHandleImporter::init() {
     mMapper4 = mapper::V4_0::IMapper::getService();
     if (mMapper4) {
@@ -213,12 +251,38 @@ Error ComposerLayerResource::getSidebandStream(uint32_t slot, bool fromCache,
     return mSidebandStreamCache.getHandle(slot, fromCache, inHandle, outHandle, outReplacedHandle);
 }
 
+bool ComposerLayerResource::updateState(LayerProperty property, const void* value, size_t size) {
+    const auto index = static_cast<size_t>(property);
+    if (index >= mCachedStates.size()) {
+        return true;
+    }
+
+    auto& state = mCachedStates[index];
+    const auto* bytes = static_cast<const uint8_t*>(value);
+    if (state.valid && state.value.size() == size &&
+        (size == 0 || memcmp(state.value.data(), bytes, size) == 0)) {
+        return false;
+    }
+
+    state.value.assign(bytes, bytes + size);
+    state.valid = true;
+    return true;
+}
+
+void ComposerLayerResource::invalidateState(LayerProperty property) {
+    const auto index = static_cast<size_t>(property);
+    if (index < mCachedStates.size()) {
+        mCachedStates[index].valid = false;
+    }
+}
+
 ComposerDisplayResource::ComposerDisplayResource(DisplayType type, ComposerHandleImporter& importer,
                                                  uint32_t outputBufferCacheSize)
     : mType(type),
       mClientTargetCache(importer),
       mOutputBufferCache(importer, ComposerHandleCache::HandleType::BUFFER, outputBufferCacheSize),
-      mMustValidate(true) {}
+      mMustValidate(true),
+      mLayerStateDirtyMask(kAllLayerPropertiesMask) {}
 
 bool ComposerDisplayResource::initClientTargetCache(uint32_t cacheSize) {
     return mClientTargetCache.initCache(ComposerHandleCache::HandleType::BUFFER, cacheSize);
@@ -253,11 +317,18 @@ Error ComposerDisplayResource::getOutputBuffer(uint32_t slot, bool fromCache,
 bool ComposerDisplayResource::addLayer(Layer layer,
                                        std::unique_ptr<ComposerLayerResource> layerResource) {
     auto result = mLayerResources.emplace(layer, std::move(layerResource));
+    if (result.second) {
+        mLayerStateDirtyMask = kAllLayerPropertiesMask;
+    }
     return result.second;
 }
 
 bool ComposerDisplayResource::removeLayer(Layer layer) {
-    return mLayerResources.erase(layer) > 0;
+    if (mLayerResources.erase(layer) == 0) {
+        return false;
+    }
+    mLayerStateDirtyMask = kAllLayerPropertiesMask;
+    return true;
 }
 
 ComposerLayerResource* ComposerDisplayResource::findLayerResource(Layer layer) {
@@ -286,6 +357,18 @@ bool ComposerDisplayResource::mustValidate() const {
     return mMustValidate;
 }
 
+void ComposerDisplayResource::markLayerStateDirty(LayerProperty property) {
+    mLayerStateDirtyMask |= toLayerPropertyMask(property);
+}
+
+uint32_t ComposerDisplayResource::getLayerStateDirtyMask() const {
+    return mLayerStateDirtyMask;
+}
+
+void ComposerDisplayResource::clearLayerStateDirtyMask() {
+    mLayerStateDirtyMask = 0;
+}
+
 std::unique_ptr<ComposerResources> ComposerResources::create() {
     auto resources = std::make_unique<ComposerResources>();
     return resources->init() ? std::move(resources) : nullptr;
@@ -435,6 +518,87 @@ bool ComposerResources::mustValidateDisplay(Display display) {
     return false;
 }
 
+bool ComposerResources::updateLayerState(Display display, Layer layer, LayerProperty property,
+                                         const void* value, size_t size) {
+    std::lock_guard<std::mutex> lock(mDisplayResourcesMutex);
+    auto* displayResource = findDisplayResourceLocked(display);
+    auto* layerResource = displayResource ? displayResource->findLayerResource(layer) : nullptr;
+    if (!layerResource) {
+        return true;
+    }
+
+    const bool changed = layerResource->updateState(property, value, size);
+    const auto index = static_cast<size_t>(property);
+    if (index < mLayerStateStats.size()) {
+        auto& stats = mLayerStateStats[index];
+        if (changed) {
+            stats.misses++;
+        } else {
+            stats.hits++;
+        }
+    }
+    if (changed) {
+        displayResource->markLayerStateDirty(property);
+    }
+    return changed;
+}
+
+void ComposerResources::invalidateLayerState(Display display, Layer layer,
+                                             LayerProperty property) {
+    std::lock_guard<std::mutex> lock(mDisplayResourcesMutex);
+    auto* displayResource = findDisplayResourceLocked(display);
+    auto* layerResource = displayResource ? displayResource->findLayerResource(layer) : nullptr;
+    if (layerResource) {
+        layerResource->invalidateState(property);
+    }
+}
+
+void ComposerResources::markLayerStateDirty(Display display, LayerProperty property) {
+    std::lock_guard<std::mutex> lock(mDisplayResourcesMutex);
+    auto* displayResource = findDisplayResourceLocked(display);
+    if (displayResource) {
+        displayResource->markLayerStateDirty(property);
+    }
+}
+
+uint32_t ComposerResources::getDisplayLayerStateDirtyMask(Display display) {
+    std::lock_guard<std::mutex> lock(mDisplayResourcesMutex);
+    auto* displayResource = findDisplayResourceLocked(display);
+    if (displayResource) {
+        return displayResource->getLayerStateDirtyMask();
+    }
+    return 0;
+}
+
+void ComposerResources::clearDisplayLayerStateDirtyMask(Display display) {
+    std::lock_guard<std::mutex> lock(mDisplayResourcesMutex);
+    auto* displayResource = findDisplayResourceLocked(display);
+    if (displayResource) {
+        displayResource->clearLayerStateDirtyMask();
+    }
+}
+
+std::string ComposerResources::dumpDebugInfo() {
+    std::lock_guard<std::mutex> lock(mDisplayResourcesMutex);
+    uint64_t totalHits = 0;
+    uint64_t totalMisses = 0;
+    std::string output = "Layer state cache:\n";
+    auto appendLine = [&output](const char* name, uint64_t hits, uint64_t misses) {
+        char line[96];
+        snprintf(line, sizeof(line), "  %-16s hits %" PRIu64 ", misses %" PRIu64 "\n", name, hits,
+                 misses);
+        output += line;
+    };
+    for (size_t i = 0; i < mLayerStateStats.size(); i++) {
+        const auto& stats = mLayerStateStats[i];
+        appendLine(toString(static_cast<LayerProperty>(i)), stats.hits, stats.misses);
+        totalHits += stats.hits;
+        totalMisses += stats.misses;
+    }
+    appendLine("total", totalHits, totalMisses);
+    return output;
+}
+
 std::unique_ptr<ComposerDisplayResource> ComposerResources::createDisplayResource(
         ComposerDisplayResource::DisplayType type, uint32_t outputBufferCacheSize) {
     return std::make_unique<ComposerDisplayResource>(type, mImporter, outputBufferCacheSize);
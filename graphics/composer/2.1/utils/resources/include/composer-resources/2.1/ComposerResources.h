@@ -20,8 +20,11 @@
 #warning "ComposerResources.h included without LOG_TAG"
 #endif
 
+#include <array>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -89,6 +92,39 @@ class ComposerHandleCache {
     std::vector<const native_handle_t*> mHandles;
 };
 
+// Layer properties tracked by the layer state cache.  The value of each
+// property is its bit position in the per-display dirty mask.  Properties up
+// to kCachedLayerPropertyCount are idempotent and have their last value
+// shadowed, so that a command setting the same value again does not reach the
+// HAL.  The remaining properties change every frame or have side effects, and
+// only mark the dirty mask.
+enum class LayerProperty : uint32_t {
+    BLEND_MODE,
+    COLOR,
+    COMPOSITION_TYPE,
+    DATASPACE,
+    DISPLAY_FRAME,
+    PLANE_ALPHA,
+    SOURCE_CROP,
+    TRANSFORM,
+    VISIBLE_REGION,
+    Z_ORDER,
+    BUFFER,
+    CURSOR_POSITION,
+    SIDEBAND_STREAM,
+    SURFACE_DAMAGE,
+};
+
+constexpr size_t kCachedLayerPropertyCount = static_cast<size_t>(LayerProperty::Z_ORDER) + 1;
+constexpr size_t kLayerPropertyCount = static_cast<size_t>(LayerProperty::SURFACE_DAMAGE) + 1;
+constexpr uint32_t kAllLayerPropertiesMask = (1u << kLayerPropertyCount) - 1;
+
+constexpr uint32_t toLayerPropertyMask(LayerProperty property) {
+    return 1u << static_cast<uint32_t>(property);
+}
+
+const char* toString(LayerProperty property);
+
 // layer resource
 class ComposerLayerResource {
   public:
@@ -102,9 +138,22 @@ class ComposerLayerResource {
                             const native_handle_t** outHandle,
                             const native_handle** outReplacedHandle);
 
+    // Record the value of a cached property.  Returns false when the value is
+    // the same as the one recorded last.
+    bool updateState(LayerProperty property, const void* value, size_t size);
+    // Forget the value of a cached property, e.g., when the HAL rejected it or
+    // may have changed it on its own.
+    void invalidateState(LayerProperty property);
+
   protected:
+    struct CachedState {
+        bool valid = false;
+        std::vector<uint8_t> value;
+    };
+
     ComposerHandleCache mBufferCache;
     ComposerHandleCache mSidebandStreamCache;
+    std::array<CachedState, kCachedLayerPropertyCount> mCachedStates;
 };
 
 // display resource
@@ -142,11 +191,17 @@ class ComposerDisplayResource {
 
     bool mustValidate() const;
 
+    void markLayerStateDirty(LayerProperty property);
+    uint32_t getLayerStateDirtyMask() const;
+    void clearLayerStateDirtyMask();
+
   protected:
     const DisplayType mType;
     ComposerHandleCache mClientTargetCache;
     ComposerHandleCache mOutputBufferCache;
     bool mMustValidate;
+    // layer properties changed since the display was last validated
+    uint32_t mLayerStateDirtyMask;
 
     std::unordered_map<Layer, std::unique_ptr<ComposerLayerResource>> mLayerResources;
 };
@@ -181,6 +236,39 @@ class ComposerResources {
 
     bool mustValidateDisplay(Display display);
 
+    // Record the value of a cached layer property and mark it dirty on the
+    // display.  Returns false when the value is unchanged and the command can
+    // be dropped.  Returns true when the value changed, or when the display or
+    // layer is unknown so that the HAL reports the error.
+    bool updateLayerState(Display display, Layer layer, LayerProperty property, const void* value,
+                          size_t size);
+
+    template <typename T>
+    bool updateLayerState(Display display, Layer layer, LayerProperty property, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return updateLayerState(display, layer, property, &value, sizeof(T));
+    }
+
+    template <typename T>
+    bool updateLayerState(Display display, Layer layer, LayerProperty property,
+                          const std::vector<T>& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return updateLayerState(display, layer, property, value.data(), value.size() * sizeof(T));
+    }
+
+    void invalidateLayerState(Display display, Layer layer, LayerProperty property);
+
+    // mark a property that is not cached as dirty on the display
+    void markLayerStateDirty(Display display, LayerProperty property);
+
+    // bitmask of toLayerPropertyMask() for the properties set on any layer of
+    // the display since it was last validated or presented
+    uint32_t getDisplayLayerStateDirtyMask(Display display);
+    void clearDisplayLayerStateDirtyMask(Display display);
+
+    // dump the layer state cache hit and miss counters
+    std::string dumpDebugInfo();
+
     // When a buffer in the cache is replaced by a new one, we must keep it
     // alive until it has been replaced in ComposerHal because it is still using
     // the old buffer.
@@ -245,6 +333,12 @@ class ComposerResources {
     std::mutex mDisplayResourcesMutex;
     std::unordered_map<Display, std::unique_ptr<ComposerDisplayResource>> mDisplayResources;
 
+    struct LayerStateStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+    std::array<LayerStateStats, kCachedLayerPropertyCount> mLayerStateStats;
+
   private:
     enum class Cache {
         CLIENT_TARGET,
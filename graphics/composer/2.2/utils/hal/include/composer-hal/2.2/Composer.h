@@ -52,6 +52,10 @@ class ComposerImpl : public V2_1::hal::detail::ComposerImpl<Interface, Hal> {
 
         auto clientDestroyed = [this]() { onClientDestroyed(); };
         client->setOnClientDestroyed(clientDestroyed);
+        mDumpClientDebugInfo = [client = client.get()]() { return client->dumpDebugInfo(); };
+        if (mCommandBatchObserver) {
+            client->setCommandBatchObserver(mCommandBatchObserver);
+        }
 
         return client.release();
     }
@@ -59,6 +63,8 @@ class ComposerImpl : public V2_1::hal::detail::ComposerImpl<Interface, Hal> {
    private:
     using BaseType2_1 = V2_1::hal::detail::ComposerImpl<Interface, Hal>;
     using BaseType2_1::mHal;
+    using BaseType2_1::mCommandBatchObserver;
+    using BaseType2_1::mDumpClientDebugInfo;
     using BaseType2_1::onClientDestroyed;
 };
 
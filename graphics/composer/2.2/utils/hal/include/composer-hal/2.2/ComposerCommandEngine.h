@@ -81,6 +81,10 @@ class ComposerCommandEngine : public V2_1::hal::ComposerCommandEngine {
             return false;
         }
 
+        // the float color replaces the color cached from SET_LAYER_COLOR
+        mResources->invalidateLayerState(mCurrentDisplay, mCurrentLayer,
+                                         V2_1::hal::LayerProperty::COLOR);
+        mResources->markLayerStateDirty(mCurrentDisplay, V2_1::hal::LayerProperty::COLOR);
         auto err = mHal->setLayerFloatColor(mCurrentDisplay, mCurrentLayer, readFloatColor());
         if (err != Error::NONE) {
             mWriter->setError(getCommandLoc(), err);
@@ -60,6 +60,10 @@ class ComposerImpl : public V2_2::hal::detail::ComposerImpl<Interface, Hal> {
 
         auto clientDestroyed = [this]() { onClientDestroyed(); };
         client->setOnClientDestroyed(clientDestroyed);
+        mDumpClientDebugInfo = [client = client.get()]() { return client->dumpDebugInfo(); };
+        if (mCommandBatchObserver) {
+            client->setCommandBatchObserver(mCommandBatchObserver);
+        }
 
         mClient = client;
         hidl_cb(Error::NONE, client);
@@ -72,6 +76,8 @@ class ComposerImpl : public V2_2::hal::detail::ComposerImpl<Interface, Hal> {
 
     using BaseType2_1::mClient;
     using BaseType2_1::mClientMutex;
+    using BaseType2_1::mCommandBatchObserver;
+    using BaseType2_1::mDumpClientDebugInfo;
     using BaseType2_1::mHal;
     using BaseType2_1::onClientDestroyed;
     using BaseType2_1::waitForClientDestroyedLocked;
@@ -58,10 +58,12 @@ class ComposerCommandEngine : public V2_3::hal::ComposerCommandEngine {
         IComposerClient::ClientTargetProperty clientTargetProperty{PixelFormat::RGBA_8888,
                                                                    Dataspace::UNKNOWN};
 
+        prepareValidateDisplay();
         auto err = mHal->validateDisplay_2_4(mCurrentDisplay, &changedLayers, &compositionTypes,
                                              &displayRequestMask, &requestedLayers, &requestMasks,
                                              &clientTargetProperty);
         mResources->setDisplayMustValidateState(mCurrentDisplay, false);
+        onDisplayValidated(static_cast<V2_1::Error>(err), changedLayers);
         if (err == Error::NONE) {
             mWriter->setChangedCompositionTypes(changedLayers, compositionTypes);
             mWriter->setDisplayRequests(displayRequestMask, requestedLayers, requestMasks);
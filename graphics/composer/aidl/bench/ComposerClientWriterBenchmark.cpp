@@ -0,0 +1,141 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android/hardware/graphics/composer3/ComposerClientWriter.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> gAllocations{0};
+
+}  // namespace
+
+// Count every heap allocation made by the benchmark so that each run can report allocations per
+// frame next to its timing.
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+namespace aidl::android::hardware::graphics::composer3 {
+namespace {
+
+constexpr int64_t kDisplay = 1;
+constexpr int64_t kLayerCount = 64;
+constexpr float kIdentity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+// Writes the commands of a typical frame: every layer gets a new buffer from its cache slot, a
+// damage region and the geometry and blending state that SurfaceFlinger sets each frame.
+void writeFrame(ComposerClientWriter& writer, int frame) {
+    for (int64_t layer = 0; layer < kLayerCount; layer++) {
+        const int32_t offset = static_cast<int32_t>(layer) * 8 + (frame & 7);
+        const Rect frameRect = {offset, offset, offset + 256, offset + 256};
+        const std::vector<Rect> region = {frameRect};
+
+        writer.setLayerBuffer(kDisplay, layer, static_cast<uint32_t>(frame & 3), nullptr, -1);
+        writer.setLayerSurfaceDamage(kDisplay, layer, region);
+        writer.setLayerBlendMode(kDisplay, layer, BlendMode::PREMULTIPLIED);
+        writer.setLayerCompositionType(kDisplay, layer, Composition::DEVICE);
+        writer.setLayerDataspace(kDisplay, layer, Dataspace::SRGB);
+        writer.setLayerDisplayFrame(kDisplay, layer, frameRect);
+        writer.setLayerPlaneAlpha(kDisplay, layer, 1.0f);
+        writer.setLayerSourceCrop(kDisplay, layer, FRect{0.0f, 0.0f, 256.0f, 256.0f});
+        writer.setLayerTransform(kDisplay, layer, static_cast<Transform>(0));
+        writer.setLayerVisibleRegion(kDisplay, layer, region);
+        writer.setLayerZOrder(kDisplay, layer, static_cast<uint32_t>(layer));
+        writer.setLayerColorTransform(kDisplay, layer, kIdentity);
+    }
+    writer.setColorTransform(kDisplay, kIdentity);
+    writer.validateDisplay(kDisplay, ComposerClientWriter::kNoTimestamp);
+}
+
+// The region vectors built by writeFrame itself are not writer allocations, so they are measured
+// once and subtracted from the per-frame counts.
+uint64_t countFrameInputAllocations() {
+    const uint64_t before = gAllocations.load(std::memory_order_relaxed);
+    for (int64_t layer = 0; layer < kLayerCount; layer++) {
+        const std::vector<Rect> region = {Rect{0, 0, 1, 1}};
+        benchmark::DoNotOptimize(region.data());
+    }
+    return gAllocations.load(std::memory_order_relaxed) - before;
+}
+
+void reportAllocations(benchmark::State& state, uint64_t allocations) {
+    const uint64_t inputAllocations = countFrameInputAllocations() * state.iterations();
+    state.counters["allocs_per_frame"] = benchmark::Counter(
+            static_cast<double>(allocations - std::min(allocations, inputAllocations)),
+            benchmark::Counter::kAvgIterations);
+}
+
+void BM_TakePendingCommands(benchmark::State& state) {
+    ComposerClientWriter writer(kDisplay);
+    int frame = 0;
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        const uint64_t before = gAllocations.load(std::memory_order_relaxed);
+        writeFrame(writer, frame++);
+        auto commands = writer.takePendingCommands();
+        benchmark::DoNotOptimize(commands.data());
+        commands.clear();
+        allocations += gAllocations.load(std::memory_order_relaxed) - before;
+    }
+    reportAllocations(state, allocations);
+}
+BENCHMARK(BM_TakePendingCommands);
+
+void BM_ReusePendingCommands(benchmark::State& state) {
+    ComposerClientWriter writer(kDisplay);
+    // warm up the recycled storage with one frame
+    writeFrame(writer, 0);
+    writer.clearPendingCommands();
+
+    int frame = 1;
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        const uint64_t before = gAllocations.load(std::memory_order_relaxed);
+        writeFrame(writer, frame++);
+        const auto& commands = writer.getPendingCommands();
+        benchmark::DoNotOptimize(commands.data());
+        writer.clearPendingCommands();
+        allocations += gAllocations.load(std::memory_order_relaxed) - before;
+    }
+    reportAllocations(state, allocations);
+}
+BENCHMARK(BM_ReusePendingCommands);
+
+}  // namespace
+}  // namespace aidl::android::hardware::graphics::composer3
+
+BENCHMARK_MAIN();
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <inttypes.h>
@@ -71,10 +72,8 @@ class ComposerClientWriter final {
     ComposerClientWriter& operator=(const ComposerClientWriter&) = delete;
 
     void setColorTransform(int64_t display, const float* matrix) {
-        std::vector<float> matVec;
-        matVec.reserve(16);
-        matVec.assign(matrix, matrix + 16);
-        getDisplayCommand(display).colorTransformMatrix.emplace(std::move(matVec));
+        assignFromPool(getDisplayCommand(display).colorTransformMatrix, mFloatsPool, matrix,
+                       matrix + 16);
     }
 
     void setDisplayBrightness(int64_t display, float brightness, float brightnessNits) {
@@ -87,6 +86,7 @@ class ComposerClientWriter final {
         ClientTarget clientTargetCommand;
         clientTargetCommand.buffer = getBufferCommand(slot, target, acquireFence);
         clientTargetCommand.dataspace = dataspace;
+        clientTargetCommand.damage = takeFromPool(mRectsPool);
         clientTargetCommand.damage.assign(damage.begin(), damage.end());
         getDisplayCommand(display).clientTarget.emplace(std::move(clientTargetCommand));
     }
@@ -143,7 +143,8 @@ class ComposerClientWriter final {
     }
 
     void setLayerSurfaceDamage(int64_t display, int64_t layer, const std::vector<Rect>& damage) {
-        getLayerCommand(display, layer).damage.emplace(damage.begin(), damage.end());
+        assignFromPool(getLayerCommand(display, layer).damage, mRectsPool, damage.begin(),
+                       damage.end());
     }
 
     void setLayerBlendMode(int64_t display, int64_t layer, BlendMode mode) {
@@ -195,7 +196,8 @@ class ComposerClientWriter final {
     }
 
     void setLayerVisibleRegion(int64_t display, int64_t layer, const std::vector<Rect>& visible) {
-        getLayerCommand(display, layer).visibleRegion.emplace(visible.begin(), visible.end());
+        assignFromPool(getLayerCommand(display, layer).visibleRegion, mRectsPool, visible.begin(),
+                       visible.end());
     }
 
     void setLayerZOrder(int64_t display, int64_t layer, uint32_t z) {
@@ -211,7 +213,8 @@ class ComposerClientWriter final {
     }
 
     void setLayerColorTransform(int64_t display, int64_t layer, const float* matrix) {
-        getLayerCommand(display, layer).colorTransform.emplace(matrix, matrix + 16);
+        assignFromPool(getLayerCommand(display, layer).colorTransform, mFloatsPool, matrix,
+                       matrix + 16);
     }
 
     void setLayerPerFrameMetadataBlobs(int64_t display, int64_t layer,
@@ -226,7 +229,8 @@ class ComposerClientWriter final {
     }
 
     void setLayerBlockingRegion(int64_t display, int64_t layer, const std::vector<Rect>& blocking) {
-        getLayerCommand(display, layer).blockingRegion.emplace(blocking.begin(), blocking.end());
+        assignFromPool(getLayerCommand(display, layer).blockingRegion, mRectsPool, blocking.begin(),
+                       blocking.end());
     }
 
     std::vector<DisplayCommand> takePendingCommands() {
@@ -237,12 +241,98 @@ class ComposerClientWriter final {
         return moved;
     }
 
+    // Returns the pending commands while keeping ownership of their storage.
+    // The commands remain valid until the next setter or clearPendingCommands
+    // call.  Unlike takePendingCommands, a frame built with this pair of calls
+    // reuses the command, layer command and array storage of earlier frames, so
+    // once the writer has seen its largest frame it no longer allocates, except
+    // for duplicating buffer handles.
+    const std::vector<DisplayCommand>& getPendingCommands() {
+        flushLayerCommand();
+        flushDisplayCommand();
+        return mCommands;
+    }
+
+    // Discards the pending commands and keeps their storage for the next frame.
+    void clearPendingCommands() {
+        flushLayerCommand();
+        flushDisplayCommand();
+        for (auto& command : mCommands) {
+            recycleDisplayCommand(command);
+        }
+        mCommands.clear();
+    }
+
   private:
     std::optional<DisplayCommand> mDisplayCommand;
-    std::optional<LayerCommand> mLayerCommand;
+    // whether the last element of mDisplayCommand->layers accepts more setters
+    bool mHasLayerCommand = false;
     std::vector<DisplayCommand> mCommands;
     const int64_t mDisplay;
 
+    // storage recycled by clearPendingCommands
+    std::vector<std::vector<LayerCommand>> mLayersPool;
+    std::vector<std::vector<Rect>> mRectsPool;
+    std::vector<std::vector<float>> mFloatsPool;
+
+    template <typename T>
+    static std::vector<T> takeFromPool(std::vector<std::vector<T>>& pool) {
+        if (pool.empty()) {
+            return {};
+        }
+        std::vector<T> vec = std::move(pool.back());
+        pool.pop_back();
+        vec.clear();
+        return vec;
+    }
+
+    template <typename T>
+    static void returnToPool(std::vector<std::vector<T>>& pool, std::vector<T>& vec) {
+        if (vec.capacity() > 0) {
+            pool.push_back(std::move(vec));
+        }
+        vec.clear();
+    }
+
+    template <typename T>
+    static void returnToPool(std::vector<std::vector<T>>& pool,
+                             std::optional<std::vector<T>>& vec) {
+        if (vec.has_value()) {
+            returnToPool(pool, *vec);
+            vec.reset();
+        }
+    }
+
+    template <typename T, typename InputIt>
+    static void assignFromPool(std::optional<std::vector<T>>& field,
+                               std::vector<std::vector<T>>& pool, InputIt first, InputIt last) {
+        if (!field.has_value()) {
+            field.emplace(takeFromPool(pool));
+        }
+        field->assign(first, last);
+    }
+
+    void recycleLayerCommand(LayerCommand& command) {
+        returnToPool(mRectsPool, command.damage);
+        returnToPool(mRectsPool, command.visibleRegion);
+        returnToPool(mRectsPool, command.blockingRegion);
+        returnToPool(mFloatsPool, command.colorTransform);
+    }
+
+    void recycleDisplayCommand(DisplayCommand& command) {
+        for (auto& layerCommand : command.layers) {
+            recycleLayerCommand(layerCommand);
+        }
+        // The layer commands hold nothing but handles and fences at this
+        // point, so destroying them keeps the capacity of the layers array.
+        command.layers.clear();
+        returnToPool(mLayersPool, command.layers);
+        returnToPool(mFloatsPool, command.colorTransformMatrix);
+        if (command.clientTarget.has_value()) {
+            returnToPool(mRectsPool, command.clientTarget->damage);
+        }
+    }
+
     Buffer getBufferCommand(uint32_t slot, const native_handle_t* bufferHandle, int fence) {
         Buffer bufferCommand;
         bufferCommand.slot = static_cast<int32_t>(slot);
@@ -251,12 +341,7 @@ class ComposerClientWriter final {
         return bufferCommand;
     }
 
-    void flushLayerCommand() {
-        if (mLayerCommand.has_value()) {
-            mDisplayCommand->layers.emplace_back(std::move(*mLayerCommand));
-            mLayerCommand.reset();
-        }
-    }
+    void flushLayerCommand() { mHasLayerCommand = false; }
 
     void flushDisplayCommand() {
         if (mDisplayCommand.has_value()) {
@@ -272,23 +357,26 @@ class ComposerClientWriter final {
             flushDisplayCommand();
             mDisplayCommand.emplace();
             mDisplayCommand->display = display;
+            mDisplayCommand->layers = takeFromPool(mLayersPool);
         }
         return *mDisplayCommand;
     }
 
     LayerCommand& getLayerCommand(int64_t display, int64_t layer) {
-        getDisplayCommand(display);
-        if (!mLayerCommand.has_value() || mLayerCommand->layer != layer) {
-            flushLayerCommand();
-            mLayerCommand.emplace();
-            mLayerCommand->layer = layer;
+        auto& layers = getDisplayCommand(display).layers;
+        if (!mHasLayerCommand || layers.back().layer != layer) {
+            // Layer command slots are reused in the order they are filled rather than looked up
+            // by layer, so that interleaved commands for one layer are sent as separate commands.
+            layers.emplace_back();
+            layers.back().layer = layer;
+            mHasLayerCommand = true;
         }
-        return *mLayerCommand;
+        return layers.back();
     }
 
     void reset() {
         mDisplayCommand.reset();
-        mLayerCommand.reset();
+        mHasLayerCommand = false;
         mCommands.clear();
     }
 };
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <android/hardware/graphics/mapper/utils/IMapperMetadataTypes.h>
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+using namespace ::android::hardware::graphics::mapper;
+using namespace ::aidl::android::hardware::graphics::common;
+
+namespace {
+
+// The metadata a client typically needs to compose or map a buffer
+constexpr StandardMetadataType kCommonTypes[] = {
+        StandardMetadataType::PLANE_LAYOUTS,
+        StandardMetadataType::DATASPACE,
+        StandardMetadataType::CROP,
+        StandardMetadataType::BLEND_MODE,
+};
+
+// Stands in for an IMapper implementation, which validates the buffer handle
+// under a lock on every getStandardMetadata call.
+class FakeMapper {
+  public:
+    FakeMapper() {
+        PlaneLayout plane;
+        plane.strideInBytes = 4 * 1920;
+        plane.widthInSamples = 1920;
+        plane.heightInSamples = 1080;
+        plane.totalSizeInBytes = plane.strideInBytes * plane.heightInSamples;
+        plane.sampleIncrementInBits = 32;
+        plane.horizontalSubsampling = 1;
+        plane.verticalSubsampling = 1;
+        for (int i = 0; i < 4; i++) {
+            plane.components.push_back(
+                    {ExtendableType{"android.hardware.graphics.common.PlaneLayoutComponentType",
+                                    1 << (10 + i)},
+                     8 * i, 8});
+        }
+        mPlaneLayouts.push_back(plane);
+    }
+
+    int32_t getStandardMetadata(StandardMetadataType type, void* destBuffer,
+                                size_t destBufferSize) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return provideLocked(type, destBuffer, destBufferSize);
+    }
+
+    int32_t getStandardMetadataBatch(const StandardMetadataType* types, size_t count,
+                                     void* destBuffer, size_t destBufferSize) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return encodeStandardMetadataBatch(
+                types, count, destBuffer, destBufferSize,
+                [this](StandardMetadataType type, void* dest, size_t destSize) {
+                    return provideLocked(type, dest, destSize);
+                });
+    }
+
+  private:
+    int32_t provideLocked(StandardMetadataType type, void* destBuffer, size_t destBufferSize) {
+        return provideStandardMetadata(type, destBuffer, destBufferSize,
+                                       [this]<StandardMetadataType T>(auto&& provide) -> int32_t {
+                                           if constexpr (T == StandardMetadataType::PLANE_LAYOUTS) {
+                                               return provide(mPlaneLayouts);
+                                           } else if constexpr (T ==
+                                                                StandardMetadataType::DATASPACE) {
+                                               return provide(Dataspace::SRGB);
+                                           } else if constexpr (T == StandardMetadataType::CROP) {
+                                               return provide(mCrop);
+                                           } else if constexpr (T ==
+                                                                StandardMetadataType::BLEND_MODE) {
+                                               return provide(BlendMode::PREMULTIPLIED);
+                                           }
+                                           return -AIMAPPER_ERROR_UNSUPPORTED;
+                                       });
+    }
+
+    std::mutex mMutex;
+    std::vector<PlaneLayout> mPlaneLayouts;
+    std::vector<Rect> mCrop{{0, 0, 1920, 1080}};
+};
+
+template <StandardMetadataType T>
+auto decode(const std::vector<uint8_t>& buffer) {
+    return StandardMetadata<T>::value::decode(buffer.data(), buffer.size());
+}
+
+// One call per type, sizing and allocating a buffer for each, the way most
+// clients of getStandardMetadata are written.
+void BM_SingleCalls(benchmark::State& state) {
+    FakeMapper mapper;
+    for (auto _ : state) {
+        std::vector<uint8_t> buffers[std::size(kCommonTypes)];
+        for (size_t i = 0; i < std::size(kCommonTypes); i++) {
+            int32_t size = mapper.getStandardMetadata(kCommonTypes[i], nullptr, 0);
+            buffers[i].resize(size);
+            mapper.getStandardMetadata(kCommonTypes[i], buffers[i].data(), buffers[i].size());
+        }
+        benchmark::DoNotOptimize(decode<StandardMetadataType::PLANE_LAYOUTS>(buffers[0]));
+        benchmark::DoNotOptimize(decode<StandardMetadataType::DATASPACE>(buffers[1]));
+        benchmark::DoNotOptimize(decode<StandardMetadataType::CROP>(buffers[2]));
+        benchmark::DoNotOptimize(decode<StandardMetadataType::BLEND_MODE>(buffers[3]));
+    }
+}
+BENCHMARK(BM_SingleCalls);
+
+// One call per type into a reused buffer, decoding each value in between.
+void BM_SingleCallsReusedBuffer(benchmark::State& state) {
+    FakeMapper mapper;
+    uint8_t buffer[1024];
+    for (auto _ : state) {
+        auto get = [&]<StandardMetadataType T>() {
+            int32_t size = mapper.getStandardMetadata(T, buffer, sizeof(buffer));
+            return StandardMetadata<T>::value::decode(buffer,
+                                                      std::min<size_t>(size, sizeof(buffer)));
+        };
+        benchmark::DoNotOptimize(get.template operator()<StandardMetadataType::PLANE_LAYOUTS>());
+        benchmark::DoNotOptimize(get.template operator()<StandardMetadataType::DATASPACE>());
+        benchmark::DoNotOptimize(get.template operator()<StandardMetadataType::CROP>());
+        benchmark::DoNotOptimize(get.template operator()<StandardMetadataType::BLEND_MODE>());
+    }
+}
+BENCHMARK(BM_SingleCallsReusedBuffer);
+
+// One batch into a reused buffer. DATASPACE and BLEND_MODE decode without
+// allocating.
+void BM_Batch(benchmark::State& state) {
+    FakeMapper mapper;
+    uint8_t buffer[1024];
+    for (auto _ : state) {
+        int32_t size = mapper.getStandardMetadataBatch(kCommonTypes, std::size(kCommonTypes),
+                                                       buffer, sizeof(buffer));
+        StandardMetadataBatchReader reader{buffer, static_cast<size_t>(size)};
+        benchmark::DoNotOptimize(reader.get<StandardMetadataType::PLANE_LAYOUTS>());
+        benchmark::DoNotOptimize(reader.get<StandardMetadataType::DATASPACE>());
+        benchmark::DoNotOptimize(reader.get<StandardMetadataType::CROP>());
+        benchmark::DoNotOptimize(reader.get<StandardMetadataType::BLEND_MODE>());
+    }
+}
+BENCHMARK(BM_Batch);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -343,6 +343,107 @@ TEST(MetadataProvider, outOfBounds) {
             << "100 (out of range) should have resulted in UNSUPPORTED";
 }
 
+static int32_t provideFakeMetadata(StandardMetadataType type, void* destBuffer,
+                                   size_t destBufferSize) {
+    return provideStandardMetadata(type, destBuffer, destBufferSize,
+                                   []<StandardMetadataType T>(auto&& provide) -> int32_t {
+                                       if constexpr (T == StandardMetadataType::PLANE_LAYOUTS) {
+                                           return provide(fakePlaneLayouts());
+                                       } else if constexpr (T == StandardMetadataType::DATASPACE) {
+                                           return provide(Dataspace::BT2020);
+                                       } else if constexpr (T == StandardMetadataType::CROP) {
+                                           return provide(std::vector<Rect>{{1, 2, 3, 4}});
+                                       } else if constexpr (T == StandardMetadataType::SMPTE2086) {
+                                           return provide(std::nullopt);
+                                       }
+                                       return -AIMAPPER_ERROR_UNSUPPORTED;
+                                   });
+}
+
+TEST(MetadataBatch, getAll) {
+    const StandardMetadataType types[] = {
+            StandardMetadataType::PLANE_LAYOUTS, StandardMetadataType::DATASPACE,
+            StandardMetadataType::CROP, StandardMetadataType::SMPTE2086};
+    int32_t expectedSize = 0;
+    for (auto type : types) {
+        expectedSize += kMetadataBatchRecordHeaderSize + provideFakeMetadata(type, nullptr, 0);
+    }
+
+    EXPECT_EQ(expectedSize, encodeStandardMetadataBatch(types, std::size(types), nullptr, 0,
+                                                        provideFakeMetadata));
+    std::vector<uint8_t> buffer(expectedSize, 0);
+    ASSERT_EQ(expectedSize, encodeStandardMetadataBatch(types, std::size(types), buffer.data(),
+                                                        buffer.size(), provideFakeMetadata));
+
+    StandardMetadataBatchReader reader{buffer.data(), buffer.size()};
+    auto planeLayouts = reader.get<StandardMetadataType::PLANE_LAYOUTS>();
+    ASSERT_TRUE(planeLayouts.has_value());
+    EXPECT_EQ(fakePlaneLayouts(), *planeLayouts);
+    EXPECT_EQ(Dataspace::BT2020, reader.get<StandardMetadataType::DATASPACE>());
+    auto crop = reader.get<StandardMetadataType::CROP>();
+    ASSERT_TRUE(crop.has_value());
+    ASSERT_EQ(1, crop->size());
+    EXPECT_EQ(3, (*crop)[0].right);
+    auto smpte2086 = reader.get<StandardMetadataType::SMPTE2086>();
+    ASSERT_TRUE(smpte2086.has_value());
+    EXPECT_FALSE(smpte2086->has_value());
+    EXPECT_FALSE(reader.get<StandardMetadataType::BLEND_MODE>().has_value());
+}
+
+TEST(MetadataBatch, tooSmall) {
+    const StandardMetadataType types[] = {StandardMetadataType::DATASPACE,
+                                          StandardMetadataType::PLANE_LAYOUTS};
+    const int32_t desiredSize =
+            encodeStandardMetadataBatch(types, std::size(types), nullptr, 0, provideFakeMetadata);
+    std::vector<uint8_t> buffer(desiredSize - 1, 0);
+    EXPECT_EQ(desiredSize, encodeStandardMetadataBatch(types, std::size(types), buffer.data(),
+                                                       buffer.size(), provideFakeMetadata));
+}
+
+TEST(MetadataBatch, unsupported) {
+    const StandardMetadataType types[] = {StandardMetadataType::DATASPACE,
+                                          StandardMetadataType::BUFFER_ID};
+    std::vector<uint8_t> buffer(10000, 0);
+    EXPECT_EQ(-AIMAPPER_ERROR_UNSUPPORTED,
+              encodeStandardMetadataBatch(types, std::size(types), buffer.data(), buffer.size(),
+                                          provideFakeMetadata));
+}
+
+TEST(MetadataBatch, malformed) {
+    const StandardMetadataType types[] = {StandardMetadataType::DATASPACE};
+    std::vector<uint8_t> buffer(10000, 0);
+    const int32_t size = encodeStandardMetadataBatch(types, std::size(types), buffer.data(),
+                                                     buffer.size(), provideFakeMetadata);
+    ASSERT_GT(size, 0);
+
+    StandardMetadataBatchReader truncated{buffer.data(), static_cast<size_t>(size - 1)};
+    EXPECT_FALSE(truncated.get<StandardMetadataType::DATASPACE>().has_value());
+    EXPECT_EQ(AIMAPPER_ERROR_BAD_VALUE, truncated.forEach([](auto, auto, auto) {
+        return AIMAPPER_ERROR_NONE;
+    }));
+}
+
+TEST(MetadataBatch, apply) {
+    const StandardMetadataType types[] = {StandardMetadataType::DATASPACE,
+                                          StandardMetadataType::CROP};
+    std::vector<uint8_t> buffer(10000, 0);
+    const int32_t size = encodeStandardMetadataBatch(types, std::size(types), buffer.data(),
+                                                     buffer.size(), provideFakeMetadata);
+    ASSERT_GT(size, 0);
+
+    std::vector<StandardMetadataType> applied;
+    AIMapper_Error error = applyStandardMetadataBatch(
+            buffer.data(), size, [&]<StandardMetadataType T>(auto&& value) {
+                if constexpr (T == StandardMetadataType::DATASPACE) {
+                    EXPECT_EQ(Dataspace::BT2020, value);
+                }
+                applied.push_back(T);
+                return AIMAPPER_ERROR_NONE;
+            });
+    EXPECT_EQ(AIMAPPER_ERROR_NONE, error);
+    EXPECT_EQ(std::vector<StandardMetadataType>(std::begin(types), std::end(types)), applied);
+}
+
 template <StandardMetadataType T>
 std::vector<uint8_t> encode(const typename StandardMetadata<T>::value_type& value) {
     using Value = typename StandardMetadata<T>::value;
@@ -33,6 +33,7 @@
 #include <cinttypes>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace android::hardware::graphics::mapper {
@@ -567,6 +568,161 @@ DEFINE_TYPE(STRIDE, uint32_t);
 
 #undef DEFINE_TYPE
 
+/**
+ * Batches of standard metadata.
+ *
+ * A batch holds several StandardMetadataType values in one buffer, so that a client can fetch
+ * the metadata it needs for a buffer, eg. PLANE_LAYOUTS, DATASPACE, CROP and BLEND_MODE, into a
+ * single caller owned buffer and decode it without any intermediate copies. Each value is stored
+ * as a record of an int64_t StandardMetadataType, an int64_t size, and the value encoded exactly
+ * as getStandardMetadata would encode it. Absent optional values have a size of 0.
+ */
+constexpr size_t kMetadataBatchRecordHeaderSize = 2 * sizeof(int64_t);
+
+/**
+ * Encodes a batch of `count` values into destBuffer, getting each value from
+ * `getStandardMetadata(StandardMetadataType, void* destBuffer, size_t destBufferSize)`, which
+ * must follow the contract of AIMapper_getStandardMetadata.
+ *
+ * Returns the size needed to hold the whole batch, which is larger than destBufferSize if the
+ * batch did not fit, or the first negative error returned by getStandardMetadata.
+ */
+template <typename F>
+int32_t encodeStandardMetadataBatch(const StandardMetadataType* _Nonnull types, size_t count,
+                                    void* _Nullable destBuffer, size_t destBufferSize,
+                                    F&& getStandardMetadata) {
+    uint8_t* dest = reinterpret_cast<uint8_t*>(destBuffer);
+    size_t sizeRemaining = dest ? destBufferSize : 0;
+    int32_t desiredSize = 0;
+    for (size_t i = 0; i < count; i++) {
+        // Once a record does not fit, only the desired size of the remaining ones is computed
+        uint8_t* record = nullptr;
+        if (sizeRemaining >= kMetadataBatchRecordHeaderSize) {
+            record = dest;
+            dest += kMetadataBatchRecordHeaderSize;
+            sizeRemaining -= kMetadataBatchRecordHeaderSize;
+        } else {
+            sizeRemaining = 0;
+        }
+
+        int32_t size = getStandardMetadata(types[i], record ? dest : nullptr,
+                                           record ? sizeRemaining : 0);
+        if (size < 0) {
+            return size;
+        }
+
+        if (record && static_cast<size_t>(size) <= sizeRemaining) {
+            const int64_t header[] = {static_cast<int64_t>(types[i]), size};
+            memcpy(record, header, sizeof(header));
+            dest += size;
+            sizeRemaining -= size;
+        } else {
+            sizeRemaining = 0;
+        }
+
+        if (__builtin_add_overflow(desiredSize, kMetadataBatchRecordHeaderSize + size,
+                                   &desiredSize)) {
+            return -AIMAPPER_ERROR_BAD_VALUE;
+        }
+    }
+    return desiredSize;
+}
+
+/**
+ * Gets a batch of standard metadata of a buffer from an AIMapper. See
+ * encodeStandardMetadataBatch for the return value.
+ */
+inline int32_t getStandardMetadataBatch(const AIMapper* _Nonnull mapper,
+                                        buffer_handle_t _Nonnull buffer,
+                                        const StandardMetadataType* _Nonnull types, size_t count,
+                                        void* _Nullable destBuffer, size_t destBufferSize) {
+    return encodeStandardMetadataBatch(
+            types, count, destBuffer, destBufferSize,
+            [&](StandardMetadataType type, void* _Nullable dest, size_t destSize) {
+                return mapper->v5.getStandardMetadata(buffer, static_cast<int64_t>(type), dest,
+                                                      destSize);
+            });
+}
+
+/**
+ * Reads the values of a batch of standard metadata. The reader does not copy the batch, which
+ * must outlive it, and does not allocate; decoding a value only allocates if its type does.
+ */
+class StandardMetadataBatchReader {
+  private:
+    const uint8_t* _Nonnull mSrc;
+    size_t mSize = 0;
+
+  public:
+    explicit StandardMetadataBatchReader(const void* _Nonnull metadata, size_t metadataSize)
+        : mSrc(reinterpret_cast<const uint8_t*>(metadata)), mSize(metadataSize) {}
+
+    /**
+     * Calls `f(StandardMetadataType, const void* metadata, size_t metadataSize)` for every record
+     * in order until it returns an error. Returns AIMAPPER_ERROR_BAD_VALUE if the batch is
+     * malformed.
+     */
+    template <typename F>
+    AIMapper_Error forEach(F&& f) const {
+        const uint8_t* src = mSrc;
+        size_t sizeRemaining = mSize;
+        while (sizeRemaining > 0) {
+            int64_t header[2];
+            if (sizeRemaining < sizeof(header)) {
+                return AIMAPPER_ERROR_BAD_VALUE;
+            }
+            memcpy(header, src, sizeof(header));
+            src += sizeof(header);
+            sizeRemaining -= sizeof(header);
+
+            if (header[1] < 0 || static_cast<uint64_t>(header[1]) > sizeRemaining) {
+                return AIMAPPER_ERROR_BAD_VALUE;
+            }
+            const size_t size = static_cast<size_t>(header[1]);
+            AIMapper_Error error = f(static_cast<StandardMetadataType>(header[0]), src, size);
+            if (error != AIMAPPER_ERROR_NONE) {
+                return error;
+            }
+            src += size;
+            sizeRemaining -= size;
+        }
+        return AIMAPPER_ERROR_NONE;
+    }
+
+    [[nodiscard]] bool find(StandardMetadataType type,
+                            const void* _Nullable* _Nonnull outMetadata,
+                            size_t* _Nonnull outMetadataSize) const {
+        bool found = false;
+        forEach([&](StandardMetadataType recordType, const void* _Nonnull metadata,
+                    size_t metadataSize) {
+            if (recordType != type) {
+                return AIMAPPER_ERROR_NONE;
+            }
+            *outMetadata = metadata;
+            *outMetadataSize = metadataSize;
+            found = true;
+            // Not an error, only stops the iteration
+            return AIMAPPER_ERROR_UNSUPPORTED;
+        });
+        return found;
+    }
+
+    /**
+     * Decodes the value of type T, as StandardMetadata<T>::value::decode would. Returns
+     * std::nullopt if the batch holds no such value.
+     */
+    template <StandardMetadataType T>
+    [[nodiscard]] auto get() const -> decltype(StandardMetadata<T>::value::decode(
+            std::declval<const void*>(), std::declval<size_t>())) {
+        const void* metadata = nullptr;
+        size_t metadataSize = 0;
+        if (!find(T, &metadata, &metadataSize)) {
+            return std::nullopt;
+        }
+        return StandardMetadata<T>::value::decode(metadata, metadataSize);
+    }
+};
+
 #if defined(__cplusplus) && __cplusplus >= 202002L
 
 template <typename F, std::size_t... I>
@@ -623,6 +779,33 @@ AIMapper_Error applyStandardMetadata(StandardMetadataType type, const void* _Non
     return retVal;
 }
 
+/**
+ * Batch version of provideStandardMetadata, for an IMapper implementation that gets several
+ * values at once. See encodeStandardMetadataBatch for the return value.
+ */
+template <typename F>
+int32_t provideStandardMetadataBatch(const StandardMetadataType* _Nonnull types, size_t count,
+                                     void* _Nullable destBuffer, size_t destBufferSize, F&& f) {
+    return encodeStandardMetadataBatch(
+            types, count, destBuffer, destBufferSize,
+            [&](StandardMetadataType type, void* _Nullable dest, size_t destSize) {
+                return provideStandardMetadata(type, dest, destSize, f);
+            });
+}
+
+/**
+ * Batch version of applyStandardMetadata. Values are applied in order, and the first error
+ * stops the batch.
+ */
+template <typename F>
+AIMapper_Error applyStandardMetadataBatch(const void* _Nonnull metadata, size_t metadataSize,
+                                          F&& f) {
+    return StandardMetadataBatchReader{metadata, metadataSize}.forEach(
+            [&](StandardMetadataType type, const void* _Nonnull value, size_t valueSize) {
+                return applyStandardMetadata(type, value, valueSize, f);
+            });
+}
+
 #endif
 
 }  // namespace android::hardware::graphics::mapper
\ No newline at end of file
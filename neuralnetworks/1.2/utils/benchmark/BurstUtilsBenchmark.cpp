@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/logging.h>
+#include <benchmark/benchmark.h>
+#include <fmq/MessageQueue.h>
+#include <nnapi/hal/1.2/BurstUtils.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::V1_2::utils {
+namespace {
+
+constexpr Timing kNoTiming = {std::numeric_limits<uint64_t>::max(),
+                              std::numeric_limits<uint64_t>::max()};
+
+// A small model: two 4-D inputs and one 2-D output, each in its own pool.
+V1_0::Request makeSmallRequest() {
+    const auto argument = [](uint32_t poolIndex, std::vector<uint32_t> dimensions) {
+        return V1_0::RequestArgument{
+                .hasNoValue = false,
+                .location = {.poolIndex = poolIndex, .offset = 0, .length = 1024},
+                .dimensions = std::move(dimensions)};
+    };
+    return {.inputs = {argument(0, {1, 224, 224, 3}), argument(1, {1, 1, 1, 16})},
+            .outputs = {argument(2, {1, 1000})},
+            .pools = {}};
+}
+
+const std::vector<int32_t> kSlots = {0, 1, 2};
+const std::vector<OutputShape> kOutputShapes = {{.dimensions = {1, 1000}, .isSufficient = true}};
+
+// Both ends of the request and result channels of one burst, created in a single process.
+struct Channels {
+    Channels() {
+        auto [sender, requestDescriptor] =
+                RequestChannelSender::create(kExecutionBurstChannelLength).value();
+        auto [receiver, resultDescriptor] =
+                ResultChannelReceiver::create(kExecutionBurstChannelLength,
+                                              std::chrono::microseconds{0})
+                        .value();
+        requestSender = std::move(sender);
+        resultReceiver = std::move(receiver);
+        requestReceiver = RequestChannelReceiver::create(*requestDescriptor,
+                                                         std::chrono::microseconds{0})
+                                  .value();
+        resultSender = ResultChannelSender::create(*resultDescriptor).value();
+        requestChannelDescriptor = requestDescriptor;
+    }
+
+    std::unique_ptr<RequestChannelSender> requestSender;
+    std::unique_ptr<ResultChannelReceiver> resultReceiver;
+    std::unique_ptr<RequestChannelReceiver> requestReceiver;
+    std::unique_ptr<ResultChannelSender> resultSender;
+    const MQDescriptorSync<FmqRequestDatum>* requestChannelDescriptor = nullptr;
+};
+
+// Round trip where every packet is serialized into and deserialized from FMQ memory in place.
+void BM_RoundTripInPlace(benchmark::State& state) {
+    Channels channels;
+    std::thread server([&channels] {
+        while (true) {
+            const auto request = channels.requestReceiver->getBlocking();
+            if (!request.ok()) {
+                return;
+            }
+            channels.resultSender->send(V1_0::ErrorStatus::NONE, kOutputShapes, kNoTiming);
+        }
+    });
+
+    const auto request = makeSmallRequest();
+    for (auto _ : state) {
+        CHECK(channels.requestSender->send(request, MeasureTiming::NO, kSlots).ok());
+        auto result = channels.resultReceiver->getBlocking();
+        CHECK(result.ok());
+        benchmark::DoNotOptimize(result);
+    }
+
+    channels.requestReceiver->invalidate();
+    server.join();
+}
+BENCHMARK(BM_RoundTripInPlace);
+
+// Round trip where every packet is built in a temporary buffer, copied into the FMQ, copied out of
+// it into another buffer and then deserialized.
+void BM_RoundTripBuffered(benchmark::State& state) {
+    Channels channels;
+    std::atomic_bool done = false;
+    std::thread server([&channels, &done] {
+        MessageQueue<FmqRequestDatum, kSynchronizedReadWrite> requestChannel(
+                *channels.requestChannelDescriptor);
+        while (true) {
+            FmqRequestDatum datum;
+            CHECK(requestChannel.readBlocking(&datum, 1));
+            const size_t count = requestChannel.availableToRead();
+            std::vector<FmqRequestDatum> packet(count + 1);
+            std::memcpy(&packet.front(), &datum, sizeof(datum));
+            CHECK(requestChannel.read(packet.data() + 1, count));
+            if (done) {
+                return;
+            }
+            CHECK(deserialize(packet).ok());
+            channels.resultSender->sendPacket(
+                    serialize(V1_0::ErrorStatus::NONE, kOutputShapes, kNoTiming));
+        }
+    });
+
+    const auto request = makeSmallRequest();
+    for (auto _ : state) {
+        CHECK(channels.requestSender->sendPacket(serialize(request, MeasureTiming::NO, kSlots))
+                      .ok());
+        const auto packet = channels.resultReceiver->getPacketBlocking();
+        CHECK(packet.ok());
+        auto result = deserialize(packet.value());
+        CHECK(result.ok());
+        benchmark::DoNotOptimize(result);
+    }
+
+    done = true;
+    CHECK(channels.requestSender->sendPacket(serialize(V1_0::Request{}, MeasureTiming::NO, {}))
+                  .ok());
+    server.join();
+}
+BENCHMARK(BM_RoundTripBuffered);
+
+}  // namespace
+}  // namespace android::hardware::neuralnetworks::V1_2::utils
+
+BENCHMARK_MAIN();
@@ -189,6 +189,13 @@ class Burst final : public nn::IBurst, public std::enable_shared_from_this<Burst
             const hal::utils::RequestRelocation& relocation, FallbackFunction fallback) const;
 
   private:
+    // Sends the request packet on the request channel.
+    using SendFunction = std::function<nn::Result<void>()>;
+
+    nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> executeInternal(
+            const SendFunction& send, const hal::utils::RequestRelocation& relocation,
+            FallbackFunction fallback) const;
+
     mutable std::atomic_flag mExecutionInFlight = ATOMIC_FLAG_INIT;
     const nn::SharedPreparedModel kPreparedModel;
     const std::unique_ptr<RequestChannelSender> mRequestChannelSender;
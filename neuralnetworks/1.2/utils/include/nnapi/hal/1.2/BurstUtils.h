@@ -19,6 +19,7 @@
 
 #include <android/hardware/neuralnetworks/1.0/types.h>
 #include <android/hardware/neuralnetworks/1.2/types.h>
+#include <fmq/EventFlag.h>
 #include <fmq/MessageQueue.h>
 #include <hidl/MQDescriptor.h>
 #include <nnapi/Result.h>
@@ -126,6 +127,9 @@ class RequestChannelSender final : public neuralnetworks::utils::IProtectedCallb
     /**
      * Send the request to the channel.
      *
+     * The request is serialized directly into the FMQ's shared memory, without an intermediate
+     * buffer.
+     *
      * @param request Request object without the pool information.
      * @param measure Whether to collect timing information for the execution.
      * @param slots Slot identifiers corresponding to memory resources for the request.
@@ -144,9 +148,11 @@ class RequestChannelSender final : public neuralnetworks::utils::IProtectedCallb
     nn::Result<void> sendPacket(const std::vector<FmqRequestDatum>& packet);
 
     RequestChannelSender(PrivateConstructorTag tag, size_t channelLength);
+    ~RequestChannelSender();
 
   private:
     MessageQueue<FmqRequestDatum, kSynchronizedReadWrite> mFmqRequestChannel;
+    EventFlag* mEventFlag = nullptr;
     std::atomic<bool> mValid{true};
 };
 
@@ -181,6 +187,9 @@ class RequestChannelReceiver final {
      * 1) The packet has been retrieved, or
      * 2) The receiver has been invalidated
      *
+     * The packet is deserialized directly from the FMQ's shared memory, without first being copied
+     * out of the channel.
+     *
      * @return Request object if successfully received, an appropriate message if error or if the
      *     receiver object was invalidated.
      */
@@ -195,11 +204,14 @@ class RequestChannelReceiver final {
     RequestChannelReceiver(PrivateConstructorTag tag,
                            const MQDescriptorSync<FmqRequestDatum>& requestChannel,
                            std::chrono::microseconds pollingTimeWindow);
+    ~RequestChannelReceiver();
 
   private:
-    nn::Result<std::vector<FmqRequestDatum>> getPacketBlocking();
+    // Blocks until a packet is available and returns its size.
+    nn::Result<size_t> waitForPacket();
 
     MessageQueue<FmqRequestDatum, kSynchronizedReadWrite> mFmqRequestChannel;
+    EventFlag* mEventFlag = nullptr;
     std::atomic<bool> mTeardown{false};
     const std::chrono::microseconds kPollingTimeWindow;
 };
@@ -224,6 +236,9 @@ class ResultChannelSender final {
     /**
      * Send the result to the channel.
      *
+     * The result is serialized directly into the FMQ's shared memory, without an intermediate
+     * buffer.
+     *
      * @param errorStatus Status of the execution.
      * @param outputShapes Dynamic shapes of the output tensors.
      * @param timing Timing information of the execution.
@@ -236,9 +251,14 @@ class ResultChannelSender final {
 
     ResultChannelSender(PrivateConstructorTag tag,
                         const MQDescriptorSync<FmqResultDatum>& resultChannel);
+    ~ResultChannelSender();
 
   private:
+    bool write(V1_0::ErrorStatus errorStatus, const std::vector<OutputShape>& outputShapes,
+               Timing timing);
+
     MessageQueue<FmqResultDatum, kSynchronizedReadWrite> mFmqResultChannel;
+    EventFlag* mEventFlag = nullptr;
 };
 
 /**
@@ -273,6 +293,9 @@ class ResultChannelReceiver final : public neuralnetworks::utils::IProtectedCall
      * 1) The packet has been retrieved, or
      * 2) The receiver has been invalidated
      *
+     * The packet is deserialized directly from the FMQ's shared memory, without first being copied
+     * out of the channel.
+     *
      * @return Result object if successfully received, otherwise an appropriate message if error or
      *     if the receiver object was invalidated.
      */
@@ -289,9 +312,14 @@ class ResultChannelReceiver final : public neuralnetworks::utils::IProtectedCall
 
     ResultChannelReceiver(PrivateConstructorTag tag, size_t channelLength,
                           std::chrono::microseconds pollingTimeWindow);
+    ~ResultChannelReceiver();
 
   private:
+    // Blocks until a packet is available and returns its size.
+    nn::Result<size_t> waitForPacket();
+
     MessageQueue<FmqResultDatum, kSynchronizedReadWrite> mFmqResultChannel;
+    EventFlag* mEventFlag = nullptr;
     std::atomic<bool> mValid{true};
     const std::chrono::microseconds kPollingTimeWindow;
 };
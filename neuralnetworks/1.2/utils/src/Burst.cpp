@@ -344,12 +344,14 @@ nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> Burst::
         holds.push_back(std::move(hold));
     }
 
-    // send request packet
-    const auto requestPacket = serialize(hidlRequest, hidlMeasure, slots);
+    // send request packet, serializing it directly into the request channel
+    const auto send = [this, &hidlRequest, hidlMeasure, &slots] {
+        return mRequestChannelSender->send(hidlRequest, hidlMeasure, slots);
+    };
     const auto fallback = [this, &request, measure, &deadline, &loopTimeoutDuration] {
         return kPreparedModel->execute(request, measure, deadline, loopTimeoutDuration, {}, {});
     };
-    return executeInternal(requestPacket, relocation, fallback);
+    return executeInternal(send, relocation, fallback);
 }
 
 // See IBurst::createReusableExecution for information on this method.
@@ -399,6 +401,15 @@ nn::GeneralResult<nn::SharedExecution> Burst::createReusableExecution(
 nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> Burst::executeInternal(
         const std::vector<FmqRequestDatum>& requestPacket,
         const hal::utils::RequestRelocation& relocation, FallbackFunction fallback) const {
+    const auto send = [this, &requestPacket] {
+        return mRequestChannelSender->sendPacket(requestPacket);
+    };
+    return executeInternal(send, relocation, std::move(fallback));
+}
+
+nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> Burst::executeInternal(
+        const SendFunction& send, const hal::utils::RequestRelocation& relocation,
+        FallbackFunction fallback) const {
     NNTRACE_FULL(NNTRACE_LAYER_IPC, NNTRACE_PHASE_EXECUTION, "Burst::executeInternal");
 
     // Ensure that at most one execution is in flight at any given time.
@@ -413,7 +424,7 @@ nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> Burst::
     }
 
     // send request packet
-    const auto sendStatus = mRequestChannelSender->sendPacket(requestPacket);
+    const auto sendStatus = send();
     if (!sendStatus.ok()) {
         // fallback to another execution path if the packet could not be sent
         if (fallback) {
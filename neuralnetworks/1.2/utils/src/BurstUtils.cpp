@@ -21,6 +21,7 @@
 #include <android/hardware/neuralnetworks/1.0/types.h>
 #include <android/hardware/neuralnetworks/1.1/types.h>
 #include <android/hardware/neuralnetworks/1.2/types.h>
+#include <fmq/EventFlag.h>
 #include <fmq/MessageQueue.h>
 #include <hidl/MQDescriptor.h>
 #include <nnapi/Result.h>
@@ -29,7 +30,9 @@
 
 #include <atomic>
 #include <chrono>
+#include <limits>
 #include <memory>
+#include <new>
 #include <thread>
 #include <tuple>
 #include <utility>
@@ -41,6 +44,13 @@ namespace {
 constexpr V1_2::Timing kNoTiming = {std::numeric_limits<uint64_t>::max(),
                                     std::numeric_limits<uint64_t>::max()};
 
+// EventFlag bits used by MessageQueue::readBlocking and MessageQueue::writeBlocking by default.
+// Packets written or read in place must signal and wait on the same bits, because the other end of
+// the channel may still be using the blocking calls.
+using FmqEventFlagBits = MessageQueue<FmqRequestDatum, kSynchronizedReadWrite>::EventFlagBits;
+constexpr uint32_t kFmqNotEmpty = FmqEventFlagBits::FMQ_NOT_EMPTY;
+constexpr uint32_t kFmqNotFull = FmqEventFlagBits::FMQ_NOT_FULL;
+
 std::chrono::microseconds getPollingTimeWindow(const std::string& property) {
     constexpr int32_t kDefaultPollingTimeWindow = 0;
 #ifdef NN_DEBUGGABLE
@@ -54,20 +64,8 @@ std::chrono::microseconds getPollingTimeWindow(const std::string& property) {
 #endif  // NN_DEBUGGABLE
 }
 
-}  // namespace
-
-std::chrono::microseconds getBurstControllerPollingTimeWindow() {
-    return getPollingTimeWindow("debug.nn.burst-controller-polling-window");
-}
-
-std::chrono::microseconds getBurstServerPollingTimeWindow() {
-    return getPollingTimeWindow("debug.nn.burst-server-polling-window");
-}
-
-// serialize a request into a packet
-std::vector<FmqRequestDatum> serialize(const V1_0::Request& request, V1_2::MeasureTiming measure,
-                                       const std::vector<int32_t>& slots) {
-    // count how many elements need to be sent for a request
+// count how many elements need to be sent for a request
+size_t getRequestPacketSize(const V1_0::Request& request, const std::vector<int32_t>& slots) {
     size_t count = 2 + request.inputs.size() + request.outputs.size() + slots.size();
     for (const auto& input : request.inputs) {
         count += input.dimensions.size();
@@ -76,14 +74,18 @@ std::vector<FmqRequestDatum> serialize(const V1_0::Request& request, V1_2::Measu
         count += output.dimensions.size();
     }
     CHECK_LE(count, std::numeric_limits<uint32_t>::max());
+    return count;
+}
 
-    // create buffer to temporarily store elements
-    std::vector<FmqRequestDatum> data;
-    data.reserve(count);
-
+// Serialize a request one element at a time. Each call to `nextDatum()` must return a reference to
+// a default-constructed FmqRequestDatum that holds the next element of the packet, so the packet
+// can be built either in a buffer or directly in FMQ memory.
+template <typename NextDatumFunction>
+void serializeRequest(const V1_0::Request& request, V1_2::MeasureTiming measure,
+                      const std::vector<int32_t>& slots, size_t count,
+                      NextDatumFunction nextDatum) {
     // package packetInfo
-    data.emplace_back();
-    data.back().packetInformation(
+    nextDatum().packetInformation(
             {.packetSize = static_cast<uint32_t>(count),
              .numberOfInputOperands = static_cast<uint32_t>(request.inputs.size()),
              .numberOfOutputOperands = static_cast<uint32_t>(request.outputs.size()),
@@ -92,111 +94,99 @@ std::vector<FmqRequestDatum> serialize(const V1_0::Request& request, V1_2::Measu
     // package input data
     for (const auto& input : request.inputs) {
         // package operand information
-        data.emplace_back();
-        data.back().inputOperandInformation(
+        nextDatum().inputOperandInformation(
                 {.hasNoValue = input.hasNoValue,
                  .location = input.location,
                  .numberOfDimensions = static_cast<uint32_t>(input.dimensions.size())});
 
         // package operand dimensions
         for (uint32_t dimension : input.dimensions) {
-            data.emplace_back();
-            data.back().inputOperandDimensionValue(dimension);
+            nextDatum().inputOperandDimensionValue(dimension);
         }
     }
 
     // package output data
     for (const auto& output : request.outputs) {
         // package operand information
-        data.emplace_back();
-        data.back().outputOperandInformation(
+        nextDatum().outputOperandInformation(
                 {.hasNoValue = output.hasNoValue,
                  .location = output.location,
                  .numberOfDimensions = static_cast<uint32_t>(output.dimensions.size())});
 
         // package operand dimensions
         for (uint32_t dimension : output.dimensions) {
-            data.emplace_back();
-            data.back().outputOperandDimensionValue(dimension);
+            nextDatum().outputOperandDimensionValue(dimension);
         }
     }
 
     // package pool identifier
     for (int32_t slot : slots) {
-        data.emplace_back();
-        data.back().poolIdentifier(slot);
+        nextDatum().poolIdentifier(slot);
     }
 
     // package measureTiming
-    data.emplace_back();
-    data.back().measureTiming(measure);
-
-    CHECK_EQ(data.size(), count);
-
-    // return packet
-    return data;
+    nextDatum().measureTiming(measure);
 }
 
-// serialize result
-std::vector<FmqResultDatum> serialize(V1_0::ErrorStatus errorStatus,
-                                      const std::vector<V1_2::OutputShape>& outputShapes,
-                                      V1_2::Timing timing) {
-    // count how many elements need to be sent for a request
+// count how many elements need to be sent for a result
+size_t getResultPacketSize(const std::vector<V1_2::OutputShape>& outputShapes) {
     size_t count = 2 + outputShapes.size();
     for (const auto& outputShape : outputShapes) {
         count += outputShape.dimensions.size();
     }
+    return count;
+}
 
-    // create buffer to temporarily store elements
-    std::vector<FmqResultDatum> data;
-    data.reserve(count);
-
+// Serialize a result one element at a time. See serializeRequest for the requirements on
+// `nextDatum`.
+template <typename NextDatumFunction>
+void serializeResult(V1_0::ErrorStatus errorStatus,
+                     const std::vector<V1_2::OutputShape>& outputShapes, V1_2::Timing timing,
+                     size_t count, NextDatumFunction nextDatum) {
     // package packetInfo
-    data.emplace_back();
-    data.back().packetInformation({.packetSize = static_cast<uint32_t>(count),
+    nextDatum().packetInformation({.packetSize = static_cast<uint32_t>(count),
                                    .errorStatus = errorStatus,
                                    .numberOfOperands = static_cast<uint32_t>(outputShapes.size())});
 
     // package output shape data
     for (const auto& operand : outputShapes) {
         // package operand information
-        data.emplace_back();
-        data.back().operandInformation(
+        nextDatum().operandInformation(
                 {.isSufficient = operand.isSufficient,
                  .numberOfDimensions = static_cast<uint32_t>(operand.dimensions.size())});
 
         // package operand dimensions
         for (uint32_t dimension : operand.dimensions) {
-            data.emplace_back();
-            data.back().operandDimensionValue(dimension);
+            nextDatum().operandDimensionValue(dimension);
         }
     }
 
     // package executionTiming
-    data.emplace_back();
-    data.back().executionTiming(timing);
-
-    CHECK_EQ(data.size(), count);
-
-    // return result
-    return data;
+    nextDatum().executionTiming(timing);
 }
 
-// deserialize request
-nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>> deserialize(
-        const std::vector<FmqRequestDatum>& data) {
+// Deserialize a request. `Packet` is any container of FmqRequestDatum that provides `size()` and
+// `at(index)`, so the request can be read either from a buffer or directly from FMQ memory. Each
+// element is copied out of the packet exactly once before it is validated, because FMQ memory is
+// shared with the sender and may change while it is being read.
+template <typename Packet>
+nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
+deserializeRequest(const Packet& data) {
     using discriminator = FmqRequestDatum::hidl_discriminator;
 
     size_t index = 0;
 
     // validate packet information
-    if (index >= data.size() ||
-        data.at(index).getDiscriminator() != discriminator::packetInformation) {
+    if (index >= data.size()) {
+        return NN_ERROR() << "FMQ Request packet ill-formed";
+    }
+    const FmqRequestDatum packetInfoDatum = data.at(index);
+    if (packetInfoDatum.getDiscriminator() != discriminator::packetInformation) {
         return NN_ERROR() << "FMQ Request packet ill-formed";
     }
 
     // unpackage packet information
-    const FmqRequestDatum::PacketInformation& packetInfo = data.at(index).packetInformation();
+    const FmqRequestDatum::PacketInformation& packetInfo = packetInfoDatum.packetInformation();
     index++;
     const uint32_t packetSize = packetInfo.packetSize;
     const uint32_t numberOfInputOperands = packetInfo.numberOfInputOperands;
@@ -213,14 +203,17 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
     inputs.reserve(numberOfInputOperands);
     for (size_t operand = 0; operand < numberOfInputOperands; ++operand) {
         // validate input operand information
-        if (index >= data.size() ||
-            data.at(index).getDiscriminator() != discriminator::inputOperandInformation) {
+        if (index >= data.size()) {
+            return NN_ERROR() << "FMQ Request packet ill-formed";
+        }
+        const FmqRequestDatum operandInfoDatum = data.at(index);
+        if (operandInfoDatum.getDiscriminator() != discriminator::inputOperandInformation) {
             return NN_ERROR() << "FMQ Request packet ill-formed";
         }
 
         // unpackage operand information
         const FmqRequestDatum::OperandInformation& operandInfo =
-                data.at(index).inputOperandInformation();
+                operandInfoDatum.inputOperandInformation();
         index++;
         const bool hasNoValue = operandInfo.hasNoValue;
         const V1_0::DataLocation location = operandInfo.location;
@@ -231,13 +224,16 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
         dimensions.reserve(numberOfDimensions);
         for (size_t i = 0; i < numberOfDimensions; ++i) {
             // validate dimension
-            if (index >= data.size() ||
-                data.at(index).getDiscriminator() != discriminator::inputOperandDimensionValue) {
+            if (index >= data.size()) {
+                return NN_ERROR() << "FMQ Request packet ill-formed";
+            }
+            const FmqRequestDatum dimensionDatum = data.at(index);
+            if (dimensionDatum.getDiscriminator() != discriminator::inputOperandDimensionValue) {
                 return NN_ERROR() << "FMQ Request packet ill-formed";
             }
 
             // unpackage dimension
-            const uint32_t dimension = data.at(index).inputOperandDimensionValue();
+            const uint32_t dimension = dimensionDatum.inputOperandDimensionValue();
             index++;
 
             // store result
@@ -254,14 +250,17 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
     outputs.reserve(numberOfOutputOperands);
     for (size_t operand = 0; operand < numberOfOutputOperands; ++operand) {
         // validate output operand information
-        if (index >= data.size() ||
-            data.at(index).getDiscriminator() != discriminator::outputOperandInformation) {
+        if (index >= data.size()) {
+            return NN_ERROR() << "FMQ Request packet ill-formed";
+        }
+        const FmqRequestDatum operandInfoDatum = data.at(index);
+        if (operandInfoDatum.getDiscriminator() != discriminator::outputOperandInformation) {
             return NN_ERROR() << "FMQ Request packet ill-formed";
         }
 
         // unpackage operand information
         const FmqRequestDatum::OperandInformation& operandInfo =
-                data.at(index).outputOperandInformation();
+                operandInfoDatum.outputOperandInformation();
         index++;
         const bool hasNoValue = operandInfo.hasNoValue;
         const V1_0::DataLocation location = operandInfo.location;
@@ -272,13 +271,16 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
         dimensions.reserve(numberOfDimensions);
         for (size_t i = 0; i < numberOfDimensions; ++i) {
             // validate dimension
-            if (index >= data.size() ||
-                data.at(index).getDiscriminator() != discriminator::outputOperandDimensionValue) {
+            if (index >= data.size()) {
+                return NN_ERROR() << "FMQ Request packet ill-formed";
+            }
+            const FmqRequestDatum dimensionDatum = data.at(index);
+            if (dimensionDatum.getDiscriminator() != discriminator::outputOperandDimensionValue) {
                 return NN_ERROR() << "FMQ Request packet ill-formed";
             }
 
             // unpackage dimension
-            const uint32_t dimension = data.at(index).outputOperandDimensionValue();
+            const uint32_t dimension = dimensionDatum.outputOperandDimensionValue();
             index++;
 
             // store result
@@ -295,13 +297,16 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
     slots.reserve(numberOfPools);
     for (size_t pool = 0; pool < numberOfPools; ++pool) {
         // validate input operand information
-        if (index >= data.size() ||
-            data.at(index).getDiscriminator() != discriminator::poolIdentifier) {
+        if (index >= data.size()) {
+            return NN_ERROR() << "FMQ Request packet ill-formed";
+        }
+        const FmqRequestDatum poolDatum = data.at(index);
+        if (poolDatum.getDiscriminator() != discriminator::poolIdentifier) {
             return NN_ERROR() << "FMQ Request packet ill-formed";
         }
 
         // unpackage operand information
-        const int32_t poolId = data.at(index).poolIdentifier();
+        const int32_t poolId = poolDatum.poolIdentifier();
         index++;
 
         // store result
@@ -309,12 +314,16 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
     }
 
     // validate measureTiming
-    if (index >= data.size() || data.at(index).getDiscriminator() != discriminator::measureTiming) {
+    if (index >= data.size()) {
+        return NN_ERROR() << "FMQ Request packet ill-formed";
+    }
+    const FmqRequestDatum measureDatum = data.at(index);
+    if (measureDatum.getDiscriminator() != discriminator::measureTiming) {
         return NN_ERROR() << "FMQ Request packet ill-formed";
     }
 
     // unpackage measureTiming
-    const V1_2::MeasureTiming measure = data.at(index).measureTiming();
+    const V1_2::MeasureTiming measure = measureDatum.measureTiming();
     index++;
 
     // validate packet information
@@ -327,20 +336,24 @@ nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
     return std::make_tuple(std::move(request), std::move(slots), measure);
 }
 
-// deserialize a packet into the result
-nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::Timing>> deserialize(
-        const std::vector<FmqResultDatum>& data) {
+// Deserialize a result. See deserializeRequest for the requirements on `Packet`.
+template <typename Packet>
+nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::Timing>>
+deserializeResult(const Packet& data) {
     using discriminator = FmqResultDatum::hidl_discriminator;
     size_t index = 0;
 
     // validate packet information
-    if (index >= data.size() ||
-        data.at(index).getDiscriminator() != discriminator::packetInformation) {
+    if (index >= data.size()) {
+        return NN_ERROR() << "FMQ Result packet ill-formed";
+    }
+    const FmqResultDatum packetInfoDatum = data.at(index);
+    if (packetInfoDatum.getDiscriminator() != discriminator::packetInformation) {
         return NN_ERROR() << "FMQ Result packet ill-formed";
     }
 
     // unpackage packet information
-    const FmqResultDatum::PacketInformation& packetInfo = data.at(index).packetInformation();
+    const FmqResultDatum::PacketInformation& packetInfo = packetInfoDatum.packetInformation();
     index++;
     const uint32_t packetSize = packetInfo.packetSize;
     const V1_0::ErrorStatus errorStatus = packetInfo.errorStatus;
@@ -356,13 +369,17 @@ nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::T
     outputShapes.reserve(numberOfOperands);
     for (size_t operand = 0; operand < numberOfOperands; ++operand) {
         // validate operand information
-        if (index >= data.size() ||
-            data.at(index).getDiscriminator() != discriminator::operandInformation) {
+        if (index >= data.size()) {
+            return NN_ERROR() << "FMQ Result packet ill-formed";
+        }
+        const FmqResultDatum operandInfoDatum = data.at(index);
+        if (operandInfoDatum.getDiscriminator() != discriminator::operandInformation) {
             return NN_ERROR() << "FMQ Result packet ill-formed";
         }
 
         // unpackage operand information
-        const FmqResultDatum::OperandInformation& operandInfo = data.at(index).operandInformation();
+        const FmqResultDatum::OperandInformation& operandInfo =
+                operandInfoDatum.operandInformation();
         index++;
         const bool isSufficient = operandInfo.isSufficient;
         const uint32_t numberOfDimensions = operandInfo.numberOfDimensions;
@@ -372,13 +389,16 @@ nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::T
         dimensions.reserve(numberOfDimensions);
         for (size_t i = 0; i < numberOfDimensions; ++i) {
             // validate dimension
-            if (index >= data.size() ||
-                data.at(index).getDiscriminator() != discriminator::operandDimensionValue) {
+            if (index >= data.size()) {
+                return NN_ERROR() << "FMQ Result packet ill-formed";
+            }
+            const FmqResultDatum dimensionDatum = data.at(index);
+            if (dimensionDatum.getDiscriminator() != discriminator::operandDimensionValue) {
                 return NN_ERROR() << "FMQ Result packet ill-formed";
             }
 
             // unpackage dimension
-            const uint32_t dimension = data.at(index).operandDimensionValue();
+            const uint32_t dimension = dimensionDatum.operandDimensionValue();
             index++;
 
             // store result
@@ -390,13 +410,16 @@ nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::T
     }
 
     // validate execution timing
-    if (index >= data.size() ||
-        data.at(index).getDiscriminator() != discriminator::executionTiming) {
+    if (index >= data.size()) {
+        return NN_ERROR() << "FMQ Result packet ill-formed";
+    }
+    const FmqResultDatum timingDatum = data.at(index);
+    if (timingDatum.getDiscriminator() != discriminator::executionTiming) {
         return NN_ERROR() << "FMQ Result packet ill-formed";
     }
 
     // unpackage execution timing
-    const V1_2::Timing timing = data.at(index).executionTiming();
+    const V1_2::Timing timing = timingDatum.executionTiming();
     index++;
 
     // validate packet information
@@ -408,6 +431,129 @@ nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::T
     return std::make_tuple(errorStatus, std::move(outputShapes), timing);
 }
 
+// Read-only view of a packet that has been acquired from an FMQ with beginRead.
+template <typename Datum>
+class FmqPacketView final {
+  public:
+    using MemTransaction = typename MessageQueue<Datum, kSynchronizedReadWrite>::MemTransaction;
+
+    FmqPacketView(MemTransaction* transaction, size_t size)
+        : kTransaction(transaction), kSize(size) {}
+
+    size_t size() const { return kSize; }
+
+    // Elements are returned by value so that the caller validates and reads the same copy.
+    Datum at(size_t index) const {
+        CHECK_LT(index, kSize);
+        return *kTransaction->getSlot(index);
+    }
+
+  private:
+    MemTransaction* const kTransaction;
+    const size_t kSize;
+};
+
+// Reserve `count` elements in the FMQ, fill them in place with `serialize(nextDatum)`, publish them
+// and wake up the reader.
+template <typename Datum, typename SerializeFunction>
+bool writeInPlace(MessageQueue<Datum, kSynchronizedReadWrite>* fmq, EventFlag* eventFlag,
+                  size_t count, SerializeFunction serialize) {
+    typename MessageQueue<Datum, kSynchronizedReadWrite>::MemTransaction transaction;
+    if (!fmq->beginWrite(count, &transaction)) {
+        return false;
+    }
+
+    size_t index = 0;
+    serialize([&transaction, &index, count]() -> Datum& {
+        CHECK_LT(index, count);
+        return *new (transaction.getSlot(index++)) Datum();
+    });
+    CHECK_EQ(index, count);
+
+    if (!fmq->commitWrite(count)) {
+        return false;
+    }
+    eventFlag->wake(kFmqNotEmpty);
+    return true;
+}
+
+// Acquire the `count` elements at the front of the FMQ, deserialize them in place with
+// `deserialize(view)`, release them and wake up the writer.
+template <typename Datum, typename DeserializeFunction>
+auto readInPlace(MessageQueue<Datum, kSynchronizedReadWrite>* fmq, EventFlag* eventFlag,
+                 size_t count, DeserializeFunction deserialize)
+        -> decltype(deserialize(std::declval<const FmqPacketView<Datum>&>())) {
+    typename MessageQueue<Datum, kSynchronizedReadWrite>::MemTransaction transaction;
+    if (!fmq->beginRead(count, &transaction)) {
+        return NN_ERROR() << "Error receiving packet";
+    }
+
+    auto result = deserialize(FmqPacketView<Datum>(&transaction, count));
+
+    if (!fmq->commitRead(count)) {
+        return NN_ERROR() << "Error receiving packet";
+    }
+    eventFlag->wake(kFmqNotFull);
+    return result;
+}
+
+}  // namespace
+
+std::chrono::microseconds getBurstControllerPollingTimeWindow() {
+    return getPollingTimeWindow("debug.nn.burst-controller-polling-window");
+}
+
+std::chrono::microseconds getBurstServerPollingTimeWindow() {
+    return getPollingTimeWindow("debug.nn.burst-server-polling-window");
+}
+
+// serialize a request into a packet
+std::vector<FmqRequestDatum> serialize(const V1_0::Request& request, V1_2::MeasureTiming measure,
+                                       const std::vector<int32_t>& slots) {
+    const size_t count = getRequestPacketSize(request, slots);
+
+    // create buffer to temporarily store elements
+    std::vector<FmqRequestDatum> data;
+    data.reserve(count);
+    serializeRequest(request, measure, slots, count,
+                     [&data]() -> FmqRequestDatum& { return data.emplace_back(); });
+
+    CHECK_EQ(data.size(), count);
+
+    // return packet
+    return data;
+}
+
+// serialize result
+std::vector<FmqResultDatum> serialize(V1_0::ErrorStatus errorStatus,
+                                      const std::vector<V1_2::OutputShape>& outputShapes,
+                                      V1_2::Timing timing) {
+    const size_t count = getResultPacketSize(outputShapes);
+
+    // create buffer to temporarily store elements
+    std::vector<FmqResultDatum> data;
+    data.reserve(count);
+    serializeResult(errorStatus, outputShapes, timing, count,
+                    [&data]() -> FmqResultDatum& { return data.emplace_back(); });
+
+    CHECK_EQ(data.size(), count);
+
+    // return result
+    return data;
+}
+
+// deserialize request
+nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>> deserialize(
+        const std::vector<FmqRequestDatum>& data) {
+    return deserializeRequest(data);
+}
+
+// deserialize a packet into the result
+nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::Timing>> deserialize(
+        const std::vector<FmqResultDatum>& data) {
+    return deserializeResult(data);
+}
+
 // RequestChannelSender methods
 
 nn::GeneralResult<
@@ -418,6 +564,10 @@ RequestChannelSender::create(size_t channelLength) {
     if (!requestChannelSender->mFmqRequestChannel.isValid()) {
         return NN_ERROR() << "Unable to create RequestChannelSender";
     }
+    if (EventFlag::createEventFlag(requestChannelSender->mFmqRequestChannel.getEventFlagWord(),
+                                   &requestChannelSender->mEventFlag) != OK) {
+        return NN_ERROR() << "Unable to create EventFlag for RequestChannelSender";
+    }
 
     const MQDescriptorSync<FmqRequestDatum>* descriptor =
             requestChannelSender->mFmqRequestChannel.getDesc();
@@ -427,11 +577,35 @@ RequestChannelSender::create(size_t channelLength) {
 RequestChannelSender::RequestChannelSender(PrivateConstructorTag /*tag*/, size_t channelLength)
     : mFmqRequestChannel(channelLength, /*configureEventFlagWord=*/true) {}
 
+RequestChannelSender::~RequestChannelSender() {
+    if (mEventFlag != nullptr) {
+        EventFlag::deleteEventFlag(&mEventFlag);
+    }
+}
+
 nn::Result<void> RequestChannelSender::send(const V1_0::Request& request,
                                             V1_2::MeasureTiming measure,
                                             const std::vector<int32_t>& slots) {
-    const std::vector<FmqRequestDatum> serialized = serialize(request, measure, slots);
-    return sendPacket(serialized);
+    if (!mValid) {
+        return NN_ERROR() << "FMQ object is invalid";
+    }
+
+    const size_t count = getRequestPacketSize(request, slots);
+    if (count > mFmqRequestChannel.availableToWrite()) {
+        return NN_ERROR()
+               << "RequestChannelSender::send -- packet size exceeds size available in FMQ";
+    }
+
+    const bool success = writeInPlace(&mFmqRequestChannel, mEventFlag, count,
+                                      [&request, measure, &slots, count](auto nextDatum) {
+                                          serializeRequest(request, measure, slots, count,
+                                                           std::move(nextDatum));
+                                      });
+    if (!success) {
+        return NN_ERROR() << "RequestChannelSender::send -- unable to write packet to FMQ";
+    }
+
+    return {};
 }
 
 nn::Result<void> RequestChannelSender::sendPacket(const std::vector<FmqRequestDatum>& packet) {
@@ -474,6 +648,10 @@ nn::GeneralResult<std::unique_ptr<RequestChannelReceiver>> RequestChannelReceive
         return NN_ERROR()
                << "RequestChannelReceiver::create was passed an MQDescriptor without an EventFlag";
     }
+    if (EventFlag::createEventFlag(requestChannelReceiver->mFmqRequestChannel.getEventFlagWord(),
+                                   &requestChannelReceiver->mEventFlag) != OK) {
+        return NN_ERROR() << "Unable to create EventFlag for RequestChannelReceiver";
+    }
 
     return requestChannelReceiver;
 }
@@ -483,10 +661,17 @@ RequestChannelReceiver::RequestChannelReceiver(
         std::chrono::microseconds pollingTimeWindow)
     : mFmqRequestChannel(requestChannel), kPollingTimeWindow(pollingTimeWindow) {}
 
+RequestChannelReceiver::~RequestChannelReceiver() {
+    if (mEventFlag != nullptr) {
+        EventFlag::deleteEventFlag(&mEventFlag);
+    }
+}
+
 nn::Result<std::tuple<V1_0::Request, std::vector<int32_t>, V1_2::MeasureTiming>>
 RequestChannelReceiver::getBlocking() {
-    const auto packet = NN_TRY(getPacketBlocking());
-    return deserialize(packet);
+    const size_t count = NN_TRY(waitForPacket());
+    return readInPlace(&mFmqRequestChannel, mEventFlag, count,
+                       [](const auto& packet) { return deserializeRequest(packet); });
 }
 
 void RequestChannelReceiver::invalidate() {
@@ -500,7 +685,7 @@ void RequestChannelReceiver::invalidate() {
     mFmqRequestChannel.writeBlocking(data.data(), data.size());
 }
 
-nn::Result<std::vector<FmqRequestDatum>> RequestChannelReceiver::getPacketBlocking() {
+nn::Result<size_t> RequestChannelReceiver::waitForPacket() {
     if (mTeardown) {
         return NN_ERROR() << "FMQ object is being torn down";
     }
@@ -518,49 +703,39 @@ nn::Result<std::vector<FmqRequestDatum>> RequestChannelReceiver::getPacketBlocki
             return NN_ERROR() << "FMQ object is being torn down";
         }
 
-        // Check if data is available. If it is, immediately retrieve it and return.
+        // Check if data is available. If it is, immediately return its size.
         const size_t available = mFmqRequestChannel.availableToRead();
         if (available > 0) {
-            std::vector<FmqRequestDatum> packet(available);
-            const bool success = mFmqRequestChannel.readBlocking(packet.data(), available);
-            if (!success) {
-                return NN_ERROR() << "Error receiving packet";
-            }
-            return packet;
+            return available;
         }
 
         std::this_thread::yield();
     }
 
     // If we get to this point, we either stopped polling because it was taking too long or polling
-    // was not allowed. Instead, perform a blocking call which uses a futex to save power.
-
-    // wait for request packet and read first element of request packet
-    FmqRequestDatum datum;
-    bool success = mFmqRequestChannel.readBlocking(&datum, 1);
-
-    // retrieve remaining elements
-    // NOTE: all of the data is already available at this point, so there's no need to do a blocking
-    // wait to wait for more data. This is known because in FMQ, all writes are published (made
-    // available) atomically. Currently, the producer always publishes the entire packet in one
-    // function call, so if the first element of the packet is available, the remaining elements are
-    // also available.
-    const size_t count = mFmqRequestChannel.availableToRead();
-    std::vector<FmqRequestDatum> packet(count + 1);
-    std::memcpy(&packet.front(), &datum, sizeof(datum));
-    success &= mFmqRequestChannel.read(packet.data() + 1, count);
-
-    // terminate loop
-    if (mTeardown) {
-        return NN_ERROR() << "FMQ object is being torn down";
-    }
+    // was not allowed. Instead, wait on the futex to save power.
+    // NOTE: once any data is available, the whole packet is available. This is known because in
+    // FMQ, all writes are published (made available) atomically, and the producer always publishes
+    // the entire packet in one transaction.
+    while (true) {
+        const size_t available = mFmqRequestChannel.availableToRead();
 
-    // ensure packet was successfully received
-    if (!success) {
-        return NN_ERROR() << "Error receiving packet";
-    }
+        // terminate loop
+        if (mTeardown) {
+            return NN_ERROR() << "FMQ object is being torn down";
+        }
 
-    return packet;
+        if (available > 0) {
+            return available;
+        }
+
+        uint32_t efState = 0;
+        const status_t status = mEventFlag->wait(kFmqNotEmpty, &efState, /*timeoutNanoSeconds=*/0,
+                                                 /*retry=*/true);
+        if (status != OK) {
+            return NN_ERROR() << "Error receiving packet: EventFlag::wait returned " << status;
+        }
+    }
 }
 
 // ResultChannelSender methods
@@ -577,6 +752,10 @@ nn::GeneralResult<std::unique_ptr<ResultChannelSender>> ResultChannelSender::cre
         return NN_ERROR()
                << "ResultChannelSender::create was passed an MQDescriptor without an EventFlag";
     }
+    if (EventFlag::createEventFlag(resultChannelSender->mFmqResultChannel.getEventFlagWord(),
+                                   &resultChannelSender->mEventFlag) != OK) {
+        return NN_ERROR() << "Unable to create EventFlag for ResultChannelSender";
+    }
 
     return resultChannelSender;
 }
@@ -585,11 +764,34 @@ ResultChannelSender::ResultChannelSender(PrivateConstructorTag /*tag*/,
                                          const MQDescriptorSync<FmqResultDatum>& resultChannel)
     : mFmqResultChannel(resultChannel) {}
 
+ResultChannelSender::~ResultChannelSender() {
+    if (mEventFlag != nullptr) {
+        EventFlag::deleteEventFlag(&mEventFlag);
+    }
+}
+
 void ResultChannelSender::send(V1_0::ErrorStatus errorStatus,
                                const std::vector<V1_2::OutputShape>& outputShapes,
                                V1_2::Timing timing) {
-    const std::vector<FmqResultDatum> serialized = serialize(errorStatus, outputShapes, timing);
-    sendPacket(serialized);
+    if (getResultPacketSize(outputShapes) > mFmqResultChannel.availableToWrite()) {
+        LOG(ERROR) << "ResultChannelSender::send -- packet size exceeds size available in FMQ";
+        write(V1_0::ErrorStatus::GENERAL_FAILURE, {}, kNoTiming);
+        return;
+    }
+    if (!write(errorStatus, outputShapes, timing)) {
+        LOG(ERROR) << "ResultChannelSender::send -- unable to write packet to FMQ";
+    }
+}
+
+bool ResultChannelSender::write(V1_0::ErrorStatus errorStatus,
+                                const std::vector<V1_2::OutputShape>& outputShapes,
+                                V1_2::Timing timing) {
+    const size_t count = getResultPacketSize(outputShapes);
+    return writeInPlace(&mFmqResultChannel, mEventFlag, count,
+                        [errorStatus, &outputShapes, timing, count](auto nextDatum) {
+                            serializeResult(errorStatus, outputShapes, timing, count,
+                                            std::move(nextDatum));
+                        });
 }
 
 void ResultChannelSender::sendPacket(const std::vector<FmqResultDatum>& packet) {
@@ -619,6 +821,10 @@ ResultChannelReceiver::create(size_t channelLength, std::chrono::microseconds po
     if (!resultChannelReceiver->mFmqResultChannel.isValid()) {
         return NN_ERROR() << "Unable to create ResultChannelReceiver";
     }
+    if (EventFlag::createEventFlag(resultChannelReceiver->mFmqResultChannel.getEventFlagWord(),
+                                   &resultChannelReceiver->mEventFlag) != OK) {
+        return NN_ERROR() << "Unable to create EventFlag for ResultChannelReceiver";
+    }
 
     const MQDescriptorSync<FmqResultDatum>* descriptor =
             resultChannelReceiver->mFmqResultChannel.getDesc();
@@ -630,10 +836,17 @@ ResultChannelReceiver::ResultChannelReceiver(PrivateConstructorTag /*tag*/, size
     : mFmqResultChannel(channelLength, /*configureEventFlagWord=*/true),
       kPollingTimeWindow(pollingTimeWindow) {}
 
+ResultChannelReceiver::~ResultChannelReceiver() {
+    if (mEventFlag != nullptr) {
+        EventFlag::deleteEventFlag(&mEventFlag);
+    }
+}
+
 nn::Result<std::tuple<V1_0::ErrorStatus, std::vector<V1_2::OutputShape>, V1_2::Timing>>
 ResultChannelReceiver::getBlocking() {
-    const auto packet = NN_TRY(getPacketBlocking());
-    return deserialize(packet);
+    const size_t count = NN_TRY(waitForPacket());
+    return readInPlace(&mFmqResultChannel, mEventFlag, count,
+                       [](const auto& packet) { return deserializeResult(packet); });
 }
 
 void ResultChannelReceiver::notifyAsDeadObject() {
@@ -648,6 +861,19 @@ void ResultChannelReceiver::notifyAsDeadObject() {
 }
 
 nn::Result<std::vector<FmqResultDatum>> ResultChannelReceiver::getPacketBlocking() {
+    const size_t count = NN_TRY(waitForPacket());
+
+    std::vector<FmqResultDatum> packet(count);
+    const bool success = mFmqResultChannel.read(packet.data(), count);
+    if (!success) {
+        return NN_ERROR() << "Error receiving packet";
+    }
+    mEventFlag->wake(kFmqNotFull);
+
+    return packet;
+}
+
+nn::Result<size_t> ResultChannelReceiver::waitForPacket() {
     if (!mValid) {
         return NN_ERROR() << "FMQ object is invalid";
     }
@@ -665,48 +891,38 @@ nn::Result<std::vector<FmqResultDatum>> ResultChannelReceiver::getPacketBlocking
             return NN_ERROR() << "FMQ object is invalid";
         }
 
-        // Check if data is available. If it is, immediately retrieve it and return.
+        // Check if data is available. If it is, immediately return its size.
         const size_t available = mFmqResultChannel.availableToRead();
         if (available > 0) {
-            std::vector<FmqResultDatum> packet(available);
-            const bool success = mFmqResultChannel.readBlocking(packet.data(), available);
-            if (!success) {
-                return NN_ERROR() << "Error receiving packet";
-            }
-            return packet;
+            return available;
         }
 
         std::this_thread::yield();
     }
 
     // If we get to this point, we either stopped polling because it was taking too long or polling
-    // was not allowed. Instead, perform a blocking call which uses a futex to save power.
-
-    // wait for result packet and read first element of result packet
-    FmqResultDatum datum;
-    bool success = mFmqResultChannel.readBlocking(&datum, 1);
-
-    // retrieve remaining elements
-    // NOTE: all of the data is already available at this point, so there's no need to do a blocking
-    // wait to wait for more data. This is known because in FMQ, all writes are published (made
-    // available) atomically. Currently, the producer always publishes the entire packet in one
-    // function call, so if the first element of the packet is available, the remaining elements are
-    // also available.
-    const size_t count = mFmqResultChannel.availableToRead();
-    std::vector<FmqResultDatum> packet(count + 1);
-    std::memcpy(&packet.front(), &datum, sizeof(datum));
-    success &= mFmqResultChannel.read(packet.data() + 1, count);
+    // was not allowed. Instead, wait on the futex to save power.
+    // NOTE: once any data is available, the whole packet is available. This is known because in
+    // FMQ, all writes are published (made available) atomically, and the producer always publishes
+    // the entire packet in one transaction.
+    while (true) {
+        const size_t available = mFmqResultChannel.availableToRead();
 
-    if (!mValid) {
-        return NN_ERROR() << "FMQ object is invalid";
-    }
+        if (!mValid) {
+            return NN_ERROR() << "FMQ object is invalid";
+        }
 
-    // ensure packet was successfully received
-    if (!success) {
-        return NN_ERROR() << "Error receiving packet";
-    }
+        if (available > 0) {
+            return available;
+        }
 
-    return packet;
+        uint32_t efState = 0;
+        const status_t status = mEventFlag->wait(kFmqNotEmpty, &efState, /*timeoutNanoSeconds=*/0,
+                                                 /*retry=*/true);
+        if (status != OK) {
+            return NN_ERROR() << "Error receiving packet: EventFlag::wait returned " << status;
+        }
+    }
 }
 
 }  // namespace android::hardware::neuralnetworks::V1_2::utils
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <nnapi/hal/1.2/BurstUtils.h>
+
+#include <chrono>
+#include <future>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::V1_2::utils {
+namespace {
+
+constexpr auto kNoTiming = V1_2::Timing{.timeOnDevice = std::numeric_limits<uint64_t>::max(),
+                                        .timeInDriver = std::numeric_limits<uint64_t>::max()};
+constexpr size_t kChannelLength = 64;
+// Long enough for a receiver started on another thread to be waiting on the futex.
+constexpr auto kReceiverWaitDelay = std::chrono::milliseconds{50};
+constexpr auto kTimeout = std::chrono::seconds{5};
+
+const V1_0::Request kRequest = {
+        .inputs = {{.hasNoValue = false,
+                    .location = {.poolIndex = 0, .offset = 0, .length = 16},
+                    .dimensions = {1, 2, 2, 1}}},
+        .outputs = {{.hasNoValue = false,
+                     .location = {.poolIndex = 1, .offset = 0, .length = 16},
+                     .dimensions = {4}}},
+        .pools = {}};
+const std::vector<int32_t> kSlots = {3, 7};
+const std::vector<V1_2::OutputShape> kOutputShapes = {{.dimensions = {4}, .isSufficient = true}};
+
+struct Channels {
+    std::unique_ptr<RequestChannelSender> requestSender;
+    std::unique_ptr<RequestChannelReceiver> requestReceiver;
+    std::unique_ptr<ResultChannelSender> resultSender;
+    std::unique_ptr<ResultChannelReceiver> resultReceiver;
+};
+
+Channels createChannels() {
+    auto [requestSender, requestDescriptor] =
+            RequestChannelSender::create(kChannelLength).value();
+    auto [resultReceiver, resultDescriptor] =
+            ResultChannelReceiver::create(kChannelLength, std::chrono::microseconds{0}).value();
+    auto requestReceiver =
+            RequestChannelReceiver::create(*requestDescriptor, std::chrono::microseconds{0})
+                    .value();
+    auto resultSender = ResultChannelSender::create(*resultDescriptor).value();
+    return {.requestSender = std::move(requestSender),
+            .requestReceiver = std::move(requestReceiver),
+            .resultSender = std::move(resultSender),
+            .resultReceiver = std::move(resultReceiver)};
+}
+
+}  // namespace
+
+TEST(BurstUtilsTest, requestRoundTrip) {
+    // setup test
+    auto channels = createChannels();
+
+    // run test
+    ASSERT_TRUE(channels.requestSender->send(kRequest, V1_2::MeasureTiming::YES, kSlots).ok());
+    const auto result = channels.requestReceiver->getBlocking();
+
+    // verify result
+    ASSERT_TRUE(result.ok()) << result.error();
+    const auto& [request, slots, measure] = result.value();
+    EXPECT_EQ(request, kRequest);
+    EXPECT_EQ(slots, kSlots);
+    EXPECT_EQ(measure, V1_2::MeasureTiming::YES);
+}
+
+TEST(BurstUtilsTest, resultRoundTrip) {
+    // setup test
+    auto channels = createChannels();
+
+    // run test
+    channels.resultSender->send(V1_0::ErrorStatus::NONE, kOutputShapes, kNoTiming);
+    const auto result = channels.resultReceiver->getBlocking();
+
+    // verify result
+    ASSERT_TRUE(result.ok()) << result.error();
+    const auto& [status, outputShapes, timing] = result.value();
+    EXPECT_EQ(status, V1_0::ErrorStatus::NONE);
+    EXPECT_EQ(outputShapes, kOutputShapes);
+    EXPECT_EQ(timing, kNoTiming);
+}
+
+TEST(BurstUtilsTest, inPlacePacketsWrapAroundChannel) {
+    // setup test
+    auto channels = createChannels();
+    const size_t packetSize = serialize(kRequest, V1_2::MeasureTiming::NO, kSlots).size();
+    ASSERT_NE(kChannelLength % packetSize, 0u);
+
+    // run test and verify result
+    // Sending more packets than fit in the channel forces packets to straddle the end of the ring.
+    for (size_t i = 0; i < 2 * kChannelLength / packetSize + 1; ++i) {
+        ASSERT_TRUE(channels.requestSender->send(kRequest, V1_2::MeasureTiming::NO, kSlots).ok());
+        const auto result = channels.requestReceiver->getBlocking();
+        ASSERT_TRUE(result.ok()) << result.error();
+        EXPECT_EQ(std::get<V1_0::Request>(result.value()), kRequest);
+    }
+}
+
+TEST(BurstUtilsTest, inPlaceAndBufferedPacketsAreCompatible) {
+    // setup test
+    auto channels = createChannels();
+
+    // run test
+    ASSERT_TRUE(channels.requestSender
+                        ->sendPacket(serialize(kRequest, V1_2::MeasureTiming::NO, kSlots))
+                        .ok());
+    const auto request = channels.requestReceiver->getBlocking();
+    channels.resultSender->send(V1_0::ErrorStatus::NONE, kOutputShapes, kNoTiming);
+    const auto packet = channels.resultReceiver->getPacketBlocking();
+
+    // verify result
+    ASSERT_TRUE(request.ok()) << request.error();
+    EXPECT_EQ(std::get<V1_0::Request>(request.value()), kRequest);
+    ASSERT_TRUE(packet.ok()) << packet.error();
+    const auto result = deserialize(packet.value());
+    ASSERT_TRUE(result.ok()) << result.error();
+    EXPECT_EQ(std::get<std::vector<V1_2::OutputShape>>(result.value()), kOutputShapes);
+}
+
+TEST(BurstUtilsTest, malformedRequestPacket) {
+    // setup test
+    auto channels = createChannels();
+    auto packet = serialize(kRequest, V1_2::MeasureTiming::NO, kSlots);
+    packet.back().poolIdentifier(0);
+
+    // run test
+    ASSERT_TRUE(channels.requestSender->sendPacket(packet).ok());
+    const auto result = channels.requestReceiver->getBlocking();
+
+    // verify result
+    EXPECT_FALSE(result.ok());
+}
+
+TEST(BurstUtilsTest, blockedRequestReceiverWakesUpOnInPlaceSend) {
+    // setup test
+    auto channels = createChannels();
+    auto result = std::async(std::launch::async,
+                             [&channels] { return channels.requestReceiver->getBlocking(); });
+    std::this_thread::sleep_for(kReceiverWaitDelay);
+
+    // run test
+    ASSERT_TRUE(channels.requestSender->send(kRequest, V1_2::MeasureTiming::NO, kSlots).ok());
+
+    // verify result
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    const auto request = result.get();
+    ASSERT_TRUE(request.ok()) << request.error();
+    EXPECT_EQ(std::get<V1_0::Request>(request.value()), kRequest);
+}
+
+TEST(BurstUtilsTest, blockedRequestReceiverWakesUpOnBufferedSend) {
+    // setup test
+    auto channels = createChannels();
+    auto result = std::async(std::launch::async,
+                             [&channels] { return channels.requestReceiver->getBlocking(); });
+    std::this_thread::sleep_for(kReceiverWaitDelay);
+
+    // run test
+    ASSERT_TRUE(channels.requestSender
+                        ->sendPacket(serialize(kRequest, V1_2::MeasureTiming::NO, kSlots))
+                        .ok());
+
+    // verify result
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    const auto request = result.get();
+    ASSERT_TRUE(request.ok()) << request.error();
+    EXPECT_EQ(std::get<V1_0::Request>(request.value()), kRequest);
+}
+
+TEST(BurstUtilsTest, blockedResultReceiverWakesUpOnInPlaceSend) {
+    // setup test
+    auto channels = createChannels();
+    auto result = std::async(std::launch::async,
+                             [&channels] { return channels.resultReceiver->getBlocking(); });
+    std::this_thread::sleep_for(kReceiverWaitDelay);
+
+    // run test
+    channels.resultSender->send(V1_0::ErrorStatus::NONE, kOutputShapes, kNoTiming);
+
+    // verify result
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    const auto packet = result.get();
+    ASSERT_TRUE(packet.ok()) << packet.error();
+    EXPECT_EQ(std::get<std::vector<V1_2::OutputShape>>(packet.value()), kOutputShapes);
+}
+
+TEST(BurstUtilsTest, blockedResultReceiverUnblocksOnDeadObject) {
+    // setup test
+    auto channels = createChannels();
+    auto result = std::async(std::launch::async,
+                             [&channels] { return channels.resultReceiver->getBlocking(); });
+    std::this_thread::sleep_for(kReceiverWaitDelay);
+
+    // run test
+    channels.resultReceiver->notifyAsDeadObject();
+
+    // verify result
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_FALSE(result.get().ok());
+}
+
+TEST(BurstUtilsTest, blockedRequestReceiverUnblocksOnInvalidate) {
+    // setup test
+    auto channels = createChannels();
+    auto result = std::async(std::launch::async,
+                             [&channels] { return channels.requestReceiver->getBlocking(); });
+    std::this_thread::sleep_for(kReceiverWaitDelay);
+
+    // run test
+    channels.requestReceiver->invalidate();
+
+    // verify result
+    ASSERT_EQ(result.wait_for(kTimeout), std::future_status::ready);
+    EXPECT_FALSE(result.get().ok());
+}
+
+}  // namespace android::hardware::neuralnetworks::V1_2::utils
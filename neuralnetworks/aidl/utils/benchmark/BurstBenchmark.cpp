@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aidl/android/hardware/neuralnetworks/BnBurst.h>
+#include <android/binder_interface_utils.h>
+#include <benchmark/benchmark.h>
+#include <nnapi/SharedMemory.h>
+#include <nnapi/Types.h>
+#include <nnapi/hal/aidl/Burst.h>
+
+#include <memory>
+#include <vector>
+
+namespace aidl::android::hardware::neuralnetworks::utils {
+namespace {
+
+constexpr uint32_t kPoolSize = 1024;
+
+// Driver stand-in that completes every execution immediately, so that the benchmark measures the
+// client side of the burst.
+class FakeBurst final : public BnBurst {
+  public:
+    ndk::ScopedAStatus executeSynchronously(const Request& /*request*/,
+                                            const std::vector<int64_t>& /*memoryIdentifierTokens*/,
+                                            bool /*measureTiming*/, int64_t /*deadline*/,
+                                            int64_t /*loopTimeoutDuration*/,
+                                            ExecutionResult* executionResult) override {
+        *executionResult = {.outputSufficientSize = true, .timing = {-1, -1}};
+        return ndk::ScopedAStatus::ok();
+    }
+    ndk::ScopedAStatus executeSynchronouslyWithConfig(
+            const Request& /*request*/, const std::vector<int64_t>& /*memoryIdentifierTokens*/,
+            const ExecutionConfig& /*config*/, int64_t /*deadline*/,
+            ExecutionResult* executionResult) override {
+        *executionResult = {.outputSufficientSize = true, .timing = {-1, -1}};
+        return ndk::ScopedAStatus::ok();
+    }
+    ndk::ScopedAStatus releaseMemoryResource(int64_t /*memoryIdentifierToken*/) override {
+        return ndk::ScopedAStatus::ok();
+    }
+};
+
+// Input and output pools shared by all benchmark threads, mirroring an application that reuses
+// the same pools for every execution.
+struct SharedPools {
+    SharedPools()
+        : input(nn::createSharedMemory(kPoolSize).value()),
+          output(nn::createSharedMemory(kPoolSize).value()) {}
+
+    nn::Request makeRequest() const {
+        const auto argument = [](uint32_t poolIndex) {
+            return nn::Request::Argument{
+                    .lifetime = nn::Request::Argument::LifeTime::POOL,
+                    .location = {.poolIndex = poolIndex, .offset = 0, .length = kPoolSize}};
+        };
+        return {.inputs = {argument(0)}, .outputs = {argument(1)}, .pools = {input, output}};
+    }
+
+    const nn::SharedMemory input;
+    const nn::SharedMemory output;
+};
+
+const SharedPools& getPools() {
+    static const SharedPools pools;
+    return pools;
+}
+
+// Lookup of already cached input and output pools in a memory cache shared by all threads. This is
+// the part of Burst::execute that contends across threads.
+void BM_MemoryCacheHit(benchmark::State& state) {
+    static std::shared_ptr<Burst::MemoryCache> memoryCache;
+    static std::vector<Burst::OptionalCacheHold> holds;
+    const auto& pools = getPools();
+    if (state.thread_index() == 0) {
+        memoryCache = std::make_shared<Burst::MemoryCache>(ndk::SharedRefBase::make<FakeBurst>());
+        holds = {memoryCache->getOrCacheMemory(pools.input).second,
+                 memoryCache->getOrCacheMemory(pools.output).second};
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(memoryCache->getMemoryIfAvailable(pools.input));
+        benchmark::DoNotOptimize(memoryCache->getMemoryIfAvailable(pools.output));
+    }
+
+    if (state.thread_index() == 0) {
+        holds.clear();
+        memoryCache.reset();
+    }
+}
+BENCHMARK(BM_MemoryCacheHit)->Threads(1)->Threads(4)->UseRealTime();
+
+// Full Burst::execute with cached pools. A burst only allows one execution in flight, so each
+// thread drives its own burst object while all threads reuse the same pools.
+void BM_BurstExecute(benchmark::State& state) {
+    const auto& pools = getPools();
+    const auto burst =
+            Burst::create(ndk::SharedRefBase::make<FakeBurst>(), nn::kVersionFeatureLevel5)
+                    .value();
+    const auto inputHold = burst->cacheMemory(pools.input);
+    const auto outputHold = burst->cacheMemory(pools.output);
+    const auto request = pools.makeRequest();
+
+    for (auto _ : state) {
+        auto result = burst->execute(request, nn::MeasureTiming::NO, {}, {}, {}, {});
+        if (!result.has_value()) {
+            state.SkipWithError(result.error().message.c_str());
+            break;
+        }
+    }
+}
+BENCHMARK(BM_BurstExecute)->Threads(1)->Threads(4)->UseRealTime();
+
+}  // namespace
+}  // namespace aidl::android::hardware::neuralnetworks::utils
+
+BENCHMARK_MAIN();
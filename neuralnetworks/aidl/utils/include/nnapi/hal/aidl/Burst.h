@@ -25,11 +25,12 @@
 #include <nnapi/Types.h>
 #include <nnapi/hal/CommonUtils.h>
 
+#include "ConcurrentMemoryMap.h"
+
 #include <atomic>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <unordered_map>
 #include <utility>
 
 // See hardware/interfaces/neuralnetworks/utils/README.md for more information on AIDL interface
@@ -45,6 +46,9 @@ class Burst final : public nn::IBurst, public std::enable_shared_from_this<Burst
     /**
      * Thread-safe, self-cleaning cache that relates an nn::Memory object to a unique int64_t
      * identifier.
+     *
+     * Looking up a memory object that is already cached does not take a lock. Only creating a new
+     * cache entry and removing an entry once its cleanup fires are serialized.
      */
     class MemoryCache : public std::enable_shared_from_this<MemoryCache> {
       public:
@@ -79,11 +83,15 @@ class Burst final : public nn::IBurst, public std::enable_shared_from_this<Burst
       private:
         void tryFreeMemory(const nn::SharedMemory& memory, int64_t identifier);
 
+        std::optional<std::pair<int64_t, SharedCleanup>> findMemory(
+                const nn::SharedMemory& memory) const;
+
         const std::shared_ptr<aidl_hal::IBurst> kBurst;
+        // Serializes writers to mCache.
         std::mutex mMutex;
         int64_t mUnusedIdentifier GUARDED_BY(mMutex) = 0;
-        std::unordered_map<nn::SharedMemory, std::pair<int64_t, WeakCleanup>> mCache
-                GUARDED_BY(mMutex);
+        // Read without holding mMutex, written only while holding mMutex.
+        ConcurrentMemoryMap<std::pair<int64_t, WeakCleanup>> mCache;
     };
 
     // featureLevel is for testing purposes.
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_AIDL_UTILS_CONCURRENT_MEMORY_MAP_H
+#define ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_AIDL_UTILS_CONCURRENT_MEMORY_MAP_H
+
+#include <android-base/logging.h>
+#include <nnapi/Types.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace aidl::android::hardware::neuralnetworks::utils {
+
+/**
+ * Hash map from nn::SharedMemory to Value with lock-free lookups.
+ *
+ * Lookups (`find`) may run concurrently with each other and with one writer. Writers
+ * (`insertOrAssign` and `eraseIf`) must be serialized by the caller.
+ *
+ * The map is an open-addressing table of pointers to immutable entries. Writers never modify an
+ * entry that has been published; they publish a replacement and retire the old entry (or the old
+ * table when it is resized). Retired objects are reclaimed with epoch-based reclamation: a reader
+ * registers itself in the current epoch for the duration of a lookup, and an object retired in
+ * epoch E is only deleted once the global epoch has advanced to E + 2, which requires that no
+ * reader is still registered in an epoch that could have observed the object.
+ */
+template <typename Value>
+class ConcurrentMemoryMap final {
+  public:
+    ConcurrentMemoryMap() : mTable(new Table(kMinimumCapacity)) {}
+
+    ~ConcurrentMemoryMap() {
+        const Table* table = mTable.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < table->capacity(); ++i) {
+            Entry* entry = table->slots[i].load(std::memory_order_relaxed);
+            if (entry != nullptr && entry != tombstone()) {
+                delete entry;
+            }
+        }
+        delete table;
+        // Retired entries and tables are released by mRetired.
+    }
+
+    ConcurrentMemoryMap(const ConcurrentMemoryMap&) = delete;
+    ConcurrentMemoryMap& operator=(const ConcurrentMemoryMap&) = delete;
+
+    /**
+     * Look up the value associated with a memory object without taking a lock.
+     *
+     * @param memory Key to look up.
+     * @param fn Invoked with a const reference to the value if the key is present. The reference
+     *     is only valid for the duration of the call.
+     * @return true if the key was present, false otherwise.
+     */
+    template <typename Fn>
+    bool find(const nn::SharedMemory& memory, Fn&& fn) const {
+        const EpochGuard guard(this);
+        const Table* table = mTable.load(std::memory_order_acquire);
+        for (size_t i = hashOf(memory) & table->mask, probes = 0; probes < table->capacity();
+             i = (i + 1) & table->mask, ++probes) {
+            const Entry* entry = table->slots[i].load(std::memory_order_acquire);
+            if (entry == nullptr) {
+                return false;
+            }
+            if (entry != tombstone() && entry->memory == memory) {
+                std::invoke(std::forward<Fn>(fn), std::as_const(entry->value));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Associate a value with a memory object, replacing any existing value. Must not be called
+     * concurrently with another writer.
+     */
+    void insertOrAssign(const nn::SharedMemory& memory, Value value) {
+        growIfNeeded();
+        Table* table = mTable.load(std::memory_order_relaxed);
+        auto* entry = new Entry{.memory = memory, .value = std::move(value)};
+
+        std::atomic<Entry*>* reusableSlot = nullptr;
+        for (size_t i = hashOf(memory) & table->mask, probes = 0; probes < table->capacity();
+             i = (i + 1) & table->mask, ++probes) {
+            auto& slot = table->slots[i];
+            Entry* existing = slot.load(std::memory_order_relaxed);
+            if (existing == nullptr) {
+                if (reusableSlot == nullptr) {
+                    reusableSlot = &slot;
+                    mUsedSlots++;
+                }
+                break;
+            }
+            if (existing == tombstone()) {
+                if (reusableSlot == nullptr) {
+                    reusableSlot = &slot;
+                }
+                continue;
+            }
+            if (existing->memory == memory) {
+                slot.store(entry, std::memory_order_release);
+                retire(std::unique_ptr<Entry>(existing));
+                return;
+            }
+        }
+
+        // growIfNeeded guarantees that the table always has a free slot.
+        CHECK(reusableSlot != nullptr);
+        reusableSlot->store(entry, std::memory_order_release);
+        mLiveEntries++;
+    }
+
+    /**
+     * Remove the entry for a memory object if `pred(value)` returns true. Must not be called
+     * concurrently with another writer.
+     *
+     * @return true if an entry was removed.
+     */
+    template <typename Pred>
+    bool eraseIf(const nn::SharedMemory& memory, Pred&& pred) {
+        Table* table = mTable.load(std::memory_order_relaxed);
+        for (size_t i = hashOf(memory) & table->mask, probes = 0; probes < table->capacity();
+             i = (i + 1) & table->mask, ++probes) {
+            auto& slot = table->slots[i];
+            Entry* existing = slot.load(std::memory_order_relaxed);
+            if (existing == nullptr) {
+                break;
+            }
+            if (existing != tombstone() && existing->memory == memory) {
+                if (!std::invoke(std::forward<Pred>(pred), std::as_const(existing->value))) {
+                    return false;
+                }
+                slot.store(tombstone(), std::memory_order_release);
+                mLiveEntries--;
+                retire(std::unique_ptr<Entry>(existing));
+                return true;
+            }
+        }
+        // Still try to make progress on reclamation, so that retired objects do not linger until
+        // the next successful write.
+        reclaim();
+        return false;
+    }
+
+    size_t size() const { return mLiveEntries; }
+
+  private:
+    static constexpr size_t kMinimumCapacity = 16;
+    static constexpr size_t kNumberOfEpochs = 3;
+
+    struct Entry {
+        const nn::SharedMemory memory;
+        const Value value;
+    };
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1), slots(std::make_unique<std::atomic<Entry*>[]>(capacity)) {
+            CHECK_EQ(capacity & mask, 0u) << "capacity must be a power of two";
+            for (size_t i = 0; i < capacity; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        size_t capacity() const { return mask + 1; }
+
+        const size_t mask;
+        const std::unique_ptr<std::atomic<Entry*>[]> slots;
+    };
+
+    // Objects that were unlinked in a given epoch and are waiting to be deleted.
+    struct RetiredList {
+        std::vector<std::unique_ptr<Entry>> entries;
+        std::vector<std::unique_ptr<Table>> tables;
+
+        void clear() {
+            entries.clear();
+            tables.clear();
+        }
+    };
+
+    class EpochGuard {
+      public:
+        explicit EpochGuard(const ConcurrentMemoryMap* map) : kMap(map) {
+            while (true) {
+                mEpoch = kMap->mEpoch.load();
+                kMap->mActiveReaders[mEpoch % kNumberOfEpochs].fetch_add(1);
+                // Re-check the epoch after registering. If it moved on in between, a writer may
+                // not have seen this reader, so register again in the new epoch.
+                if (kMap->mEpoch.load() == mEpoch) {
+                    return;
+                }
+                kMap->mActiveReaders[mEpoch % kNumberOfEpochs].fetch_sub(1);
+            }
+        }
+        ~EpochGuard() { kMap->mActiveReaders[mEpoch % kNumberOfEpochs].fetch_sub(1); }
+
+      private:
+        const ConcurrentMemoryMap* const kMap;
+        uint64_t mEpoch;
+    };
+
+    static Entry* tombstone() {
+        static Entry sTombstone{};
+        return &sTombstone;
+    }
+
+    static size_t hashOf(const nn::SharedMemory& memory) {
+        return std::hash<const nn::Memory*>{}(memory.get());
+    }
+
+    void growIfNeeded() {
+        Table* table = mTable.load(std::memory_order_relaxed);
+        // Keep the load factor (including tombstones) at or below one half.
+        if ((mUsedSlots + 1) * 2 <= table->capacity()) {
+            return;
+        }
+
+        size_t capacity = kMinimumCapacity;
+        while (capacity < (mLiveEntries + 1) * 4) {
+            capacity *= 2;
+        }
+        auto newTable = std::make_unique<Table>(capacity);
+        for (size_t i = 0; i < table->capacity(); ++i) {
+            Entry* entry = table->slots[i].load(std::memory_order_relaxed);
+            if (entry == nullptr || entry == tombstone()) {
+                continue;
+            }
+            size_t j = hashOf(entry->memory) & newTable->mask;
+            while (newTable->slots[j].load(std::memory_order_relaxed) != nullptr) {
+                j = (j + 1) & newTable->mask;
+            }
+            newTable->slots[j].store(entry, std::memory_order_relaxed);
+        }
+
+        // The entries are now shared with the new table; only the old array of slots is retired.
+        mTable.store(newTable.release(), std::memory_order_release);
+        mUsedSlots = mLiveEntries;
+        retire(std::unique_ptr<Table>(table));
+    }
+
+    void retire(std::unique_ptr<Entry> entry) {
+        mRetired[mEpoch.load() % kNumberOfEpochs].entries.push_back(std::move(entry));
+        reclaim();
+    }
+
+    void retire(std::unique_ptr<Table> table) {
+        mRetired[mEpoch.load() % kNumberOfEpochs].tables.push_back(std::move(table));
+        reclaim();
+    }
+
+    // Advances the epoch if no reader is still registered in the previous one, and deletes the
+    // objects that were retired two epochs ago.
+    void reclaim() {
+        const uint64_t epoch = mEpoch.load();
+        const uint64_t previous = epoch + kNumberOfEpochs - 1;
+        if (mActiveReaders[previous % kNumberOfEpochs].load() != 0) {
+            return;
+        }
+        // Objects retired in epoch - 2 share a bucket with epoch + 1. They are unreachable for any
+        // reader that can still be registered, so free them before the bucket is reused.
+        mRetired[(epoch + 1) % kNumberOfEpochs].clear();
+        mEpoch.store(epoch + 1);
+    }
+
+    std::atomic<Table*> mTable;
+    mutable std::atomic<uint64_t> mEpoch{0};
+    mutable std::array<std::atomic<uint32_t>, kNumberOfEpochs> mActiveReaders{};
+
+    // The following members are only accessed by the (externally serialized) writer.
+    std::array<RetiredList, kNumberOfEpochs> mRetired;
+    size_t mUsedSlots = 0;
+    size_t mLiveEntries = 0;
+};
+
+}  // namespace aidl::android::hardware::neuralnetworks::utils
+
+#endif  // ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_AIDL_UTILS_CONCURRENT_MEMORY_MAP_H
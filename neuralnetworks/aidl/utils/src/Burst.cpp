@@ -27,6 +27,7 @@
 #include <nnapi/TypeUtils.h>
 #include <nnapi/Types.h>
 
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -84,18 +85,31 @@ nn::GeneralResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> convertEx
 Burst::MemoryCache::MemoryCache(std::shared_ptr<aidl_hal::IBurst> burst)
     : kBurst(std::move(burst)) {}
 
+std::optional<std::pair<int64_t, Burst::MemoryCache::SharedCleanup>>
+Burst::MemoryCache::findMemory(const nn::SharedMemory& memory) const {
+    std::optional<std::pair<int64_t, SharedCleanup>> result;
+    mCache.find(memory, [&result](const std::pair<int64_t, WeakCleanup>& payload) {
+        const auto& [identifier, maybeCleaner] = payload;
+        if (auto cleaner = maybeCleaner.lock()) {
+            result.emplace(identifier, std::move(cleaner));
+        }
+    });
+    return result;
+}
+
 std::pair<int64_t, Burst::MemoryCache::SharedCleanup> Burst::MemoryCache::getOrCacheMemory(
         const nn::SharedMemory& memory) {
+    // If cache payload already exists, reuse it without taking the lock.
+    if (auto cached = findMemory(memory)) {
+        return std::move(cached).value();
+    }
+
     std::lock_guard lock(mMutex);
 
-    // Get the cache payload or create it (with default values) if it does not exist.
-    auto& cachedPayload = mCache[memory];
-    {
-        const auto& [identifier, maybeCleaner] = cachedPayload;
-        // If cache payload already exists, reuse it.
-        if (auto cleaner = maybeCleaner.lock()) {
-            return std::make_pair(identifier, std::move(cleaner));
-        }
+    // Another thread may have cached the same memory object before the current thread locked
+    // mMutex.
+    if (auto cached = findMemory(memory)) {
+        return std::move(cached).value();
     }
 
     // If the code reaches this point, the cached payload either did not exist or expired prior to
@@ -116,26 +130,15 @@ std::pair<int64_t, Burst::MemoryCache::SharedCleanup> Burst::MemoryCache::getOrC
 
     // Store the result in the cache and return it.
     auto result = std::make_pair(identifier, std::move(cleaner));
-    cachedPayload = result;
+    mCache.insertOrAssign(memory, std::make_pair(identifier, WeakCleanup(result.second)));
     return result;
 }
 
 std::optional<std::pair<int64_t, Burst::MemoryCache::SharedCleanup>>
 Burst::MemoryCache::getMemoryIfAvailable(const nn::SharedMemory& memory) {
-    std::lock_guard lock(mMutex);
-
-    // Get the existing cached entry if it exists.
-    const auto iter = mCache.find(memory);
-    if (iter != mCache.end()) {
-        const auto& [identifier, maybeCleaner] = iter->second;
-        if (auto cleaner = maybeCleaner.lock()) {
-            return std::make_pair(identifier, std::move(cleaner));
-        }
-    }
-
-    // If the code reaches this point, the cached payload did not exist or was actively being
+    // If this returns std::nullopt, the cached payload did not exist or was actively being
     // deleted.
-    return std::nullopt;
+    return findMemory(memory);
 }
 
 void Burst::MemoryCache::tryFreeMemory(const nn::SharedMemory& memory, int64_t identifier) {
@@ -143,13 +146,11 @@ void Burst::MemoryCache::tryFreeMemory(const nn::SharedMemory& memory, int64_t i
         std::lock_guard guard(mMutex);
         // Remove the cached memory and payload if it is present but expired. Note that it may not
         // be present or may not be expired because another thread may have removed or cached the
-        // same memory object before the current thread locked mMutex in tryFreeMemory.
-        const auto iter = mCache.find(memory);
-        if (iter != mCache.end()) {
-            if (std::get<WeakCleanup>(iter->second).expired()) {
-                mCache.erase(iter);
-            }
-        }
+        // same memory object before the current thread locked mMutex in tryFreeMemory. The entry
+        // itself is reclaimed once no concurrent lookup can still be reading it.
+        mCache.eraseIf(memory, [](const std::pair<int64_t, WeakCleanup>& payload) {
+            return std::get<WeakCleanup>(payload).expired();
+        });
     }
     kBurst->releaseMemoryResource(identifier);
 }
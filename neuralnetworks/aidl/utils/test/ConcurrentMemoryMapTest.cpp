@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <nnapi/SharedMemory.h>
+#include <nnapi/Types.h>
+#include <nnapi/hal/aidl/ConcurrentMemoryMap.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace aidl::android::hardware::neuralnetworks::utils {
+namespace {
+
+constexpr size_t kMemorySize = 64;
+
+nn::SharedMemory createMemory() {
+    return nn::createSharedMemory(kMemorySize).value();
+}
+
+std::optional<int64_t> lookup(const ConcurrentMemoryMap<int64_t>& map,
+                              const nn::SharedMemory& memory) {
+    std::optional<int64_t> result;
+    map.find(memory, [&result](int64_t value) { result = value; });
+    return result;
+}
+
+}  // namespace
+
+TEST(ConcurrentMemoryMapTest, findMissing) {
+    // setup test
+    ConcurrentMemoryMap<int64_t> map;
+    const auto memory = createMemory();
+
+    // run test
+    const auto result = lookup(map, memory);
+
+    // verify result
+    EXPECT_FALSE(result.has_value());
+}
+
+TEST(ConcurrentMemoryMapTest, insertAndFind) {
+    // setup test
+    ConcurrentMemoryMap<int64_t> map;
+    const auto memory = createMemory();
+
+    // run test
+    map.insertOrAssign(memory, 7);
+    const auto result = lookup(map, memory);
+
+    // verify result
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), 7);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(ConcurrentMemoryMapTest, insertReplacesExistingValue) {
+    // setup test
+    ConcurrentMemoryMap<int64_t> map;
+    const auto memory = createMemory();
+    map.insertOrAssign(memory, 1);
+
+    // run test
+    map.insertOrAssign(memory, 2);
+    const auto result = lookup(map, memory);
+
+    // verify result
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), 2);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(ConcurrentMemoryMapTest, eraseIf) {
+    // setup test
+    ConcurrentMemoryMap<int64_t> map;
+    const auto memory = createMemory();
+    map.insertOrAssign(memory, 3);
+
+    // run test
+    const bool keptOnFalse = !map.eraseIf(memory, [](int64_t) { return false; });
+    const bool erasedOnTrue = map.eraseIf(memory, [](int64_t value) { return value == 3; });
+
+    // verify result
+    EXPECT_TRUE(keptOnFalse);
+    EXPECT_TRUE(erasedOnTrue);
+    EXPECT_FALSE(lookup(map, memory).has_value());
+    EXPECT_EQ(map.size(), 0u);
+}
+
+TEST(ConcurrentMemoryMapTest, growsAndReusesErasedSlots) {
+    // setup test
+    constexpr int64_t kNumberOfMemories = 100;
+    ConcurrentMemoryMap<int64_t> map;
+    std::vector<nn::SharedMemory> memories;
+    for (int64_t i = 0; i < kNumberOfMemories; ++i) {
+        memories.push_back(createMemory());
+    }
+
+    // run test
+    for (int round = 0; round < 3; ++round) {
+        for (int64_t i = 0; i < kNumberOfMemories; ++i) {
+            map.insertOrAssign(memories[i], i);
+        }
+        for (int64_t i = 0; i < kNumberOfMemories; i += 2) {
+            map.eraseIf(memories[i], [](int64_t) { return true; });
+        }
+    }
+
+    // verify result
+    EXPECT_EQ(map.size(), static_cast<size_t>(kNumberOfMemories / 2));
+    for (int64_t i = 0; i < kNumberOfMemories; ++i) {
+        const auto result = lookup(map, memories[i]);
+        if (i % 2 == 0) {
+            EXPECT_FALSE(result.has_value());
+        } else {
+            ASSERT_TRUE(result.has_value());
+            EXPECT_EQ(result.value(), i);
+        }
+    }
+}
+
+TEST(ConcurrentMemoryMapTest, concurrentReadersDuringWrites) {
+    // setup test
+    constexpr size_t kNumberOfReaders = 4;
+    ConcurrentMemoryMap<int64_t> map;
+    const auto stable = createMemory();
+    map.insertOrAssign(stable, 42);
+    std::atomic_bool done = false;
+    std::atomic_bool mismatch = false;
+
+    // run test
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < kNumberOfReaders; ++i) {
+        readers.emplace_back([&map, &stable, &done, &mismatch] {
+            while (!done) {
+                if (lookup(map, stable) != 42) {
+                    mismatch = true;
+                }
+            }
+        });
+    }
+    for (int64_t i = 0; i < 1000; ++i) {
+        const auto memory = createMemory();
+        map.insertOrAssign(memory, i);
+        map.eraseIf(memory, [](int64_t) { return true; });
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    // verify result
+    EXPECT_FALSE(mismatch);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+}  // namespace aidl::android::hardware::neuralnetworks::utils
@@ -22,23 +22,34 @@
 #include <android/binder_interface_utils.h>
 #include <nnapi/IDevice.h>
 #include <nnapi/Types.h>
+#include <nnapi/hal/ThreadPoolExecutor.h>
 
 #include <functional>
 #include <memory>
-#include <thread>
 
 // See hardware/interfaces/neuralnetworks/utils/README.md for more information on AIDL interface
 // lifetimes across processes and for protecting asynchronous calls across AIDL.
 
 namespace aidl::android::hardware::neuralnetworks::adapter {
+namespace {
+
+// Shared by all devices adapted with the default executor. Intentionally never destroyed, so that
+// no worker is joined during static destruction while a task is still running.
+::android::hardware::neuralnetworks::utils::ThreadPoolExecutor& getDefaultThreadPool() {
+    static auto* const kThreadPool =
+            new ::android::hardware::neuralnetworks::utils::ThreadPoolExecutor();
+    return *kThreadPool;
+}
+
+}  // namespace
 
 std::shared_ptr<BnDevice> adapt(::android::nn::SharedDevice device, Executor executor) {
     return ndk::SharedRefBase::make<Device>(std::move(device), std::move(executor));
 }
 
 std::shared_ptr<BnDevice> adapt(::android::nn::SharedDevice device) {
-    Executor defaultExecutor = [](Task task, ::android::nn::OptionalTimePoint /*deadline*/) {
-        std::thread(std::move(task)).detach();
+    Executor defaultExecutor = [](Task task, ::android::nn::OptionalTimePoint deadline) {
+        getDefaultThreadPool().execute(std::move(task), deadline);
     };
     return adapt(std::move(device), std::move(defaultExecutor));
 }
@@ -158,6 +158,17 @@ void notify(IPreparedModelCallback* callback, PrepareModelResult result) {
     }
 }
 
+bool hasDeadlinePassed(const nn::OptionalTimePoint& deadline) {
+    return deadline.has_value() && *deadline < nn::Clock::now();
+}
+
+// Tasks may wait in the executor's queue. A task whose deadline passed while it was queued is
+// completed with an error instead of calling into the driver.
+PrepareModelResult missedDeadline() {
+    return NN_ERROR(nn::ErrorStatus::MISSED_DEADLINE_TRANSIENT)
+           << "Deadline passed before the task was started";
+}
+
 nn::GeneralResult<void> prepareModel(
         const nn::SharedDevice& device, const Executor& executor, const Model& model,
         ExecutionPreference preference, Priority priority, int64_t deadlineNs,
@@ -184,6 +195,10 @@ nn::GeneralResult<void> prepareModel(
                  nnModelCache = std::move(nnModelCache), nnDataCache = std::move(nnDataCache),
                  nnToken, nnHints = std::move(nnHints),
                  nnExtensionNameToPrefix = std::move(nnExtensionNameToPrefix), callback] {
+        if (hasDeadlinePassed(nnDeadline)) {
+            notify(callback.get(), missedDeadline());
+            return;
+        }
         auto result =
                 device->prepareModel(nnModel, nnPreference, nnPriority, nnDeadline, nnModelCache,
                                      nnDataCache, nnToken, nnHints, nnExtensionNameToPrefix);
@@ -210,6 +225,10 @@ nn::GeneralResult<void> prepareModelFromCache(
 
     auto task = [device, nnDeadline, nnModelCache = std::move(nnModelCache),
                  nnDataCache = std::move(nnDataCache), nnToken, callback] {
+        if (hasDeadlinePassed(nnDeadline)) {
+            notify(callback.get(), missedDeadline());
+            return;
+        }
         auto result = device->prepareModelFromCache(nnDeadline, nnModelCache, nnDataCache, nnToken);
         notify(callback.get(), std::move(result));
     };
@@ -21,23 +21,33 @@
 #include <android/hardware/neuralnetworks/1.3/IDevice.h>
 #include <nnapi/IDevice.h>
 #include <nnapi/Types.h>
+#include <nnapi/hal/ThreadPoolExecutor.h>
 
 #include <functional>
 #include <memory>
-#include <thread>
 
 // See hardware/interfaces/neuralnetworks/utils/README.md for more information on HIDL interface
 // lifetimes across processes and for protecting asynchronous calls across HIDL.
 
 namespace android::hardware::neuralnetworks::adapter {
+namespace {
+
+// Shared by all devices adapted with the default executor. Intentionally never destroyed, so that
+// no worker is joined during static destruction while a task is still running.
+utils::ThreadPoolExecutor& getDefaultThreadPool() {
+    static auto* const kThreadPool = new utils::ThreadPoolExecutor();
+    return *kThreadPool;
+}
+
+}  // namespace
 
 sp<V1_3::IDevice> adapt(nn::SharedDevice device, Executor executor) {
     return sp<Device>::make(std::move(device), std::move(executor));
 }
 
 sp<V1_3::IDevice> adapt(nn::SharedDevice device) {
-    Executor defaultExecutor = [](Task task, nn::OptionalTimePoint /*deadline*/) {
-        std::thread(std::move(task)).detach();
+    Executor defaultExecutor = [](Task task, nn::OptionalTimePoint deadline) {
+        getDefaultThreadPool().execute(std::move(task), deadline);
     };
     return adapt(std::move(device), std::move(defaultExecutor));
 }
@@ -117,6 +117,17 @@ void notify(CallbackType* callback, PrepareModelResult result) {
     }
 }
 
+bool hasDeadlinePassed(const nn::OptionalTimePoint& deadline) {
+    return deadline.has_value() && *deadline < nn::Clock::now();
+}
+
+// Tasks may wait in the executor's queue. A task whose deadline passed while it was queued is
+// completed with an error instead of calling into the driver.
+PrepareModelResult missedDeadline() {
+    return NN_ERROR(nn::ErrorStatus::MISSED_DEADLINE_TRANSIENT)
+           << "Deadline passed before the task was started";
+}
+
 template <typename ModelType>
 nn::GeneralResult<hidl_vec<bool>> getSupportedOperations(const nn::SharedDevice& device,
                                                          const ModelType& model) {
@@ -214,6 +225,10 @@ nn::GeneralResult<void> prepareModel_1_3(
     Task task = [device, nnModel = std::move(nnModel), nnPreference, nnPriority, nnDeadline,
                  nnModelCache = std::move(nnModelCache), nnDataCache = std::move(nnDataCache),
                  nnToken, callback] {
+        if (hasDeadlinePassed(nnDeadline)) {
+            notify(callback.get(), missedDeadline());
+            return;
+        }
         auto result = device->prepareModel(nnModel, nnPreference, nnPriority, nnDeadline,
                                            nnModelCache, nnDataCache, nnToken, {}, {});
         notify(callback.get(), std::move(result));
@@ -263,6 +278,10 @@ nn::GeneralResult<void> prepareModelFromCache_1_3(
 
     auto task = [device, nnDeadline, nnModelCache = std::move(nnModelCache),
                  nnDataCache = std::move(nnDataCache), nnToken, callback] {
+        if (hasDeadlinePassed(nnDeadline)) {
+            notify(callback.get(), missedDeadline());
+            return;
+        }
         auto result = device->prepareModelFromCache(nnDeadline, nnModelCache, nnDataCache, nnToken);
         notify(callback.get(), std::move(result));
     };
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_THREAD_POOL_EXECUTOR_H
+#define ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_THREAD_POOL_EXECUTOR_H
+
+#include <android-base/thread_annotations.h>
+#include <nnapi/Types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::utils {
+
+/**
+ * Executes tasks on a fixed number of worker threads.
+ *
+ * Pending tasks are ordered by earliest deadline first. Tasks without a deadline are run after all
+ * tasks with a deadline, and tasks with equal deadlines are run in submission order.
+ *
+ * When a worker picks up a task whose deadline has already passed, the task's expiry handler is
+ * run instead of the task itself. Tasks submitted without an expiry handler are always run, so
+ * that no task is silently dropped.
+ *
+ * This class is thread-safe. The destructor runs all pending tasks before joining the workers.
+ */
+class ThreadPoolExecutor final {
+  public:
+    using Task = std::function<void()>;
+
+    struct Stats {
+        // Number of tasks accepted by execute().
+        uint64_t submitted = 0;
+        // Number of tasks whose main body was run.
+        uint64_t executed = 0;
+        // Number of tasks whose expiry handler was run instead of the task.
+        uint64_t expired = 0;
+        // Number of tasks currently waiting for a worker, and the largest number seen so far.
+        size_t queueDepth = 0;
+        size_t maxQueueDepth = 0;
+        // Time tasks spent waiting for a worker, summed over all dequeued tasks and the longest.
+        std::chrono::nanoseconds totalQueueLatency{0};
+        std::chrono::nanoseconds maxQueueLatency{0};
+    };
+
+    static constexpr size_t kDefaultNumberOfThreads = 4;
+
+    explicit ThreadPoolExecutor(size_t numberOfThreads = kDefaultNumberOfThreads);
+    ~ThreadPoolExecutor();
+
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    /**
+     * Schedule a task for execution.
+     *
+     * @param task Work to be executed.
+     * @param deadline Optional point in time by which the task is expected to complete.
+     * @param onExpired Optional handler run in place of the task if the deadline has already passed
+     *     when a worker becomes available, typically to report a missed deadline to the client.
+     */
+    void execute(Task task, nn::OptionalTimePoint deadline, Task onExpired = nullptr)
+            EXCLUDES(mMutex);
+
+    Stats getStats() const EXCLUDES(mMutex);
+
+  private:
+    using QueueClock = std::chrono::steady_clock;
+
+    struct PendingTask {
+        Task task;
+        Task onExpired;
+        nn::OptionalTimePoint deadline;
+        uint64_t sequenceNumber;
+        QueueClock::time_point enqueueTime;
+    };
+
+    // Orders the priority queue so that the task with the earliest deadline is on top.
+    struct LaterDeadline {
+        bool operator()(const PendingTask& lhs, const PendingTask& rhs) const;
+    };
+
+    void workerLoop() EXCLUDES(mMutex);
+
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::priority_queue<PendingTask, std::vector<PendingTask>, LaterDeadline> mQueue
+            GUARDED_BY(mMutex);
+    bool mTeardown GUARDED_BY(mMutex) = false;
+    uint64_t mNextSequenceNumber GUARDED_BY(mMutex) = 0;
+    Stats mStats GUARDED_BY(mMutex);
+    std::vector<std::thread> mWorkers;
+};
+
+}  // namespace android::hardware::neuralnetworks::utils
+
+#endif  // ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_THREAD_POOL_EXECUTOR_H
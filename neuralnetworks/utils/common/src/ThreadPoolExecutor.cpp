@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadPoolExecutor.h"
+
+#include <android-base/logging.h>
+#include <nnapi/Types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace android::hardware::neuralnetworks::utils {
+
+bool ThreadPoolExecutor::LaterDeadline::operator()(const PendingTask& lhs,
+                                                   const PendingTask& rhs) const {
+    if (lhs.deadline.has_value() != rhs.deadline.has_value()) {
+        // A task without a deadline is always "later" than a task with one.
+        return !lhs.deadline.has_value();
+    }
+    if (lhs.deadline.has_value() && *lhs.deadline != *rhs.deadline) {
+        return *lhs.deadline > *rhs.deadline;
+    }
+    return lhs.sequenceNumber > rhs.sequenceNumber;
+}
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t numberOfThreads) {
+    CHECK_GT(numberOfThreads, 0u);
+    mWorkers.reserve(numberOfThreads);
+    for (size_t i = 0; i < numberOfThreads; ++i) {
+        mWorkers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    {
+        std::lock_guard guard(mMutex);
+        mTeardown = true;
+    }
+    mCondition.notify_all();
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+void ThreadPoolExecutor::execute(Task task, nn::OptionalTimePoint deadline, Task onExpired) {
+    CHECK(task != nullptr);
+    {
+        std::lock_guard guard(mMutex);
+        mQueue.push({.task = std::move(task),
+                     .onExpired = std::move(onExpired),
+                     .deadline = deadline,
+                     .sequenceNumber = mNextSequenceNumber++,
+                     .enqueueTime = QueueClock::now()});
+        mStats.submitted++;
+        mStats.queueDepth = mQueue.size();
+        mStats.maxQueueDepth = std::max(mStats.maxQueueDepth, mStats.queueDepth);
+    }
+    mCondition.notify_one();
+}
+
+ThreadPoolExecutor::Stats ThreadPoolExecutor::getStats() const {
+    std::lock_guard guard(mMutex);
+    return mStats;
+}
+
+void ThreadPoolExecutor::workerLoop() {
+    while (true) {
+        Task work;
+        {
+            std::unique_lock lock(mMutex);
+            base::ScopedLockAssertion lockAssertion(mMutex);
+            mCondition.wait(lock, [this]() REQUIRES(mMutex) {
+                return mTeardown || !mQueue.empty();
+            });
+            if (mQueue.empty()) {
+                // Only reachable during teardown, once all pending tasks have been run.
+                return;
+            }
+
+            // std::priority_queue::top only provides const access. Moving out of the element is
+            // safe because it is popped immediately afterwards.
+            auto& top = const_cast<PendingTask&>(mQueue.top());
+            const bool hasExpired = top.deadline.has_value() && *top.deadline < nn::Clock::now();
+            const auto queueLatency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    QueueClock::now() - top.enqueueTime);
+            if (hasExpired && top.onExpired != nullptr) {
+                work = std::move(top.onExpired);
+                mStats.expired++;
+            } else {
+                work = std::move(top.task);
+                mStats.executed++;
+            }
+            mQueue.pop();
+
+            mStats.queueDepth = mQueue.size();
+            mStats.totalQueueLatency += queueLatency;
+            mStats.maxQueueLatency = std::max(mStats.maxQueueLatency, queueLatency);
+        }
+        work();
+    }
+}
+
+}  // namespace android::hardware::neuralnetworks::utils
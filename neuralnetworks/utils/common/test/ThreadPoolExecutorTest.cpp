@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <nnapi/Types.h>
+#include <nnapi/hal/ThreadPoolExecutor.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::utils {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Blocks the only worker of a single-threaded executor until release() is called, so that tasks
+// submitted in the meantime are queued.
+class WorkerBlocker {
+  public:
+    explicit WorkerBlocker(ThreadPoolExecutor* executor) {
+        auto started = std::make_shared<std::promise<void>>();
+        auto released = mRelease.get_future().share();
+        executor->execute(
+                [started, released] {
+                    started->set_value();
+                    released.wait();
+                },
+                {});
+        started->get_future().wait();
+    }
+
+    void release() { mRelease.set_value(); }
+
+  private:
+    std::promise<void> mRelease;
+};
+
+}  // namespace
+
+TEST(ThreadPoolExecutorTest, runsTask) {
+    // setup test
+    ThreadPoolExecutor executor(2);
+    std::promise<void> ran;
+
+    // run test
+    executor.execute([&ran] { ran.set_value(); }, {});
+
+    // verify result
+    EXPECT_EQ(ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+}
+
+TEST(ThreadPoolExecutorTest, earliestDeadlineFirst) {
+    // setup test
+    const auto now = nn::Clock::now();
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto record = [&mutex, &order](int id) {
+        return [&mutex, &order, id] {
+            std::lock_guard guard(mutex);
+            order.push_back(id);
+        };
+    };
+    {
+        ThreadPoolExecutor executor(1);
+        WorkerBlocker blocker(&executor);
+
+        // run test
+        executor.execute(record(0), {});
+        executor.execute(record(1), now + std::chrono::hours(3));
+        executor.execute(record(2), now + std::chrono::hours(1));
+        executor.execute(record(3), now + std::chrono::hours(2));
+        executor.execute(record(4), {});
+        blocker.release();
+    }
+
+    // verify result
+    EXPECT_THAT(order, ElementsAre(2, 3, 1, 0, 4));
+}
+
+TEST(ThreadPoolExecutorTest, expiredTaskRunsExpiryHandler) {
+    // setup test
+    bool ranTask = false;
+    bool ranExpiryHandler = false;
+    ThreadPoolExecutor::Stats stats;
+    {
+        ThreadPoolExecutor executor(1);
+
+        // run test
+        executor.execute([&ranTask] { ranTask = true; },
+                         nn::Clock::now() - std::chrono::seconds(1),
+                         [&ranExpiryHandler] { ranExpiryHandler = true; });
+        executor.execute([] {}, {});
+
+        // drain the executor before reading the counters
+        std::promise<void> drained;
+        executor.execute([&drained] { drained.set_value(); }, {});
+        drained.get_future().wait();
+        stats = executor.getStats();
+    }
+
+    // verify result
+    EXPECT_FALSE(ranTask);
+    EXPECT_TRUE(ranExpiryHandler);
+    EXPECT_EQ(stats.submitted, 3u);
+    EXPECT_EQ(stats.expired, 1u);
+    EXPECT_EQ(stats.executed, 2u);
+}
+
+TEST(ThreadPoolExecutorTest, expiredTaskWithoutExpiryHandlerStillRuns) {
+    // setup test
+    bool ranTask = false;
+    {
+        ThreadPoolExecutor executor(1);
+
+        // run test
+        executor.execute([&ranTask] { ranTask = true; },
+                         nn::Clock::now() - std::chrono::seconds(1));
+    }
+
+    // verify result
+    EXPECT_TRUE(ranTask);
+}
+
+TEST(ThreadPoolExecutorTest, tracksQueueDepth) {
+    // setup test
+    ThreadPoolExecutor executor(1);
+    WorkerBlocker blocker(&executor);
+
+    // run test
+    for (int i = 0; i < 5; ++i) {
+        executor.execute([] {}, {});
+    }
+    const auto stats = executor.getStats();
+    blocker.release();
+
+    // verify result
+    EXPECT_EQ(stats.queueDepth, 5u);
+    EXPECT_EQ(stats.maxQueueDepth, 5u);
+}
+
+}  // namespace android::hardware::neuralnetworks::utils
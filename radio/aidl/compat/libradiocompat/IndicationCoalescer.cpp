@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <libradiocompat/IndicationCoalescer.h>
+
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+
+#include <sstream>
+
+using namespace std::literals::chrono_literals;
+
+namespace android::hardware::radio::compat {
+
+/**
+ * How often the delivered and dropped indication counters are logged, at most. They are only
+ * logged while indications are being held back.
+ */
+static constexpr auto kStatsLogInterval = 10min;
+
+/**
+ * Time windows (in milliseconds) within which only the latest of the state indications of a given
+ * kind is delivered.
+ */
+static constexpr std::pair<IndicationCoalescer::Kind, const char*> kWindowProps[] = {
+        {IndicationCoalescer::Kind::SIGNAL_STRENGTH,
+         "ro.vendor.radio.compat.coalesce.signal_strength_ms"},
+        {IndicationCoalescer::Kind::CELL_INFO, "ro.vendor.radio.compat.coalesce.cell_info_ms"},
+        {IndicationCoalescer::Kind::NETWORK_STATE,
+         "ro.vendor.radio.compat.coalesce.network_state_ms"},
+};
+
+IndicationCoalescer::IndicationCoalescer() : mClock(Clock::now), mHasFlushThread(true) {}
+
+IndicationCoalescer::IndicationCoalescer(std::function<Clock::time_point()> clock)
+    : mClock(std::move(clock)), mHasFlushThread(false) {}
+
+IndicationCoalescer::~IndicationCoalescer() {
+    std::thread flushThread;
+    {
+        std::unique_lock<std::mutex> lock(mGuard);
+        mDestroy = true;
+        mCv.notify_all();
+        flushThread = std::move(mFlushThread);
+    }
+    if (flushThread.joinable()) flushThread.join();
+}
+
+void IndicationCoalescer::setWindow(Kind kind, std::chrono::milliseconds window) {
+    std::unique_lock<std::mutex> lock(mGuard);
+    mSlots[static_cast<size_t>(kind)].window = window;
+    mCv.notify_all();
+}
+
+void IndicationCoalescer::setWindowsFromProperties(const PropertyGetter& getProperty) {
+    for (const auto& [kind, prop] : kWindowProps) {
+        const auto value = getProperty(prop, "");
+        if (value.empty()) continue;
+        int32_t window = 0;
+        if (!base::ParseInt(value, &window, 0)) {
+            LOG(WARNING) << "Invalid " << prop << ": " << value;
+            continue;
+        }
+        if (window == 0) continue;
+        LOG(INFO) << "Coalescing " << kind << " indications within " << window << "ms";
+        setWindow(kind, std::chrono::milliseconds(window));
+    }
+}
+
+bool IndicationCoalescer::isEnabled(Kind kind) const {
+    std::unique_lock<std::mutex> lock(mGuard);
+    return mSlots[static_cast<size_t>(kind)].window > 0ms;
+}
+
+void IndicationCoalescer::deliver(Kind kind, std::function<void()> indication, bool droppable) {
+    std::unique_lock<std::mutex> lock(mGuard);
+    auto& slot = mSlots[static_cast<size_t>(kind)];
+
+    const auto now = mClock();
+    const bool inWindow = slot.lastDelivery && now < *slot.lastDelivery + slot.window;
+    if (droppable && (inWindow || slot.pending)) {
+        if (slot.pending) slot.stats.dropped++;
+        slot.pending = std::move(indication);
+        if (mHasFlushThread && !mFlushThread.joinable()) {
+            mFlushThread = std::thread(&IndicationCoalescer::flushThread, this);
+        }
+        mCv.notify_all();
+        return;
+    }
+
+    // the indication supersedes any held back one
+    if (slot.pending) {
+        slot.pending = nullptr;
+        slot.stats.dropped++;
+    }
+    deliverLocked(slot, indication);
+}
+
+void IndicationCoalescer::flush() {
+    std::unique_lock<std::mutex> lock(mGuard);
+    flushLocked();
+}
+
+IndicationCoalescer::Stats IndicationCoalescer::getStats(Kind kind) const {
+    std::unique_lock<std::mutex> lock(mGuard);
+    return mSlots[static_cast<size_t>(kind)].stats;
+}
+
+std::string IndicationCoalescer::dumpStats() const {
+    std::unique_lock<std::mutex> lock(mGuard);
+    return dumpStatsLocked();
+}
+
+void IndicationCoalescer::deliverLocked(Slot& slot, const std::function<void()>& indication) {
+    slot.lastDelivery = mClock();
+    slot.stats.delivered++;
+    indication();
+}
+
+std::optional<IndicationCoalescer::Clock::time_point> IndicationCoalescer::flushLocked() {
+    const auto now = mClock();
+    std::optional<Clock::time_point> nextDeadline;
+    for (auto& slot : mSlots) {
+        if (!slot.pending) continue;
+
+        // lastDelivery is set whenever an indication is held back
+        const auto deadline = *slot.lastDelivery + slot.window;
+        if (deadline <= now) {
+            const auto indication = std::move(slot.pending);
+            slot.pending = nullptr;
+            deliverLocked(slot, indication);
+        } else if (!nextDeadline || deadline < *nextDeadline) {
+            nextDeadline = deadline;
+        }
+    }
+    return nextDeadline;
+}
+
+void IndicationCoalescer::flushThread() {
+    std::unique_lock<std::mutex> lock(mGuard);
+    mLastStatsLog = Clock::now();
+    while (!mDestroy) {
+        const auto nextDeadline = flushLocked();
+
+        if (Clock::now() - mLastStatsLog >= kStatsLogInterval) {
+            mLastStatsLog = Clock::now();
+            LOG(INFO) << dumpStatsLocked();
+        }
+
+        if (nextDeadline) {
+            mCv.wait_until(lock, *nextDeadline);
+        } else {
+            mCv.wait(lock);
+        }
+    }
+}
+
+std::string IndicationCoalescer::dumpStatsLocked() const {
+    std::ostringstream os;
+    for (size_t i = 0; i < kKindCount; i++) {
+        const auto& slot = mSlots[i];
+        os << static_cast<Kind>(i) << " indications (window " << slot.window.count()
+           << "ms): " << slot.stats.delivered << " delivered, " << slot.stats.dropped
+           << " dropped\n";
+    }
+    return os.str();
+}
+
+std::ostream& operator<<(std::ostream& os, IndicationCoalescer::Kind kind) {
+    switch (kind) {
+        case IndicationCoalescer::Kind::SIGNAL_STRENGTH:
+            return os << "Signal strength";
+        case IndicationCoalescer::Kind::CELL_INFO:
+            return os << "Cell info";
+        case IndicationCoalescer::Kind::NETWORK_STATE:
+            return os << "Network state";
+    }
+    return os << static_cast<int>(kind);
+}
+
+}  // namespace android::hardware::radio::compat
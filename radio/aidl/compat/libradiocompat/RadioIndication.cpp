@@ -16,8 +16,16 @@
 
 #include <libradiocompat/RadioIndication.h>
 
+#include <android-base/properties.h>
+
 namespace android::hardware::radio::compat {
 
-RadioIndication::RadioIndication(std::shared_ptr<DriverContext> context) : mContext(context) {}
+RadioIndication::RadioIndication(std::shared_ptr<DriverContext> context) : mContext(context) {
+    mCoalescer.setWindowsFromProperties(base::GetProperty);
+}
+
+std::string RadioIndication::dumpCoalescerStats() const {
+    return mCoalescer.dumpStats();
+}
 
 }  // namespace android::hardware::radio::compat
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "commonStructs.h"
+#include "network/structs.h"
+
+#include "collections.h"
+
+namespace android::hardware::radio::compat {
+namespace {
+
+namespace aidl = ::aidl::android::hardware::radio::network;
+
+V1_2::CellIdentityOperatorNames makeOperatorNames(size_t i) {
+    V1_2::CellIdentityOperatorNames names;
+    // long enough not to fit in the small string buffer of std::string
+    names.alphaLong = "Example Mobile Network Operator " + std::to_string(i);
+    names.alphaShort = "ExampleMNO";
+    return names;
+}
+
+V1_6::CellInfo makeLteCell(size_t i) {
+    V1_5::CellIdentityLte id;
+    id.base.base.mcc = "310";
+    id.base.base.mnc = "260";
+    id.base.base.ci = static_cast<int32_t>(1000 + i);
+    id.base.base.pci = static_cast<int32_t>(i % 504);
+    id.base.base.tac = 42;
+    id.base.base.earfcn = 1850;
+    id.base.operatorNames = makeOperatorNames(i);
+    id.base.bandwidth = 20000;
+    id.additionalPlmns = hidl_vec<hidl_string>{"310410", "311480"};
+    id.bands = hidl_vec<V1_5::EutranBands>{V1_5::EutranBands::BAND_3};
+
+    V1_6::LteSignalStrength sig = {};
+    sig.base.signalStrength = 20;
+    sig.base.rsrp = 95;
+    sig.base.rsrq = 10;
+    sig.base.rssnr = 150;
+
+    V1_6::CellInfoLte lte;
+    lte.cellIdentityLte = id;
+    lte.signalStrengthLte = sig;
+
+    V1_6::CellInfo info;
+    info.registered = i == 0;
+    info.connectionStatus = i == 0 ? V1_2::CellConnectionStatus::PRIMARY_SERVING
+                                   : V1_2::CellConnectionStatus::NONE;
+    info.ratSpecificInfo.lte(lte);
+    return info;
+}
+
+V1_6::CellInfo makeNrCell(size_t i) {
+    V1_5::CellIdentityNr id;
+    id.base.mcc = "310";
+    id.base.mnc = "260";
+    id.base.nci = 68719476735 - i;
+    id.base.pci = static_cast<uint32_t>(i % 1008);
+    id.base.tac = 42;
+    id.base.nrarfcn = 632628;
+    id.base.operatorNames = makeOperatorNames(i);
+    id.additionalPlmns = hidl_vec<hidl_string>{"310410"};
+    id.bands = hidl_vec<V1_5::NgranBands>{V1_5::NgranBands::BAND_78};
+
+    V1_6::NrSignalStrength sig = {};
+    sig.base.ssRsrp = 90;
+    sig.base.ssRsrq = 11;
+    sig.base.ssSinr = 15;
+    sig.csiCqiReport = hidl_vec<uint8_t>{7, 8, 9, 10};
+
+    V1_6::CellInfoNr nr;
+    nr.cellIdentityNr = id;
+    nr.signalStrengthNr = sig;
+
+    V1_6::CellInfo info;
+    info.registered = false;
+    info.connectionStatus = V1_2::CellConnectionStatus::NONE;
+    info.ratSpecificInfo.nr(nr);
+    return info;
+}
+
+// A dense urban scan: mostly neighboring LTE cells, with some NR cells.
+hidl_vec<V1_6::CellInfo> makeCellInfoList(size_t count) {
+    hidl_vec<V1_6::CellInfo> list(count);
+    for (size_t i = 0; i < count; i++) {
+        list[i] = i % 4 == 3 ? makeNrCell(i) : makeLteCell(i);
+    }
+    return list;
+}
+
+// The conversion as it was done before constructing the values in place, for comparison.
+std::vector<aidl::CellInfo> toAidlDefaultConstructed(const hidl_vec<V1_6::CellInfo>& inp) {
+    std::vector<aidl::CellInfo> out(inp.size());
+    for (size_t i = 0; i < inp.size(); i++) {
+        out[i] = toAidl(inp[i]);
+    }
+    return out;
+}
+
+void BM_CellInfoList_DefaultConstructed(benchmark::State& state) {
+    const auto records = makeCellInfoList(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(toAidlDefaultConstructed(records));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CellInfoList_DefaultConstructed)->Arg(8)->Arg(32)->Arg(128);
+
+void BM_CellInfoList(benchmark::State& state) {
+    const auto records = makeCellInfoList(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(toAidl(records));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CellInfoList)->Arg(8)->Arg(32)->Arg(128);
+
+// As done by the cellInfoList indications.
+void BM_CellInfoList_Reused(benchmark::State& state) {
+    const auto records = makeCellInfoList(state.range(0));
+    std::vector<aidl::CellInfo> cellInfos;
+    for (auto _ : state) {
+        toAidl(records, &cellInfos);
+        benchmark::DoNotOptimize(cellInfos.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CellInfoList_Reused)->Arg(8)->Arg(32)->Arg(128);
+
+}  // namespace
+}  // namespace android::hardware::radio::compat
+
+BENCHMARK_MAIN();
@@ -19,6 +19,7 @@
 
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 namespace android::hardware::radio::compat {
 
@@ -31,13 +32,32 @@ namespace android::hardware::radio::compat {
  */
 template <typename T>
 auto toAidl(const hidl_vec<T>& inp) {
-    std::vector<decltype(toAidl(T{}))> out(inp.size());
-    for (size_t i = 0; i < inp.size(); i++) {
-        out[i] = toAidl(inp[i]);
+    std::vector<decltype(toAidl(T{}))> out;
+    out.reserve(inp.size());
+    for (const auto& value : inp) {
+        out.push_back(toAidl(value));
     }
     return out;
 }
 
+/**
+ * Converts hidl_vec<T> HIDL list to std::vector<T> AIDL list, reusing the storage of out.
+ *
+ * Lists which are converted repeatedly (like cell info indications) can keep out around, so it's
+ * only reallocated when the list grows.
+ *
+ * \param inp vector to convert
+ * \param out vector to replace the contents of
+ */
+template <typename T, typename U>
+void toAidl(const hidl_vec<T>& inp, std::vector<U>* out) {
+    out->clear();
+    out->reserve(inp.size());
+    for (const auto& value : inp) {
+        out->push_back(toAidl(value));
+    }
+}
+
 /**
  * Converts std::vector<T> AIDL list to hidl_vec<T> HIDL list.
  *
@@ -63,9 +83,10 @@ auto toHidl(const std::vector<T>& inp) {
  */
 template <typename T, size_t N>
 auto toAidl(const hidl_array<T, N>& inp) {
-    std::vector<decltype(toAidl(T{}))> out(N);
+    std::vector<decltype(toAidl(T{}))> out;
+    out.reserve(N);
     for (size_t i = 0; i < N; i++) {
-        out[i] = toAidl(inp[i]);
+        out.push_back(toAidl(inp[i]));
     }
     return out;
 }
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <android-base/thread_annotations.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace android::hardware::radio::compat {
+
+/**
+ * Rate limits state indications, which only report the latest state of something (e.g. signal
+ * strength), so that at most one indication of each kind is delivered per time window.
+ *
+ * The first indication after a quiet period is delivered right away. Indications arriving within
+ * the window after it are held back, each one replacing (dropping) the one held before, and the
+ * last one is delivered when the window elapses. So the latest state is always delivered, and
+ * indications of a given kind are never reordered. Indications of different kinds may be.
+ *
+ * Event indications must not go through the coalescer, so they keep being delivered in order.
+ */
+class IndicationCoalescer {
+  public:
+    enum class Kind {
+        SIGNAL_STRENGTH,
+        CELL_INFO,
+        NETWORK_STATE,
+    };
+    static constexpr size_t kKindCount = static_cast<size_t>(Kind::NETWORK_STATE) + 1;
+
+    struct Stats {
+        uint64_t delivered = 0;
+        uint64_t dropped = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Reads a system property, returning the default value if it's not set.
+     */
+    using PropertyGetter =
+            std::function<std::string(const std::string& key, const std::string& defaultValue)>;
+
+    IndicationCoalescer();
+
+    /**
+     * For tests: uses the given clock, and only delivers the held back indications from flush().
+     */
+    explicit IndicationCoalescer(std::function<Clock::time_point()> clock);
+
+    ~IndicationCoalescer();
+
+    /**
+     * Sets the time window of a kind of indications. Zero (the default) disables coalescing.
+     */
+    void setWindow(Kind kind, std::chrono::milliseconds window);
+
+    /**
+     * Sets the time windows from the ro.vendor.radio.compat.coalesce.<kind>_ms properties. Kinds
+     * without a valid window keep coalescing disabled.
+     */
+    void setWindowsFromProperties(const PropertyGetter& getProperty);
+
+    bool isEnabled(Kind kind) const;
+
+    /**
+     * Delivers an indication now or when the window of its kind elapses.
+     *
+     * \param kind kind of the indication
+     * \param indication function delivering the indication, which must own everything it uses
+     * \param droppable whether the indication may be dropped in favor of a newer one; indications
+     *        which have to be acknowledged must be delivered
+     */
+    void deliver(Kind kind, std::function<void()> indication, bool droppable = true);
+
+    /**
+     * Delivers the held back indications whose window has elapsed.
+     */
+    void flush();
+
+    Stats getStats(Kind kind) const;
+
+    /**
+     * Returns the windows and the delivered and dropped indication counters of all kinds.
+     */
+    std::string dumpStats() const;
+
+  private:
+    struct Slot {
+        std::chrono::milliseconds window{0};
+        std::optional<Clock::time_point> lastDelivery;
+        std::function<void()> pending;
+        Stats stats;
+    };
+
+    const std::function<Clock::time_point()> mClock;
+    const bool mHasFlushThread;
+
+    // Held while delivering indications as well, so that a held back indication and a newer one
+    // can't race to the callback.
+    mutable std::mutex mGuard;
+    std::array<Slot, kKindCount> mSlots GUARDED_BY(mGuard);
+    std::condition_variable mCv;
+    std::thread mFlushThread GUARDED_BY(mGuard);
+    bool mDestroy GUARDED_BY(mGuard) = false;
+    Clock::time_point mLastStatsLog GUARDED_BY(mGuard);
+
+    void deliverLocked(Slot& slot, const std::function<void()>& indication) REQUIRES(mGuard);
+    // returns the time at which the next held back indication is due
+    std::optional<Clock::time_point> flushLocked() REQUIRES(mGuard);
+    void flushThread();
+    std::string dumpStatsLocked() const REQUIRES(mGuard);
+};
+
+std::ostream& operator<<(std::ostream& os, IndicationCoalescer::Kind kind);
+
+}  // namespace android::hardware::radio::compat
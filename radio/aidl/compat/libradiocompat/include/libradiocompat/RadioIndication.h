@@ -17,6 +17,7 @@
 
 #include "DriverContext.h"
 #include "GuaranteedCallback.h"
+#include "IndicationCoalescer.h"
 
 #include <aidl/android/hardware/radio/data/IRadioDataIndication.h>
 #include <aidl/android/hardware/radio/ims/IRadioImsIndication.h>
@@ -61,6 +62,12 @@ class RadioIndication : public V1_6::IRadioIndication {
             ::aidl::android::hardware::radio::ims::IRadioImsIndicationDefault, true>
             mImsCb;
 
+    // Declared last, so that indications still held back are dropped before the callbacks.
+    IndicationCoalescer mCoalescer;
+
+    template <typename CellInfo>
+    void deliverCellInfoList(V1_0::RadioIndicationType type, const hidl_vec<CellInfo>& records);
+
     // IRadioIndication @ 1.0
     Return<void> radioStateChanged(V1_0::RadioIndicationType type,
                                    V1_0::RadioState radioState) override;
@@ -212,6 +219,8 @@ class RadioIndication : public V1_6::IRadioIndication {
   public:
     RadioIndication(std::shared_ptr<DriverContext> context);
 
+    std::string dumpCoalescerStats() const;
+
     void setResponseFunction(
             std::shared_ptr<::aidl::android::hardware::radio::data::IRadioDataIndication> dataCb);
     void setResponseFunction(
@@ -108,6 +108,8 @@ class RadioNetwork : public RadioCompatBase,
     ::ndk::ScopedAStatus setNullCipherAndIntegrityEnabled(int32_t serial, bool enabled) override;
     ::ndk::ScopedAStatus isNullCipherAndIntegrityEnabled(int32_t serial) override;
 
+    binder_status_t dump(int fd, const char** args, uint32_t numArgs) override;
+
   protected:
     std::shared_ptr<::aidl::android::hardware::radio::network::IRadioNetworkResponse> respond();
 
@@ -29,6 +29,14 @@ namespace android::hardware::radio::compat {
 using ::aidl::android::hardware::radio::RadioTechnology;
 namespace aidl = ::aidl::android::hardware::radio::network;
 
+/**
+ * Whether a state indication may be dropped in favor of a newer one. The ones which have to be
+ * acknowledged are always delivered.
+ */
+static bool isDroppable(V1_0::RadioIndicationType type) {
+    return type == V1_0::RadioIndicationType::UNSOLICITED;
+}
+
 void RadioIndication::setResponseFunction(std::shared_ptr<aidl::IRadioNetworkIndication> netCb) {
     mNetworkCb = netCb;
 }
@@ -51,6 +59,28 @@ Return<void> RadioIndication::cdmaPrlChanged(V1_0::RadioIndicationType type, int
     return {};
 }
 
+template <typename CellInfo>
+void RadioIndication::deliverCellInfoList(V1_0::RadioIndicationType type,
+                                          const hidl_vec<CellInfo>& records) {
+    using Kind = IndicationCoalescer::Kind;
+
+    // Reported often and with dozens of cells on dense networks, so reuse the list when it's
+    // delivered right away.
+    if (!mCoalescer.isEnabled(Kind::CELL_INFO)) {
+        thread_local std::vector<aidl::CellInfo> cellInfos;
+        toAidl(records, &cellInfos);
+        networkCb()->cellInfoList(toAidl(type), cellInfos);
+        return;
+    }
+
+    mCoalescer.deliver(
+            Kind::CELL_INFO,
+            [this, aidlType = toAidl(type), cellInfos = toAidl(records)] {
+                networkCb()->cellInfoList(aidlType, cellInfos);
+            },
+            isDroppable(type));
+}
+
 Return<void> RadioIndication::cellInfoList(V1_0::RadioIndicationType type,
                                            const hidl_vec<V1_0::CellInfo>&) {
     LOG_CALL << type;
@@ -75,14 +105,14 @@ Return<void> RadioIndication::cellInfoList_1_4(V1_0::RadioIndicationType type,
 Return<void> RadioIndication::cellInfoList_1_5(V1_0::RadioIndicationType type,
                                                const hidl_vec<V1_5::CellInfo>& records) {
     LOG_CALL << type;
-    networkCb()->cellInfoList(toAidl(type), toAidl(records));
+    deliverCellInfoList(type, records);
     return {};
 }
 
 Return<void> RadioIndication::cellInfoList_1_6(V1_0::RadioIndicationType type,
                                                const hidl_vec<V1_6::CellInfo>& records) {
     LOG_CALL << type;
-    networkCb()->cellInfoList(toAidl(type), toAidl(records));
+    deliverCellInfoList(type, records);
     return {};
 }
 
@@ -138,14 +168,24 @@ Return<void> RadioIndication::currentSignalStrength_1_2(V1_0::RadioIndicationTyp
 Return<void> RadioIndication::currentSignalStrength_1_4(
         V1_0::RadioIndicationType type, const V1_4::SignalStrength& signalStrength) {
     LOG_CALL << type;
-    networkCb()->currentSignalStrength(toAidl(type), toAidl(signalStrength));
+    mCoalescer.deliver(
+            IndicationCoalescer::Kind::SIGNAL_STRENGTH,
+            [this, aidlType = toAidl(type), signalStrength = toAidl(signalStrength)] {
+                networkCb()->currentSignalStrength(aidlType, signalStrength);
+            },
+            isDroppable(type));
     return {};
 }
 
 Return<void> RadioIndication::currentSignalStrength_1_6(
         V1_0::RadioIndicationType type, const V1_6::SignalStrength& signalStrength) {
     LOG_CALL << type;
-    networkCb()->currentSignalStrength(toAidl(type), toAidl(signalStrength));
+    mCoalescer.deliver(
+            IndicationCoalescer::Kind::SIGNAL_STRENGTH,
+            [this, aidlType = toAidl(type), signalStrength = toAidl(signalStrength)] {
+                networkCb()->currentSignalStrength(aidlType, signalStrength);
+            },
+            isDroppable(type));
     return {};
 }
 
@@ -192,7 +232,10 @@ Return<void> RadioIndication::networkScanResult_1_6(V1_0::RadioIndicationType ty
 
 Return<void> RadioIndication::networkStateChanged(V1_0::RadioIndicationType type) {
     LOG_CALL << type;
-    networkCb()->networkStateChanged(toAidl(type));
+    mCoalescer.deliver(
+            IndicationCoalescer::Kind::NETWORK_STATE,
+            [this, aidlType = toAidl(type)] { networkCb()->networkStateChanged(aidlType); },
+            isDroppable(type));
     return {};
 }
 
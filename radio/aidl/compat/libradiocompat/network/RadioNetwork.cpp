@@ -23,6 +23,8 @@
 
 #include "collections.h"
 
+#include <android-base/file.h>
+
 #define RADIO_MODULE "Network"
 
 namespace android::hardware::radio::compat {
@@ -372,4 +374,9 @@ ScopedAStatus RadioNetwork::setN1ModeEnabled(int32_t serial, bool /*enable*/) {
     respond()->setN1ModeEnabledResponse(notSupported(serial));
     return ok();
 }
+
+binder_status_t RadioNetwork::dump(int fd, const char** /*args*/, uint32_t /*numArgs*/) {
+    base::WriteStringToFd(mCallbackManager->indication().dumpCoalescerStats(), fd);
+    return STATUS_OK;
+}
 }  // namespace android::hardware::radio::compat
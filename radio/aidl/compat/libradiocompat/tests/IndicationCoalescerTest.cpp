@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <libradiocompat/IndicationCoalescer.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace android::hardware::radio::compat {
+
+using namespace std::literals::chrono_literals;
+using Kind = IndicationCoalescer::Kind;
+
+class IndicationCoalescerTest : public ::testing::Test {
+  protected:
+    IndicationCoalescer::Clock::time_point mNow;
+    IndicationCoalescer mCoalescer{[this] { return mNow; }};
+    std::vector<int> mDelivered;
+
+    void advance(std::chrono::milliseconds duration) {
+        mNow += duration;
+        mCoalescer.flush();
+    }
+
+    void deliver(Kind kind, int indication, bool droppable = true) {
+        mCoalescer.deliver(
+                kind, [this, indication] { mDelivered.push_back(indication); }, droppable);
+    }
+
+    void expectStats(Kind kind, uint64_t delivered, uint64_t dropped) {
+        const auto stats = mCoalescer.getStats(kind);
+        EXPECT_EQ(stats.delivered, delivered) << kind;
+        EXPECT_EQ(stats.dropped, dropped) << kind;
+    }
+};
+
+TEST_F(IndicationCoalescerTest, DisabledByDefault) {
+    EXPECT_FALSE(mCoalescer.isEnabled(Kind::SIGNAL_STRENGTH));
+    deliver(Kind::SIGNAL_STRENGTH, 1);
+    deliver(Kind::SIGNAL_STRENGTH, 2);
+    deliver(Kind::SIGNAL_STRENGTH, 3);
+
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 2, 3}));
+    expectStats(Kind::SIGNAL_STRENGTH, 3, 0);
+}
+
+TEST_F(IndicationCoalescerTest, DeliversLatestWhenWindowElapses) {
+    mCoalescer.setWindow(Kind::SIGNAL_STRENGTH, 100ms);
+    EXPECT_TRUE(mCoalescer.isEnabled(Kind::SIGNAL_STRENGTH));
+
+    deliver(Kind::SIGNAL_STRENGTH, 1);
+    advance(10ms);
+    deliver(Kind::SIGNAL_STRENGTH, 2);
+    advance(10ms);
+    deliver(Kind::SIGNAL_STRENGTH, 3);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1}));
+
+    advance(79ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1}));
+    advance(1ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 3}));
+    expectStats(Kind::SIGNAL_STRENGTH, 2, 1);
+
+    // the window restarts with the delivery of the held back indication
+    advance(50ms);
+    deliver(Kind::SIGNAL_STRENGTH, 4);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 3}));
+    advance(50ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 3, 4}));
+
+    // after a quiet period, the first indication is delivered right away
+    advance(200ms);
+    deliver(Kind::SIGNAL_STRENGTH, 5);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 3, 4, 5}));
+    expectStats(Kind::SIGNAL_STRENGTH, 4, 1);
+}
+
+TEST_F(IndicationCoalescerTest, WindowsArePerKind) {
+    mCoalescer.setWindow(Kind::SIGNAL_STRENGTH, 100ms);
+    mCoalescer.setWindow(Kind::NETWORK_STATE, 50ms);
+
+    deliver(Kind::SIGNAL_STRENGTH, 1);
+    deliver(Kind::CELL_INFO, 2);
+    deliver(Kind::NETWORK_STATE, 3);
+    deliver(Kind::SIGNAL_STRENGTH, 4);
+    deliver(Kind::CELL_INFO, 5);
+    deliver(Kind::NETWORK_STATE, 6);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 2, 3, 5}));
+
+    advance(50ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 2, 3, 5, 6}));
+    advance(50ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 2, 3, 5, 6, 4}));
+
+    expectStats(Kind::SIGNAL_STRENGTH, 2, 0);
+    expectStats(Kind::CELL_INFO, 2, 0);
+    expectStats(Kind::NETWORK_STATE, 2, 0);
+}
+
+TEST_F(IndicationCoalescerTest, NonDroppableIsDeliveredRightAway) {
+    mCoalescer.setWindow(Kind::CELL_INFO, 100ms);
+
+    deliver(Kind::CELL_INFO, 1);
+    deliver(Kind::CELL_INFO, 2);
+    // e.g. UNSOLICITED_ACK_EXP, which the modem waits to be acknowledged; it supersedes 2
+    deliver(Kind::CELL_INFO, 3, /* droppable= */ false);
+    deliver(Kind::CELL_INFO, 4, /* droppable= */ false);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 3, 4}));
+
+    advance(100ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 3, 4}));
+    expectStats(Kind::CELL_INFO, 3, 1);
+}
+
+TEST_F(IndicationCoalescerTest, WindowsFromProperties) {
+    const std::map<std::string, std::string> properties = {
+            {"ro.vendor.radio.compat.coalesce.signal_strength_ms", "250"},
+            {"ro.vendor.radio.compat.coalesce.cell_info_ms", "fast"},
+            {"ro.vendor.radio.compat.coalesce.network_state_ms", "-1"},
+    };
+    mCoalescer.setWindowsFromProperties(
+            [&properties](const std::string& key, const std::string& defaultValue) {
+                const auto it = properties.find(key);
+                return it != properties.end() ? it->second : defaultValue;
+            });
+
+    EXPECT_TRUE(mCoalescer.isEnabled(Kind::SIGNAL_STRENGTH));
+    EXPECT_FALSE(mCoalescer.isEnabled(Kind::CELL_INFO));
+    EXPECT_FALSE(mCoalescer.isEnabled(Kind::NETWORK_STATE));
+
+    deliver(Kind::SIGNAL_STRENGTH, 1);
+    deliver(Kind::SIGNAL_STRENGTH, 2);
+    advance(249ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1}));
+    advance(1ms);
+    EXPECT_EQ(mDelivered, (std::vector<int>{1, 2}));
+}
+
+TEST_F(IndicationCoalescerTest, DumpStats) {
+    mCoalescer.setWindow(Kind::NETWORK_STATE, 100ms);
+    deliver(Kind::NETWORK_STATE, 1);
+    deliver(Kind::NETWORK_STATE, 2);
+    deliver(Kind::NETWORK_STATE, 3);
+
+    const auto dump = mCoalescer.dumpStats();
+    EXPECT_NE(dump.find("Network state indications (window 100ms): 1 delivered, 1 dropped"),
+              std::string::npos)
+            << dump;
+    EXPECT_NE(dump.find("Signal strength indications (window 0ms): 0 delivered, 0 dropped"),
+              std::string::npos)
+            << dump;
+}
+
+}  // namespace android::hardware::radio::compat
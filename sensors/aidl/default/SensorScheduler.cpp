@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensors-impl/SensorScheduler.h"
+
+#include "utils/SystemClock.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace sensors {
+
+SensorScheduler::SensorScheduler(ISensorsEventCallback* callback, int64_t coalesceToleranceNs)
+    : mCallback(callback), mCoalesceToleranceNs(coalesceToleranceNs), mStopThread(false) {
+    mThread = std::thread([this] { run(); });
+}
+
+SensorScheduler::~SensorScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopThread = true;
+    }
+    mCv.notify_all();
+    mThread.join();
+}
+
+void SensorScheduler::addSensor(Sensor* sensor) {
+    std::lock_guard<std::mutex> lock(mLock);
+    SensorState& state = mSensors[sensor->getSensorInfo().sensorHandle];
+    state.sensor = sensor;
+    state.wakeUp = sensor->isWakeUpSensor();
+}
+
+void SensorScheduler::updateSensor(Sensor* sensor) {
+    std::unique_lock<std::mutex> lock(mLock);
+    auto it = mSensors.find(sensor->getSensorInfo().sensorHandle);
+    if (it == mSensors.end()) {
+        return;
+    }
+    SensorState& state = it->second;
+    const Sensor::SensorInfo& info = sensor->getSensorInfo();
+
+    bool active = sensor->isActive();
+    int64_t samplingPeriodNs = sensor->getSamplingPeriodNs();
+    // Batching only applies to sensors that advertise a FIFO, otherwise events are reported as
+    // soon as they are generated.
+    int64_t maxReportLatencyNs =
+            info.fifoMaxEventCount > 0 ? sensor->getMaxReportLatencyNs() : 0;
+
+    if (state.active == active && state.samplingPeriodNs == samplingPeriodNs &&
+        state.maxReportLatencyNs == maxReportLatencyNs) {
+        return;
+    }
+
+    if (!active || maxReportLatencyNs < state.maxReportLatencyNs) {
+        // Deliver what was batched under the old configuration rather than dropping it or
+        // holding it for longer than the new latency allows.
+        takeBatchLocked(state);
+    }
+
+    int64_t now = ::android::elapsedRealtimeNano();
+    if (active && !state.active) {
+        // Generate the first sample as soon as the sensor is enabled.
+        state.nextSampleTimeNs = now;
+    } else if (active) {
+        state.nextSampleTimeNs = std::max(now, state.lastSampleTimeNs + samplingPeriodNs);
+    }
+
+    state.active = active;
+    state.samplingPeriodNs = samplingPeriodNs;
+    state.maxReportLatencyNs = maxReportLatencyNs;
+    state.maxBatchedEvents = info.fifoMaxEventCount;
+    state.generation++;
+
+    if (active) {
+        scheduleLocked(state);
+    }
+    postPendingLocked();
+    lock.unlock();
+    // Wake up the scheduler thread to check if a new event should be generated now.
+    mCv.notify_all();
+}
+
+void SensorScheduler::flushSensor(Sensor* sensor) {
+    std::lock_guard<std::mutex> lock(mLock);
+    auto it = mSensors.find(sensor->getSensorInfo().sensorHandle);
+    if (it == mSensors.end()) {
+        return;
+    }
+    takeBatchLocked(it->second);
+    postPendingLocked();
+}
+
+void SensorScheduler::scheduleLocked(SensorState& state) {
+    mQueue.push({state.nextSampleTimeNs, state.sensor->getSensorInfo().sensorHandle,
+                 state.generation});
+}
+
+void SensorScheduler::run() {
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStopThread) {
+        // Discard entries whose sensor has been reconfigured since they were pushed.
+        while (!mQueue.empty()) {
+            const ScheduledSample& top = mQueue.top();
+            auto it = mSensors.find(top.sensorHandle);
+            if (it != mSensors.end() && it->second.active &&
+                it->second.generation == top.generation) {
+                break;
+            }
+            mQueue.pop();
+        }
+
+        if (mQueue.empty()) {
+            mCv.wait(lock);
+            continue;
+        }
+
+        int64_t now = ::android::elapsedRealtimeNano();
+        int64_t earliest = mQueue.top().timeNs;
+        if (earliest > now + mCoalesceToleranceNs) {
+            mCv.wait_for(lock, std::chrono::nanoseconds(earliest - now));
+            continue;
+        }
+
+        // Sample every sensor that is due within the tolerance of this wakeup.
+        while (!mQueue.empty() && mQueue.top().timeNs <= now + mCoalesceToleranceNs) {
+            ScheduledSample sample = mQueue.top();
+            mQueue.pop();
+            auto it = mSensors.find(sample.sensorHandle);
+            if (it == mSensors.end() || !it->second.active ||
+                it->second.generation != sample.generation) {
+                continue;
+            }
+            sampleLocked(it->second, sample.timeNs, now);
+        }
+
+        postPendingLocked();
+    }
+}
+
+void SensorScheduler::sampleLocked(SensorState& state, int64_t scheduledTimeNs, int64_t now) {
+    std::vector<Event> events = state.sensor->readEvents();
+    state.batch.insert(state.batch.end(), std::make_move_iterator(events.begin()),
+                       std::make_move_iterator(events.end()));
+    state.lastSampleTimeNs = now;
+
+    // Keep the sampling cadence stable, but don't try to catch up on samples that were missed.
+    state.nextSampleTimeNs = scheduledTimeNs + state.samplingPeriodNs;
+    if (state.nextSampleTimeNs <= now) {
+        state.nextSampleTimeNs = now + state.samplingPeriodNs;
+    }
+    scheduleLocked(state);
+
+    if (shouldFlushBatchLocked(state, now)) {
+        takeBatchLocked(state);
+    }
+}
+
+bool SensorScheduler::shouldFlushBatchLocked(const SensorState& state, int64_t now) const {
+    if (state.batch.empty()) {
+        return false;
+    }
+    if (state.maxReportLatencyNs == 0 || state.batch.size() >= state.maxBatchedEvents) {
+        return true;
+    }
+    // Flush on the last sample that still meets the report latency of the oldest batched event,
+    // so that no separate timer is needed for the batch deadline.
+    int64_t deadline = state.batch.front().timestamp + state.maxReportLatencyNs;
+    return state.nextSampleTimeNs > deadline || now + mCoalesceToleranceNs >= deadline;
+}
+
+void SensorScheduler::takeBatchLocked(SensorState& state) {
+    if (state.batch.empty()) {
+        return;
+    }
+    std::vector<Event>& pending = state.wakeUp ? mPendingWakeUpEvents : mPendingEvents;
+    pending.insert(pending.end(), std::make_move_iterator(state.batch.begin()),
+                   std::make_move_iterator(state.batch.end()));
+    state.batch.clear();
+}
+
+void SensorScheduler::postPendingLocked() {
+    if (!mPendingEvents.empty()) {
+        mCallback->postEvents(mPendingEvents, false /* wakeup */);
+        mPendingEvents.clear();
+    }
+    if (!mPendingWakeUpEvents.empty()) {
+        mCallback->postEvents(mPendingWakeUpEvents, true /* wakeup */);
+        mPendingWakeUpEvents.clear();
+    }
+}
+
+}  // namespace sensors
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
@@ -35,6 +35,7 @@ ScopedAStatus Sensors::activate(int32_t in_sensorHandle, bool in_enabled) {
     auto sensor = mSensors.find(in_sensorHandle);
     if (sensor != mSensors.end()) {
         sensor->second->activate(in_enabled);
+        mScheduler.updateSensor(sensor->second.get());
         return ScopedAStatus::ok();
     }
 
@@ -42,10 +43,11 @@ ScopedAStatus Sensors::activate(int32_t in_sensorHandle, bool in_enabled) {
 }
 
 ScopedAStatus Sensors::batch(int32_t in_sensorHandle, int64_t in_samplingPeriodNs,
-                             int64_t /* in_maxReportLatencyNs */) {
+                             int64_t in_maxReportLatencyNs) {
     auto sensor = mSensors.find(in_sensorHandle);
     if (sensor != mSensors.end()) {
-        sensor->second->batch(in_samplingPeriodNs);
+        sensor->second->batch(in_samplingPeriodNs, in_maxReportLatencyNs);
+        mScheduler.updateSensor(sensor->second.get());
         return ScopedAStatus::ok();
     }
 
@@ -64,6 +66,9 @@ ScopedAStatus Sensors::configDirectReport(int32_t /* in_sensorHandle */,
 ScopedAStatus Sensors::flush(int32_t in_sensorHandle) {
     auto sensor = mSensors.find(in_sensorHandle);
     if (sensor != mSensors.end()) {
+        // Write all of the events currently batched for the sensor before the flush complete
+        // event.
+        mScheduler.flushSensor(sensor->second.get());
         return sensor->second->flush();
     }
 
@@ -90,6 +95,7 @@ ScopedAStatus Sensors::initialize(
     // Ensure that all sensors are disabled.
     for (auto sensor : mSensors) {
         sensor.second->activate(false);
+        mScheduler.updateSensor(sensor.second.get());
     }
 
     // Stop the Wake Lock thread if it is currently running
@@ -143,6 +149,7 @@ ScopedAStatus Sensors::registerDirectChannel(const ISensors::SharedMemInfo& /* i
 ScopedAStatus Sensors::setOperationMode(OperationMode in_mode) {
     for (auto sensor : mSensors) {
         sensor.second->setOperationMode(in_mode);
+        mScheduler.updateSensor(sensor.second.get());
     }
     return ScopedAStatus::ok();
 }
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
-#include <thread>
+#pragma once
+
+#include <atomic>
 
 #include <aidl/android/hardware/sensors/BnSensors.h>
 
@@ -23,6 +25,8 @@ namespace android {
 namespace hardware {
 namespace sensors {
 
+class SensorScheduler;
+
 class ISensorsEventCallback {
   public:
     using Event = ::aidl::android::hardware::sensors::Event;
@@ -45,7 +49,7 @@ class Sensor {
     virtual ~Sensor();
 
     const SensorInfo& getSensorInfo() const;
-    void batch(int64_t samplingPeriodNs);
+    void batch(int64_t samplingPeriodNs, int64_t maxReportLatencyNs = 0);
     virtual void activate(bool enable);
     ndk::ScopedAStatus flush();
 
@@ -53,27 +57,28 @@ class Sensor {
     bool supportsDataInjection() const;
     ndk::ScopedAStatus injectEvent(const Event& event);
 
+    // Returns true if the sensor should currently be generating samples.
+    bool isActive() const;
+    int64_t getSamplingPeriodNs() const;
+    int64_t getMaxReportLatencyNs() const;
+
   protected:
-    void run();
+    // Samples are generated by the SensorScheduler which calls readEvents() when due.
+    friend class SensorScheduler;
+
     virtual std::vector<Event> readEvents();
     virtual void readEventPayload(EventPayload&) = 0;
-    static void startThread(Sensor* sensor);
 
-    bool isWakeUpSensor();
+    bool isWakeUpSensor() const;
 
-    bool mIsEnabled;
-    int64_t mSamplingPeriodNs;
-    int64_t mLastSampleTimeNs;
+    std::atomic_bool mIsEnabled;
+    std::atomic<int64_t> mSamplingPeriodNs;
+    std::atomic<int64_t> mMaxReportLatencyNs;
     SensorInfo mSensorInfo;
 
-    std::atomic_bool mStopThread;
-    std::condition_variable mWaitCV;
-    std::mutex mRunMutex;
-    std::thread mRunThread;
-
     ISensorsEventCallback* mCallback;
 
-    OperationMode mMode;
+    std::atomic<OperationMode> mMode;
 };
 
 class OnChangeSensor : public Sensor {
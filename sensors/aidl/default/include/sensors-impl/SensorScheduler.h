@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Sensor.h"
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace sensors {
+
+/**
+ * Drives sample generation for all sensors from a single thread.
+ *
+ * The next sample time of every active sensor is kept in a min-heap. On each wakeup the scheduler
+ * samples every sensor that is due within the coalescing tolerance, holds the events of sensors
+ * that requested a non-zero max report latency (and advertise a FIFO) until their latency would
+ * be exceeded, and writes everything that is ready in one batch per wake-up class.
+ */
+class SensorScheduler {
+  public:
+    using Event = ::aidl::android::hardware::sensors::Event;
+
+    // Samples that are due within this window of the earliest due sample are generated in the
+    // same wakeup.
+    static constexpr int64_t kDefaultCoalesceToleranceNs = 1 * 1000 * 1000;  // 1 ms
+
+    explicit SensorScheduler(ISensorsEventCallback* callback,
+                             int64_t coalesceToleranceNs = kDefaultCoalesceToleranceNs);
+    ~SensorScheduler();
+
+    // Registers a sensor. The sensor must outlive the scheduler.
+    void addSensor(Sensor* sensor);
+
+    // Re-reads the enabled state, operation mode, sampling period and max report latency of the
+    // sensor. Must be called after any of those change.
+    void updateSensor(Sensor* sensor);
+
+    // Writes any events currently batched for the sensor to the event queue.
+    void flushSensor(Sensor* sensor);
+
+  private:
+    struct SensorState {
+        Sensor* sensor = nullptr;
+        bool active = false;
+        bool wakeUp = false;
+        int64_t samplingPeriodNs = 0;
+        int64_t maxReportLatencyNs = 0;
+        size_t maxBatchedEvents = 0;
+        int64_t lastSampleTimeNs = 0;
+        int64_t nextSampleTimeNs = 0;
+        // Incremented whenever the schedule of the sensor changes so that stale heap entries can
+        // be discarded when they are popped.
+        uint64_t generation = 0;
+        // Events held back because of the sensor's max report latency.
+        std::vector<Event> batch;
+    };
+
+    struct ScheduledSample {
+        int64_t timeNs;
+        int32_t sensorHandle;
+        uint64_t generation;
+
+        bool operator>(const ScheduledSample& other) const { return timeNs > other.timeNs; }
+    };
+
+    void run();
+    void scheduleLocked(SensorState& state);
+    void sampleLocked(SensorState& state, int64_t scheduledTimeNs, int64_t now);
+    bool shouldFlushBatchLocked(const SensorState& state, int64_t now) const;
+    void takeBatchLocked(SensorState& state);
+    void postPendingLocked();
+
+    ISensorsEventCallback* mCallback;
+    const int64_t mCoalesceToleranceNs;
+
+    std::mutex mLock;
+    std::condition_variable mCv;
+    std::map<int32_t, SensorState> mSensors;
+    std::priority_queue<ScheduledSample, std::vector<ScheduledSample>,
+                        std::greater<ScheduledSample>>
+            mQueue;
+    // Events that are ready to be written to the event queue, split by wake-up class because a
+    // single write carries one wake-up flag.
+    std::vector<Event> mPendingWakeUpEvents;
+    std::vector<Event> mPendingEvents;
+    bool mStopThread;
+    std::thread mThread;
+};
+
+}  // namespace sensors
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
@@ -22,6 +22,7 @@
 #include <hardware_legacy/power.h>
 #include <map>
 #include "Sensor.h"
+#include "SensorScheduler.h"
 
 namespace aidl {
 namespace android {
@@ -44,7 +45,8 @@ class Sensors : public BnSensors, public ISensorsEventCallback {
           mOutstandingWakeUpEvents(0),
           mReadWakeLockQueueRun(false),
           mAutoReleaseWakeLockTime(0),
-          mHasWakeLock(false) {
+          mHasWakeLock(false),
+          mScheduler(this /* callback */) {
         AddSensor<AccelSensor>();
         AddSensor<GyroSensor>();
         AddSensor<AmbientTempSensor>();
@@ -93,7 +95,7 @@ class Sensors : public BnSensors, public ISensorsEventCallback {
 
     void postEvents(const std::vector<Event>& events, bool wakeup) override {
         std::lock_guard<std::mutex> lock(mWriteLock);
-        if (mEventQueue == nullptr) {
+        if (mEventQueue == nullptr || events.empty()) {
             return;
         }
         if (mEventQueue->write(&events.front(), events.size())) {
@@ -115,6 +117,7 @@ class Sensors : public BnSensors, public ISensorsEventCallback {
         std::shared_ptr<SensorType> sensor =
                 std::make_shared<SensorType>(mNextHandle++ /* sensorHandle */, this /* callback */);
         mSensors[sensor->getSensorInfo().sensorHandle] = sensor;
+        mScheduler.addSensor(sensor.get());
     }
 
     // Utility function to delete the Event Flag
@@ -208,6 +211,9 @@ class Sensors : public BnSensors, public ISensorsEventCallback {
     int64_t mAutoReleaseWakeLockTime;
     // Flag to indicate if a wake lock has been acquired
     bool mHasWakeLock;
+    // Generates samples for all sensors from a single thread. Declared after mSensors so that the
+    // scheduler thread is stopped before the sensors are destroyed.
+    SensorScheduler mScheduler;
 };
 
 }  // namespace sensors
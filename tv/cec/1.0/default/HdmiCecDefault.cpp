@@ -23,7 +23,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/ioctl.h>
-#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include "HdmiCecDefault.h"
 
@@ -31,6 +33,9 @@
 #define MIN_PORT_ID 0
 #define MAX_PORT_ID 15
 #define INVALID_PHYSICAL_ADDRESS 0xFFFF
+#define EXIT_EVENT_ID UINT32_MAX
+// Bounds the time spent reading before delivering, should a port never stop being ready.
+#define MAX_READ_ROUNDS_PER_WAKEUP 64
 
 namespace android {
 namespace hardware {
@@ -308,6 +313,7 @@ Return<Result> HdmiCecDefault::init() {
     DIR* dir = opendir(parentPath);
     const char* cecFilename = "cec";
 
+    vector<shared_ptr<HdmiCecPort>> hdmiCecPorts;
     while (struct dirent* dirEntry = readdir(dir)) {
         string filename = dirEntry->d_name;
         if (filename.compare(0, 3, cecFilename, 0, 3) == 0) {
@@ -321,19 +327,57 @@ Return<Result> HdmiCecDefault::init() {
             if (result != Result::SUCCESS) {
                 continue;
             }
-            thread eventThread(&HdmiCecDefault::event_thread, this, hdmiCecPort.get());
-            mEventThreads.push_back(std::move(eventThread));
-            mHdmiCecPorts.push_back(std::move(hdmiCecPort));
+            hdmiCecPorts.push_back(std::move(hdmiCecPort));
         }
     }
+    closedir(dir);
+    return initPorts(std::move(hdmiCecPorts));
+}
+
+Return<Result> HdmiCecDefault::initPorts(vector<shared_ptr<HdmiCecPort>> hdmiCecPorts) {
+    if (hdmiCecPorts.empty()) {
+        return Result::FAILURE_NOT_SUPPORTED;
+    }
+
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (mEpollFd < 0) {
+        LOG(ERROR) << "Failed to create epoll instance, Error = " << strerror(errno);
+        return Result::FAILURE_NOT_SUPPORTED;
+    }
+    mExitFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mExitFd < 0) {
+        LOG(ERROR) << "Failed to open eventfd, Error = " << strerror(errno);
+        release();
+        return Result::FAILURE_NOT_SUPPORTED;
+    }
+    epoll_event exitEvent = {.events = EPOLLIN, .data = {.u32 = EXIT_EVENT_ID}};
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mExitFd, &exitEvent)) {
+        LOG(ERROR) << "Failed to watch eventfd, Error = " << strerror(errno);
+        release();
+        return Result::FAILURE_NOT_SUPPORTED;
+    }
+
+    for (auto& hdmiCecPort : hdmiCecPorts) {
+        // The CEC framework signals received messages as EPOLLIN, and pending events as EPOLLPRI.
+        epoll_event portEvent = {.events = EPOLLIN | EPOLLPRI,
+                                 .data = {.u32 = static_cast<uint32_t>(mHdmiCecPorts.size())}};
+        if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, hdmiCecPort->mCecFd, &portEvent)) {
+            LOG(ERROR) << "Failed to watch port " << hdmiCecPort->mPortId
+                       << ", Error = " << strerror(errno);
+            continue;
+        }
+        mHdmiCecPorts.push_back(std::move(hdmiCecPort));
+    }
 
     if (mHdmiCecPorts.empty()) {
+        release();
         return Result::FAILURE_NOT_SUPPORTED;
     }
 
     mCecEnabled = true;
     mWakeupEnabled = true;
     mCecControlEnabled = true;
+    mEventThread = thread(&HdmiCecDefault::eventLoop, this);
     return Result::SUCCESS;
 }
 
@@ -341,93 +385,96 @@ Return<void> HdmiCecDefault::release() {
     mCecEnabled = false;
     mWakeupEnabled = false;
     mCecControlEnabled = false;
-    for (thread& eventThread : mEventThreads) {
-        if (eventThread.joinable()) {
-            eventThread.join();
-        }
+    if (mExitFd > 0) {
+        uint64_t tmp = 1;
+        write(mExitFd, &tmp, sizeof(tmp));
+    }
+    if (mEventThread.joinable()) {
+        mEventThread.join();
+    }
+    if (mExitFd > 0) {
+        close(mExitFd);
+        mExitFd = -1;
+    }
+    if (mEpollFd > 0) {
+        close(mEpollFd);
+        mEpollFd = -1;
     }
     setCallback(nullptr);
     mHdmiCecPorts.clear();
-    mEventThreads.clear();
     return Void();
 }
 
-void HdmiCecDefault::event_thread(HdmiCecPort* hdmiCecPort) {
-    struct pollfd ufds[3] = {
-            {hdmiCecPort->mCecFd, POLLIN, 0},
-            {hdmiCecPort->mCecFd, POLLERR, 0},
-            {hdmiCecPort->mExitFd, POLLIN, 0},
-    };
+void HdmiCecDefault::eventLoop() {
+    vector<epoll_event> events(mHdmiCecPorts.size() + 1);
+    vector<CecEvent> cecEvents;
 
     while (1) {
-        ufds[0].revents = 0;
-        ufds[1].revents = 0;
-        ufds[2].revents = 0;
-
-        int ret = poll(ufds, /* size(ufds) = */ 3, /* timeout = */ -1);
-
-        if (ret <= 0) {
-            continue;
-        }
-
-        if (ufds[2].revents == POLLIN) { /* Exit */
-            break;
+        int ret = TEMP_FAILURE_RETRY(
+                epoll_wait(mEpollFd, events.data(), events.size(), /* timeout = */ -1));
+        if (ret < 0) {
+            LOG(ERROR) << "epoll_wait failed, Error = " << strerror(errno);
+            return;
         }
-
-        if (ufds[1].revents == POLLERR) { /* CEC Event */
-            cec_event ev;
-            ret = ioctl(hdmiCecPort->mCecFd, CEC_DQEVENT, &ev);
-
-            if (ret) {
-                LOG(ERROR) << "CEC_DQEVENT failed, Error = " << strerror(errno);
-                continue;
-            }
-
-            if (!mCecEnabled) {
-                continue;
+        mWakeupCount++;
+
+        // Keep reading until nothing is ready, so that a burst of messages, e.g. the replies to
+        // a broadcast poll, is delivered in one go instead of one wakeup per message.
+        for (int round = 0; ret > 0 && round < MAX_READ_ROUNDS_PER_WAKEUP; round++) {
+            for (int i = 0; i < ret; i++) {
+                if (events[i].data.u32 == EXIT_EVENT_ID) { /* Exit */
+                    return;
+                }
+                readPort(mHdmiCecPorts[events[i].data.u32].get(), events[i].events, &cecEvents);
             }
+            ret = TEMP_FAILURE_RETRY(
+                    epoll_wait(mEpollFd, events.data(), events.size(), /* timeout = */ 0));
+        }
 
-            if (ev.event == CEC_EVENT_STATE_CHANGE) {
-                if (mCallback != nullptr) {
-                    HotplugEvent hotplugEvent{
-                            .connected = (ev.state_change.phys_addr != CEC_PHYS_ADDR_INVALID),
-                            .portId = hdmiCecPort->mPortId};
-                    mCallback->onHotplugEvent(hotplugEvent);
+        // IHdmiCecCallback has no batched method, deliver the batch in the order it was read.
+        sp<IHdmiCecCallback> callback = mCallback;
+        if (callback != nullptr) {
+            for (const CecEvent& cecEvent : cecEvents) {
+                if (auto* cecMessage = std::get_if<CecMessage>(&cecEvent)) {
+                    callback->onCecMessage(*cecMessage);
                 } else {
-                    LOG(ERROR) << "No event callback for hotplug";
+                    callback->onHotplugEvent(std::get<HotplugEvent>(cecEvent));
                 }
             }
+        } else if (!cecEvents.empty()) {
+            LOG(ERROR) << "No event callback, dropping " << cecEvents.size()
+                       << " messages and hotplug events";
         }
+        cecEvents.clear();
+    }
+}
 
-        if (ufds[0].revents == POLLIN) { /* CEC Driver */
-            cec_msg msg = {};
-            ret = ioctl(hdmiCecPort->mCecFd, CEC_RECEIVE, &msg);
-
-            if (ret) {
-                LOG(ERROR) << "CEC_RECEIVE failed, Error = " << strerror(errno);
-                continue;
-            }
-
-            if (msg.rx_status != CEC_RX_STATUS_OK) {
-                LOG(ERROR) << "msg rx_status = " << msg.rx_status;
-                continue;
-            }
-
-            if (!mCecEnabled) {
-                continue;
-            }
-
-            if (!mWakeupEnabled && isWakeupMessage(msg)) {
-                LOG(DEBUG) << "Filter wakeup message";
-                continue;
-            }
+void HdmiCecDefault::readPort(HdmiCecPort* hdmiCecPort, uint32_t events,
+                              vector<CecEvent>* cecEvents) {
+    if (events & EPOLLHUP) {
+        // The adapter was unregistered, stop watching it rather than spinning on it.
+        LOG(ERROR) << "Port " << hdmiCecPort->mPortId << " was disconnected";
+        epoll_ctl(mEpollFd, EPOLL_CTL_DEL, hdmiCecPort->mCecFd, nullptr);
+        return;
+    }
 
-            if (!mCecControlEnabled && !isTransferableInSleep(msg)) {
-                LOG(DEBUG) << "Filter message in standby mode";
-                continue;
+    if (events & EPOLLPRI) { /* CEC Event */
+        cec_event ev;
+        if (hdmiCecPort->dequeueEvent(&ev)) {
+            mReceivedCount++;
+            if (mCecEnabled && ev.event == CEC_EVENT_STATE_CHANGE) {
+                cecEvents->push_back(HotplugEvent{
+                        .connected = (ev.state_change.phys_addr != CEC_PHYS_ADDR_INVALID),
+                        .portId = hdmiCecPort->mPortId});
             }
+        }
+    }
 
-            if (mCallback != nullptr) {
+    if (events & EPOLLIN) { /* CEC Driver */
+        cec_msg msg;
+        if (hdmiCecPort->receiveMessage(&msg)) {
+            mReceivedCount++;
+            if (shouldDeliver(msg)) {
                 size_t length = std::min(msg.len - 1, (uint32_t)MaxLength::MESSAGE_BODY);
                 CecMessage cecMessage{
                         .initiator = static_cast<CecLogicalAddress>(msg.msg[0] >> 4),
@@ -437,14 +484,34 @@ void HdmiCecDefault::event_thread(HdmiCecPort* hdmiCecPort) {
                 for (size_t i = 0; i < length; ++i) {
                     cecMessage.body[i] = static_cast<uint8_t>(msg.msg[i + 1]);
                 }
-                mCallback->onCecMessage(cecMessage);
-            } else {
-                LOG(ERROR) << "no event callback for message";
+                cecEvents->push_back(std::move(cecMessage));
             }
         }
     }
 }
 
+bool HdmiCecDefault::shouldDeliver(const cec_msg& msg) {
+    if (msg.rx_status != CEC_RX_STATUS_OK) {
+        LOG(ERROR) << "msg rx_status = " << msg.rx_status;
+        return false;
+    }
+
+    if (!mCecEnabled) {
+        return false;
+    }
+
+    if (!mWakeupEnabled && isWakeupMessage(msg)) {
+        LOG(DEBUG) << "Filter wakeup message";
+        return false;
+    }
+
+    if (!mCecControlEnabled && !isTransferableInSleep(msg)) {
+        LOG(DEBUG) << "Filter message in standby mode";
+        return false;
+    }
+    return true;
+}
+
 int HdmiCecDefault::getOpcode(cec_msg message) {
     return static_cast<uint8_t>(message.msg[1]);
 }
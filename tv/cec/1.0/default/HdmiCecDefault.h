@@ -15,7 +15,10 @@
  */
 #include <hardware/hdmi_cec.h>
 #include <linux/cec.h>
+#include <atomic>
+#include <memory>
 #include <thread>
+#include <variant>
 #include <vector>
 #include "HdmiCecPort.h"
 
@@ -26,6 +29,7 @@ namespace cec {
 namespace V1_0 {
 namespace implementation {
 
+using std::atomic;
 using std::shared_ptr;
 using std::thread;
 using std::vector;
@@ -55,8 +59,22 @@ class HdmiCecDefault : public IHdmiCec, public hidl_death_recipient {
     Return<Result> init();
     Return<void> release();
 
+    // Starts handling the given opened ports. Called by init(), and by tests with fake ports.
+    Return<Result> initPorts(vector<shared_ptr<HdmiCecPort>> hdmiCecPorts);
+
+    // The number of times the event loop woke up, and the number of messages and events it read.
+    uint64_t getWakeupCount() const { return mWakeupCount; }
+    uint64_t getReceivedCount() const { return mReceivedCount; }
+
   private:
-    void event_thread(HdmiCecPort* hdmiCecPort);
+    // A message or a hotplug event read from a port. Both are kept in a single list, so that they
+    // are delivered in the order they were read.
+    using CecEvent = std::variant<CecMessage, HotplugEvent>;
+
+    void eventLoop();
+    // Reads what is ready on the port according to the epoll events, without blocking.
+    void readPort(HdmiCecPort* hdmiCecPort, uint32_t events, vector<CecEvent>* cecEvents);
+    bool shouldDeliver(const cec_msg& message);
     static int getOpcode(cec_msg message);
     static int getFirstParam(cec_msg message);
     static bool isWakeupMessage(cec_msg message);
@@ -64,8 +82,14 @@ class HdmiCecDefault : public IHdmiCec, public hidl_death_recipient {
     static bool isPowerUICommand(cec_msg message);
     static Return<SendMessageResult> getSendMessageResult(int tx_status);
 
-    vector<thread> mEventThreads;
+    // A single thread waits on all the ports, so that messages arriving on several ports at once
+    // or in bursts are read and delivered in one wakeup.
+    thread mEventThread;
+    int mEpollFd = -1;
+    int mExitFd = -1;
     vector<shared_ptr<HdmiCecPort>> mHdmiCecPorts;
+    atomic<uint64_t> mWakeupCount = 0;
+    atomic<uint64_t> mReceivedCount = 0;
 
     // When set to false, all the CEC commands are discarded. True by default after initialization.
     bool mCecEnabled;
@@ -19,7 +19,6 @@
 #include <errno.h>
 #include <linux/cec.h>
 #include <linux/ioctl.h>
-#include <sys/eventfd.h>
 #include <algorithm>
 
 #include "HdmiCecPort.h"
@@ -34,7 +33,6 @@ namespace implementation {
 HdmiCecPort::HdmiCecPort(unsigned int portId) {
     mPortId = portId;
     mCecFd = -1;
-    mExitFd = -1;
 }
 
 HdmiCecPort::~HdmiCecPort() {
@@ -48,13 +46,6 @@ Return<Result> HdmiCecPort::init(const char* path) {
         LOG(ERROR) << "Failed to open " << path << ", Error = " << strerror(errno);
         return Result::FAILURE_NOT_SUPPORTED;
     }
-    mExitFd = eventfd(0, EFD_NONBLOCK);
-    if (mExitFd < 0) {
-        LOG(ERROR) << "Failed to open eventfd, Error = " << strerror(errno);
-        release();
-        return Result::FAILURE_NOT_SUPPORTED;
-    }
-
     // Ensure the CEC device supports required capabilities
     struct cec_caps caps = {};
     int ret = ioctl(mCecFd, CEC_ADAP_G_CAPS, &caps);
@@ -81,18 +72,29 @@ Return<Result> HdmiCecPort::init(const char* path) {
 }
 
 Return<void> HdmiCecPort::release() {
-    if (mExitFd > 0) {
-        uint64_t tmp = 1;
-        write(mExitFd, &tmp, sizeof(tmp));
-    }
-    if (mExitFd > 0) {
-        close(mExitFd);
-    }
     if (mCecFd > 0) {
         close(mCecFd);
+        mCecFd = -1;
     }
     return Void();
 }
+
+bool HdmiCecPort::receiveMessage(cec_msg* msg) {
+    *msg = {};
+    if (ioctl(mCecFd, CEC_RECEIVE, msg)) {
+        LOG(ERROR) << "CEC_RECEIVE failed, Error = " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool HdmiCecPort::dequeueEvent(cec_event* event) {
+    if (ioctl(mCecFd, CEC_DQEVENT, event)) {
+        LOG(ERROR) << "CEC_DQEVENT failed, Error = " << strerror(errno);
+        return false;
+    }
+    return true;
+}
 }  // namespace implementation
 }  // namespace V1_0
 }  // namespace cec
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include <android/hardware/tv/cec/1.0/IHdmiCec.h>
+#include <linux/cec.h>
 
 namespace android {
 namespace hardware {
@@ -25,13 +26,17 @@ namespace implementation {
 class HdmiCecPort {
   public:
     HdmiCecPort(unsigned int portId);
-    ~HdmiCecPort();
+    virtual ~HdmiCecPort();
     Return<Result> init(const char* path);
     Return<void> release();
 
+    // Reads one received message, only call it when mCecFd is readable as it blocks otherwise.
+    virtual bool receiveMessage(cec_msg* msg);
+    // Dequeues one pending event, only call it when mCecFd has priority data.
+    virtual bool dequeueEvent(cec_event* event);
+
     unsigned int mPortId;
     int mCecFd;
-    int mExitFd;
 };
 
 }  // namespace implementation
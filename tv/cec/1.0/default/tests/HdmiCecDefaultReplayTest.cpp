@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "HdmiCecDefaultReplayTest"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <android-base/logging.h>
+#include <gtest/gtest.h>
+
+#include "HdmiCecDefault.h"
+
+using android::sp;
+using android::hardware::Return;
+using android::hardware::Void;
+using android::hardware::tv::cec::V1_0::CecMessage;
+using android::hardware::tv::cec::V1_0::HotplugEvent;
+using android::hardware::tv::cec::V1_0::IHdmiCecCallback;
+using android::hardware::tv::cec::V1_0::OptionKey;
+using android::hardware::tv::cec::V1_0::Result;
+using android::hardware::tv::cec::V1_0::implementation::HdmiCecDefault;
+using android::hardware::tv::cec::V1_0::implementation::HdmiCecPort;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Traffic recorded on a TV with a playback device on port 1 and an audio system on port 2,
+// from the devices being powered on until the user changes the volume. Each message is in
+// the format of the input FIFO of HdmiCecMock: the header block then the opcode and operands.
+const vector<vector<uint8_t>> kPlaybackDeviceTraffic = {
+        {0x4f, 0x84, 0x10, 0x00, 0x04},              // <Report Physical Address> 1.0.0.0
+        {0x4f, 0x87, 0x00, 0x10, 0xfa},              // <Device Vendor ID>
+        {0x40, 0x04},                                // <Image View On>
+        {0x4f, 0x82, 0x10, 0x00},                    // <Active Source> 1.0.0.0
+        {0x40, 0x47, 0x50, 0x6c, 0x61, 0x79, 0x65, 0x72},  // <Set OSD Name> "Player"
+        {0x40, 0x9e, 0x05},                          // <CEC Version> 1.4
+        {0x40, 0x90, 0x00},                          // <Report Power Status> on
+        {0x40, 0x8f},                                // <Give Device Power Status>
+        {0x40, 0x44, 0x09},                          // <User Control Pressed> root menu
+        {0x40, 0x45},                                // <User Control Released>
+        {0x40, 0x44, 0x01},                          // <User Control Pressed> up
+        {0x40, 0x45},                                // <User Control Released>
+};
+const vector<vector<uint8_t>> kAudioSystemTraffic = {
+        {0x5f, 0x84, 0x20, 0x00, 0x05},  // <Report Physical Address> 2.0.0.0
+        {0x5f, 0x87, 0x00, 0x80, 0x45},  // <Device Vendor ID>
+        {0x50, 0x47, 0x41, 0x56, 0x52},  // <Set OSD Name> "AVR"
+        {0x50, 0x70, 0x20, 0x00},        // <System Audio Mode Request> 2.0.0.0
+        {0x5f, 0x72, 0x01},              // <Set System Audio Mode> on
+        {0x50, 0x7a, 0x20},              // <Report Audio Status> 32
+        {0x50, 0x7a, 0x21},              // <Report Audio Status> 33
+        {0x50, 0x7a, 0x22},              // <Report Audio Status> 34
+        {0x50, 0x7a, 0x23},              // <Report Audio Status> 35
+};
+
+// Describes a message, including its header block, or a hotplug event. Used to compare the order
+// in which they were read with the order in which they were delivered.
+string describeMessage(const uint8_t* data, size_t length) {
+    string description = "message";
+    for (size_t i = 0; i < length; i++) {
+        char byte[4];
+        snprintf(byte, sizeof(byte), " %02x", data[i]);
+        description += byte;
+    }
+    return description;
+}
+
+string describeHotplug(unsigned int portId, bool connected) {
+    return "hotplug " + std::to_string(portId) + (connected ? " connected" : " disconnected");
+}
+
+// The messages and events in the order they were read by the ports.
+class ReadLog {
+  public:
+    void add(string entry) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mEntries.push_back(std::move(entry));
+    }
+
+    vector<string> get() {
+        std::lock_guard<std::mutex> lock(mLock);
+        return mEntries;
+    }
+
+  private:
+    std::mutex mLock;
+    vector<string> mEntries;
+};
+
+// A port which reads the messages from a loopback TCP connection instead of a CEC adapter, each
+// message is preceded by its length. Hotplug events are sent as urgent data, which epoll reports
+// as EPOLLPRI, like the CEC framework does for pending events.
+class HdmiCecPortFake : public HdmiCecPort {
+  public:
+    HdmiCecPortFake(unsigned int portId, ReadLog* readLog)
+        : HdmiCecPort(portId), mReadLog(readLog) {
+        int listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address = {.sin_family = AF_INET,
+                               .sin_addr = {.s_addr = htonl(INADDR_LOOPBACK)}};
+        socklen_t addressLength = sizeof(address);
+        if (listenFd < 0 ||
+            bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listenFd, 1) != 0 ||
+            getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0) {
+            PLOG(ERROR) << "Failed to listen on a loopback port";
+        } else {
+            mWriteFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            int noDelay = 1;
+            setsockopt(mWriteFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            if (connect(mWriteFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+                mCecFd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            } else {
+                PLOG(ERROR) << "Failed to connect to the loopback port";
+            }
+        }
+        if (listenFd >= 0) {
+            close(listenFd);
+        }
+    }
+
+    ~HdmiCecPortFake() {
+        if (mWriteFd >= 0) {
+            close(mWriteFd);
+        }
+    }
+
+    // Queues all the messages with a single write, as if they had arrived while the HAL was busy.
+    bool replay(const vector<vector<uint8_t>>& messages) {
+        vector<uint8_t> data;
+        for (const auto& message : messages) {
+            data.push_back(message.size());
+            data.insert(data.end(), message.begin(), message.end());
+        }
+        return write(mWriteFd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    }
+
+    // Queues a hotplug event. Only one event can be pending at a time.
+    bool replayHotplug(bool connected) {
+        uint8_t data = connected;
+        return send(mWriteFd, &data, sizeof(data), MSG_OOB) == sizeof(data);
+    }
+
+    bool receiveMessage(cec_msg* msg) override {
+        *msg = {};
+        uint8_t length;
+        if (read(mCecFd, &length, sizeof(length)) != sizeof(length) || length == 0 ||
+            length > CEC_MAX_MSG_SIZE || read(mCecFd, msg->msg, length) != length) {
+            return false;
+        }
+        msg->len = length;
+        msg->rx_status = CEC_RX_STATUS_OK;
+        mReadLog->add(describeMessage(msg->msg, msg->len));
+        return true;
+    }
+
+    bool dequeueEvent(cec_event* event) override {
+        uint8_t connected;
+        if (recv(mCecFd, &connected, sizeof(connected), MSG_OOB) != sizeof(connected)) {
+            return false;
+        }
+        *event = {};
+        event->event = CEC_EVENT_STATE_CHANGE;
+        event->state_change.phys_addr = connected ? mPortId << 12 : CEC_PHYS_ADDR_INVALID;
+        mReadLog->add(describeHotplug(mPortId, connected));
+        return true;
+    }
+
+  private:
+    ReadLog* mReadLog;
+    int mWriteFd = -1;
+};
+
+class RecordingCallback : public IHdmiCecCallback {
+  public:
+    Return<void> onCecMessage(const CecMessage& message) override {
+        vector<uint8_t> data = {static_cast<uint8_t>(static_cast<uint8_t>(message.initiator) << 4 |
+                                                     static_cast<uint8_t>(message.destination))};
+        data.insert(data.end(), message.body.begin(), message.body.end());
+        std::unique_lock<std::mutex> lock(mLock);
+        mMessages.push_back(message);
+        record(describeMessage(data.data(), data.size()), lock);
+        return Void();
+    }
+
+    Return<void> onHotplugEvent(const HotplugEvent& event) override {
+        std::unique_lock<std::mutex> lock(mLock);
+        record(describeHotplug(event.portId, event.connected), lock);
+        return Void();
+    }
+
+    vector<CecMessage> waitForMessages(size_t count) {
+        std::unique_lock<std::mutex> lock(mLock);
+        mCondition.wait_for(lock, 5s, [&] { return mMessages.size() >= count; });
+        return mMessages;
+    }
+
+    // Returns the delivered messages and events, in the order they were delivered.
+    vector<string> waitForDeliveries(size_t count) {
+        std::unique_lock<std::mutex> lock(mLock);
+        mCondition.wait_for(lock, 5s, [&] { return mDeliveries.size() >= count; });
+        return mDeliveries;
+    }
+
+    // While held, the event loop is blocked in the callback after each delivery.
+    void setHeld(bool held) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mHeld = held;
+        mCondition.notify_all();
+    }
+
+  private:
+    void record(string delivery, std::unique_lock<std::mutex>& lock) {
+        mDeliveries.push_back(std::move(delivery));
+        mCondition.notify_all();
+        mCondition.wait(lock, [&] { return !mHeld; });
+    }
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    vector<CecMessage> mMessages;
+    vector<string> mDeliveries;
+    bool mHeld = false;
+};
+
+// Returns the bodies of the delivered messages sent by the given logical address.
+vector<vector<uint8_t>> bodiesFrom(const vector<CecMessage>& messages, uint8_t initiator) {
+    vector<vector<uint8_t>> bodies;
+    for (const auto& message : messages) {
+        if (static_cast<uint8_t>(message.initiator) == initiator) {
+            bodies.emplace_back(message.body.begin(), message.body.end());
+        }
+    }
+    return bodies;
+}
+
+// Returns the bodies of the recorded messages, i.e. without their header block.
+vector<vector<uint8_t>> bodiesOf(const vector<vector<uint8_t>>& traffic) {
+    vector<vector<uint8_t>> bodies;
+    for (const auto& message : traffic) {
+        bodies.emplace_back(message.begin() + 1, message.end());
+    }
+    return bodies;
+}
+
+}  // namespace
+
+class HdmiCecDefaultReplayTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        mPlaybackDevicePort = std::make_shared<HdmiCecPortFake>(1, &mReadLog);
+        mAudioSystemPort = std::make_shared<HdmiCecPortFake>(2, &mReadLog);
+        ASSERT_GE(mPlaybackDevicePort->mCecFd, 0);
+        ASSERT_GE(mAudioSystemPort->mCecFd, 0);
+        mHdmiCec = new HdmiCecDefault();
+        mCallback = new RecordingCallback();
+        mHdmiCec->setCallback(mCallback);
+        ASSERT_EQ(Result::SUCCESS,
+                  mHdmiCec->initPorts({mPlaybackDevicePort, mAudioSystemPort}).withDefault(
+                          Result::FAILURE_UNKNOWN));
+    }
+
+    void TearDown() override { mHdmiCec->release(); }
+
+    void waitForReceived(uint64_t count) {
+        for (int i = 0; i < 500 && mHdmiCec->getReceivedCount() < count; i++) {
+            std::this_thread::sleep_for(10ms);
+        }
+        ASSERT_EQ(count, mHdmiCec->getReceivedCount());
+    }
+
+    ReadLog mReadLog;
+    shared_ptr<HdmiCecPortFake> mPlaybackDevicePort;
+    shared_ptr<HdmiCecPortFake> mAudioSystemPort;
+    sp<HdmiCecDefault> mHdmiCec;
+    sp<RecordingCallback> mCallback;
+};
+
+TEST_F(HdmiCecDefaultReplayTest, DeliversBurstsInFewWakeups) {
+    ASSERT_TRUE(mPlaybackDevicePort->replay(kPlaybackDeviceTraffic));
+    ASSERT_TRUE(mAudioSystemPort->replay(kAudioSystemTraffic));
+
+    const size_t total = kPlaybackDeviceTraffic.size() + kAudioSystemTraffic.size();
+    vector<CecMessage> messages = mCallback->waitForMessages(total);
+    ASSERT_EQ(total, messages.size());
+    // The order of the messages of each port is kept, the ports may be interleaved.
+    EXPECT_EQ(bodiesOf(kPlaybackDeviceTraffic), bodiesFrom(messages, 4));
+    EXPECT_EQ(bodiesOf(kAudioSystemTraffic), bodiesFrom(messages, 5));
+
+    const uint64_t wakeups = mHdmiCec->getWakeupCount();
+    ASSERT_GT(wakeups, 0u);
+    const double messagesPerWakeup = static_cast<double>(total) / wakeups;
+    LOG(INFO) << "Processed " << total << " messages in " << wakeups << " wakeups, "
+              << messagesPerWakeup << " messages per wakeup";
+    RecordProperty("messages_per_wakeup", std::to_string(messagesPerWakeup));
+    // Each port was written at once, so it is drained in a single wakeup.
+    EXPECT_LE(wakeups, 2u);
+}
+
+TEST_F(HdmiCecDefaultReplayTest, DeliversMessagesAndHotplugEventsInReadOrder) {
+    // Block the event loop in the first delivery, so that the rest is read in one batch.
+    mCallback->setHeld(true);
+    ASSERT_TRUE(mPlaybackDevicePort->replay({kPlaybackDeviceTraffic[0]}));
+    ASSERT_EQ(1u, mCallback->waitForDeliveries(1).size());
+
+    ASSERT_TRUE(mPlaybackDevicePort->replay(
+            {kPlaybackDeviceTraffic.begin() + 1, kPlaybackDeviceTraffic.end()}));
+    ASSERT_TRUE(mAudioSystemPort->replayHotplug(/* connected= */ true));
+    ASSERT_TRUE(mAudioSystemPort->replay(kAudioSystemTraffic));
+    ASSERT_TRUE(mPlaybackDevicePort->replayHotplug(/* connected= */ false));
+    mCallback->setHeld(false);
+
+    const size_t total = kPlaybackDeviceTraffic.size() + kAudioSystemTraffic.size() + 2;
+    vector<string> deliveries = mCallback->waitForDeliveries(total);
+    ASSERT_EQ(total, deliveries.size());
+    EXPECT_EQ(mReadLog.get(), deliveries);
+}
+
+TEST_F(HdmiCecDefaultReplayTest, FiltersMessagesInStandby) {
+    mHdmiCec->setOption(OptionKey::SYSTEM_CEC_CONTROL, false);
+    ASSERT_TRUE(mPlaybackDevicePort->replay(kPlaybackDeviceTraffic));
+    waitForReceived(kPlaybackDeviceTraffic.size());
+    // Joins the event loop, so that the last batch has been delivered.
+    mHdmiCec->release();
+
+    const vector<vector<uint8_t>> expected = {
+            {0x84, 0x10, 0x00, 0x04},              // <Report Physical Address>
+            {0x87, 0x00, 0x10, 0xfa},              // <Device Vendor ID>
+            {0x04},                                // <Image View On>
+            {0x47, 0x50, 0x6c, 0x61, 0x79, 0x65, 0x72},  // <Set OSD Name>
+            {0x90, 0x00},                          // <Report Power Status>
+            {0x8f},                                // <Give Device Power Status>
+            {0x44, 0x09},                          // <User Control Pressed> root menu
+    };
+    EXPECT_EQ(expected, bodiesFrom(mCallback->waitForMessages(0), 4));
+}
+
+TEST_F(HdmiCecDefaultReplayTest, ReleaseStopsEventLoop) {
+    mHdmiCec->release();
+    EXPECT_TRUE(mPlaybackDevicePort->replay(kPlaybackDeviceTraffic));
+    EXPECT_EQ(0u, mHdmiCec->getReceivedCount());
+    EXPECT_TRUE(mCallback->waitForMessages(0).empty());
+}
@@ -65,10 +65,12 @@ class AidlCallbackHandler {
         return true;
     }
 
-    const std::set<std::shared_ptr<CallbackType>>& getCallbacks() {
+    // Returns a copy, since callbacks are invoked from the legacy HAL event
+    // loop thread while the set may be modified on the AIDL thread.
+    std::set<std::shared_ptr<CallbackType>> getCallbacks() {
         std::unique_lock<std::mutex> lk(callback_handler_lock_);
-        // unique_lock unlocked here
         return cb_set_;
+        // unique_lock unlocked here
     }
 
     void invalidate() {
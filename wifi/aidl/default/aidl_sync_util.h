@@ -17,6 +17,8 @@
 #ifndef AIDL_SYNC_UTIL_H_
 #define AIDL_SYNC_UTIL_H_
 
+#include <functional>
+#include <memory>
 #include <mutex>
 
 // Utility that provides a global lock to synchronize access between
@@ -27,6 +29,51 @@ namespace hardware {
 namespace wifi {
 namespace aidl_sync_util {
 std::unique_lock<std::recursive_mutex> acquireGlobalLock();
+
+// Holds a callback that is set and reset from the AIDL thread and invoked
+// from the legacy HAL event loop thread without holding the global lock.
+// The callback is published as an immutable std::function behind an atomically
+// swapped shared_ptr, so the event loop thread never waits for an AIDL call to
+// finish, and a callback which resets its own slot stays alive until it
+// returns.
+template <typename Signature>
+class CallbackSlot {
+  public:
+    using Function = std::function<Signature>;
+    using Snapshot = std::shared_ptr<const Function>;
+
+    CallbackSlot() = default;
+    CallbackSlot(const CallbackSlot&) = delete;
+    CallbackSlot& operator=(const CallbackSlot&) = delete;
+
+    CallbackSlot& operator=(Function callback) {
+        std::atomic_store(&callback_,
+                          callback ? std::make_shared<const Function>(std::move(callback))
+                                   : Snapshot());
+        return *this;
+    }
+
+    CallbackSlot& operator=(std::nullptr_t) {
+        std::atomic_store(&callback_, Snapshot());
+        return *this;
+    }
+
+    explicit operator bool() const { return load() != nullptr; }
+
+    // Returns the current callback, which remains valid even if the slot is
+    // reset while it is being invoked.
+    Snapshot load() const { return std::atomic_load(&callback_); }
+
+    // Resets the slot only if it still holds |expected|, so that a one shot
+    // callback does not drop the callback of a request started while it ran.
+    void resetIf(const Snapshot& expected) {
+        Snapshot current = expected;
+        std::atomic_compare_exchange_strong(&callback_, &current, Snapshot());
+    }
+
+  private:
+    Snapshot callback_;
+};
 }  // namespace aidl_sync_util
 }  // namespace wifi
 }  // namespace hardware
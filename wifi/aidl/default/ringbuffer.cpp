@@ -16,14 +16,18 @@
 
 #include "ringbuffer.h"
 
+#include <algorithm>
 #include <android-base/logging.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 namespace aidl {
 namespace android {
 namespace hardware {
 namespace wifi {
 
-Ringbuffer::Ringbuffer(size_t maxSize) : size_(0), maxSize_(maxSize) {}
+Ringbuffer::Ringbuffer(size_t maxSize) : head_(0), size_(0), maxSize_(maxSize) {}
 
 enum Ringbuffer::AppendStatus Ringbuffer::append(const std::vector<uint8_t>& input) {
     if (input.size() == 0) {
@@ -33,29 +37,93 @@ enum Ringbuffer::AppendStatus Ringbuffer::append(const std::vector<uint8_t>& inp
         LOG(INFO) << "Oversized message of " << input.size() << " bytes is dropped";
         return AppendStatus::FAIL_IP_BUFFER_EXCEEDED_MAXSIZE;
     }
-    data_.push_back(input);
-    size_ += input.size() * sizeof(input[0]);
-    while (size_ > maxSize_) {
-        if (data_.front().size() <= 0 || data_.front().size() > maxSize_) {
+    while (size_ + input.size() > maxSize_) {
+        if (recordSizes_.empty() || recordSizes_.front() == 0 ||
+            recordSizes_.front() > size_) {
             LOG(ERROR) << "First buffer in the ring buffer is Invalid. Size: "
-                       << data_.front().size();
+                       << (recordSizes_.empty() ? 0 : recordSizes_.front());
             return AppendStatus::FAIL_RING_BUFFER_CORRUPTED;
         }
-        size_ -= data_.front().size() * sizeof(data_.front()[0]);
-        data_.pop_front();
+        head_ = (head_ + recordSizes_.front()) % maxSize_;
+        size_ -= recordSizes_.front();
+        recordSizes_.pop_front();
     }
+    if (!data_) {
+        data_.reset(new uint8_t[maxSize_]);
+    }
+    copyIn((head_ + size_) % maxSize_, input.data(), input.size());
+    recordSizes_.push_back(input.size());
+    size_ += input.size();
     return AppendStatus::SUCCESS;
 }
 
-const std::list<std::vector<uint8_t>>& Ringbuffer::getData() const {
-    return data_;
+std::vector<std::vector<uint8_t>> Ringbuffer::getData() const {
+    std::vector<std::vector<uint8_t>> records;
+    records.reserve(recordSizes_.size());
+    size_t offset = head_;
+    for (size_t record_size : recordSizes_) {
+        auto& record = records.emplace_back(record_size);
+        copyOut(offset, record.data(), record_size);
+        offset = (offset + record_size) % maxSize_;
+    }
+    return records;
+}
+
+bool Ringbuffer::empty() const {
+    return size_ == 0;
+}
+
+bool Ringbuffer::writeToFd(int fd) const {
+    if (size_ == 0) {
+        return true;
+    }
+    // The ring holds the records back to back, so it is written as at most
+    // two chunks: up to the end of |data_|, then from its start.
+    const size_t first_size = std::min(size_, maxSize_ - head_);
+    struct iovec iov[2] = {
+            {data_.get() + head_, first_size},
+            {data_.get(), size_ - first_size},
+    };
+    struct iovec* cur_iov = iov;
+    int iov_count = iov[1].iov_len > 0 ? 2 : 1;
+    while (iov_count > 0) {
+        ssize_t written = TEMP_FAILURE_RETRY(writev(fd, cur_iov, iov_count));
+        if (written < 0) {
+            return false;
+        }
+        // Skip what was written, in case of a short write
+        while (iov_count > 0 && static_cast<size_t>(written) >= cur_iov->iov_len) {
+            written -= cur_iov->iov_len;
+            cur_iov++;
+            iov_count--;
+        }
+        if (iov_count > 0) {
+            cur_iov->iov_base = static_cast<uint8_t*>(cur_iov->iov_base) + written;
+            cur_iov->iov_len -= written;
+        }
+    }
+    return true;
 }
 
 void Ringbuffer::clear() {
-    data_.clear();
+    data_.reset();
+    recordSizes_.clear();
+    head_ = 0;
     size_ = 0;
 }
 
+void Ringbuffer::copyIn(size_t offset, const uint8_t* src, size_t size) {
+    const size_t first_size = std::min(size, maxSize_ - offset);
+    memcpy(data_.get() + offset, src, first_size);
+    memcpy(data_.get(), src + first_size, size - first_size);
+}
+
+void Ringbuffer::copyOut(size_t offset, uint8_t* dst, size_t size) const {
+    const size_t first_size = std::min(size, maxSize_ - offset);
+    memcpy(dst, data_.get() + offset, first_size);
+    memcpy(dst + first_size, data_.get(), size - first_size);
+}
+
 }  // namespace wifi
 }  // namespace hardware
 }  // namespace android
@@ -17,7 +17,8 @@
 #ifndef RINGBUFFER_H_
 #define RINGBUFFER_H_
 
-#include <list>
+#include <deque>
+#include <memory>
 #include <vector>
 
 namespace aidl {
@@ -27,6 +28,12 @@ namespace wifi {
 
 /**
  * Ringbuffer object used to store debug data.
+ *
+ * The records are stored back to back in one contiguous byte ring of
+ * |maxSize_| bytes, and their sizes in a separate queue. Dropping the oldest
+ * record is O(1), and the ring can be written to a file with a single writev.
+ * The ring is allocated uninitialized on the first append, so that only the
+ * pages written so far are committed, and freed by clear().
  */
 class Ringbuffer {
   public:
@@ -43,11 +50,23 @@ class Ringbuffer {
     // Appends the data buffer and deletes from the front until buffer is
     // within |maxSize_|.
     enum AppendStatus append(const std::vector<uint8_t>& input);
-    const std::list<std::vector<uint8_t>>& getData() const;
+    // Returns a copy of the records, oldest first.
+    std::vector<std::vector<uint8_t>> getData() const;
+    bool empty() const;
+    // Writes the records, oldest first, to |fd|. Returns false on a write
+    // error.
+    bool writeToFd(int fd) const;
     void clear();
 
   private:
-    std::list<std::vector<uint8_t>> data_;
+    // Copies |size| bytes starting at |offset| into the ring, wrapping around.
+    void copyIn(size_t offset, const uint8_t* src, size_t size);
+    void copyOut(size_t offset, uint8_t* dst, size_t size) const;
+
+    std::unique_ptr<uint8_t[]> data_;
+    std::deque<size_t> recordSizes_;
+    // offset of the oldest byte in |data_|
+    size_t head_;
     size_t size_;
     size_t maxSize_;
 };
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <thread>
+
+#include "aidl_sync_util.h"
+
+using testing::Test;
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace wifi {
+namespace aidl_sync_util {
+
+class CallbackSlotTest : public Test {
+  public:
+    CallbackSlot<void(int)> slot_;
+};
+
+TEST_F(CallbackSlotTest, EmptyByDefault) {
+    EXPECT_FALSE(slot_);
+    EXPECT_EQ(nullptr, slot_.load());
+}
+
+TEST_F(CallbackSlotTest, SetAndReset) {
+    int received = 0;
+    slot_ = [&received](int value) { received = value; };
+    ASSERT_TRUE(slot_);
+    (*slot_.load())(5);
+    EXPECT_EQ(5, received);
+
+    slot_ = nullptr;
+    EXPECT_FALSE(slot_);
+}
+
+TEST_F(CallbackSlotTest, EmptyFunctionResetsSlot) {
+    slot_ = [](int) {};
+    slot_ = std::function<void(int)>();
+    EXPECT_FALSE(slot_);
+}
+
+TEST_F(CallbackSlotTest, CallbackResettingItsSlotStaysAlive) {
+    auto token = std::make_shared<int>(7);
+    int received = 0;
+    slot_ = [this, token, &received](int) {
+        slot_ = nullptr;
+        // |token| is owned by the lambda, so this would be a use after free
+        // if resetting the slot destroyed the running callback.
+        received = *token;
+    };
+    const auto callback = slot_.load();
+    (*callback)(0);
+    EXPECT_EQ(7, received);
+    EXPECT_FALSE(slot_);
+}
+
+TEST_F(CallbackSlotTest, ResetIfKeepsNewerCallback) {
+    slot_ = [](int) {};
+    const auto first = slot_.load();
+    slot_.resetIf(first);
+    EXPECT_FALSE(slot_);
+
+    slot_ = [](int) {};
+    const auto second = slot_.load();
+    slot_ = [](int) {};
+    slot_.resetIf(second);
+    ASSERT_TRUE(slot_);
+    EXPECT_NE(second, slot_.load());
+}
+
+TEST_F(CallbackSlotTest, ConcurrentSetAndInvoke) {
+    std::atomic<int> calls = 0;
+    std::atomic<bool> done = false;
+    std::thread invoker([&] {
+        while (!done) {
+            if (const auto callback = slot_.load()) {
+                (*callback)(1);
+            }
+        }
+    });
+    for (int i = 0; i < 10000; i++) {
+        slot_ = [&calls](int value) { calls += value; };
+        slot_ = nullptr;
+    }
+    done = true;
+    invoker.join();
+    EXPECT_FALSE(slot_);
+    EXPECT_GE(calls, 0);
+}
+
+}  // namespace aidl_sync_util
+}  // namespace wifi
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include <android-base/file.h>
+#include <android-base/logging.h>
 #include <gmock/gmock.h>
 
+#include <chrono>
+
 #include "ringbuffer.h"
 
 using testing::Return;
@@ -90,6 +94,88 @@ TEST_F(RingbufferTest, OversizedAppendDoesNotDropExistingData) {
     EXPECT_EQ(input, buffer_.getData().front());
 }
 
+TEST_F(RingbufferTest, RecordsWrapAroundTheEndOfTheRing) {
+    const std::vector<uint8_t> input = {'0', '1', '2', '3'};
+    const std::vector<uint8_t> input2 = {'4', '5', '6', '7'};
+    const std::vector<uint8_t> input3 = {'8', '9', 'a', 'b'};
+    buffer_.append(input);
+    buffer_.append(input2);
+    // Drops |input|, and is split between the end and the start of the ring
+    buffer_.append(input3);
+    const auto data = buffer_.getData();
+    ASSERT_EQ(2u, data.size());
+    EXPECT_EQ(input2, data.front());
+    EXPECT_EQ(input3, data.back());
+}
+
+TEST_F(RingbufferTest, ClearEmptiesTheBuffer) {
+    buffer_.append({'0', '1', '2'});
+    ASSERT_FALSE(buffer_.empty());
+    buffer_.clear();
+    EXPECT_TRUE(buffer_.empty());
+    EXPECT_TRUE(buffer_.getData().empty());
+}
+
+TEST_F(RingbufferTest, CanAppendAfterClear) {
+    buffer_.append({'0', '1', '2'});
+    buffer_.clear();
+    const std::vector<uint8_t> input(maxBufferSize_, '3');
+    ASSERT_EQ(Ringbuffer::AppendStatus::SUCCESS, buffer_.append(input));
+    const auto data = buffer_.getData();
+    ASSERT_EQ(1u, data.size());
+    EXPECT_EQ(input, data.front());
+}
+
+TEST_F(RingbufferTest, WriteToFdWritesRecordsInOrder) {
+    buffer_.append({'0', '1', '2', '3'});
+    buffer_.append({'4', '5', '6', '7'});
+    buffer_.append({'8', '9', 'a', 'b'});
+
+    TemporaryFile file;
+    ASSERT_TRUE(buffer_.writeToFd(file.fd));
+    std::string contents;
+    ASSERT_TRUE(::android::base::ReadFileToString(file.path, &contents));
+    EXPECT_EQ("456789ab", contents);
+}
+
+// Appends small records the way verbose firmware logging does, then dumps
+// the ring, and reports the throughput of both.
+TEST(RingbufferThroughputTest, AppendAndDump) {
+    constexpr size_t kMaxSize = 1024 * 1024 * 3;
+    constexpr size_t kRecordSize = 128;
+    constexpr size_t kRecordCount = 100000;
+    Ringbuffer buffer(kMaxSize);
+    std::vector<uint8_t> record(kRecordSize);
+
+    const auto append_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kRecordCount; i++) {
+        record[0] = static_cast<uint8_t>(i);
+        ASSERT_EQ(Ringbuffer::AppendStatus::SUCCESS, buffer.append(record));
+    }
+    const auto append_end = std::chrono::steady_clock::now();
+
+    TemporaryFile file;
+    ASSERT_TRUE(buffer.writeToFd(file.fd));
+    const auto dump_end = std::chrono::steady_clock::now();
+
+    std::string contents;
+    ASSERT_TRUE(::android::base::ReadFileToString(file.path, &contents));
+    const size_t retained = kMaxSize / kRecordSize;
+    ASSERT_EQ(retained * kRecordSize, contents.size());
+    // The oldest retained record comes first
+    EXPECT_EQ(static_cast<uint8_t>(kRecordCount - retained), static_cast<uint8_t>(contents[0]));
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const auto append_us = duration_cast<microseconds>(append_end - append_start).count();
+    const auto dump_us = duration_cast<microseconds>(dump_end - append_end).count();
+    LOG(INFO) << "Appended " << kRecordCount << " records of " << kRecordSize << " bytes in "
+              << append_us << " us, dumped " << contents.size() << " bytes in " << dump_us
+              << " us";
+    RecordProperty("append_us", append_us);
+    RecordProperty("dump_us", dump_us);
+}
+
 }  // namespace wifi
 }  // namespace hardware
 }  // namespace android
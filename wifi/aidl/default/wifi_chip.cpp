@@ -1274,8 +1274,13 @@ ndk::ScopedAStatus WifiChip::startLoggingToDebugRingBufferInternal(
             getFirstActiveWlanIfaceName(), ring_name,
             static_cast<std::underlying_type<WifiDebugRingBufferVerboseLevel>::type>(verbose_level),
             max_interval_in_sec, min_data_size_in_bytes);
-    ringbuffer_map_.insert(
-            std::pair<std::string, Ringbuffer>(ring_name, Ringbuffer(kMaxBufferSizeBytes)));
+    {
+        // The ring buffer data callback appends to the map on the event loop
+        // thread.
+        std::unique_lock<std::mutex> lk(lock_t);
+        ringbuffer_map_.insert(
+                std::pair<std::string, Ringbuffer>(ring_name, Ringbuffer(kMaxBufferSizeBytes)));
+    }
     // if verbose logging enabled, turn up HAL daemon logging as well.
     if (verbose_level < WifiDebugRingBufferVerboseLevel::VERBOSE) {
         ::android::base::SetMinimumLogSeverity(::android::base::DEBUG);
@@ -1904,41 +1909,33 @@ std::string WifiChip::allocateStaIfaceName() {
 }
 
 bool WifiChip::writeRingbufferFilesInternal() {
+    // Also called from the ring buffer data callback on the event loop thread,
+    // so hold the lock while cleaning up the tombstone folder as well.
+    std::unique_lock<std::mutex> lk(lock_t);
     if (!removeOldFilesInternal()) {
         LOG(ERROR) << "Error occurred while deleting old tombstone files";
         return false;
     }
     // write ringbuffers to file
-    {
-        std::unique_lock<std::mutex> lk(lock_t);
-        for (auto& item : ringbuffer_map_) {
-            Ringbuffer& cur_buffer = item.second;
-            if (cur_buffer.getData().empty()) {
-                continue;
-            }
-            const std::string file_path_raw = kTombstoneFolderPath + item.first + "XXXXXXXXXX";
-            const int dump_fd = mkstemp(makeCharVec(file_path_raw).data());
-            if (dump_fd == -1) {
-                PLOG(ERROR) << "create file failed";
-                return false;
-            }
-            unique_fd file_auto_closer(dump_fd);
-            for (const auto& cur_block : cur_buffer.getData()) {
-                if (cur_block.size() <= 0 || cur_block.size() > kMaxBufferSizeBytes) {
-                    PLOG(ERROR) << "Ring buffer: " << item.first
-                                << " is corrupted. Invalid block size: " << cur_block.size();
-                    break;
-                }
-                if (write(dump_fd, cur_block.data(), sizeof(cur_block[0]) * cur_block.size()) ==
-                    -1) {
-                    PLOG(ERROR) << "Error writing to file";
-                }
-            }
-            cur_buffer.clear();
+    for (auto& item : ringbuffer_map_) {
+        Ringbuffer& cur_buffer = item.second;
+        if (cur_buffer.empty()) {
+            continue;
         }
-        // unique_lock unlocked here
+        const std::string file_path_raw = kTombstoneFolderPath + item.first + "XXXXXXXXXX";
+        const int dump_fd = mkstemp(makeCharVec(file_path_raw).data());
+        if (dump_fd == -1) {
+            PLOG(ERROR) << "create file failed";
+            return false;
+        }
+        unique_fd file_auto_closer(dump_fd);
+        if (!cur_buffer.writeToFd(dump_fd)) {
+            PLOG(ERROR) << "Error writing to file";
+        }
+        cur_buffer.clear();
     }
     return true;
+    // unique_lock unlocked here
 }
 
 std::string WifiChip::getWlanIfaceNameWithType(IfaceType type, unsigned idx) {
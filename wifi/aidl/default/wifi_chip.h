@@ -21,6 +21,7 @@
 #include <aidl/android/hardware/wifi/IWifiRttController.h>
 #include <android-base/macros.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <mutex>
@@ -275,7 +276,7 @@ class WifiChip : public BnWifiChip {
     std::vector<std::shared_ptr<WifiStaIface>> sta_ifaces_;
     std::vector<std::shared_ptr<WifiRttController>> rtt_controllers_;
     std::map<std::string, Ringbuffer> ringbuffer_map_;
-    bool is_valid_;
+    std::atomic<bool> is_valid_;
     // Members pertaining to chip configuration.
     int32_t current_mode_id_;
     std::mutex lock_t;
@@ -58,10 +58,19 @@ namespace hardware {
 namespace wifi {
 namespace legacy_hal {
 
+using aidl_sync_util::CallbackSlot;
+
 // Legacy HAL functions accept "C" style function pointers, so use global
 // functions to pass to the legacy HAL function and store the corresponding
 // std::function methods to be invoked.
 //
+// The asynchronous callbacks are invoked on the legacy HAL event loop thread
+// without the global lock, so they are held in CallbackSlots (see
+// THREADING.README). The synchronous ones are only set for the duration of the
+// legacy HAL call which invokes them, and the stop complete and subsystem
+// restart callbacks still acquire the global lock since they tear down state
+// owned by the AIDL thread.
+//
 // Callback to be invoked once |stop| is complete
 std::function<void(wifi_handle handle)> on_stop_complete_internal_callback;
 void onAsyncStopComplete(wifi_handle handle) {
@@ -90,22 +99,22 @@ void onSyncFirmwareMemoryDump(char* buffer, int buffer_size) {
 }
 
 // Callback to be invoked for Gscan events.
-std::function<void(wifi_request_id, wifi_scan_event)> on_gscan_event_internal_callback;
+CallbackSlot<void(wifi_request_id, wifi_scan_event)> on_gscan_event_internal_callback;
 void onAsyncGscanEvent(wifi_request_id id, wifi_scan_event event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_gscan_event_internal_callback) {
-        on_gscan_event_internal_callback(id, event);
+    const auto callback = on_gscan_event_internal_callback.load();
+    if (callback) {
+        (*callback)(id, event);
     }
 }
 
 // Callback to be invoked for Gscan full results.
-std::function<void(wifi_request_id, wifi_scan_result*, uint32_t)>
+CallbackSlot<void(wifi_request_id, wifi_scan_result*, uint32_t)>
         on_gscan_full_result_internal_callback;
 void onAsyncGscanFullResult(wifi_request_id id, wifi_scan_result* result,
                             uint32_t buckets_scanned) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_gscan_full_result_internal_callback) {
-        on_gscan_full_result_internal_callback(id, result, buckets_scanned);
+    const auto callback = on_gscan_full_result_internal_callback.load();
+    if (callback) {
+        (*callback)(id, result, buckets_scanned);
     }
 }
 
@@ -130,42 +139,42 @@ void onSyncLinkLayerMlStatsResult(wifi_request_id id, wifi_iface_ml_stat* iface_
 }
 
 // Callback to be invoked for rssi threshold breach.
-std::function<void((wifi_request_id, uint8_t*, int8_t))>
+CallbackSlot<void((wifi_request_id, uint8_t*, int8_t))>
         on_rssi_threshold_breached_internal_callback;
 void onAsyncRssiThresholdBreached(wifi_request_id id, uint8_t* bssid, int8_t rssi) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_rssi_threshold_breached_internal_callback) {
-        on_rssi_threshold_breached_internal_callback(id, bssid, rssi);
+    const auto callback = on_rssi_threshold_breached_internal_callback.load();
+    if (callback) {
+        (*callback)(id, bssid, rssi);
     }
 }
 
 // Callback to be invoked for ring buffer data indication.
-std::function<void(char*, char*, int, wifi_ring_buffer_status*)>
+CallbackSlot<void(char*, char*, int, wifi_ring_buffer_status*)>
         on_ring_buffer_data_internal_callback;
 void onAsyncRingBufferData(char* ring_name, char* buffer, int buffer_size,
                            wifi_ring_buffer_status* status) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_ring_buffer_data_internal_callback) {
-        on_ring_buffer_data_internal_callback(ring_name, buffer, buffer_size, status);
+    const auto callback = on_ring_buffer_data_internal_callback.load();
+    if (callback) {
+        (*callback)(ring_name, buffer, buffer_size, status);
     }
 }
 
 // Callback to be invoked for error alert indication.
-std::function<void(wifi_request_id, char*, int, int)> on_error_alert_internal_callback;
+CallbackSlot<void(wifi_request_id, char*, int, int)> on_error_alert_internal_callback;
 void onAsyncErrorAlert(wifi_request_id id, char* buffer, int buffer_size, int err_code) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_error_alert_internal_callback) {
-        on_error_alert_internal_callback(id, buffer, buffer_size, err_code);
+    const auto callback = on_error_alert_internal_callback.load();
+    if (callback) {
+        (*callback)(id, buffer, buffer_size, err_code);
     }
 }
 
 // Callback to be invoked for radio mode change indication.
-std::function<void(wifi_request_id, uint32_t, wifi_mac_info*)>
+CallbackSlot<void(wifi_request_id, uint32_t, wifi_mac_info*)>
         on_radio_mode_change_internal_callback;
 void onAsyncRadioModeChange(wifi_request_id id, uint32_t num_macs, wifi_mac_info* mac_infos) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_radio_mode_change_internal_callback) {
-        on_radio_mode_change_internal_callback(id, num_macs, mac_infos);
+    const auto callback = on_radio_mode_change_internal_callback.load();
+    if (callback) {
+        (*callback)(id, num_macs, mac_infos);
     }
 }
 
@@ -179,9 +188,9 @@ void onAsyncSubsystemRestart(const char* error) {
 }
 
 // Callback to be invoked for rtt results results.
-std::function<void(wifi_request_id, unsigned num_results, wifi_rtt_result* rtt_results[])>
+CallbackSlot<void(wifi_request_id, unsigned num_results, wifi_rtt_result* rtt_results[])>
         on_rtt_results_internal_callback;
-std::function<void(wifi_request_id, unsigned num_results, wifi_rtt_result_v2* rtt_results_v2[])>
+CallbackSlot<void(wifi_request_id, unsigned num_results, wifi_rtt_result_v2* rtt_results_v2[])>
         on_rtt_results_internal_callback_v2;
 
 void invalidateRttResultsCallbacks() {
@@ -189,20 +198,26 @@ void invalidateRttResultsCallbacks() {
     on_rtt_results_internal_callback_v2 = nullptr;
 };
 
+// Only invalidate the callbacks of the range request whose results were just
+// delivered, in case it was cancelled and a new one started in the meantime.
 void onAsyncRttResults(wifi_request_id id, unsigned num_results, wifi_rtt_result* rtt_results[]) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_rtt_results_internal_callback) {
-        on_rtt_results_internal_callback(id, num_results, rtt_results);
-        invalidateRttResultsCallbacks();
+    const auto callback = on_rtt_results_internal_callback.load();
+    const auto callback_v2 = on_rtt_results_internal_callback_v2.load();
+    if (callback) {
+        (*callback)(id, num_results, rtt_results);
+        on_rtt_results_internal_callback.resetIf(callback);
+        on_rtt_results_internal_callback_v2.resetIf(callback_v2);
     }
 }
 
 void onAsyncRttResultsV2(wifi_request_id id, unsigned num_results,
                          wifi_rtt_result_v2* rtt_results_v2[]) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_rtt_results_internal_callback_v2) {
-        on_rtt_results_internal_callback_v2(id, num_results, rtt_results_v2);
-        invalidateRttResultsCallbacks();
+    const auto callback = on_rtt_results_internal_callback.load();
+    const auto callback_v2 = on_rtt_results_internal_callback_v2.load();
+    if (callback_v2) {
+        (*callback_v2)(id, num_results, rtt_results_v2);
+        on_rtt_results_internal_callback.resetIf(callback);
+        on_rtt_results_internal_callback_v2.resetIf(callback_v2);
     }
 }
 
@@ -210,229 +225,229 @@ void onAsyncRttResultsV2(wifi_request_id id, unsigned num_results,
 // NOTE: These have very little conversions to perform before invoking the user
 // callbacks.
 // So, handle all of them here directly to avoid adding an unnecessary layer.
-std::function<void(transaction_id, const NanResponseMsg&)> on_nan_notify_response_user_callback;
+CallbackSlot<void(transaction_id, const NanResponseMsg&)> on_nan_notify_response_user_callback;
 void onAsyncNanNotifyResponse(transaction_id id, NanResponseMsg* msg) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_notify_response_user_callback && msg) {
-        on_nan_notify_response_user_callback(id, *msg);
+    const auto callback = on_nan_notify_response_user_callback.load();
+    if (callback && msg) {
+        (*callback)(id, *msg);
     }
 }
 
-std::function<void(const NanPublishRepliedInd&)> on_nan_event_publish_replied_user_callback;
+CallbackSlot<void(const NanPublishRepliedInd&)> on_nan_event_publish_replied_user_callback;
 void onAsyncNanEventPublishReplied(NanPublishRepliedInd* /* event */) {
     LOG(ERROR) << "onAsyncNanEventPublishReplied triggered";
 }
 
-std::function<void(const NanPublishTerminatedInd&)> on_nan_event_publish_terminated_user_callback;
+CallbackSlot<void(const NanPublishTerminatedInd&)> on_nan_event_publish_terminated_user_callback;
 void onAsyncNanEventPublishTerminated(NanPublishTerminatedInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_publish_terminated_user_callback && event) {
-        on_nan_event_publish_terminated_user_callback(*event);
+    const auto callback = on_nan_event_publish_terminated_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanMatchInd&)> on_nan_event_match_user_callback;
+CallbackSlot<void(const NanMatchInd&)> on_nan_event_match_user_callback;
 void onAsyncNanEventMatch(NanMatchInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_match_user_callback && event) {
-        on_nan_event_match_user_callback(*event);
+    const auto callback = on_nan_event_match_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanMatchExpiredInd&)> on_nan_event_match_expired_user_callback;
+CallbackSlot<void(const NanMatchExpiredInd&)> on_nan_event_match_expired_user_callback;
 void onAsyncNanEventMatchExpired(NanMatchExpiredInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_match_expired_user_callback && event) {
-        on_nan_event_match_expired_user_callback(*event);
+    const auto callback = on_nan_event_match_expired_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanSubscribeTerminatedInd&)>
+CallbackSlot<void(const NanSubscribeTerminatedInd&)>
         on_nan_event_subscribe_terminated_user_callback;
 void onAsyncNanEventSubscribeTerminated(NanSubscribeTerminatedInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_subscribe_terminated_user_callback && event) {
-        on_nan_event_subscribe_terminated_user_callback(*event);
+    const auto callback = on_nan_event_subscribe_terminated_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanFollowupInd&)> on_nan_event_followup_user_callback;
+CallbackSlot<void(const NanFollowupInd&)> on_nan_event_followup_user_callback;
 void onAsyncNanEventFollowup(NanFollowupInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_followup_user_callback && event) {
-        on_nan_event_followup_user_callback(*event);
+    const auto callback = on_nan_event_followup_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanDiscEngEventInd&)> on_nan_event_disc_eng_event_user_callback;
+CallbackSlot<void(const NanDiscEngEventInd&)> on_nan_event_disc_eng_event_user_callback;
 void onAsyncNanEventDiscEngEvent(NanDiscEngEventInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_disc_eng_event_user_callback && event) {
-        on_nan_event_disc_eng_event_user_callback(*event);
+    const auto callback = on_nan_event_disc_eng_event_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanDisabledInd&)> on_nan_event_disabled_user_callback;
+CallbackSlot<void(const NanDisabledInd&)> on_nan_event_disabled_user_callback;
 void onAsyncNanEventDisabled(NanDisabledInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_disabled_user_callback && event) {
-        on_nan_event_disabled_user_callback(*event);
+    const auto callback = on_nan_event_disabled_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanTCAInd&)> on_nan_event_tca_user_callback;
+CallbackSlot<void(const NanTCAInd&)> on_nan_event_tca_user_callback;
 void onAsyncNanEventTca(NanTCAInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_tca_user_callback && event) {
-        on_nan_event_tca_user_callback(*event);
+    const auto callback = on_nan_event_tca_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanBeaconSdfPayloadInd&)> on_nan_event_beacon_sdf_payload_user_callback;
+CallbackSlot<void(const NanBeaconSdfPayloadInd&)> on_nan_event_beacon_sdf_payload_user_callback;
 void onAsyncNanEventBeaconSdfPayload(NanBeaconSdfPayloadInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_beacon_sdf_payload_user_callback && event) {
-        on_nan_event_beacon_sdf_payload_user_callback(*event);
+    const auto callback = on_nan_event_beacon_sdf_payload_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanDataPathRequestInd&)> on_nan_event_data_path_request_user_callback;
+CallbackSlot<void(const NanDataPathRequestInd&)> on_nan_event_data_path_request_user_callback;
 void onAsyncNanEventDataPathRequest(NanDataPathRequestInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_data_path_request_user_callback && event) {
-        on_nan_event_data_path_request_user_callback(*event);
+    const auto callback = on_nan_event_data_path_request_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
-std::function<void(const NanDataPathConfirmInd&)> on_nan_event_data_path_confirm_user_callback;
+CallbackSlot<void(const NanDataPathConfirmInd&)> on_nan_event_data_path_confirm_user_callback;
 void onAsyncNanEventDataPathConfirm(NanDataPathConfirmInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_data_path_confirm_user_callback && event) {
-        on_nan_event_data_path_confirm_user_callback(*event);
+    const auto callback = on_nan_event_data_path_confirm_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanDataPathEndInd&)> on_nan_event_data_path_end_user_callback;
+CallbackSlot<void(const NanDataPathEndInd&)> on_nan_event_data_path_end_user_callback;
 void onAsyncNanEventDataPathEnd(NanDataPathEndInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_data_path_end_user_callback && event) {
-        on_nan_event_data_path_end_user_callback(*event);
+    const auto callback = on_nan_event_data_path_end_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanTransmitFollowupInd&)> on_nan_event_transmit_follow_up_user_callback;
+CallbackSlot<void(const NanTransmitFollowupInd&)> on_nan_event_transmit_follow_up_user_callback;
 void onAsyncNanEventTransmitFollowUp(NanTransmitFollowupInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_transmit_follow_up_user_callback && event) {
-        on_nan_event_transmit_follow_up_user_callback(*event);
+    const auto callback = on_nan_event_transmit_follow_up_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanRangeRequestInd&)> on_nan_event_range_request_user_callback;
+CallbackSlot<void(const NanRangeRequestInd&)> on_nan_event_range_request_user_callback;
 void onAsyncNanEventRangeRequest(NanRangeRequestInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_range_request_user_callback && event) {
-        on_nan_event_range_request_user_callback(*event);
+    const auto callback = on_nan_event_range_request_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanRangeReportInd&)> on_nan_event_range_report_user_callback;
+CallbackSlot<void(const NanRangeReportInd&)> on_nan_event_range_report_user_callback;
 void onAsyncNanEventRangeReport(NanRangeReportInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_range_report_user_callback && event) {
-        on_nan_event_range_report_user_callback(*event);
+    const auto callback = on_nan_event_range_report_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanDataPathScheduleUpdateInd&)> on_nan_event_schedule_update_user_callback;
+CallbackSlot<void(const NanDataPathScheduleUpdateInd&)> on_nan_event_schedule_update_user_callback;
 void onAsyncNanEventScheduleUpdate(NanDataPathScheduleUpdateInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_schedule_update_user_callback && event) {
-        on_nan_event_schedule_update_user_callback(*event);
+    const auto callback = on_nan_event_schedule_update_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanSuspensionModeChangeInd&)>
+CallbackSlot<void(const NanSuspensionModeChangeInd&)>
         on_nan_event_suspension_mode_change_user_callback;
 void onAsyncNanEventSuspensionModeChange(NanSuspensionModeChangeInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_suspension_mode_change_user_callback && event) {
-        on_nan_event_suspension_mode_change_user_callback(*event);
+    const auto callback = on_nan_event_suspension_mode_change_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanPairingRequestInd&)> on_nan_event_pairing_request_user_callback;
+CallbackSlot<void(const NanPairingRequestInd&)> on_nan_event_pairing_request_user_callback;
 void onAsyncNanEventPairingRequest(NanPairingRequestInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_pairing_request_user_callback && event) {
-        on_nan_event_pairing_request_user_callback(*event);
+    const auto callback = on_nan_event_pairing_request_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanPairingConfirmInd&)> on_nan_event_pairing_confirm_user_callback;
+CallbackSlot<void(const NanPairingConfirmInd&)> on_nan_event_pairing_confirm_user_callback;
 void onAsyncNanEventPairingConfirm(NanPairingConfirmInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_pairing_confirm_user_callback && event) {
-        on_nan_event_pairing_confirm_user_callback(*event);
+    const auto callback = on_nan_event_pairing_confirm_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanBootstrappingRequestInd&)>
+CallbackSlot<void(const NanBootstrappingRequestInd&)>
         on_nan_event_bootstrapping_request_user_callback;
 void onAsyncNanEventBootstrappingRequest(NanBootstrappingRequestInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_bootstrapping_request_user_callback && event) {
-        on_nan_event_bootstrapping_request_user_callback(*event);
+    const auto callback = on_nan_event_bootstrapping_request_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const NanBootstrappingConfirmInd&)>
+CallbackSlot<void(const NanBootstrappingConfirmInd&)>
         on_nan_event_bootstrapping_confirm_user_callback;
 void onAsyncNanEventBootstrappingConfirm(NanBootstrappingConfirmInd* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_nan_event_bootstrapping_confirm_user_callback && event) {
-        on_nan_event_bootstrapping_confirm_user_callback(*event);
+    const auto callback = on_nan_event_bootstrapping_confirm_user_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
 // Callbacks for the various TWT operations.
-std::function<void(const TwtSetupResponse&)> on_twt_event_setup_response_callback;
+CallbackSlot<void(const TwtSetupResponse&)> on_twt_event_setup_response_callback;
 void onAsyncTwtEventSetupResponse(TwtSetupResponse* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_twt_event_setup_response_callback && event) {
-        on_twt_event_setup_response_callback(*event);
+    const auto callback = on_twt_event_setup_response_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const TwtTeardownCompletion&)> on_twt_event_teardown_completion_callback;
+CallbackSlot<void(const TwtTeardownCompletion&)> on_twt_event_teardown_completion_callback;
 void onAsyncTwtEventTeardownCompletion(TwtTeardownCompletion* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_twt_event_teardown_completion_callback && event) {
-        on_twt_event_teardown_completion_callback(*event);
+    const auto callback = on_twt_event_teardown_completion_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const TwtInfoFrameReceived&)> on_twt_event_info_frame_received_callback;
+CallbackSlot<void(const TwtInfoFrameReceived&)> on_twt_event_info_frame_received_callback;
 void onAsyncTwtEventInfoFrameReceived(TwtInfoFrameReceived* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_twt_event_info_frame_received_callback && event) {
-        on_twt_event_info_frame_received_callback(*event);
+    const auto callback = on_twt_event_info_frame_received_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
-std::function<void(const TwtDeviceNotify&)> on_twt_event_device_notify_callback;
+CallbackSlot<void(const TwtDeviceNotify&)> on_twt_event_device_notify_callback;
 void onAsyncTwtEventDeviceNotify(TwtDeviceNotify* event) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_twt_event_device_notify_callback && event) {
-        on_twt_event_device_notify_callback(*event);
+    const auto callback = on_twt_event_device_notify_callback.load();
+    if (callback && event) {
+        (*callback)(*event);
     }
 }
 
 // Callback to report current CHRE NAN state
-std::function<void(chre_nan_rtt_state)> on_chre_nan_rtt_internal_callback;
+CallbackSlot<void(chre_nan_rtt_state)> on_chre_nan_rtt_internal_callback;
 void onAsyncChreNanRttState(chre_nan_rtt_state state) {
-    const auto lock = aidl_sync_util::acquireGlobalLock();
-    if (on_chre_nan_rtt_internal_callback) {
-        on_chre_nan_rtt_internal_callback(state);
+    const auto callback = on_chre_nan_rtt_internal_callback.load();
+    if (callback) {
+        (*callback)(state);
     }
 }
 
@@ -1611,7 +1626,7 @@ wifi_error WifiLegacyHal::retrieveIfaceHandles() {
         LOG(ERROR) << "Failed to enumerate interface handles";
         return status;
     }
-    iface_name_to_handle_.clear();
+    std::map<std::string, wifi_interface_handle> iface_name_to_handle;
     for (int i = 0; i < num_iface_handles; ++i) {
         std::array<char, IFNAMSIZ> iface_name_arr = {};
         status = global_func_table_.wifi_get_iface_name(iface_handles[i], iface_name_arr.data(),
@@ -1624,12 +1639,15 @@ wifi_error WifiLegacyHal::retrieveIfaceHandles() {
         // API does not return a size.
         std::string iface_name(iface_name_arr.data());
         LOG(INFO) << "Adding interface handle for " << iface_name;
-        iface_name_to_handle_[iface_name] = iface_handles[i];
+        iface_name_to_handle[iface_name] = iface_handles[i];
     }
+    std::lock_guard<std::mutex> lock(iface_handles_lock_);
+    iface_name_to_handle_.swap(iface_name_to_handle);
     return WIFI_SUCCESS;
 }
 
 wifi_interface_handle WifiLegacyHal::getIfaceHandle(const std::string& iface_name) {
+    std::lock_guard<std::mutex> lock(iface_handles_lock_);
     const auto iface_handle_iter = iface_name_to_handle_.find(iface_name);
     if (iface_handle_iter == iface_name_to_handle_.end()) {
         LOG(ERROR) << "Unknown iface name: " << iface_name;
@@ -1895,7 +1913,10 @@ WifiLegacyHal::getSupportedIfaceConcurrencyMatrix() {
 
 void WifiLegacyHal::invalidate() {
     global_handle_ = nullptr;
-    iface_name_to_handle_.clear();
+    {
+        std::lock_guard<std::mutex> lock(iface_handles_lock_);
+        iface_name_to_handle_.clear();
+    }
     on_driver_memory_dump_internal_callback = nullptr;
     on_firmware_memory_dump_internal_callback = nullptr;
     on_gscan_event_internal_callback = nullptr;
@@ -804,8 +804,11 @@ class WifiLegacyHal {
     // Opaque handle to be used for all global operations.
     wifi_handle global_handle_;
     // Map of interface name to handle that is to be used for all interface
-    // specific operations.
+    // specific operations. Only modified with the global lock held, but
+    // guarded by |iface_handles_lock_| as well since the callbacks invoked on
+    // the event loop thread look up handles without the global lock.
     std::map<std::string, wifi_interface_handle> iface_name_to_handle_;
+    std::mutex iface_handles_lock_;
     // Flag to indicate if we have initiated the cleanup of legacy HAL.
     std::atomic<bool> awaiting_event_loop_termination_;
     std::condition_variable_any stop_wait_cv_;
@@ -21,6 +21,8 @@
 #include <aidl/android/hardware/wifi/IWifiNanIfaceEventCallback.h>
 #include <android-base/macros.h>
 
+#include <atomic>
+
 #include "aidl_callback_util.h"
 #include "wifi_iface_util.h"
 #include "wifi_legacy_hal.h"
@@ -141,7 +143,7 @@ class WifiNanIface : public BnWifiNanIface {
     bool is_dedicated_iface_;
     std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal_;
     std::weak_ptr<iface_util::WifiIfaceUtil> iface_util_;
-    bool is_valid_;
+    std::atomic<bool> is_valid_;
     std::weak_ptr<WifiNanIface> weak_ptr_this_;
     aidl_callback_util::AidlCallbackHandler<IWifiNanIfaceEventCallback> event_cb_handler_;
 
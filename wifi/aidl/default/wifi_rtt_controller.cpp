@@ -45,7 +45,10 @@ std::shared_ptr<WifiRttController> WifiRttController::create(
 
 void WifiRttController::invalidate() {
     legacy_hal_.reset();
-    event_callbacks_.clear();
+    {
+        std::lock_guard<std::mutex> lock(event_callbacks_lock_);
+        event_callbacks_.clear();
+    }
     is_valid_ = false;
 };
 
@@ -59,6 +62,7 @@ void WifiRttController::setWeakPtr(std::weak_ptr<WifiRttController> ptr) {
 
 std::vector<std::shared_ptr<IWifiRttControllerEventCallback>>
 WifiRttController::getEventCallbacks() {
+    std::lock_guard<std::mutex> lock(event_callbacks_lock_);
     return event_callbacks_;
 }
 
@@ -130,6 +134,7 @@ WifiRttController::getBoundIfaceInternal() {
 
 ndk::ScopedAStatus WifiRttController::registerEventCallbackInternal(
         const std::shared_ptr<IWifiRttControllerEventCallback>& callback) {
+    std::lock_guard<std::mutex> lock(event_callbacks_lock_);
     event_callbacks_.emplace_back(callback);
     return ndk::ScopedAStatus::ok();
 }
@@ -22,6 +22,9 @@
 #include <aidl/android/hardware/wifi/IWifiStaIface.h>
 #include <android-base/macros.h>
 
+#include <atomic>
+#include <mutex>
+
 #include "wifi_legacy_hal.h"
 
 namespace aidl {
@@ -87,9 +90,12 @@ class WifiRttController : public BnWifiRttController {
     std::string ifname_;
     std::shared_ptr<IWifiStaIface> bound_iface_;
     std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal_;
+    // Guarded by |event_callbacks_lock_|, since the callbacks are read from
+    // the legacy HAL event loop thread.
     std::vector<std::shared_ptr<IWifiRttControllerEventCallback>> event_callbacks_;
+    std::mutex event_callbacks_lock_;
     std::weak_ptr<WifiRttController> weak_ptr_this_;
-    bool is_valid_;
+    std::atomic<bool> is_valid_;
 
     DISALLOW_COPY_AND_ASSIGN(WifiRttController);
 };
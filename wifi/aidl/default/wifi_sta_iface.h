@@ -21,6 +21,8 @@
 #include <aidl/android/hardware/wifi/IWifiStaIfaceEventCallback.h>
 #include <android-base/macros.h>
 
+#include <atomic>
+
 #include "aidl_callback_util.h"
 #include "wifi_iface_util.h"
 #include "wifi_legacy_hal.h"
@@ -137,7 +139,7 @@ class WifiStaIface : public BnWifiStaIface {
     std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal_;
     std::weak_ptr<iface_util::WifiIfaceUtil> iface_util_;
     std::weak_ptr<WifiStaIface> weak_ptr_this_;
-    bool is_valid_;
+    std::atomic<bool> is_valid_;
     aidl_callback_util::AidlCallbackHandler<IWifiStaIfaceEventCallback> event_cb_handler_;
 
     DISALLOW_COPY_AND_ASSIGN(WifiStaIface);